@@ -18,11 +18,15 @@
 // See also //turbo/synchronization:mutex_benchmark for a comparison of SpinLock
 // and Mutex performance under varying levels of contention.
 
+#include <cstdint>
+
+#include <turbo/base/internal/cycleclock.h>
 #include <turbo/base/internal/raw_logging.h>
 #include <turbo/base/internal/scheduling_mode.h>
 #include <turbo/base/internal/spinlock.h>
 #include <turbo/base/no_destructor.h>
 #include <turbo/synchronization/internal/create_thread_identity.h>
+#include <turbo/synchronization/mutex.h>
 #include <benchmark/benchmark.h>
 
 namespace {
@@ -57,6 +61,43 @@ static void BM_SpinLock(benchmark::State& state) {
   }
 }
 
+static void DelayNs(int64_t ns, int* data) {
+  int64_t end = turbo::base_internal::CycleClock::Now() +
+                ns * turbo::base_internal::CycleClock::Frequency() / 1e9;
+  while (turbo::base_internal::CycleClock::Now() < end) {
+    ++(*data);
+    benchmark::DoNotOptimize(*data);
+  }
+}
+
+// Holds the lock for `cs_ns` nanoseconds per iteration, with the fixed spin
+// count (adaptive=0) or the learned per-lock spin budget (adaptive=1).
+static void BM_SpinLockCriticalSection(benchmark::State& state) {
+  turbo::EnableMutexAdaptiveSpinning(state.range(1) != 0);
+  static turbo::NoDestructor<turbo::base_internal::SpinLock> spinlock(
+      turbo::base_internal::SCHEDULE_KERNEL_ONLY);
+  static int shared = 0;
+  int local = 0;
+  for (auto _ : state) {
+    DelayNs(100 * state.threads(), &local);
+    turbo::base_internal::SpinLockHolder holder(spinlock.get());
+    DelayNs(state.range(0), &shared);
+  }
+  if (state.thread_index() == 0) {
+    turbo::EnableMutexAdaptiveSpinning(false);
+  }
+}
+
+BENCHMARK(BM_SpinLockCriticalSection)
+    ->UseRealTime()
+    ->Threads(4)
+    ->Threads(16)
+    ->ArgNames({"cs_ns", "adaptive"})
+    ->ArgPair(50, 0)
+    ->ArgPair(50, 1)
+    ->ArgPair(20000, 0)
+    ->ArgPair(20000, 1);
+
 BENCHMARK_TEMPLATE(BM_SpinLock,
                    turbo::base_internal::SCHEDULE_KERNEL_ONLY)
     ->UseRealTime()
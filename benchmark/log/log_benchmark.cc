@@ -15,12 +15,22 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 //
 
+#include <cstdio>
+#include <memory>
+#include <ostream>
+#include <string>
+
 #include <turbo/base/attributes.h>
 #include <turbo/base/log_severity.h>
 #include <turbo/flags/flag.h>
 #include <turbo/log/check.h>
+#include <turbo/log/deferred_log.h>
 #include <turbo/log/globals.h>
-#include <turbo/log/internal/flags.h>
+#include <turbo/log/internal/append_file.h>
+#include <turbo/log/internal/batch_file_writer.h>
+#include <turbo/log/internal/globals.h>
+#include <turbo/log/internal/log_format.h>
+#include <turbo/log/flags.h>
 #include <turbo/log/log.h>
 #include <turbo/log/log_entry.h>
 #include <turbo/log/log_sink.h>
@@ -98,6 +108,123 @@ static void BM_EnabledLogOverhead(benchmark::State& state) {
 }
 BENCHMARK(BM_EnabledLogOverhead);
 
+// A typical short message. Every thread reuses its cached staging buffers.
+static void BM_EnabledLogMessage(benchmark::State& state) {
+  turbo::ScopedStderrThreshold stderr_logging(
+      turbo::LogSeverityAtLeast::kInfinity);
+  turbo::log_internal::ScopedMinLogLevel scoped_min_log_level(
+      turbo::LogSeverityAtLeast::kInfo);
+  TURBO_ATTRIBUTE_UNUSED NullLogSink null_sink;
+  int n = 0;
+  for (auto _ : state) {
+    LOG(INFO) << "request " << n++ << " took " << 1.5 << "ms";
+  }
+}
+BENCHMARK(BM_EnabledLogMessage)->ThreadRange(1, 16);
+
+// Messages of `state.range(0)` bytes; the longer ones outgrow the per-thread
+// staging buffers and spill to the heap.
+static void BM_LongLogMessage(benchmark::State& state) {
+  turbo::ScopedStderrThreshold stderr_logging(
+      turbo::LogSeverityAtLeast::kInfinity);
+  turbo::log_internal::ScopedMinLogLevel scoped_min_log_level(
+      turbo::LogSeverityAtLeast::kInfo);
+  TURBO_ATTRIBUTE_UNUSED NullLogSink null_sink;
+  const std::string message(static_cast<size_t>(state.range(0)), 'x');
+  for (auto _ : state) {
+    LOG(INFO) << message;
+  }
+}
+BENCHMARK(BM_LongLogMessage)->Arg(1 << 10)->Arg(8 << 10);
+
+// The same message through `LOG_DEFERRED`, written unformatted by the
+// background thread.
+static void BM_DeferredLogMessage(benchmark::State& state) {
+  turbo::log_internal::ScopedMinLogLevel scoped_min_log_level(
+      turbo::LogSeverityAtLeast::kInfo);
+  if (state.thread_index() == 0) {
+    turbo::DeferredLogOptions options;
+    options.binary_path = "/dev/null";
+    turbo::start_deferred_logging(options);
+  }
+  int n = 0;
+  for (auto _ : state) {
+    LOG_DEFERRED(INFO, "request %d took %gms", n++, 1.5);
+  }
+  if (state.thread_index() == 0) {
+    turbo::stop_deferred_logging();
+  }
+}
+BENCHMARK(BM_DeferredLogMessage)->ThreadRange(1, 16);
+
+// Prefix of consecutive entries from one thread, mostly within one second.
+static void BM_FormatLogPrefix(benchmark::State& state) {
+  if (turbo::log_internal::TimeZone() == nullptr) {
+    turbo::log_internal::SetTimeZone(turbo::TimeZone::utc());
+  }
+  const turbo::log_internal::Tid tid = 4242;
+  turbo::Time t = turbo::Time::current_time();
+  char buf[256];
+  for (auto _ : state) {
+    turbo::span<char> span(buf, sizeof(buf));
+    benchmark::DoNotOptimize(turbo::log_internal::FormatLogPrefix(
+        turbo::LogSeverity::kInfo, t, tid, "log_benchmark.cc", 123,
+        turbo::log_internal::PrefixFormat::kNotRaw, span));
+    benchmark::DoNotOptimize(buf);
+    t += turbo::Duration::microseconds(3);
+  }
+}
+BENCHMARK(BM_FormatLogPrefix);
+
+// Appends 120 byte lines to a file: 0 through `AppendFile`, 1 through
+// `BatchFileWriter` with writev, 2 with io_uring, 3 with io_uring and
+// O_DIRECT.
+static void BM_FileWriter(benchmark::State& state) {
+  std::unique_ptr<turbo::FileWriter> writer;
+  if (state.range(0) == 0) {
+    writer = std::make_unique<turbo::log_internal::AppendFile>();
+  } else {
+    turbo::log_internal::BatchFileWriterOptions options;
+    options.use_io_uring = state.range(0) >= 2;
+    options.direct_io = state.range(0) == 3;
+    writer = std::make_unique<turbo::log_internal::BatchFileWriter>(options);
+  }
+  const std::string path = "log_benchmark_file_writer.log";
+  std::remove(path.c_str());
+  writer->initialize(path);
+  const std::string line(119, 'x');
+  const std::string entry = line + "\n";
+  for (auto _ : state) {
+    writer->write(entry);
+  }
+  writer->flush();
+  writer->close();
+  state.SetBytesProcessed(state.iterations() * entry.size());
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_FileWriter)->DenseRange(0, 3);
+
+struct LogsWhenStreamed {
+  friend std::ostream& operator<<(std::ostream& os, const LogsWhenStreamed&) {
+    LOG(INFO) << "inner";
+    return os << "outer";
+  }
+};
+
+// A message logged while another is being built on the same thread, which
+// takes the heap-allocated overflow path for the inner message.
+static void BM_NestedLogMessage(benchmark::State& state) {
+  turbo::ScopedStderrThreshold stderr_logging(
+      turbo::LogSeverityAtLeast::kInfinity);
+  turbo::log_internal::ScopedMinLogLevel scoped_min_log_level(
+      turbo::LogSeverityAtLeast::kInfo);
+  TURBO_ATTRIBUTE_UNUSED NullLogSink null_sink;
+  for (auto _ : state) {
+    LOG(INFO) << LogsWhenStreamed();
+  }
+}
+BENCHMARK(BM_NestedLogMessage);
+
 static void BM_VlogIsOnOverhead(benchmark::State& state) {
   // It would make sense to do this only when state.thread_index == 0,
   // but thread_index is an int on some platforms (e.g. Android) and a
@@ -132,4 +132,85 @@ BENCHMARK(BM_StrToUpper)
     ->RangeMultiplier(2)
     ->Range(64, 1 << 26);
 
+static void BM_StrToLowerInPlace(benchmark::State& state) {
+  const int size = state.range(0);
+  std::string s(size, 'X');
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(s);
+    turbo::str_to_lower(&s);
+    benchmark::DoNotOptimize(s);
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_StrToLowerInPlace)
+    ->DenseRange(0, 32, 8)
+    ->RangeMultiplier(4)
+    ->Range(64, 1 << 20);
+
+// Typical HTTP header names, lowered to be used as map keys.
+static void BM_StrToLowerHeaderNames(benchmark::State& state) {
+  const std::string names[] = {"Host", "User-Agent", "Accept-Encoding",
+                               "Content-Type", "X-Forwarded-For",
+                               "Access-Control-Request-Headers"};
+  for (auto _ : state) {
+    for (const std::string& name : names) {
+      benchmark::DoNotOptimize(turbo::str_to_lower(name));
+    }
+  }
+}
+BENCHMARK(BM_StrToLowerHeaderNames);
+
+// `size` printable characters, then the byte looked for.
+template <typename Function>
+void BulkBenchmark(benchmark::State& state, char last, Function f) {
+  const int size = state.range(0);
+  std::string s(size, 'x');
+  s.push_back(last);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(s);
+    benchmark::DoNotOptimize(f(s));
+  }
+  state.SetBytesProcessed(state.iterations() * s.size());
+}
+
+static void BM_StrIsAscii(benchmark::State& state) {
+  BulkBenchmark(state, 'y', turbo::str_is_ascii);
+}
+BENCHMARK(BM_StrIsAscii)->RangeMultiplier(4)->Range(16, 1 << 20);
+
+static void BM_StrFindFirstNonPrintable(benchmark::State& state) {
+  BulkBenchmark(state, '\n', turbo::str_find_first_non_printable);
+}
+BENCHMARK(BM_StrFindFirstNonPrintable)->RangeMultiplier(4)->Range(16, 1 << 20);
+
+static void BM_StrCountNonPrintable(benchmark::State& state) {
+  BulkBenchmark(state, '\n', turbo::str_count_non_printable);
+}
+BENCHMARK(BM_StrCountNonPrintable)->RangeMultiplier(4)->Range(16, 1 << 20);
+
+static void BM_StrFindFirstWhitespace(benchmark::State& state) {
+  BulkBenchmark(state, ' ', turbo::str_find_first_whitespace);
+}
+BENCHMARK(BM_StrFindFirstWhitespace)->RangeMultiplier(4)->Range(16, 1 << 20);
+
+static void BM_StrFindFirstWhitespaceStd(benchmark::State& state) {
+  BulkBenchmark(state, ' ', [](std::string_view s) {
+    return std::find_if(s.begin(), s.end(), turbo::ascii_isspace) - s.begin();
+  });
+}
+BENCHMARK(BM_StrFindFirstWhitespaceStd)
+    ->RangeMultiplier(4)
+    ->Range(16, 1 << 20);
+
+static void BM_TrimAll(benchmark::State& state) {
+  const int size = state.range(0);
+  const std::string s =
+      std::string(size, ' ') + "value" + std::string(size, '\t');
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(s);
+    benchmark::DoNotOptimize(turbo::trim_all(s));
+  }
+}
+BENCHMARK(BM_TrimAll)->Arg(0)->Arg(1)->Arg(4)->Arg(64)->Arg(1024);
+
 }  // namespace
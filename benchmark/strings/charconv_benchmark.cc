@@ -17,11 +17,18 @@
 
 #include <turbo/strings/charconv.h>
 
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <random>
 #include <string>
+#include <vector>
 
 #include <benchmark/benchmark.h>
+#include <turbo/strings/str_cat.h>
+#include <turbo/strings/str_format.h>
 
 namespace {
 
@@ -178,6 +185,97 @@ void BM_Turbo_Big_And_Difficult(benchmark::State& state) {
 }
 BENCHMARK(BM_Turbo_Big_And_Difficult)->Range(3, 5000);
 
+// Doubles with random bits, which mostly need 16 or 17 digits, and ones with
+// few digits, like most numbers printed in practice.
+template <typename Float>
+std::vector<Float> MakeValues(bool short_digits) {
+  std::mt19937_64 rng(42);
+  std::vector<Float> values;
+  while (values.size() < 4096) {
+    Float value;
+    if (short_digits) {
+      value = static_cast<Float>(rng() % 100000) / 1000;
+    } else {
+      const uint64_t bits = rng();
+      std::memcpy(&value, &bits, sizeof(value));
+      if (!std::isfinite(value)) continue;
+    }
+    values.push_back(value);
+  }
+  return values;
+}
+
+template <typename Float>
+void BM_Snprintf_ToChars(benchmark::State& state) {
+  const auto values = MakeValues<Float>(state.range(0) != 0);
+  char buf[64];
+  size_t i = 0;
+  for (auto s : state) {
+    benchmark::DoNotOptimize(snprintf(
+        buf, sizeof(buf), sizeof(Float) == sizeof(double) ? "%.17g" : "%.9g",
+        static_cast<double>(values[i++ & 4095])));
+  }
+}
+BENCHMARK_TEMPLATE(BM_Snprintf_ToChars, double)->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_Snprintf_ToChars, float)->Arg(0)->Arg(1);
+
+template <typename Float>
+void BM_Turbo_ToChars(benchmark::State& state) {
+  const auto values = MakeValues<Float>(state.range(0) != 0);
+  char buf[64];
+  size_t i = 0;
+  for (auto s : state) {
+    benchmark::DoNotOptimize(
+        turbo::to_chars(buf, buf + sizeof(buf), values[i++ & 4095]).ptr);
+  }
+}
+BENCHMARK_TEMPLATE(BM_Turbo_ToChars, double)->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_Turbo_ToChars, float)->Arg(0)->Arg(1);
+
+void BM_Turbo_ToChars_Scientific(benchmark::State& state) {
+  const auto values = MakeValues<double>(state.range(0) != 0);
+  char buf[64];
+  size_t i = 0;
+  for (auto s : state) {
+    benchmark::DoNotOptimize(turbo::to_chars(buf, buf + sizeof(buf),
+                                             values[i++ & 4095],
+                                             turbo::chars_format::scientific)
+                                 .ptr);
+  }
+}
+BENCHMARK(BM_Turbo_ToChars_Scientific)->Arg(0)->Arg(1);
+
+void BM_StrFormat_G(benchmark::State& state) {
+  const auto values = MakeValues<double>(state.range(0) != 0);
+  std::string out;
+  size_t i = 0;
+  for (auto s : state) {
+    out.clear();
+    turbo::str_append_format(&out, "%g", values[i++ & 4095]);
+    benchmark::DoNotOptimize(out);
+  }
+}
+BENCHMARK(BM_StrFormat_G)->Arg(0)->Arg(1);
+
+void BM_StrCat_ShortestDigits(benchmark::State& state) {
+  const auto values = MakeValues<double>(state.range(0) != 0);
+  size_t i = 0;
+  for (auto s : state) {
+    benchmark::DoNotOptimize(
+        turbo::str_cat(turbo::shortest_digits(values[i++ & 4095])));
+  }
+}
+BENCHMARK(BM_StrCat_ShortestDigits)->Arg(0)->Arg(1);
+
+void BM_StrCat_SixDigits(benchmark::State& state) {
+  const auto values = MakeValues<double>(state.range(0) != 0);
+  size_t i = 0;
+  for (auto s : state) {
+    benchmark::DoNotOptimize(turbo::str_cat(values[i++ & 4095]));
+  }
+}
+BENCHMARK(BM_StrCat_SixDigits)->Arg(0)->Arg(1);
+
 }  // namespace
 
 // ------------------------------------------------------------------------
@@ -23,6 +23,7 @@
 #include <memory>
 #include <random>
 #include <string>
+#include <string_view>
 
 #include <benchmark/benchmark.h>
 #include <turbo/base/internal/raw_logging.h>
@@ -66,6 +67,112 @@ void BM_WebSafeBase64Escape_string(benchmark::State& state) {
 }
 BENCHMARK(BM_WebSafeBase64Escape_string);
 
+// Binary payloads of the sizes JSON APIs carry, from a small token to an
+// image.
+std::string RandomBytes(size_t size) {
+  std::mt19937 rng(17);
+  std::string bytes(size, '\0');
+  for (char& c : bytes) c = static_cast<char>(rng());
+  return bytes;
+}
+
+void BM_Base64Encode(benchmark::State& state) {
+  const std::string raw = RandomBytes(static_cast<size_t>(state.range(0)));
+  std::string escaped;
+  for (auto _ : state) {
+    turbo::base64_encode(raw, &escaped);
+    benchmark::DoNotOptimize(escaped.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Base64Encode)->Range(16, 1 << 20);
+
+void BM_Base64Decode(benchmark::State& state) {
+  const std::string raw = RandomBytes(static_cast<size_t>(state.range(0)));
+  const std::string escaped = turbo::base64_encode(raw);
+  std::string unescaped;
+  for (auto _ : state) {
+    TURBO_RAW_CHECK(turbo::base64_decode(escaped, &unescaped), "");
+    benchmark::DoNotOptimize(unescaped.data());
+  }
+  TURBO_RAW_CHECK(unescaped == raw, "");
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Base64Decode)->Range(16, 1 << 20);
+
+void BM_WebSafeBase64Decode(benchmark::State& state) {
+  const std::string raw = RandomBytes(static_cast<size_t>(state.range(0)));
+  const std::string escaped = turbo::web_safe_base64_encode(raw);
+  std::string unescaped;
+  for (auto _ : state) {
+    TURBO_RAW_CHECK(turbo::web_safe_base64_decode(escaped, &unescaped), "");
+    benchmark::DoNotOptimize(unescaped.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WebSafeBase64Decode)->Range(16, 1 << 20);
+
+// MIME style, in lines of 76 characters.
+void BM_Base64Decode_Lines(benchmark::State& state) {
+  const std::string raw = RandomBytes(static_cast<size_t>(state.range(0)));
+  const std::string escaped = turbo::base64_encode(raw);
+  std::string wrapped;
+  for (size_t i = 0; i < escaped.size(); i += 76) {
+    wrapped += escaped.substr(i, 76);
+    wrapped += "\r\n";
+  }
+  std::string unescaped;
+  for (auto _ : state) {
+    TURBO_RAW_CHECK(turbo::base64_decode(wrapped, &unescaped), "");
+    benchmark::DoNotOptimize(unescaped.data());
+  }
+  TURBO_RAW_CHECK(unescaped == raw, "");
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Base64Decode_Lines)->Range(1 << 10, 1 << 20);
+
+// A payload read 16 KiB at a time.
+void BM_Base64Decoder_Pieces(benchmark::State& state) {
+  const std::string raw = RandomBytes(static_cast<size_t>(state.range(0)));
+  const std::string escaped = turbo::base64_encode(raw);
+  const std::string_view input = escaped;
+  std::string unescaped;
+  for (auto _ : state) {
+    turbo::Base64Decoder decoder;
+    unescaped.clear();
+    for (size_t i = 0; i < input.size(); i += 16 << 10) {
+      decoder.decode(input.substr(i, 16 << 10), &unescaped);
+    }
+    TURBO_RAW_CHECK(decoder.finish(&unescaped), "");
+    benchmark::DoNotOptimize(unescaped.data());
+  }
+  TURBO_RAW_CHECK(unescaped == raw, "");
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Base64Decoder_Pieces)->Range(1 << 14, 1 << 20);
+
+void BM_BytesToHexString(benchmark::State& state) {
+  const std::string raw = RandomBytes(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(turbo::bytes_to_hex_string(raw));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BytesToHexString)->Range(16, 1 << 20);
+
+void BM_HexStringToBytes(benchmark::State& state) {
+  const std::string raw = RandomBytes(static_cast<size_t>(state.range(0)));
+  const std::string hex = turbo::bytes_to_hex_string(raw);
+  std::string bytes;
+  for (auto _ : state) {
+    TURBO_RAW_CHECK(turbo::hex_string_to_bytes(hex, &bytes), "");
+    benchmark::DoNotOptimize(bytes.data());
+  }
+  TURBO_RAW_CHECK(bytes == raw, "");
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HexStringToBytes)->Range(16, 1 << 20);
+
 // Used for the c_encode benchmarks
 const char kStringValueNoEscape[] = "1234567890";
 const char kStringValueSomeEscaped[] = "123\n56789\xA1";
@@ -27,6 +27,8 @@
 #include <turbo/random/distributions.h>
 #include <turbo/random/random.h>
 #include <turbo/strings/numbers.h>
+#include <turbo/strings/str_cat.h>
+#include <turbo/strings/str_split.h>
 #include <turbo/strings/string_view.h>
 
 namespace {
@@ -288,4 +290,84 @@ void BM_FastHexToBufferZeroPad16(benchmark::State& state) {
 }
 BENCHMARK(BM_FastHexToBufferZeroPad16);
 
+// A column of `count` numbers of up to `max_digits` digits, one per line, as
+// read from a CSV or TSV file.
+std::string MakeIntColumn(int count, int max_digits) {
+  std::mt19937_64 rng(17);
+  int64_t limit = 1;
+  for (int i = 0; i < max_digits; ++i) limit *= 10;
+  std::string column;
+  for (int i = 0; i < count; ++i) {
+    const int64_t value = static_cast<int64_t>(rng() % static_cast<uint64_t>(limit));
+    turbo::str_append(&column, rng() % 4 == 0 ? -value : value, "\n");
+  }
+  column.pop_back();
+  return column;
+}
+
+std::string MakeDoubleColumn(int count) {
+  std::mt19937_64 rng(19);
+  std::string column;
+  for (int i = 0; i < count; ++i) {
+    const double value = static_cast<double>(rng() % 10000000) / 100;
+    turbo::str_append(&column, turbo::shortest_digits(value), "\n");
+  }
+  column.pop_back();
+  return column;
+}
+
+void BM_SimpleAtoi_SplitColumn(benchmark::State& state) {
+  const std::string column = MakeIntColumn(10000, state.range(0));
+  std::vector<int64_t> values(10000);
+  for (auto _ : state) {
+    size_t i = 0;
+    for (std::string_view field : turbo::str_split(column, '\n')) {
+      benchmark::DoNotOptimize(turbo::simple_atoi(field, &values[i++]));
+    }
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(column.size()));
+}
+BENCHMARK(BM_SimpleAtoi_SplitColumn)->Arg(4)->Arg(9)->Arg(18);
+
+void BM_SimpleAtoiInto_Column(benchmark::State& state) {
+  const std::string column = MakeIntColumn(10000, state.range(0));
+  std::vector<int64_t> values(10000);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        turbo::simple_atoi_into(column, '\n', turbo::MakeSpan(values)));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(column.size()));
+}
+BENCHMARK(BM_SimpleAtoiInto_Column)->Arg(4)->Arg(9)->Arg(18);
+
+void BM_SimpleAtod_SplitColumn(benchmark::State& state) {
+  const std::string column = MakeDoubleColumn(10000);
+  std::vector<double> values(10000);
+  for (auto _ : state) {
+    size_t i = 0;
+    for (std::string_view field : turbo::str_split(column, '\n')) {
+      benchmark::DoNotOptimize(turbo::simple_atod(field, &values[i++]));
+    }
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(column.size()));
+}
+BENCHMARK(BM_SimpleAtod_SplitColumn);
+
+void BM_SimpleAtodInto_Column(benchmark::State& state) {
+  const std::string column = MakeDoubleColumn(10000);
+  std::vector<double> values(10000);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        turbo::simple_atod_into(column, '\n', turbo::MakeSpan(values)));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(column.size()));
+}
+BENCHMARK(BM_SimpleAtodInto_Column);
+
 }  // namespace
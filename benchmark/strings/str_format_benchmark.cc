@@ -0,0 +1,109 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <cstdio>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <turbo/strings/str_format.h>
+#include <turbo/strings/string_view.h>
+
+namespace {
+
+// A log-line like format, with flags and widths that need the full parser.
+#define TURBO_BENCHMARK_LINE_FORMAT "%s:%d] %-8s id=%08x took %.3fms (%5.1f%%)"
+
+void BM_StrFormat_Line(benchmark::State& state) {
+  int i = 0;
+  for (auto _ : state) {
+    std::string s = turbo::str_format(TURBO_BENCHMARK_LINE_FORMAT, "server.cc",
+                                      i, "GET", i * 2654435761u, i * 0.125,
+                                      i % 1000 * 0.1);
+    benchmark::DoNotOptimize(s);
+    ++i;
+  }
+}
+BENCHMARK(BM_StrFormat_Line);
+
+void BM_StrFormat_Line_Compiled(benchmark::State& state) {
+  int i = 0;
+  for (auto _ : state) {
+    std::string s = turbo::str_format(TURBO_FORMAT(TURBO_BENCHMARK_LINE_FORMAT),
+                                      "server.cc", i, "GET", i * 2654435761u,
+                                      i * 0.125, i % 1000 * 0.1);
+    benchmark::DoNotOptimize(s);
+    ++i;
+  }
+}
+BENCHMARK(BM_StrFormat_Line_Compiled);
+
+void BM_StrFormat_Line_Parsed(benchmark::State& state) {
+  const turbo::ParsedFormat<'s', 'd', 's', 'x', 'f', 'f'> format(
+      TURBO_BENCHMARK_LINE_FORMAT);
+  int i = 0;
+  for (auto _ : state) {
+    std::string s = turbo::str_format(format, "server.cc", i, "GET",
+                                      i * 2654435761u, i * 0.125,
+                                      i % 1000 * 0.1);
+    benchmark::DoNotOptimize(s);
+    ++i;
+  }
+}
+BENCHMARK(BM_StrFormat_Line_Parsed);
+
+void BM_Snprintf_Line(benchmark::State& state) {
+  char buf[128];
+  int i = 0;
+  for (auto _ : state) {
+    std::snprintf(buf, sizeof(buf), TURBO_BENCHMARK_LINE_FORMAT, "server.cc", i,
+                  "GET", i * 2654435761u, i * 0.125, i % 1000 * 0.1);
+    std::string s(buf);
+    benchmark::DoNotOptimize(s);
+    ++i;
+  }
+}
+BENCHMARK(BM_Snprintf_Line);
+
+// Mostly literal text with a few plain conversions.
+void BM_StrAppendFormat_KeyValues(benchmark::State& state) {
+  std::string out;
+  int i = 0;
+  for (auto _ : state) {
+    out.clear();
+    turbo::str_append_format(&out, "user=%s; session=%d; shard=%d; ok", "alice",
+                             i, i & 15);
+    benchmark::DoNotOptimize(out);
+    ++i;
+  }
+}
+BENCHMARK(BM_StrAppendFormat_KeyValues);
+
+void BM_StrAppendFormat_KeyValues_Compiled(benchmark::State& state) {
+  std::string out;
+  int i = 0;
+  for (auto _ : state) {
+    out.clear();
+    turbo::str_append_format(
+        &out, TURBO_FORMAT("user=%s; session=%d; shard=%d; ok"), "alice", i,
+        i & 15);
+    benchmark::DoNotOptimize(out);
+    ++i;
+  }
+}
+BENCHMARK(BM_StrAppendFormat_KeyValues_Compiled);
+
+}  // namespace
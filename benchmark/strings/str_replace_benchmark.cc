@@ -19,9 +19,12 @@
 
 #include <cstring>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <benchmark/benchmark.h>
 #include <turbo/base/internal/raw_logging.h>
+#include <turbo/strings/cord.h>
 
 namespace {
 
@@ -122,4 +125,102 @@ void BM_StrReplaceAll(benchmark::State& state) {
 }
 BENCHMARK(BM_StrReplaceAll);
 
+void BM_StrReplacerOneReplacement(benchmark::State& state) {
+  SetUpStrings();
+  std::string src = *big_string;
+  const turbo::StrReplacer replacer({{"the", "box"}});
+  for (auto _ : state) {
+    std::string dest = replacer.replace_all(src);
+    TURBO_RAW_CHECK(dest == *after_replacing_the,
+                   "not benchmarking intended behavior");
+  }
+}
+BENCHMARK(BM_StrReplacerOneReplacement);
+
+void BM_StrReplacer(benchmark::State& state) {
+  SetUpStrings();
+  std::string src = *big_string;
+  const turbo::StrReplacer replacer({{"the", "box"},
+                                     {"brown", "quick"},
+                                     {"jumped", "liquored"},
+                                     {"dozen", "brown"},
+                                     {"lazy", "pack"},
+                                     {"liquor", "shakes"}});
+  for (auto _ : state) {
+    std::string dest = replacer.replace_all(src);
+    TURBO_RAW_CHECK(dest == *after_replacing_many,
+                   "not benchmarking intended behavior");
+  }
+}
+BENCHMARK(BM_StrReplacer);
+
+// Redaction-style lists: the six words above among `n` made-up terms.
+std::vector<std::pair<std::string, std::string>> ManyReplacements(int n) {
+  std::vector<std::pair<std::string, std::string>> result;
+  for (const auto& r : replacements) {
+    result.emplace_back(r.needle, r.replacement);
+  }
+  size_t x = 12345;
+  while (result.size() < static_cast<size_t>(n)) {
+    std::string term;
+    for (size_t size = 5 + x % 6; term.size() < size;) {
+      x = x * 6364136223846793005u + 1442695040888963407u;
+      term.push_back(static_cast<char>('a' + (x >> 33) % 26));
+    }
+    result.emplace_back(term, "[redacted]");
+  }
+  return result;
+}
+
+void BM_StrReplaceAllManyPatterns(benchmark::State& state) {
+  SetUpStrings();
+  const auto many = ManyReplacements(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    std::string dest = turbo::str_replace_all(*big_string, many);
+    benchmark::DoNotOptimize(dest);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(big_string->size()));
+}
+BENCHMARK(BM_StrReplaceAllManyPatterns)->Arg(16)->Arg(128)->Arg(512);
+
+void BM_StrReplacerManyPatterns(benchmark::State& state) {
+  SetUpStrings();
+  const auto many = ManyReplacements(static_cast<int>(state.range(0)));
+  const turbo::StrReplacer replacer(many);
+  TURBO_RAW_CHECK(replacer.replace_all(*big_string) ==
+                      turbo::str_replace_all(*big_string, many),
+                  "not benchmarking intended behavior");
+  for (auto _ : state) {
+    std::string dest = replacer.replace_all(*big_string);
+    benchmark::DoNotOptimize(dest);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(big_string->size()));
+}
+BENCHMARK(BM_StrReplacerManyPatterns)->Arg(16)->Arg(128)->Arg(512);
+
+void BM_StrReplacerManyPatternsCord(benchmark::State& state) {
+  SetUpStrings();
+  const auto many = ManyReplacements(static_cast<int>(state.range(0)));
+  const turbo::StrReplacer replacer(many);
+  const turbo::Cord src(*big_string);
+  for (auto _ : state) {
+    turbo::Cord dest = replacer.replace_all(src);
+    benchmark::DoNotOptimize(dest);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(big_string->size()));
+}
+BENCHMARK(BM_StrReplacerManyPatternsCord)->Arg(16)->Arg(512);
+
+void BM_StrReplacerBuild(benchmark::State& state) {
+  const auto many = ManyReplacements(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    turbo::StrReplacer replacer(many);
+    benchmark::DoNotOptimize(replacer);
+  }
+}
+BENCHMARK(BM_StrReplacerBuild)->Arg(16)->Arg(512);
+
 }  // namespace
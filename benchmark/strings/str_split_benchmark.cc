@@ -26,6 +26,8 @@
 
 #include <benchmark/benchmark.h>
 #include <turbo/base/internal/raw_logging.h>
+#include <turbo/container/span.h>
+#include <turbo/strings/charset.h>
 #include <turbo/strings/string_view.h>
 
 namespace {
@@ -71,6 +73,91 @@ void BM_Split2StringViewByAnyChar(benchmark::State& state) {
 }
 BENCHMARK_RANGE(BM_Split2StringViewByAnyChar, 0, 1 << 20);
 
+void BM_SplitIntoByChar(benchmark::State& state) {
+  std::string test = MakeTestString(state.range(0));
+  std::vector<std::string_view> result(state.range(0) + 2);
+  for (auto _ : state) {
+    size_t n = turbo::str_split_into(test, ';', turbo::MakeSpan(result));
+    benchmark::DoNotOptimize(n);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetBytesProcessed(state.iterations() * test.size());
+}
+BENCHMARK_RANGE(BM_SplitIntoByChar, 0, 1 << 20);
+
+void BM_SplitIntoByAnyChar(benchmark::State& state) {
+  std::string test = MakeMultiDelimiterTestString(state.range(0));
+  const turbo::ByAnyChar delimiters(kDelimiters);
+  std::vector<std::string_view> result(state.range(0) + 2);
+  for (auto _ : state) {
+    size_t n = turbo::str_split_into(test, delimiters, turbo::MakeSpan(result));
+    benchmark::DoNotOptimize(n);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetBytesProcessed(state.iterations() * test.size());
+}
+BENCHMARK_RANGE(BM_SplitIntoByAnyChar, 0, 1 << 20);
+
+// Lines of 12 tab separated fields, about 120 bytes each.
+std::vector<std::string> MakeTsvLines() {
+  std::vector<std::string> lines;
+  for (int i = 0; i < 1000; ++i) {
+    std::string line;
+    for (int field = 0; field < 12; ++field) {
+      if (field > 0) line.push_back('\t');
+      line.append(1 + (i * 7 + field * 3) % 17, static_cast<char>('a' + field));
+    }
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+void BM_TsvLinesStrSplit(benchmark::State& state) {
+  const std::vector<std::string> lines = MakeTsvLines();
+  size_t bytes = 0;
+  for (const std::string& line : lines) bytes += line.size();
+  for (auto _ : state) {
+    for (const std::string& line : lines) {
+      std::vector<std::string_view> fields = turbo::str_split(line, '\t');
+      benchmark::DoNotOptimize(fields.data());
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_TsvLinesStrSplit);
+
+void BM_TsvLinesSplitInto(benchmark::State& state) {
+  const std::vector<std::string> lines = MakeTsvLines();
+  size_t bytes = 0;
+  for (const std::string& line : lines) bytes += line.size();
+  std::string_view fields[16];
+  for (auto _ : state) {
+    for (const std::string& line : lines) {
+      size_t n = turbo::str_split_into(line, '\t', fields);
+      benchmark::DoNotOptimize(n);
+      benchmark::DoNotOptimize(fields);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_TsvLinesSplitInto);
+
+// Log lines split on any whitespace.
+void BM_LogLinesByWhitespace(benchmark::State& state) {
+  const std::string line =
+      "I1018 09:04:17.123456 12345 server.cc:123] request done user=alice\t"
+      "latency_ms=12 status=OK path=/api/v1/items?id=42";
+  const turbo::ByAnyChar whitespace(turbo::CharSet::AsciiWhitespace());
+  std::string_view fields[32];
+  for (auto _ : state) {
+    size_t n = turbo::str_split_into(line, whitespace, fields);
+    benchmark::DoNotOptimize(n);
+    benchmark::DoNotOptimize(fields);
+  }
+  state.SetBytesProcessed(state.iterations() * line.size());
+}
+BENCHMARK(BM_LogLinesByWhitespace);
+
 void BM_Split2StringViewLifted(benchmark::State& state) {
   std::string test = MakeTestString(state.range(0));
   std::vector<std::string_view> result;
@@ -0,0 +1,136 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/strings/utf8.h>
+
+#include <cstddef>
+#include <random>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <turbo/strings/internal/utf8.h>
+
+namespace {
+
+enum Text { kAscii, kLatin, kCjk };
+
+// About 1MB of text: ASCII, mostly ASCII with some accented letters, or
+// Chinese (three bytes a code point) with spaces.
+std::string MakeText(Text text) {
+  std::mt19937 rng(42);
+  std::string out;
+  while (out.size() < (1 << 20)) {
+    const uint32_t r = rng() % 16;
+    switch (text) {
+      case kAscii:
+        out.push_back(static_cast<char>('a' + r));
+        break;
+      case kLatin:
+        out += r == 0 ? "\xc3\xa9" : r == 1 ? "\xc3\xbc" : std::string(1, static_cast<char>('a' + r));
+        break;
+      case kCjk:
+        out += r == 0 ? " " : "\xe4\xb8\xad";
+        break;
+    }
+  }
+  return out;
+}
+
+// The implementation is the first argument: 0 for the one picked for the
+// CPU, then scalar, ssse3, avx2 and neon.
+bool Select(benchmark::State& state) {
+  static const char* const kImplementations[] = {nullptr, "scalar", "ssse3", "avx2", "neon"};
+  static const std::string best = turbo::strings_internal::Utf8Implementation();
+  const char* name = kImplementations[state.range(0)];
+  if (!turbo::strings_internal::SetUtf8Implementation(name == nullptr ? best : name)) {
+    state.SkipWithError("not supported");
+    return false;
+  }
+  state.SetLabel(turbo::strings_internal::Utf8Implementation());
+  return true;
+}
+
+void BM_Validate(benchmark::State& state) {
+  const std::string text = MakeText(static_cast<Text>(state.range(1)));
+  if (!Select(state)) return;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(turbo::validate_utf8(text));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+void BM_CountCodePoints(benchmark::State& state) {
+  const std::string text = MakeText(static_cast<Text>(state.range(1)));
+  if (!Select(state)) return;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(turbo::count_utf8_code_points(text));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+void BM_Utf8ToUtf16(benchmark::State& state) {
+  const std::string text = MakeText(static_cast<Text>(state.range(1)));
+  if (!Select(state)) return;
+  std::u16string out;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(turbo::utf8_to_utf16(text, &out));
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+void BM_Utf8ToUtf32(benchmark::State& state) {
+  const std::string text = MakeText(static_cast<Text>(state.range(1)));
+  if (!Select(state)) return;
+  std::u32string out;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(turbo::utf8_to_utf32(text, &out));
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+// Bytes processed are those of the UTF-8 side.
+void BM_Utf16ToUtf8(benchmark::State& state) {
+  const std::string text = MakeText(static_cast<Text>(state.range(1)));
+  std::u16string utf16;
+  turbo::utf8_to_utf16(text, &utf16);
+  if (!Select(state)) return;
+  std::string out;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(turbo::utf16_to_utf8(utf16, &out));
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+void Arguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"impl", "text"});
+  for (int impl = 0; impl < 5; ++impl) {
+    for (int text : {kAscii, kLatin, kCjk}) {
+      b->Args({impl, text});
+    }
+  }
+}
+
+BENCHMARK(BM_Validate)->Apply(Arguments);
+BENCHMARK(BM_CountCodePoints)->Apply(Arguments);
+BENCHMARK(BM_Utf8ToUtf16)->Apply(Arguments);
+BENCHMARK(BM_Utf8ToUtf32)->Apply(Arguments);
+BENCHMARK(BM_Utf16ToUtf8)->Apply(Arguments);
+
+}  // namespace
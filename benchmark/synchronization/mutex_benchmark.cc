@@ -24,6 +24,7 @@
 #include <turbo/base/internal/spinlock.h>
 #include <turbo/base/no_destructor.h>
 #include <turbo/synchronization/blocking_counter.h>
+#include <turbo/synchronization/distributed_rw_lock.h>
 #include <turbo/synchronization/internal/thread_pool.h>
 #include <turbo/synchronization/mutex.h>
 #include <benchmark/benchmark.h>
@@ -46,6 +47,14 @@ void BM_ReaderLock(benchmark::State& state) {
 }
 BENCHMARK(BM_ReaderLock)->UseRealTime()->Threads(1)->ThreadPerCpu();
 
+void BM_DistributedReaderLock(benchmark::State& state) {
+  static turbo::NoDestructor<turbo::DistributedRWLock> mu;
+  for (auto _ : state) {
+    turbo::DistributedReaderLock lock(mu.get());
+  }
+}
+BENCHMARK(BM_DistributedReaderLock)->UseRealTime()->Threads(1)->ThreadPerCpu();
+
 void BM_TryLock(benchmark::State& state) {
   turbo::Mutex mu;
   for (auto _ : state) {
@@ -279,6 +288,94 @@ BENCHMARK_TEMPLATE(BM_Contended, std::mutex)
       SetupBenchmarkArgs(bm, /*do_test_priorities=*/false);
     });
 
+BENCHMARK_TEMPLATE(BM_Contended, turbo::DistributedRWLock)
+    ->Apply([](benchmark::internal::Benchmark* bm) {
+      SetupBenchmarkArgs(bm, /*do_test_priorities=*/false);
+    });
+
+// Same workload as BM_Contended with a short and a long critical section, run
+// with the fixed spin count and with adaptive spinning. With long critical
+// sections adaptive spinning should cut CPU time at equal throughput.
+template <typename MutexType>
+void BM_ContendedSpinMode(benchmark::State& state) {
+  turbo::EnableMutexAdaptiveSpinning(state.range(1) != 0);
+  struct Shared {
+    MutexType mu;
+    int data = 0;
+  };
+  static turbo::NoDestructor<Shared> shared;
+  int local = 0;
+  for (auto _ : state) {
+    DelayNs(100 * state.threads(), &local);
+    RaiiLocker<MutexType> locker(&shared->mu);
+    DelayNs(state.range(0), &shared->data);
+  }
+  if (state.thread_index() == 0) {
+    turbo::EnableMutexAdaptiveSpinning(false);
+  }
+}
+
+void SetupSpinModeArgs(benchmark::internal::Benchmark* bm) {
+  bm->UseRealTime()
+      ->Threads(2)
+      ->Threads(4)
+      ->Threads(8)
+      ->Threads(16)
+      ->ArgNames({"cs_ns", "adaptive"});
+  for (int critical_section_ns : {50, 20000}) {
+    for (int adaptive = 0; adaptive <= 1; ++adaptive) {
+      bm->ArgPair(critical_section_ns, adaptive);
+    }
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_ContendedSpinMode, turbo::Mutex)
+    ->Apply(SetupSpinModeArgs);
+BENCHMARK_TEMPLATE(BM_ContendedSpinMode, turbo::base_internal::SpinLock)
+    ->Apply(SetupSpinModeArgs);
+
+// Read-dominated workload: every thread takes the lock in shared mode and
+// one acquisition in `write_period` is exclusive.
+template <typename MutexType>
+void BM_ReadMostly(benchmark::State& state) {
+  const int write_period = state.range(0);
+  struct Shared {
+    MutexType mu;
+    int data = 0;
+  };
+  static turbo::NoDestructor<Shared> shared;
+  int local = 0;
+  int i = 0;
+  for (auto _ : state) {
+    DelayNs(20, &local);
+    if (++i == write_period) {
+      i = 0;
+      shared->mu.Lock();
+      DelayNs(20, &shared->data);
+      shared->mu.Unlock();
+    } else {
+      shared->mu.ReaderLock();
+      benchmark::DoNotOptimize(shared->data);
+      shared->mu.ReaderUnlock();
+    }
+  }
+}
+
+void SetupReadMostlyArgs(benchmark::internal::Benchmark* bm) {
+  bm->UseRealTime()
+      ->Threads(1)
+      ->Threads(4)
+      ->Threads(16)
+      ->Threads(64)
+      ->ArgName("write_period")
+      ->Arg(1000)
+      ->Arg(100000);
+}
+
+BENCHMARK_TEMPLATE(BM_ReadMostly, turbo::Mutex)->Apply(SetupReadMostlyArgs);
+BENCHMARK_TEMPLATE(BM_ReadMostly, turbo::DistributedRWLock)
+    ->Apply(SetupReadMostlyArgs);
+
 // Measure the overhead of conditions on mutex release (when they must be
 // evaluated).  Mutex has (some) support for equivalence classes allowing
 // Conditions with the same function/argument to potentially not be multiply
@@ -0,0 +1,117 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+// Read-side overhead of the memory reclamation primitives compared to
+// protecting the same read with `turbo::Mutex` in shared mode.
+
+#include <atomic>
+#include <cstdint>
+
+#include <turbo/base/no_destructor.h>
+#include <turbo/synchronization/epoch_domain.h>
+#include <turbo/synchronization/hazard_pointer.h>
+#include <turbo/synchronization/mutex.h>
+#include <turbo/synchronization/read_mostly.h>
+#include <benchmark/benchmark.h>
+
+namespace {
+
+struct Payload {
+  int64_t value = 42;
+};
+
+Payload* SharedPayload() {
+  static turbo::NoDestructor<Payload> payload;
+  return payload.get();
+}
+
+void BM_MutexReaderLock(benchmark::State& state) {
+  static turbo::NoDestructor<turbo::Mutex> mu;
+  Payload* payload = SharedPayload();
+  for (auto _ : state) {
+    turbo::ReaderMutexLock lock(mu.get());
+    benchmark::DoNotOptimize(payload->value);
+  }
+}
+BENCHMARK(BM_MutexReaderLock)->UseRealTime()->Threads(1)->ThreadPerCpu();
+
+void BM_EpochPin(benchmark::State& state) {
+  static turbo::NoDestructor<std::atomic<Payload*>> current(SharedPayload());
+  turbo::EpochDomain& domain = turbo::EpochDomain::Default();
+  for (auto _ : state) {
+    turbo::EpochDomain::Guard guard = domain.Pin();
+    benchmark::DoNotOptimize(
+        current->load(std::memory_order_acquire)->value);
+  }
+}
+BENCHMARK(BM_EpochPin)->UseRealTime()->Threads(1)->ThreadPerCpu();
+
+void BM_EpochPinNested(benchmark::State& state) {
+  static turbo::NoDestructor<std::atomic<Payload*>> current(SharedPayload());
+  turbo::EpochDomain& domain = turbo::EpochDomain::Default();
+  // An outer guard turns every inner pin into a nesting counter update.
+  turbo::EpochDomain::Guard outer = domain.Pin();
+  for (auto _ : state) {
+    turbo::EpochDomain::Guard guard = domain.Pin();
+    benchmark::DoNotOptimize(
+        current->load(std::memory_order_acquire)->value);
+  }
+}
+BENCHMARK(BM_EpochPinNested)->UseRealTime()->Threads(1)->ThreadPerCpu();
+
+void BM_HazardPointerProtect(benchmark::State& state) {
+  static turbo::NoDestructor<std::atomic<Payload*>> current(SharedPayload());
+  turbo::HazardPointerDomain::Holder holder;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(holder.Protect(*current)->value);
+    holder.Reset();
+  }
+}
+BENCHMARK(BM_HazardPointerProtect)->UseRealTime()->Threads(1)->ThreadPerCpu();
+
+void BM_ReadMostlyRead(benchmark::State& state) {
+  static turbo::NoDestructor<turbo::ReadMostly<Payload>> value;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(value->Read()->value);
+  }
+}
+BENCHMARK(BM_ReadMostlyRead)->UseRealTime()->Threads(1)->ThreadPerCpu();
+
+// Writer cost: publish a new object and retire the old one.
+void BM_EpochRetire(benchmark::State& state) {
+  turbo::EpochDomain domain;
+  std::atomic<Payload*> current{new Payload};
+  for (auto _ : state) {
+    domain.Retire(current.exchange(new Payload, std::memory_order_acq_rel));
+  }
+  domain.Retire(current.load());
+  domain.Synchronize();
+}
+BENCHMARK(BM_EpochRetire);
+
+void BM_HazardPointerRetire(benchmark::State& state) {
+  turbo::HazardPointerDomain domain;
+  std::atomic<Payload*> current{new Payload};
+  for (auto _ : state) {
+    domain.Retire(current.exchange(new Payload, std::memory_order_acq_rel));
+  }
+  domain.Retire(current.load());
+  domain.Reclaim();
+}
+BENCHMARK(BM_HazardPointerRetire);
+
+}  // namespace
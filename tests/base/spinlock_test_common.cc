@@ -19,6 +19,7 @@
 // spinlock.  If the spinlock is working properly, all elements of the
 // array should be equal at the end of the test.
 
+#include <algorithm>
 #include <cstdint>
 #include <limits>
 #include <random>
@@ -29,6 +30,7 @@
 #include <gtest/gtest.h>
 #include <turbo/base/attributes.h>
 #include <turbo/base/config.h>
+#include <turbo/base/internal/adaptive_spin.h>
 #include <turbo/base/internal/low_level_scheduling.h>
 #include <turbo/base/internal/scheduling_mode.h>
 #include <turbo/base/internal/spinlock.h>
@@ -282,6 +284,43 @@ TEST(SpinLockTest, IsCooperative) {
   EXPECT_FALSE(SpinLockTest::IsCooperative(kernel_only));
 }
 
+// Returns the smallest limit over a full probe period, i.e. the learned one.
+static int LearnedSpinLimit(const void* lock, int max_spins) {
+  int limit = max_spins;
+  for (uint32_t i = 0; i < AdaptiveSpin::kProbePeriod; ++i) {
+    limit = std::min(limit, AdaptiveSpin::SpinLimit(lock, max_spins));
+  }
+  return limit;
+}
+
+TEST(AdaptiveSpin, LearnsFromOutcomes) {
+  static int lock;
+  constexpr int kMaxSpins = 1000;
+  for (int i = 0; i < 100; ++i) {
+    AdaptiveSpin::RecordFailure(&lock, kMaxSpins);
+  }
+  EXPECT_EQ(LearnedSpinLimit(&lock, kMaxSpins), AdaptiveSpin::kMinSpins);
+
+  for (int i = 0; i < 200; ++i) {
+    AdaptiveSpin::RecordSuccess(&lock, 100);
+  }
+  const int limit = LearnedSpinLimit(&lock, kMaxSpins);
+  EXPECT_GE(limit, 2 * 90 + AdaptiveSpin::kMinSpins);
+  EXPECT_LE(limit, 2 * 100 + AdaptiveSpin::kMinSpins);
+
+  for (int i = 0; i < 200; ++i) {
+    AdaptiveSpin::RecordSuccess(&lock, 5000);
+  }
+  EXPECT_EQ(LearnedSpinLimit(&lock, kMaxSpins), kMaxSpins);
+}
+
+TEST(SpinLockWithThreads, AdaptiveSpinning) {
+  AdaptiveSpin::set_enabled(true);
+  SpinLock spinlock(base_internal::SCHEDULE_KERNEL_ONLY);
+  ThreadedTest(&spinlock);
+  AdaptiveSpin::set_enabled(false);
+}
+
 }  // namespace
 }  // namespace base_internal
 TURBO_NAMESPACE_END
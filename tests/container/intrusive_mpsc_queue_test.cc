@@ -0,0 +1,170 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include "turbo/container/intrusive_mpsc_queue.h"
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <turbo/times/time.h>
+
+namespace {
+
+    struct Item : public turbo::intrusive_list_node {
+        int producer = 0;
+        int seq = 0;
+    };
+
+    TEST(IntrusiveMpscQueueTest, EmptyOnConstruction) {
+        turbo::intrusive_mpsc_queue<Item> q;
+        EXPECT_TRUE(q.empty());
+        turbo::intrusive_list<Item> out;
+        EXPECT_EQ(q.pop_all(out), 0u);
+        EXPECT_TRUE(out.empty());
+    }
+
+    TEST(IntrusiveMpscQueueTest, PushReportsEmptyTransition) {
+        turbo::intrusive_mpsc_queue<Item> q;
+        Item a, b, c;
+        EXPECT_TRUE(q.push(a));
+        EXPECT_FALSE(q.push(b));
+        EXPECT_FALSE(q.empty());
+
+        turbo::intrusive_list<Item> out;
+        EXPECT_EQ(q.pop_all(out), 2u);
+        EXPECT_TRUE(q.empty());
+        EXPECT_TRUE(q.push(c));
+        EXPECT_EQ(q.pop_all(out), 1u);
+    }
+
+    TEST(IntrusiveMpscQueueTest, PopAllPreservesPushOrder) {
+        turbo::intrusive_mpsc_queue<Item> q;
+        std::vector<Item> items(10);
+        for (int i = 0; i < 5; ++i) {
+            items[i].seq = i;
+            q.push(items[i]);
+        }
+
+        turbo::intrusive_list<Item> out;
+        EXPECT_EQ(q.pop_all(out), 5u);
+        for (int i = 5; i < 10; ++i) {
+            items[i].seq = i;
+            q.push(items[i]);
+        }
+        // A second batch is appended behind the first one.
+        EXPECT_EQ(q.pop_all(out), 5u);
+
+        int expected = 0;
+        for (auto &item: out) {
+            EXPECT_EQ(item.seq, expected++);
+        }
+        EXPECT_EQ(expected, 10);
+    }
+
+    TEST(IntrusiveMpscQueueTest, ConsumeAllAllowsRepush) {
+        turbo::intrusive_mpsc_queue<Item> q;
+        Item a, b;
+        a.seq = 1;
+        b.seq = 2;
+        q.push(a);
+        q.push(b);
+
+        std::vector<int> seen;
+        EXPECT_EQ(q.consume_all([&](Item *item) {
+            seen.push_back(item->seq);
+            if (item->seq == 1) {
+                q.push(*item);
+            }
+        }), 2u);
+        EXPECT_EQ(seen, (std::vector<int>{1, 2}));
+
+        seen.clear();
+        EXPECT_EQ(q.consume_all([&](Item *item) { seen.push_back(item->seq); }), 1u);
+        EXPECT_EQ(seen, (std::vector<int>{1}));
+    }
+
+    TEST(IntrusiveMpscQueueTest, MultipleProducers) {
+        constexpr int kProducers = 4;
+        constexpr int kPerProducer = 10000;
+        turbo::intrusive_mpsc_queue<Item> q;
+        std::vector<std::vector<Item>> items(kProducers, std::vector<Item>(kPerProducer));
+
+        std::vector<std::thread> producers;
+        for (int p = 0; p < kProducers; ++p) {
+            producers.emplace_back([&, p] {
+                for (int i = 0; i < kPerProducer; ++i) {
+                    items[p][i].producer = p;
+                    items[p][i].seq = i;
+                    q.push(items[p][i]);
+                }
+            });
+        }
+
+        std::vector<int> next(kProducers, 0);
+        int total = 0;
+        while (total < kProducers * kPerProducer) {
+            total += static_cast<int>(q.consume_all([&](Item *item) {
+                // Elements of a single producer are delivered in order.
+                EXPECT_EQ(item->seq, next[item->producer]);
+                ++next[item->producer];
+            }));
+        }
+        for (auto &t: producers) {
+            t.join();
+        }
+        EXPECT_TRUE(q.empty());
+        for (int p = 0; p < kProducers; ++p) {
+            EXPECT_EQ(next[p], kPerProducer);
+        }
+    }
+
+    TEST(BlockingIntrusiveMpscQueueTest, WaitTimesOutWhenEmpty) {
+        turbo::blocking_intrusive_mpsc_queue<Item> q;
+        turbo::intrusive_list<Item> out;
+        EXPECT_EQ(q.wait_pop_all_with_timeout(out, turbo::Duration::milliseconds(10)), 0u);
+        EXPECT_TRUE(out.empty());
+    }
+
+    TEST(BlockingIntrusiveMpscQueueTest, ProducerWakesConsumer) {
+        constexpr int kItems = 1000;
+        turbo::blocking_intrusive_mpsc_queue<Item> q;
+        std::vector<Item> items(kItems);
+
+        std::thread producer([&] {
+            for (int i = 0; i < kItems; ++i) {
+                items[i].seq = i;
+                q.push(items[i]);
+                if (i % 100 == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        });
+
+        int expected = 0;
+        while (expected < kItems) {
+            turbo::intrusive_list<Item> out;
+            EXPECT_GT(q.wait_pop_all(out), 0u);
+            for (auto &item: out) {
+                EXPECT_EQ(item.seq, expected++);
+            }
+        }
+        producer.join();
+        EXPECT_TRUE(q.empty());
+    }
+
+}  // namespace
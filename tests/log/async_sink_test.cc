@@ -0,0 +1,173 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/log/sinks/async_sink.h>
+
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <turbo/log/log.h>
+#include <turbo/log/log_sink.h>
+#include <turbo/strings/str_cat.h>
+#include <turbo/synchronization/mutex.h>
+#include <turbo/synchronization/notification.h>
+
+namespace {
+
+using ::testing::ElementsAre;
+
+// Records message texts. Optionally blocks the first `Send()` until
+// `release` is notified, which keeps the drain thread busy so that the
+// queue fills up.
+class RecordingSink : public turbo::LogSink {
+ public:
+  explicit RecordingSink(bool gate = false) : gate_(gate) {}
+
+  void Send(const turbo::LogEntry& entry) override {
+    if (gate_ && !entered.HasBeenNotified()) {
+      entered.Notify();
+      release.WaitForNotification();
+    }
+    turbo::MutexLock l(&mu_);
+    messages_.emplace_back(entry.text_message());
+  }
+
+  void Flush() override {
+    turbo::MutexLock l(&mu_);
+    ++flushes_;
+  }
+
+  std::vector<std::string> messages() {
+    turbo::MutexLock l(&mu_);
+    return messages_;
+  }
+
+  int flushes() {
+    turbo::MutexLock l(&mu_);
+    return flushes_;
+  }
+
+  turbo::Notification entered;
+  turbo::Notification release;
+
+ private:
+  const bool gate_;
+  turbo::Mutex mu_;
+  std::vector<std::string> messages_ TURBO_GUARDED_BY(mu_);
+  int flushes_ TURBO_GUARDED_BY(mu_) = 0;
+};
+
+TEST(AsyncLogSink, DeliversInOrderAndFlushes) {
+  RecordingSink a;
+  RecordingSink b;
+  turbo::AsyncLogSink sink({&a, &b}, 64);
+  EXPECT_EQ(sink.capacity(), 64u);
+
+  constexpr int kMessages = 1000;
+  for (int i = 0; i < kMessages; ++i) {
+    LOG(INFO).ToSinkOnly(&sink) << i;
+  }
+  sink.Flush();
+
+  for (RecordingSink* s : {&a, &b}) {
+    std::vector<std::string> messages = s->messages();
+    ASSERT_EQ(messages.size(), static_cast<size_t>(kMessages));
+    for (int i = 0; i < kMessages; ++i) {
+      EXPECT_EQ(messages[i], turbo::str_cat(i));
+    }
+    EXPECT_EQ(s->flushes(), 1);
+  }
+  EXPECT_EQ(sink.stats().enqueued, static_cast<uint64_t>(kMessages));
+}
+
+TEST(AsyncLogSink, DestructorDrainsQueue) {
+  RecordingSink recorder;
+  {
+    turbo::AsyncLogSink sink({&recorder}, 16);
+    for (int i = 0; i < 10; ++i) {
+      LOG(INFO).ToSinkOnly(&sink) << i;
+    }
+  }
+  EXPECT_EQ(recorder.messages().size(), 10u);
+}
+
+TEST(AsyncLogSink, DropNewest) {
+  RecordingSink recorder(/*gate=*/true);
+  turbo::AsyncLogSink sink({&recorder}, 2,
+                           turbo::AsyncOverflowPolicy::kDropNewest);
+  LOG(INFO).ToSinkOnly(&sink) << "first";
+  recorder.entered.WaitForNotification();
+  for (int i = 0; i < 10; ++i) {
+    LOG(INFO).ToSinkOnly(&sink) << i;
+  }
+  recorder.release.Notify();
+  sink.Flush();
+
+  // "first" is being delivered and does not occupy a slot.
+  EXPECT_THAT(recorder.messages(), ElementsAre("first", "0", "1"));
+  EXPECT_EQ(sink.stats().dropped_newest, 8u);
+  EXPECT_EQ(sink.stats().dropped_oldest, 0u);
+}
+
+TEST(AsyncLogSink, DropOldest) {
+  RecordingSink recorder(/*gate=*/true);
+  turbo::AsyncLogSink sink({&recorder}, 2,
+                           turbo::AsyncOverflowPolicy::kDropOldest);
+  LOG(INFO).ToSinkOnly(&sink) << "first";
+  recorder.entered.WaitForNotification();
+  for (int i = 0; i < 10; ++i) {
+    LOG(INFO).ToSinkOnly(&sink) << i;
+  }
+  recorder.release.Notify();
+  sink.Flush();
+
+  EXPECT_THAT(recorder.messages(), ElementsAre("first", "8", "9"));
+  EXPECT_EQ(sink.stats().dropped_oldest, 8u);
+  EXPECT_EQ(sink.stats().dropped_newest, 0u);
+}
+
+TEST(AsyncLogSink, BlockWaitsForRoom) {
+  RecordingSink recorder(/*gate=*/true);
+  turbo::AsyncLogSink sink({&recorder}, 2, turbo::AsyncOverflowPolicy::kBlock);
+  LOG(INFO).ToSinkOnly(&sink) << "first";
+  recorder.entered.WaitForNotification();
+
+  std::thread producer([&] {
+    for (int i = 0; i < 10; ++i) {
+      LOG(INFO).ToSinkOnly(&sink) << i;
+    }
+  });
+  // The producer fills both slots and then has to wait.
+  while (sink.stats().blocked == 0) {
+    std::this_thread::yield();
+  }
+  recorder.release.Notify();
+  producer.join();
+  sink.Flush();
+
+  std::vector<std::string> messages = recorder.messages();
+  ASSERT_EQ(messages.size(), 11u);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(messages[i + 1], turbo::str_cat(i));
+  }
+  EXPECT_EQ(sink.stats().dropped_newest + sink.stats().dropped_oldest, 0u);
+}
+
+}  // namespace
@@ -0,0 +1,164 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/log/internal/batch_file_writer.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <turbo/strings/str_cat.h>
+
+namespace {
+
+using turbo::log_internal::BatchFileWriter;
+using turbo::log_internal::BatchFileWriterOptions;
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  std::stringstream data;
+  data << in.rdbuf();
+  return data.str();
+}
+
+class BatchFileWriterTest : public ::testing::TestWithParam<bool> {
+ protected:
+  BatchFileWriterTest()
+      : path_(turbo::str_cat(::testing::TempDir(), "/batch_file_writer_",
+                             GetParam() ? "uring" : "writev", ".log")) {
+    std::remove(path_.c_str());
+  }
+
+  ~BatchFileWriterTest() override { std::remove(path_.c_str()); }
+
+  BatchFileWriterOptions SmallBlocks() const {
+    BatchFileWriterOptions options;
+    options.block_size = 4096;
+    options.block_count = 3;
+    options.use_io_uring = GetParam();
+    return options;
+  }
+
+  const std::string path_;
+};
+
+TEST_P(BatchFileWriterTest, WritesEverythingInOrder) {
+  BatchFileWriter writer(SmallBlocks());
+  ASSERT_EQ(writer.initialize(path_), 0);
+  std::string expected;
+  for (int i = 0; i < 5000; ++i) {
+    std::string line = turbo::str_cat("line ", i, std::string(i % 97, 'x'), "\n");
+    if (i == 1234) {
+      // Spans several blocks.
+      line.append(3 * 4096, 'y');
+    }
+    ASSERT_EQ(writer.write(line), static_cast<ssize_t>(line.size()));
+    expected += line;
+  }
+  EXPECT_EQ(writer.file_size(), expected.size());
+  writer.flush();
+  EXPECT_EQ(ReadFile(path_), expected);
+  writer.close();
+  EXPECT_EQ(ReadFile(path_), expected);
+}
+
+TEST_P(BatchFileWriterTest, BatchesSystemCalls) {
+  BatchFileWriter writer(SmallBlocks());
+  ASSERT_EQ(writer.initialize(path_), 0);
+  const std::string line(64, 'a');
+  const int kLines = 3 * 4096 * 8 / 64;
+  for (int i = 0; i < kLines; ++i) {
+    writer.write(line);
+  }
+  // 24 full blocks, written at most one block per call.
+  EXPECT_LE(writer.submissions(), 24u);
+  EXPECT_GT(writer.submissions(), 0u);
+  writer.flush();
+  EXPECT_EQ(ReadFile(path_).size(), static_cast<size_t>(kLines) * 64);
+}
+
+TEST_P(BatchFileWriterTest, AppendsToExistingFile) {
+  {
+    std::ofstream out(path_, std::ios::binary);
+    out << "existing\n";
+  }
+  BatchFileWriter writer(SmallBlocks());
+  ASSERT_EQ(writer.initialize(path_), 0);
+  EXPECT_EQ(writer.file_size(), 9u);
+  writer.write("appended\n");
+  writer.close();
+  EXPECT_EQ(ReadFile(path_), "existing\nappended\n");
+}
+
+TEST_P(BatchFileWriterTest, DirectIo) {
+  {
+    std::ofstream out(path_, std::ios::binary);
+    out << std::string(5000, 'e');
+  }
+  BatchFileWriterOptions options = SmallBlocks();
+  options.direct_io = true;
+  options.sync_policy = turbo::log_internal::FileSyncPolicy::kOnFlush;
+  BatchFileWriter writer(options);
+  ASSERT_EQ(writer.initialize(path_), 0);
+  std::string expected(5000, 'e');
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 700; ++i) {
+      std::string line = turbo::str_cat(round, ":", i, "\n");
+      writer.write(line);
+      expected += line;
+    }
+    // Flushing pads the unaligned tail; the file still ends where the
+    // data does, and the tail is rewritten by the next round.
+    writer.flush();
+    EXPECT_EQ(ReadFile(path_), expected);
+  }
+  writer.close();
+  EXPECT_EQ(ReadFile(path_), expected);
+}
+
+TEST_P(BatchFileWriterTest, ReopenRecreatesRemovedFile) {
+  BatchFileWriter writer(SmallBlocks());
+  ASSERT_EQ(writer.initialize(path_), 0);
+  writer.write("before\n");
+  writer.flush();
+  std::remove(path_.c_str());
+  ASSERT_EQ(writer.reopen(), 0);
+  EXPECT_EQ(writer.file_size(), 0u);
+  writer.write("after\n");
+  writer.flush();
+  EXPECT_EQ(ReadFile(path_), "after\n");
+}
+
+TEST_P(BatchFileWriterTest, PeriodicSync) {
+  BatchFileWriterOptions options = SmallBlocks();
+  options.sync_policy = turbo::log_internal::FileSyncPolicy::kPeriodic;
+  options.sync_interval = turbo::Duration::milliseconds(1);
+  BatchFileWriter writer(options);
+  ASSERT_EQ(writer.initialize(path_), 0);
+  for (int i = 0; i < 1000; ++i) {
+    writer.write(turbo::str_cat(i, "\n"));
+    if (i % 100 == 0) writer.flush();
+  }
+  writer.close();
+  EXPECT_EQ(ReadFile(path_).substr(0, 6), "0\n1\n2\n");
+}
+
+INSTANTIATE_TEST_SUITE_P(IoUring, BatchFileWriterTest, ::testing::Bool());
+
+}  // namespace
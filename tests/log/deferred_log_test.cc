@@ -0,0 +1,232 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/log/deferred_log.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <turbo/base/log_severity.h>
+#include <turbo/log/globals.h>
+#include <turbo/log/log_entry.h>
+#include <turbo/log/log_sink.h>
+#include <turbo/log/log_sink_registry.h>
+#include <turbo/strings/str_cat.h>
+#include <turbo/synchronization/mutex.h>
+
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::UnorderedElementsAreArray;
+
+class RecordingSink : public turbo::LogSink {
+ public:
+  RecordingSink() { turbo::add_log_sink(this); }
+  ~RecordingSink() override { turbo::remove_log_sink(this); }
+
+  void Send(const turbo::LogEntry& entry) override {
+    turbo::MutexLock l(&mu_);
+    messages_.emplace_back(entry.text_message());
+    lines_.push_back(entry.source_line());
+    severities_.push_back(entry.log_severity());
+  }
+
+  std::vector<std::string> messages() {
+    turbo::MutexLock l(&mu_);
+    return messages_;
+  }
+
+  std::vector<int> lines() {
+    turbo::MutexLock l(&mu_);
+    return lines_;
+  }
+
+  std::vector<turbo::LogSeverity> severities() {
+    turbo::MutexLock l(&mu_);
+    return severities_;
+  }
+
+ private:
+  turbo::Mutex mu_;
+  std::vector<std::string> messages_ TURBO_GUARDED_BY(mu_);
+  std::vector<int> lines_ TURBO_GUARDED_BY(mu_);
+  std::vector<turbo::LogSeverity> severities_ TURBO_GUARDED_BY(mu_);
+};
+
+class DeferredLogTest : public ::testing::Test {
+ protected:
+  DeferredLogTest()
+      : stderr_threshold_(turbo::LogSeverityAtLeast::kInfinity),
+        min_log_level_(turbo::LogSeverityAtLeast::kInfo) {}
+
+  turbo::ScopedStderrThreshold stderr_threshold_;
+  turbo::log_internal::ScopedMinLogLevel min_log_level_;
+};
+
+TEST_F(DeferredLogTest, FormatsImmediatelyWhenInactive) {
+  RecordingSink sink;
+  const std::string peer = "10.0.0.1";
+  LOG_DEFERRED(INFO, "request %d from %s took %.1fms", 42, peer, 1.5);
+  const int line = __LINE__ - 1;
+  LOG_DEFERRED(WARNING, "%v %c %x %s", true, 'z', 255u, "literal");
+
+  EXPECT_THAT(sink.messages(),
+              ElementsAre("request 42 from 10.0.0.1 took 1.5ms",
+                          "true z ff literal"));
+  EXPECT_EQ(sink.lines()[0], line);
+  EXPECT_THAT(sink.severities(), ElementsAre(turbo::LogSeverity::kInfo,
+                                             turbo::LogSeverity::kWarning));
+}
+
+TEST_F(DeferredLogTest, DeliversFromManyThreads) {
+  RecordingSink sink;
+  ASSERT_TRUE(turbo::start_deferred_logging());
+  EXPECT_FALSE(turbo::start_deferred_logging());
+
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 500;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([t] {
+      for (int i = 0; i < kPerThread; ++i) {
+        LOG_DEFERRED(ERROR, "thread %d message %d", t, i);
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  turbo::flush_deferred_log();
+
+  std::vector<std::string> expected;
+  for (int t = 0; t < kThreads; ++t) {
+    for (int i = 0; i < kPerThread; ++i) {
+      expected.push_back(turbo::str_cat("thread ", t, " message ", i));
+    }
+  }
+  EXPECT_THAT(sink.messages(), UnorderedElementsAreArray(expected));
+  EXPECT_EQ(turbo::deferred_log_stats().dropped, 0u);
+  turbo::stop_deferred_logging();
+}
+
+TEST_F(DeferredLogTest, StopDeliversRecordsOfRacingCalls) {
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 2000;
+  for (int round = 0; round < 20; ++round) {
+    RecordingSink sink;
+    ASSERT_TRUE(turbo::start_deferred_logging());
+    // Stop while every thread is still logging: each record is either staged
+    // before the final drain or formatted immediately afterwards.
+    std::atomic<int> started{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([t, &started] {
+        for (int i = 0; i < kPerThread; ++i) {
+          if (i == 100) started.fetch_add(1);
+          LOG_DEFERRED(ERROR, "thread %d message %d", t, i);
+        }
+      });
+    }
+    while (started.load() < kThreads) std::this_thread::yield();
+    turbo::stop_deferred_logging();
+    for (std::thread& thread : threads) thread.join();
+
+    std::vector<std::string> expected;
+    for (int t = 0; t < kThreads; ++t) {
+      for (int i = 0; i < kPerThread; ++i) {
+        expected.push_back(turbo::str_cat("thread ", t, " message ", i));
+      }
+    }
+    std::vector<std::string> messages = sink.messages();
+    std::sort(expected.begin(), expected.end());
+    std::sort(messages.begin(), messages.end());
+    ASSERT_EQ(messages, expected) << "round " << round;
+  }
+  EXPECT_EQ(turbo::deferred_log_stats().dropped, 0u);
+}
+
+TEST_F(DeferredLogTest, MismatchedFormatIsReported) {
+  RecordingSink sink;
+  ASSERT_TRUE(turbo::start_deferred_logging());
+  LOG_DEFERRED(INFO, "%d", "not a number");
+  turbo::stop_deferred_logging();
+  ASSERT_EQ(sink.messages().size(), 1u);
+  EXPECT_THAT(sink.messages()[0], HasSubstr("LOG_DEFERRED"));
+}
+
+TEST_F(DeferredLogTest, DropsWhenBufferIsFull) {
+  RecordingSink sink;
+  turbo::DeferredLogOptions options;
+  options.thread_buffer_size = 4096;
+  options.drain_interval = turbo::Duration::hours(1);
+  ASSERT_TRUE(turbo::start_deferred_logging(options));
+  const uint64_t dropped_before = turbo::deferred_log_stats().dropped;
+  // A thread of its own, so that the buffer has the requested size.
+  std::thread([] {
+    for (int i = 0; i < 10000; ++i) {
+      LOG_DEFERRED(INFO, "%d", i);
+    }
+  }).join();
+  EXPECT_GT(turbo::deferred_log_stats().dropped, dropped_before);
+  turbo::stop_deferred_logging();
+  // The records that fit are delivered in order, followed by the warning.
+  std::vector<std::string> messages = sink.messages();
+  ASSERT_GE(messages.size(), 2u);
+  EXPECT_EQ(messages[0], "0");
+  EXPECT_THAT(messages.back(), HasSubstr("dropped"));
+}
+
+TEST_F(DeferredLogTest, BinaryRoundTrip) {
+  const std::string path =
+      ::testing::TempDir() + "/deferred_log_test.bin";
+  std::remove(path.c_str());
+  turbo::DeferredLogOptions options;
+  options.binary_path = path;
+  ASSERT_TRUE(turbo::start_deferred_logging(options));
+  std::thread([] {
+    for (int i = 0; i < 3; ++i) {
+      LOG_DEFERRED(WARNING, "value=%d name=%s ratio=%.2f", i, "x", i / 4.0);
+    }
+  }).join();
+  turbo::stop_deferred_logging();
+
+  std::ifstream in(path, std::ios::binary);
+  std::stringstream data;
+  data << in.rdbuf();
+  std::string text;
+  ASSERT_TRUE(turbo::decode_deferred_log(data.str(), &text));
+  std::vector<std::string> lines;
+  std::istringstream lines_in(text);
+  for (std::string line; std::getline(lines_in, line);) lines.push_back(line);
+  ASSERT_EQ(lines.size(), 3u);
+  EXPECT_EQ(lines[0][0], 'W');
+  EXPECT_THAT(lines[0], HasSubstr("deferred_log_test.cc:"));
+  EXPECT_THAT(lines[0], HasSubstr("] value=0 name=x ratio=0.00"));
+  EXPECT_THAT(lines[2], HasSubstr("] value=2 name=x ratio=0.50"));
+
+  EXPECT_FALSE(turbo::decode_deferred_log("not a deferred log", &text));
+  std::remove(path.c_str());
+}
+
+}  // namespace
@@ -0,0 +1,149 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/log/sinks/json_sink.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <tests/log/test_helpers.h>
+#include <turbo/log/log.h>
+#include <turbo/strings/match.h>
+
+namespace {
+
+class StringWriter : public turbo::FileWriter {
+ public:
+  explicit StringWriter(std::string* out) : out_(out) {}
+
+  int initialize(std::string_view) override { return 0; }
+  int reopen() override { return 0; }
+  ssize_t write(std::string_view message) override {
+    out_->append(message.data(), message.size());
+    return static_cast<ssize_t>(message.size());
+  }
+  void flush() override {}
+  void close() override {}
+  size_t file_size() const override { return out_->size(); }
+  std::string file_path() const override { return "string"; }
+
+ private:
+  std::string* out_;
+};
+
+std::unique_ptr<turbo::FileWriter> Writer(std::string* out) {
+  return std::make_unique<StringWriter>(out);
+}
+
+TEST(JsonSinkTest, WritesAllKeysByDefault) {
+  std::string out;
+  turbo::JsonSink sink(Writer(&out));
+  LOG(WARNING).ToSinkOnly(&sink) << "hello";
+  ASSERT_TRUE(turbo::ends_with(out, "}\n")) << out;
+  EXPECT_EQ(out.find('\n'), out.size() - 1);
+  EXPECT_TRUE(turbo::starts_with(out, "{\"time\":\"")) << out;
+  EXPECT_NE(out.find("Z\",\"severity\":\"WARNING\",\"tid\":"), std::string::npos) << out;
+  EXPECT_NE(out.find(",\"file\":\"json_sink_test.cc\",\"line\":"), std::string::npos) << out;
+  EXPECT_NE(out.find(",\"message\":\"hello\",\"fields\":{}}"), std::string::npos) << out;
+  EXPECT_EQ(out.find("verbosity"), std::string::npos) << out;
+  EXPECT_EQ(out.find("stacktrace"), std::string::npos) << out;
+}
+
+TEST(JsonSinkTest, FormatsTimeInUtc) {
+  std::string out;
+  turbo::JsonSinkOptions options;
+  options.keys = {"time"};
+  turbo::JsonSink sink(Writer(&out), options);
+  const turbo::Time epoch = turbo::Time::from_unix_epoch();
+  LOG(INFO).ToSinkOnly(&sink).WithTimestamp(epoch + turbo::Duration::microseconds(1714566896789012))
+      << "x";
+  EXPECT_EQ(out, "{\"time\":\"2024-05-01T12:34:56.789012Z\"}\n");
+  out.clear();
+  LOG(INFO).ToSinkOnly(&sink).WithTimestamp(epoch - turbo::Duration::microseconds(1)) << "x";
+  EXPECT_EQ(out, "{\"time\":\"1969-12-31T23:59:59.999999Z\"}\n");
+}
+
+TEST(JsonSinkTest, WritesKeysInGivenOrder) {
+  std::string out;
+  turbo::JsonSinkOptions options;
+  options.keys = {"message", "severity", "unknown", "verbosity"};
+  turbo::JsonSink sink(Writer(&out), options);
+  LOG(ERROR).ToSinkOnly(&sink) << "first";
+  VLOG(0).ToSinkOnly(&sink) << "second";
+  EXPECT_EQ(out,
+            "{\"message\":\"first\",\"severity\":\"ERROR\"}\n"
+            "{\"message\":\"second\",\"severity\":\"INFO\",\"verbosity\":0}\n");
+}
+
+TEST(JsonSinkTest, EscapesStrings) {
+  std::string out;
+  turbo::JsonSinkOptions options;
+  options.keys = {"message"};
+  turbo::JsonSink sink(Writer(&out), options);
+  LOG(INFO).ToSinkOnly(&sink) << "a\"b\\c\nd\te" << std::string(1, '\x01') << "\xc3\xa9";
+  EXPECT_EQ(out, "{\"message\":\"a\\\"b\\\\c\\nd\\te\\u0001\xc3\xa9\"}\n");
+}
+
+TEST(JsonSinkTest, ExtractsFields) {
+  std::string out;
+  turbo::JsonSinkOptions options;
+  options.keys = {"fields"};
+  turbo::JsonSink sink(Writer(&out), options);
+  const std::string user = "al\"ice";
+  // Only literals name fields.
+  LOG(INFO).ToSinkOnly(&sink) << "request done user=" << user << " latency_ms=" << 12
+                              << " no key= here " << std::string("k=") << 3;
+  EXPECT_EQ(out, "{\"fields\":{\"user\":\"al\\\"ice\",\"latency_ms\":\"12\"}}\n");
+}
+
+TEST(JsonSinkTest, FiltersFields) {
+  std::string out;
+  turbo::JsonSinkOptions options;
+  options.keys = {"fields", "message"};
+  options.fields = {"latency_ms"};
+  turbo::JsonSink sink(Writer(&out), options);
+  LOG(INFO).ToSinkOnly(&sink) << "user=" << "bob" << " latency_ms=" << 7;
+  EXPECT_EQ(out, "{\"fields\":{\"latency_ms\":\"7\"},\"message\":\"user=bob latency_ms=7\"}\n");
+}
+
+#if GTEST_HAS_DEATH_TEST
+// Writes to stderr, where a death test can see it.
+class StderrWriter : public StringWriter {
+ public:
+  StderrWriter() : StringWriter(nullptr) {}
+
+  ssize_t write(std::string_view message) override {
+    return static_cast<ssize_t>(std::fwrite(message.data(), 1, message.size(), stderr));
+  }
+  size_t file_size() const override { return 0; }
+};
+
+TEST(JsonSinkDeathTest, WritesQuietFatalMessages) {
+  // `QFATAL` sends its message once, without a stack trace.
+  EXPECT_EXIT(
+      {
+        turbo::JsonSink sink(std::make_unique<StderrWriter>());
+        LOG(QFATAL).ToSinkOnly(&sink) << "quiet fatal message";
+      },
+      turbo::log_internal::DiedOfQFatal,
+      "\"severity\":\"FATAL\".*\"message\":\"quiet fatal message\"");
+}
+#endif
+
+}  // namespace
@@ -0,0 +1,230 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <turbo/log/globals.h>
+#include <turbo/log/internal/conditions.h>
+#include <turbo/log/log.h>
+#include <turbo/log/log_sink.h>
+#include <turbo/log/log_sink_registry.h>
+#include <turbo/synchronization/mutex.h>
+
+namespace {
+
+class CountingSink : public turbo::LogSink {
+ public:
+  void Send(const turbo::LogEntry& entry) override {
+    turbo::MutexLock lock(&mutex_);
+    ++count_;
+    if (entry.text_message().find("suppressed") != std::string_view::npos) {
+      summaries_.emplace_back(entry.text_message());
+    }
+  }
+
+  int count() {
+    turbo::MutexLock lock(&mutex_);
+    return count_;
+  }
+
+  std::vector<std::string> summaries() {
+    turbo::MutexLock lock(&mutex_);
+    return summaries_;
+  }
+
+ private:
+  turbo::Mutex mutex_;
+  int count_ = 0;
+  std::vector<std::string> summaries_;
+};
+
+class LogBudgetTest : public ::testing::Test {
+ protected:
+  ~LogBudgetTest() override {
+    for (auto severity : {turbo::LogSeverity::kInfo, turbo::LogSeverity::kWarning,
+                          turbo::LogSeverity::kError}) {
+      turbo::set_log_budget(severity, turbo::LogBudget());
+    }
+    turbo::set_log_budget_summary_period(10);
+  }
+};
+
+int Evaluated(std::atomic<int>* evaluations) {
+  evaluations->fetch_add(1);
+  return 0;
+}
+
+TEST_F(LogBudgetTest, UnlimitedByDefault) {
+  CountingSink sink;
+  for (int i = 0; i < 1000; ++i) {
+    LOG(INFO).ToSinkOnly(&sink) << i;
+  }
+  EXPECT_EQ(sink.count(), 1000);
+  EXPECT_EQ(turbo::log_budget(turbo::LogSeverity::kInfo).lines_per_second, 0);
+}
+
+TEST_F(LogBudgetTest, DropsLinesOverBudgetBeforeFormatting) {
+  turbo::set_log_budget(turbo::LogSeverity::kInfo, {100, 0});
+  EXPECT_EQ(turbo::log_budget(turbo::LogSeverity::kInfo).lines_per_second, 100);
+  const uint64_t dropped_before = turbo::log_budget_dropped(turbo::LogSeverity::kInfo);
+  CountingSink sink;
+  std::atomic<int> evaluations{0};
+  for (int i = 0; i < 10000; ++i) {
+    LOG(INFO).ToSinkOnly(&sink) << Evaluated(&evaluations);
+  }
+  // The budget starts full with a second worth of lines, split between
+  // stripes and rounded down; the loop takes far less than a second.
+  EXPECT_GE(sink.count(), 90);
+  EXPECT_LT(sink.count(), 200);
+  EXPECT_EQ(evaluations.load(), sink.count());
+  EXPECT_EQ(turbo::log_budget_dropped(turbo::LogSeverity::kInfo) - dropped_before,
+            static_cast<uint64_t>(10000 - sink.count()));
+}
+
+TEST_F(LogBudgetTest, BudgetsFewerLinesThanStripes) {
+  turbo::set_log_budget(turbo::LogSeverity::kInfo, {2, 0});
+  CountingSink sink;
+  for (int i = 0; i < 10; ++i) {
+    LOG(INFO).ToSinkOnly(&sink) << i;
+  }
+  // A second worth of lines, not a share of it per stripe.
+  EXPECT_GE(sink.count(), 2);
+  EXPECT_LE(sink.count(), 3);
+  // And it refills.
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  const int before = sink.count();
+  for (int i = 0; i < 10; ++i) {
+    LOG(INFO).ToSinkOnly(&sink) << i;
+  }
+  EXPECT_GE(sink.count() - before, 2);
+  EXPECT_LE(sink.count() - before, 3);
+}
+
+TEST_F(LogBudgetTest, BudgetsSeveritiesSeparately) {
+  turbo::set_log_budget(turbo::LogSeverity::kInfo, {10, 0});
+  CountingSink info;
+  CountingSink error;
+  for (int i = 0; i < 1000; ++i) {
+    LOG(INFO).ToSinkOnly(&info) << i;
+    LOG(ERROR).ToSinkOnly(&error) << i;
+  }
+  EXPECT_LT(info.count(), 100);
+  EXPECT_EQ(error.count(), 1000);
+}
+
+TEST_F(LogBudgetTest, DropsLinesOverByteBudget) {
+  turbo::set_log_budget(turbo::LogSeverity::kWarning, {0, 10000});
+  CountingSink sink;
+  const std::string payload(1000, 'x');
+  for (int i = 0; i < 1000; ++i) {
+    LOG(WARNING).ToSinkOnly(&sink) << payload;
+  }
+  // Bytes are charged after formatting, so the budget is overdrawn by at most
+  // one message per stripe.
+  EXPECT_GE(sink.count(), 5);
+  EXPECT_LE(sink.count(), 20);
+}
+
+TEST_F(LogBudgetTest, SharesBudgetAcrossThreads) {
+  turbo::set_log_budget(turbo::LogSeverity::kInfo, {800, 0});
+  CountingSink sink;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&sink] {
+      for (int i = 0; i < 5000; ++i) {
+        LOG(INFO).ToSinkOnly(&sink) << i;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_GE(sink.count(), 800);
+  EXPECT_LT(sink.count(), 4 * 5000);
+}
+
+TEST_F(LogBudgetTest, AppliesAfterRateLimitingConditions) {
+  turbo::set_log_budget(turbo::LogSeverity::kInfo, {10, 0});
+  CountingSink sink;
+  for (int i = 0; i < 1000; ++i) {
+    LOG_EVERY_N(INFO, 100).ToSinkOnly(&sink) << i;
+  }
+  // Skipped statements do not spend the budget.
+  EXPECT_GE(sink.count(), 5);
+  EXPECT_LE(sink.count(), 10);
+}
+
+TEST_F(LogBudgetTest, LogsSuppressedSummary) {
+  CountingSink sink;
+  turbo::add_log_sink(&sink);
+  turbo::set_log_budget_summary_period(0.01);
+  turbo::set_log_budget(turbo::LogSeverity::kInfo, {10, 0});
+  for (int i = 0; i < 100; ++i) {
+    LOG(INFO).ToSinkOnly(&sink) << i;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  LOG(INFO).ToSinkOnly(&sink) << "last";
+  turbo::remove_log_sink(&sink);
+  auto summaries = sink.summaries();
+  ASSERT_FALSE(summaries.empty());
+  EXPECT_NE(summaries[0].find(" INFO"), std::string::npos) << summaries[0];
+  EXPECT_NE(summaries[0].find("messages suppressed"), std::string::npos) << summaries[0];
+}
+
+TEST_F(LogBudgetTest, SummaryIsNotCharged) {
+  CountingSink sink;
+  turbo::add_log_sink(&sink);
+  turbo::set_log_budget_summary_period(0.01);
+  turbo::set_log_budget(turbo::LogSeverity::kInfo, {1, 0});
+  // Less than the summary takes.
+  turbo::set_log_budget(turbo::LogSeverity::kWarning, {5, 100});
+  for (int i = 0; i < 10; ++i) {
+    LOG(INFO).ToSinkOnly(&sink) << i;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  // Dropped, and logs the summary instead.
+  LOG(INFO).ToSinkOnly(&sink) << "last";
+  EXPECT_EQ(sink.summaries().size(), 1u);
+  const int before = sink.count();
+  LOG(WARNING).ToSinkOnly(&sink) << "after the summary";
+  EXPECT_EQ(sink.count(), before + 1);
+  turbo::remove_log_sink(&sink);
+}
+
+TEST_F(LogBudgetTest, DisabledStatementsDoNotLogSummary) {
+  CountingSink sink;
+  turbo::add_log_sink(&sink);
+  turbo::set_log_budget(turbo::LogSeverity::kInfo, {1, 0});
+  for (int i = 0; i < 10; ++i) {
+    LOG(INFO).ToSinkOnly(&sink) << i;
+  }
+  turbo::log_internal::log_budget_summary_due.store(true);
+  LOG_IF(INFO, false).ToSinkOnly(&sink) << "disabled";
+  VLOG(5).ToSinkOnly(&sink) << "disabled";
+  EXPECT_TRUE(sink.summaries().empty());
+  // The next message flushed logs it.
+  LOG(WARNING).ToSinkOnly(&sink) << "enabled";
+  EXPECT_EQ(sink.summaries().size(), 1u);
+  turbo::remove_log_sink(&sink);
+}
+
+}  // namespace
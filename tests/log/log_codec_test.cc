@@ -0,0 +1,248 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/log/log_codec.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+
+#include <gtest/gtest.h>
+#include <turbo/log/internal/append_file.h>
+#include <turbo/log/internal/compressed_file.h>
+#include <turbo/log/log.h>
+#include <turbo/log/sinks/rotating_file_sink.h>
+#include <turbo/strings/str_cat.h>
+
+namespace {
+
+using turbo::LogCompressionOptions;
+using turbo::log_internal::CompressedFileWriter;
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  std::stringstream data;
+  data << in.rdbuf();
+  return data.str();
+}
+
+bool FileExists(const std::string& path) {
+  return std::ifstream(path).good();
+}
+
+std::string Decompress(const std::string& compressed) {
+  std::string out;
+  EXPECT_TRUE(turbo::lz4_log_codec()->decompress(compressed, &out));
+  return out;
+}
+
+std::string LogLines(int begin, int end) {
+  std::string text;
+  for (int i = begin; i < end; ++i) {
+    turbo::str_append(&text, "line ", i, " of a log that repeats itself a lot\n");
+  }
+  return text;
+}
+
+std::string RandomBytes(size_t size) {
+  std::mt19937 rng(42);
+  std::string bytes(size, '\0');
+  for (char& c : bytes) {
+    c = static_cast<char>(rng());
+  }
+  return bytes;
+}
+
+TEST(Lz4LogCodecTest, RoundTrips) {
+  auto codec = turbo::lz4_log_codec();
+  EXPECT_EQ(codec->extension(), ".lz4");
+  for (const std::string& input :
+       {std::string(), std::string("x"), LogLines(0, 10), LogLines(0, 200000),
+        RandomBytes(100000), std::string(5 << 20, 'a')}) {
+    std::string compressed;
+    codec->compress(input, &compressed);
+    EXPECT_EQ(Decompress(compressed), input);
+  }
+}
+
+TEST(Lz4LogCodecTest, CompressesLogs) {
+  const std::string input = LogLines(0, 10000);
+  std::string compressed;
+  turbo::lz4_log_codec()->compress(input, &compressed);
+  EXPECT_LT(compressed.size(), input.size() / 3);
+}
+
+TEST(Lz4LogCodecTest, DecodesConcatenatedChunks) {
+  auto codec = turbo::lz4_log_codec();
+  std::string compressed;
+  codec->compress(LogLines(0, 100), &compressed);
+  codec->compress(RandomBytes(1000), &compressed);
+  codec->compress(LogLines(100, 200), &compressed);
+  EXPECT_EQ(Decompress(compressed),
+            turbo::str_cat(LogLines(0, 100), RandomBytes(1000), LogLines(100, 200)));
+}
+
+TEST(Lz4LogCodecTest, RejectsCorruption) {
+  auto codec = turbo::lz4_log_codec();
+  std::string compressed;
+  codec->compress(LogLines(0, 1000), &compressed);
+  std::string out;
+  EXPECT_FALSE(codec->decompress(compressed.substr(0, compressed.size() - 1), &out));
+  compressed[compressed.size() / 2] ^= 0x5a;
+  out.clear();
+  EXPECT_FALSE(codec->decompress(compressed, &out));
+}
+
+class CompressedFileTest : public ::testing::Test {
+ protected:
+  CompressedFileTest() : dir_(::testing::TempDir()) { Clean(); }
+  ~CompressedFileTest() override { Clean(); }
+
+  std::string Path(int index) const {
+    return turbo::RotatingFileSink::calc_filename(turbo::str_cat(dir_, "/compressed.log"),
+                                                  static_cast<size_t>(index));
+  }
+
+  void Clean() const {
+    for (int i = 0; i < 5; ++i) {
+      for (const char* suffix : {"", ".lz4", ".lz4.tmp"}) {
+        std::remove(turbo::str_cat(Path(i), suffix).c_str());
+      }
+    }
+  }
+
+  const std::string dir_;
+};
+
+TEST_F(CompressedFileTest, LiveWriterWritesDecodableChunks) {
+  LogCompressionOptions options;
+  options.codec = turbo::lz4_log_codec();
+  options.mode = LogCompressionOptions::Mode::kLive;
+  options.chunk_size = 1000;
+  CompressedFileWriter writer(options, std::make_unique<turbo::log_internal::AppendFile>());
+  ASSERT_EQ(writer.initialize(Path(0)), 0);
+  const std::string text = LogLines(0, 1000);
+  for (size_t pos = 0; pos < text.size(); pos += 100) {
+    writer.write(std::string_view(text).substr(pos, 100));
+  }
+  writer.flush();
+  EXPECT_GT(writer.file_size(), 0u);
+  EXPECT_LT(writer.file_size(), text.size() / 2);
+  EXPECT_EQ(writer.file_size(), ReadFile(Path(0)).size());
+  EXPECT_EQ(Decompress(ReadFile(Path(0))), text);
+  writer.close();
+  EXPECT_EQ(Decompress(ReadFile(Path(0))), text);
+}
+
+TEST_F(CompressedFileTest, LiveWriterSyncsIdleText) {
+  LogCompressionOptions options;
+  options.codec = turbo::lz4_log_codec();
+  options.mode = LogCompressionOptions::Mode::kLive;
+  options.sync_interval = turbo::Duration::milliseconds(10);
+  CompressedFileWriter writer(options, std::make_unique<turbo::log_internal::AppendFile>());
+  ASSERT_EQ(writer.initialize(Path(0)), 0);
+  const std::string text = LogLines(0, 10);
+  writer.write(text);
+  // No further write or flush: the background thread writes the chunk once
+  // the text is `sync_interval` old.
+  for (int i = 0; i < 500 && writer.file_size() == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(Decompress(ReadFile(Path(0))), text);
+}
+
+TEST_F(CompressedFileTest, RotatedCompressorCommitsOnlyUnchangedFiles) {
+  std::ofstream(Path(1)) << LogLines(0, 100);
+  std::ofstream(Path(2)) << LogLines(100, 200);
+  {
+    turbo::log_internal::RotatedFileCompressor compressor(
+        turbo::lz4_log_codec(),
+        [this](const std::string& path, const turbo::log_internal::FileId& id, const std::string& tmp) {
+          if (path == Path(2)) {
+            // Replaced while being compressed.
+            std::remove(path.c_str());
+            std::ofstream(path) << "new";
+          }
+          turbo::log_internal::commit_compressed_file(path, id, tmp, ".lz4");
+        });
+    compressor.add(Path(1));
+    compressor.add(Path(2));
+    compressor.add(Path(3));  // Does not exist.
+    compressor.wait_idle();
+  }
+  EXPECT_FALSE(FileExists(Path(1)));
+  EXPECT_EQ(Decompress(ReadFile(Path(1) + ".lz4")), LogLines(0, 100));
+  EXPECT_EQ(ReadFile(Path(2)), "new");
+  EXPECT_FALSE(FileExists(Path(2) + ".lz4"));
+  EXPECT_FALSE(FileExists(Path(2) + ".lz4.tmp"));
+}
+
+TEST_F(CompressedFileTest, RotatingFileSinkCompressesRotatedFiles) {
+  LogCompressionOptions options;
+  options.codec = turbo::lz4_log_codec();
+  {
+    turbo::RotatingFileSink sink(Path(0), 4096, 3, 60, options);
+    for (int i = 0; i < 1000; ++i) {
+      LOG(INFO).ToSinkOnly(&sink) << "line " << i;
+    }
+    sink.Flush();
+  }
+  // The sink waits for its compressor.
+  std::string text;
+  for (int i = 3; i > 0; --i) {
+    EXPECT_FALSE(FileExists(Path(i))) << i;
+    ASSERT_TRUE(FileExists(Path(i) + ".lz4")) << i;
+    text += Decompress(ReadFile(Path(i) + ".lz4"));
+  }
+  text += ReadFile(Path(0));
+  // What is left is the tail of the log, in order.
+  size_t pos = text.find("line ");
+  ASSERT_NE(pos, std::string::npos);
+  int first = std::stoi(text.substr(pos + 5));
+  EXPECT_GT(first, 0);
+  for (int i = first; i < 1000; ++i) {
+    pos = text.find(turbo::str_cat("line ", i, "\n"), pos);
+    ASSERT_NE(pos, std::string::npos) << i;
+  }
+}
+
+TEST_F(CompressedFileTest, RotatingFileSinkCompressesLive) {
+  LogCompressionOptions options;
+  options.codec = turbo::lz4_log_codec();
+  options.mode = LogCompressionOptions::Mode::kLive;
+  options.chunk_size = 512;
+  {
+    turbo::RotatingFileSink sink(Path(0), 1 << 20, 3, 60, options);
+    for (int i = 0; i < 100; ++i) {
+      LOG(INFO).ToSinkOnly(&sink) << "line " << i;
+    }
+    sink.Flush();
+  }
+  EXPECT_FALSE(FileExists(Path(0)));
+  const std::string text = Decompress(ReadFile(Path(0) + ".lz4"));
+  size_t pos = 0;
+  for (int i = 0; i < 100; ++i) {
+    pos = text.find(turbo::str_cat("line ", i, "\n"), pos);
+    ASSERT_NE(pos, std::string::npos) << i;
+  }
+}
+
+}  // namespace
@@ -1705,6 +1705,23 @@ TEST(StructuredLoggingOverflowTest, TruncatesInsertionOperators) {
       std::string(2 * turbo::log_internal::kLogMessageBufferSize, 'x')};
 }
 
+TEST(StructuredLoggingOverflowTest, KeepsMessagesUnderBufferSizeWhole) {
+  turbo::ScopedMockLog test_sink(turbo::MockLogDefault::kDisallowUnexpected);
+
+  // Long enough to outgrow the per-thread staging buffers, which must not cut
+  // it short.
+  const std::string str(turbo::log_internal::kLogMessageBufferSize / 3, 'x');
+  EXPECT_CALL(test_sink, Send(AllOf(TextMessage(Eq(str)),
+                                    ENCODED_MESSAGE(HasOneStrThat(Eq(str))))))
+      .Times(2);
+  EXPECT_CALL(test_sink, Send(TextMessage(Eq(str + "y" + str))));
+
+  test_sink.StartCapturingLogs();
+  LOG(INFO) << str;
+  LOG(INFO) << StringLike{str};
+  LOG(INFO) << StringLike{str} << 'y' << str;
+}
+
 // Returns the size of the largest string that will fit in a `LOG` message
 // buffer with no prefix.
 size_t MaxLogFieldLengthNoPrefix() {
@@ -0,0 +1,68 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <turbo/base/log_severity.h>
+#include <turbo/log/internal/globals.h>
+#include <turbo/log/internal/log_format.h>
+#include <turbo/times/time.h>
+
+namespace {
+
+using turbo::log_internal::PrefixFormat;
+
+// Formats the prefix with `FormatLogPrefix` and with the uncached
+// `FormatLogMessage`.
+void ExpectSamePrefix(turbo::Time t, turbo::log_internal::Tid tid) {
+  const turbo::TimeZone* tz = turbo::log_internal::TimeZone();
+  ASSERT_NE(tz, nullptr);
+  std::array<char, 256> buf;
+  turbo::span<char> span = turbo::MakeSpan(buf);
+  const size_t size = turbo::log_internal::FormatLogPrefix(
+      turbo::LogSeverity::kWarning, t, tid, "file.cc", 17,
+      PrefixFormat::kNotRaw, span);
+  const turbo::TimeZone::CivilInfo ci = tz->at(t);
+  EXPECT_EQ(std::string(buf.data(), size),
+            turbo::log_internal::FormatLogMessage(
+                turbo::LogSeverity::kWarning, ci.cs, ci.subsecond, tid,
+                "file.cc", 17, PrefixFormat::kNotRaw, ""))
+      << "at " << turbo::Time::to_microseconds(t) << "us, tid " << tid;
+}
+
+TEST(FormatLogPrefix, MatchesUncachedFormatting) {
+  turbo::log_internal::SetTimeZone(turbo::TimeZone::utc());
+  const int64_t base = int64_t{1700000000} * 1000000;
+  // Same second, next second, a jump back, and a different thread ID.
+  for (int64_t usecs : {int64_t{0}, int64_t{1}, int64_t{999999},
+                        int64_t{1000000}, int64_t{1000123}, int64_t{-1},
+                        int64_t{86400} * 1000000 * 45 + 7}) {
+    ExpectSamePrefix(turbo::Time::from_microseconds(base + usecs), 12345);
+  }
+  for (turbo::log_internal::Tid tid : {1, 1234567, 7, 2147483647}) {
+    ExpectSamePrefix(turbo::Time::from_microseconds(base), tid);
+  }
+  // Before the epoch.
+  ExpectSamePrefix(turbo::Time::from_microseconds(-1), 5);
+  ExpectSamePrefix(turbo::Time::from_microseconds(-1000001), 5);
+}
+
+}  // namespace
@@ -18,6 +18,11 @@
 
 #include <turbo/log/log_sink.h>
 
+#include <atomic>
+#include <chrono>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <turbo/base/attributes.h>
@@ -130,6 +135,44 @@ TEST(LogSinkTest, FlushSinks) {
   turbo::flush_log_sinks();
 }
 
+TEST(LogSinkTest, NoSendAfterRemovalReturns) {
+  class CheckingSink : public turbo::LogSink {
+   public:
+    // Still running when `remove_log_sink()` returned?
+    void Send(const turbo::LogEntry&) override {
+      sends.fetch_add(1, std::memory_order_relaxed);
+      std::this_thread::sleep_for(std::chrono::microseconds(20));
+      if (removed.load(std::memory_order_relaxed)) late.store(true);
+    }
+    std::atomic<bool> removed{false};
+    std::atomic<bool> late{false};
+    std::atomic<int> sends{0};
+  };
+
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> loggers;
+  for (int i = 0; i < 4; ++i) {
+    loggers.emplace_back([&stop] {
+      while (!stop.load(std::memory_order_relaxed)) {
+        LOG(INFO) << "concurrent";
+      }
+    });
+  }
+  for (int round = 0; round < 100; ++round) {
+    CheckingSink sink;
+    turbo::add_log_sink(&sink);
+    while (round % 10 == 0 && sink.sends.load() == 0) {
+      std::this_thread::yield();
+    }
+    turbo::remove_log_sink(&sink);
+    sink.removed.store(true, std::memory_order_relaxed);
+    std::this_thread::yield();
+    EXPECT_FALSE(sink.late.load());
+  }
+  stop.store(true);
+  for (std::thread& logger : loggers) logger.join();
+}
+
 TEST(LogSinkDeathTest, DeathInSend) {
   class FatalSendSink : public turbo::LogSink {
    public:
@@ -0,0 +1,180 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/log/sinks/ring_log_sink.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tests/log/test_helpers.h>
+#include <turbo/log/log.h>
+#include <turbo/strings/str_cat.h>
+
+namespace {
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  std::stringstream data;
+  data << in.rdbuf();
+  return data.str();
+}
+
+std::string Decode(const std::string& path) {
+  std::string text;
+  EXPECT_TRUE(turbo::decode_ring_log(ReadFile(path), &text));
+  return text;
+}
+
+class RingLogSinkTest : public ::testing::Test {
+ protected:
+  RingLogSinkTest() : path_(turbo::str_cat(::testing::TempDir(), "/ring.log")) {
+    std::remove(path_.c_str());
+  }
+  ~RingLogSinkTest() override { std::remove(path_.c_str()); }
+
+  const std::string path_;
+};
+
+TEST_F(RingLogSinkTest, KeepsEntriesInOrder) {
+  {
+    turbo::RingLogSink sink(path_, 1 << 16);
+    ASSERT_TRUE(sink.is_open());
+    for (int i = 0; i < 100; ++i) {
+      LOG(INFO).ToSinkOnly(&sink) << "entry " << i;
+    }
+  }
+  const std::string text = Decode(path_);
+  size_t pos = 0;
+  for (int i = 0; i < 100; ++i) {
+    pos = text.find(turbo::str_cat("] entry ", i, "\n"), pos);
+    ASSERT_NE(pos, std::string::npos) << i;
+  }
+  EXPECT_EQ(text[0], 'I');
+}
+
+TEST_F(RingLogSinkTest, KeepsTheTailWhenFull) {
+  turbo::RingLogSink sink(path_, 8192);
+  for (int i = 0; i < 10000; ++i) {
+    LOG(INFO).ToSinkOnly(&sink) << "entry " << i;
+  }
+  // Readable while the sink still has it mapped.
+  const std::string text = Decode(path_);
+  EXPECT_LE(text.size(), 8192u);
+  size_t pos = text.find("] entry ");
+  ASSERT_NE(pos, std::string::npos);
+  const int first = std::stoi(text.substr(pos + 8));
+  EXPECT_GT(first, 9800);
+  for (int i = first; i < 10000; ++i) {
+    pos = text.find(turbo::str_cat("] entry ", i, "\n"), pos);
+    ASSERT_NE(pos, std::string::npos) << i;
+  }
+}
+
+TEST_F(RingLogSinkTest, AppendsToExistingRing) {
+  {
+    turbo::RingLogSink sink(path_, 1 << 16);
+    LOG(INFO).ToSinkOnly(&sink) << "before crash";
+  }
+  {
+    turbo::RingLogSink sink(path_, 1 << 16);
+    LOG(INFO).ToSinkOnly(&sink) << "after restart";
+  }
+  const std::string text = Decode(path_);
+  const size_t before = text.find("before crash");
+  ASSERT_NE(before, std::string::npos) << text;
+  EXPECT_NE(text.find("after restart", before), std::string::npos) << text;
+
+  // A different capacity starts over.
+  { turbo::RingLogSink sink(path_, 1 << 15); }
+  EXPECT_EQ(Decode(path_), "");
+}
+
+TEST_F(RingLogSinkTest, TruncatesLongEntries) {
+  turbo::RingLogSink sink(path_, 4096);
+  LOG(INFO).ToSinkOnly(&sink) << std::string(10000, 'x');
+  LOG(INFO).ToSinkOnly(&sink) << "short";
+  const std::string text = Decode(path_);
+  EXPECT_LT(text.size(), 4096u);
+  EXPECT_NE(text.find("xxxx\nI"), std::string::npos) << text.size();
+  EXPECT_NE(text.find("] short\n"), std::string::npos) << text.size();
+}
+
+TEST_F(RingLogSinkTest, ConcurrentWriters) {
+  turbo::RingLogSink sink(path_, 1 << 20);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&sink, t] {
+      for (int i = 0; i < 1000; ++i) {
+        LOG(INFO).ToSinkOnly(&sink) << "thread " << t << " entry " << i;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const std::string text = Decode(path_);
+  for (int t = 0; t < 4; ++t) {
+    size_t pos = 0;
+    for (int i = 0; i < 1000; ++i) {
+      pos = text.find(turbo::str_cat("thread ", t, " entry ", i, "\n"), pos);
+      ASSERT_NE(pos, std::string::npos) << t << " " << i;
+    }
+  }
+}
+
+TEST_F(RingLogSinkTest, SkipsUncommittedEntries) {
+  {
+    turbo::RingLogSink sink(path_, 1 << 16);
+    LOG(INFO).ToSinkOnly(&sink) << "first";
+    LOG(INFO).ToSinkOnly(&sink) << "second";
+  }
+  std::string data = ReadFile(path_);
+  // Break the commit word of the first entry, as if the process died while
+  // writing it.
+  data[4096] ^= 1;
+  std::string text;
+  ASSERT_TRUE(turbo::decode_ring_log(data, &text));
+  EXPECT_EQ(text.find("first"), std::string::npos) << text;
+  EXPECT_NE(text.find("second"), std::string::npos) << text;
+
+  EXPECT_FALSE(turbo::decode_ring_log("not a ring", &text));
+}
+
+#if GTEST_HAS_DEATH_TEST
+using RingLogSinkDeathTest = RingLogSinkTest;
+
+TEST_F(RingLogSinkDeathTest, RecordsQuietFatalMessages) {
+  // `QFATAL` sends its message once, without a stack trace.
+  EXPECT_EXIT(
+      {
+        turbo::RingLogSink sink(path_, 1 << 16);
+        LOG(INFO).ToSinkOnly(&sink) << "before";
+        LOG(QFATAL).ToSinkOnly(&sink) << "quiet fatal message";
+      },
+      turbo::log_internal::DiedOfQFatal, "");
+  const std::string text = Decode(path_);
+  EXPECT_NE(text.find("] before\n"), std::string::npos) << text;
+  EXPECT_NE(text.find("] quiet fatal message\n"), std::string::npos) << text;
+}
+#endif
+
+}  // namespace
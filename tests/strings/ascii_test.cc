@@ -362,4 +362,65 @@ TEST(trim_complete, InPlace) {
   }
 }
 
+// Every byte value at every position of strings long enough for the
+// vectorized loops and their tails.
+TEST(AsciiStrTo, AllBytesAllPositions) {
+  for (size_t size : {1, 15, 16, 17, 31, 32, 33, 64, 100}) {
+    for (int byte = 0; byte < 256; ++byte) {
+      for (size_t pos = 0; pos < size; ++pos) {
+        std::string s(size, 'm');
+        s[pos] = static_cast<char>(byte);
+        const std::string lower = turbo::str_to_lower(s);
+        const std::string upper = turbo::str_to_upper(s);
+        ASSERT_EQ(lower[pos], turbo::ascii_tolower(static_cast<unsigned char>(byte)));
+        ASSERT_EQ(upper[pos], turbo::ascii_toupper(static_cast<unsigned char>(byte)));
+        ASSERT_EQ(lower.size(), size);
+        turbo::str_to_upper(&s);
+        ASSERT_EQ(s, upper);
+      }
+    }
+  }
+}
+
+TEST(AsciiBulk, MatchesPerCharacterFunctions) {
+  for (size_t size : {0, 1, 15, 16, 17, 31, 32, 33, 64, 100}) {
+    for (int byte = 0; byte < 256; ++byte) {
+      const unsigned char c = static_cast<unsigned char>(byte);
+      for (size_t pos = 0; pos < std::max<size_t>(size, 1); ++pos) {
+        std::string printable(size, 'x');
+        std::string spaces(size, ' ');
+        if (size > 0) {
+          printable[pos] = static_cast<char>(c);
+          spaces[pos] = static_cast<char>(c);
+        }
+        const bool placed = size > 0;
+        ASSERT_EQ(turbo::str_is_ascii(printable), !placed || turbo::ascii_isascii(c));
+        const bool odd = placed && !turbo::ascii_isprint(c);
+        ASSERT_EQ(turbo::str_count_non_printable(printable), odd ? 1u : 0u);
+        ASSERT_EQ(turbo::str_find_first_non_printable(printable),
+                  odd ? pos : std::string_view::npos);
+        const bool space = placed && turbo::ascii_isspace(c);
+        ASSERT_EQ(turbo::str_find_first_whitespace(printable),
+                  space ? pos : std::string_view::npos);
+        ASSERT_EQ(turbo::str_find_first_non_whitespace(spaces),
+                  placed && !space ? pos : std::string_view::npos);
+        ASSERT_EQ(turbo::str_find_last_non_whitespace(spaces),
+                  placed && !space ? pos : std::string_view::npos);
+      }
+    }
+  }
+}
+
+TEST(AsciiBulk, FindsFirstAndLast) {
+  const std::string s = "  \t\n ab c\r\n \x01\x7f\xc3\xa9 d  \v";
+  EXPECT_EQ(turbo::str_find_first_non_whitespace(s), 5u);
+  EXPECT_EQ(turbo::str_find_last_non_whitespace(s), s.size() - 4);
+  EXPECT_EQ(turbo::str_find_first_whitespace("abc def"), 3u);
+  EXPECT_EQ(turbo::str_find_first_non_printable(s), 2u);
+  EXPECT_EQ(turbo::str_count_non_printable(s), 9u);
+  EXPECT_FALSE(turbo::str_is_ascii(s));
+  EXPECT_TRUE(turbo::str_is_ascii(std::string(1000, '\x7f')));
+  EXPECT_EQ(turbo::trim_all(std::string(100, ' ') + "x" + std::string(100, '\t')), "x");
+}
+
 }  // namespace
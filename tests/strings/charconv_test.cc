@@ -19,13 +19,16 @@
 
 #include <cfloat>
 #include <cmath>
+#include <cstdio>
 #include <cstdlib>
 #include <functional>
 #include <limits>
+#include <random>
 #include <string>
 #include <system_error>  // NOLINT(build/c++11)
 
 #include <gtest/gtest.h>
+#include <turbo/base/casts.h>
 #include <turbo/strings/internal/pow10_helper.h>
 #include <turbo/strings/str_cat.h>
 #include <turbo/strings/str_format.h>
@@ -787,4 +790,170 @@ TEST(FromChars, DecimalFloatLimits) {
   TestOverflowAndUnderflow<float>(input_gen, expected_gen, -45, 38);
 }
 
+template <typename Float>
+std::string ToChars(Float value) {
+  char buf[512];
+  turbo::to_chars_result result = turbo::to_chars(buf, buf + sizeof(buf), value);
+  EXPECT_EQ(result.ec, std::errc());
+  return std::string(buf, result.ptr);
+}
+
+template <typename Float>
+std::string ToChars(Float value, turbo::chars_format fmt) {
+  char buf[512];
+  turbo::to_chars_result result =
+      turbo::to_chars(buf, buf + sizeof(buf), value, fmt);
+  EXPECT_EQ(result.ec, std::errc());
+  return std::string(buf, result.ptr);
+}
+
+TEST(ToChars, ShortestDouble) {
+  EXPECT_EQ(ToChars(0.0), "0");
+  EXPECT_EQ(ToChars(-0.0), "-0");
+  EXPECT_EQ(ToChars(1.0), "1");
+  EXPECT_EQ(ToChars(0.1), "0.1");
+  EXPECT_EQ(ToChars(0.3), "0.3");
+  EXPECT_EQ(ToChars(0.1 + 0.2), "0.30000000000000004");
+  EXPECT_EQ(ToChars(1.0 / 3), "0.3333333333333333");
+  EXPECT_EQ(ToChars(-1.5), "-1.5");
+  EXPECT_EQ(ToChars(123456.0), "123456");
+  EXPECT_EQ(ToChars(1e5), "1e+05");
+  EXPECT_EQ(ToChars(1e-4), "1e-04");
+  EXPECT_EQ(ToChars(0.001), "0.001");
+  EXPECT_EQ(ToChars(1e23), "1e+23");
+  EXPECT_EQ(ToChars(9007199254740993.0), "9007199254740992");
+  EXPECT_EQ(ToChars(std::numeric_limits<double>::max()),
+            "1.7976931348623157e+308");
+  EXPECT_EQ(ToChars(std::numeric_limits<double>::min()),
+            "2.2250738585072014e-308");
+  EXPECT_EQ(ToChars(std::numeric_limits<double>::denorm_min()), "5e-324");
+  EXPECT_EQ(ToChars(std::numeric_limits<double>::infinity()), "inf");
+  EXPECT_EQ(ToChars(-std::numeric_limits<double>::infinity()), "-inf");
+  EXPECT_EQ(ToChars(std::numeric_limits<double>::quiet_NaN()), "nan");
+  EXPECT_EQ(ToChars(-std::numeric_limits<double>::quiet_NaN()), "-nan");
+}
+
+TEST(ToChars, ShortestFloat) {
+  EXPECT_EQ(ToChars(0.1f), "0.1");
+  EXPECT_EQ(ToChars(1.0f / 3), "0.33333334");
+  EXPECT_EQ(ToChars(16777216.0f), "16777216");
+  EXPECT_EQ(ToChars(3e10f), "3e+10");
+  EXPECT_EQ(ToChars(std::numeric_limits<float>::max()), "3.4028235e+38");
+  EXPECT_EQ(ToChars(std::numeric_limits<float>::min()), "1.1754944e-38");
+  EXPECT_EQ(ToChars(std::numeric_limits<float>::denorm_min()), "1e-45");
+}
+
+TEST(ToChars, ShortestFloat16) {
+  EXPECT_EQ(ToChars(turbo::Float16(1.0f)), "1");
+  EXPECT_EQ(ToChars(turbo::Float16(0.1f)), "0.1");
+  EXPECT_EQ(ToChars(turbo::Float16(-2.5f)), "-2.5");
+  EXPECT_EQ(ToChars(turbo::Float16::from_bits(0x7bff)), "65504");
+  EXPECT_EQ(ToChars(turbo::Float16::from_bits(0x0001)), "6e-08");
+  EXPECT_EQ(ToChars(turbo::Float16::from_bits(0x7c00)), "inf");
+  EXPECT_EQ(ToChars(turbo::Float16::from_bits(0xfe00)), "-nan");
+}
+
+TEST(ToChars, Formats) {
+  using turbo::chars_format;
+  EXPECT_EQ(ToChars(1.5, chars_format::scientific), "1.5e+00");
+  EXPECT_EQ(ToChars(1e100, chars_format::scientific), "1e+100");
+  EXPECT_EQ(ToChars(-0.000123, chars_format::scientific), "-1.23e-04");
+  EXPECT_EQ(ToChars(1e-7, chars_format::fixed), "0.0000001");
+  EXPECT_EQ(ToChars(123.456, chars_format::fixed), "123.456");
+  EXPECT_EQ(ToChars(1e15, chars_format::fixed), "1000000000000000");
+  // Beyond 2^53, fixed notation writes the exact integer.
+  EXPECT_EQ(ToChars(1e23, chars_format::fixed), "99999999999999991611392");
+  EXPECT_EQ(ToChars(1e5, chars_format::general), "100000");
+  EXPECT_EQ(ToChars(1e6, chars_format::general), "1e+06");
+  EXPECT_EQ(ToChars(1e-4, chars_format::general), "0.0001");
+  EXPECT_EQ(ToChars(1e-5, chars_format::general), "1e-05");
+  EXPECT_EQ(ToChars(0.0, chars_format::hex), "0p+0");
+  EXPECT_EQ(ToChars(3.0, chars_format::hex), "1.8p+1");
+  EXPECT_EQ(ToChars(0.1, chars_format::hex), "1.999999999999ap-4");
+  EXPECT_EQ(ToChars(-1.0, chars_format::hex), "-1p+0");
+  EXPECT_EQ(ToChars(std::numeric_limits<double>::denorm_min(),
+                    chars_format::hex),
+            "0.0000000000001p-1022");
+  EXPECT_EQ(ToChars(0.1f, chars_format::hex), "1.99999ap-4");
+  EXPECT_EQ(ToChars(std::numeric_limits<float>::denorm_min(),
+                    chars_format::hex),
+            "0.000002p-126");
+}
+
+TEST(ToChars, ValueTooLarge) {
+  char buf[32];
+  for (double value : {0.0, -1.5, 1e23, 0.30000000000000004,
+                       -std::numeric_limits<double>::infinity()}) {
+    SCOPED_TRACE(value);
+    const std::string expected = ToChars(value);
+    for (size_t n = 0; n < expected.size(); ++n) {
+      turbo::to_chars_result result = turbo::to_chars(buf, buf + n, value);
+      EXPECT_EQ(result.ec, std::errc::value_too_large);
+      EXPECT_EQ(result.ptr, buf + n);
+    }
+    turbo::to_chars_result result =
+        turbo::to_chars(buf, buf + expected.size(), value);
+    EXPECT_EQ(result.ec, std::errc());
+    EXPECT_EQ(std::string(buf, result.ptr), expected);
+  }
+}
+
+// The shortest output reads back exactly.
+TEST(ToChars, RoundTrip) {
+  std::mt19937_64 rng(0x5eed);
+  for (int i = 0; i < 100000; ++i) {
+    const uint64_t bits = rng();
+    const double d = turbo::bit_cast<double>(bits);
+    const float f = turbo::bit_cast<float>(static_cast<uint32_t>(bits));
+    if (std::isfinite(d)) {
+      const std::string str = ToChars(d);
+      double parsed = 0;
+      turbo::from_chars(str.data(), str.data() + str.size(), parsed);
+      ASSERT_EQ(turbo::bit_cast<uint64_t>(parsed), bits) << str;
+    }
+    if (std::isfinite(f)) {
+      const std::string str = ToChars(f);
+      float parsed = 0;
+      turbo::from_chars(str.data(), str.data() + str.size(), parsed);
+      ASSERT_EQ(turbo::bit_cast<uint32_t>(parsed), static_cast<uint32_t>(bits))
+          << str;
+    }
+  }
+}
+
+TEST(ToChars, Float16RoundTripsExhaustively) {
+  for (uint32_t bits = 0; bits < 0x10000; ++bits) {
+    const turbo::Float16 value = turbo::Float16::from_bits(bits);
+    if (!value.is_finite()) {
+      continue;
+    }
+    const std::string str = ToChars(value);
+    float parsed = 0;
+    turbo::from_chars(str.data(), str.data() + str.size(), parsed);
+    ASSERT_EQ(turbo::Float16(parsed).bits(), bits) << str;
+  }
+}
+
+// The "%g" fast path, which uses the shortest digits when there are few
+// enough of them, agrees with the exact digits.
+TEST(ToChars, FormatGeneralMatchesSnprintf) {
+  std::mt19937_64 rng(0xfeed);
+  for (int i = 0; i < 20000; ++i) {
+    const double values[] = {
+        turbo::bit_cast<double>(rng()),
+        static_cast<double>(rng() % 1000000) / Pow10(static_cast<int>(rng() % 12)),
+        static_cast<double>(turbo::bit_cast<float>(static_cast<uint32_t>(rng())))};
+    for (double value : values) {
+      if (!std::isfinite(value)) continue;
+      char expected[64];
+      snprintf(expected, sizeof(expected), "%.3g", value);
+      EXPECT_EQ(turbo::str_format("%.3g", value), expected);
+      snprintf(expected, sizeof(expected), "%g", value);
+      EXPECT_EQ(turbo::str_format("%g", value), expected);
+      snprintf(expected, sizeof(expected), "%.15g", value);
+      EXPECT_EQ(turbo::str_format("%.15g", value), expected);
+    }
+  }
+}
+
 }  // namespace
@@ -692,6 +692,116 @@ namespace {
         EXPECT_EQ(huge, unescaped);
     }
 
+    // Long enough for the vector kernels, with the odd bytes where they take
+    // over from each other.
+    std::string LongBytes(size_t size) {
+        std::string bytes(size, '\0');
+        for (size_t i = 0; i < size; ++i) {
+            bytes[i] = static_cast<char>(i * 131 + (i >> 3));
+        }
+        return bytes;
+    }
+
+    TEST(Base64, LongWithWhitespace) {
+        for (size_t size: {0, 1, 2, 47, 48, 49, 100, 1000, 4097}) {
+            const std::string bytes = LongBytes(size);
+            const std::string encoded = turbo::base64_encode(bytes);
+            std::string decoded;
+            EXPECT_TRUE(turbo::base64_decode(encoded, &decoded));
+            EXPECT_EQ(decoded, bytes);
+
+            // MIME wraps lines at 76 characters, which is 19 groups; 70 is not
+            // a whole number of groups.
+            for (size_t line: {76, 70}) {
+                std::string wrapped;
+                for (size_t i = 0; i < encoded.size(); i += line) {
+                    wrapped += encoded.substr(i, line);
+                    wrapped += "\r\n";
+                }
+                EXPECT_TRUE(turbo::base64_decode(wrapped, &decoded));
+                EXPECT_EQ(decoded, bytes);
+            }
+
+            const std::string websafe = turbo::web_safe_base64_encode(bytes);
+            EXPECT_TRUE(turbo::web_safe_base64_decode(websafe, &decoded));
+            EXPECT_EQ(decoded, bytes);
+            if (websafe.find_first_of("-_") != std::string::npos) {
+                EXPECT_FALSE(turbo::base64_decode(websafe, &decoded));
+            }
+        }
+    }
+
+    TEST(Base64Decoder, Pieces) {
+        const std::string bytes = LongBytes(1000);
+        const std::string encoded = turbo::base64_encode(bytes);
+        for (size_t piece: {1, 3, 7, 64, 333}) {
+            turbo::Base64Decoder decoder;
+            std::string decoded;
+            for (size_t i = 0; i < encoded.size(); i += piece) {
+                ASSERT_TRUE(decoder.decode(encoded.substr(i, piece), &decoded));
+            }
+            EXPECT_TRUE(decoder.finish(&decoded));
+            EXPECT_EQ(decoded, bytes);
+            EXPECT_FALSE(decoder.failed());
+        }
+
+        turbo::Base64Decoder decoder(/*web_safe=*/true);
+        std::string decoded;
+        EXPECT_TRUE(decoder.decode("YW", &decoded));
+        EXPECT_EQ(decoded, "");
+        EXPECT_TRUE(decoder.decode(" Jj\n", &decoded));
+        EXPECT_EQ(decoded, "abc");
+        EXPECT_TRUE(decoder.decode("ZA", &decoded));
+        EXPECT_TRUE(decoder.finish(&decoded));
+        EXPECT_EQ(decoded, "abcd");
+
+        decoder.reset();
+        decoded.clear();
+        EXPECT_TRUE(decoder.decode("_-8=", &decoded));
+        EXPECT_TRUE(decoder.finish(&decoded));
+        EXPECT_EQ(decoded, "\xff\xef");
+    }
+
+    TEST(Base64Decoder, ErrorOffset) {
+        const std::string encoded = turbo::base64_encode(LongBytes(300));
+        for (size_t pos: {0, 5, 31, 32, 77, 200, 399}) {
+            std::string bad = encoded;
+            bad[pos] = '*';
+            turbo::Base64Decoder decoder;
+            std::string decoded;
+            EXPECT_FALSE(decoder.decode(bad.substr(0, 100), &decoded) &&
+                         decoder.decode(bad.substr(100), &decoded));
+            EXPECT_TRUE(decoder.failed());
+            EXPECT_EQ(decoder.error_offset(), pos);
+            // The groups before the bad byte are decoded.
+            EXPECT_EQ(decoded, LongBytes(pos / 4 * 3));
+            EXPECT_FALSE(decoder.decode("QUJD", &decoded));
+            EXPECT_FALSE(decoder.finish(&decoded));
+            EXPECT_EQ(decoder.error_offset(), pos);
+        }
+
+        struct {
+            std::string_view input;
+            size_t offset;
+        } const cases[] = {
+                {"YWJj\nZA=x", 8},  // Data after the padding.
+                {"YWJj=", 4},        // Padding after a whole group.
+                {"YWJjZ=", 5},       // Six bits.
+                {"YWJjZA===", 8},    // Too much padding.
+                {"YWJjZA=", 7},      // Not enough, seen at the end.
+                {"YWJjZ", 5},
+                {"YW-j", 2},         // Web safe.
+        };
+        for (const auto &tc: cases) {
+            turbo::Base64Decoder decoder;
+            std::string decoded;
+            EXPECT_FALSE(decoder.decode(tc.input, &decoded) &&
+                         decoder.finish(&decoded))
+                                << tc.input;
+            EXPECT_EQ(decoder.error_offset(), tc.offset) << tc.input;
+        }
+    }
+
     TEST(Escaping, HexStringToBytesBackToHex) {
         std::string bytes, hex;
 
@@ -756,4 +866,25 @@ namespace {
         EXPECT_EQ(hex_only_lower, hex_result);
     }
 
+    TEST(HexAndBack, Long) {
+        for (size_t size: {15, 16, 17, 31, 32, 33, 100, 1000}) {
+            const std::string bytes = LongBytes(size);
+            std::string hex = turbo::bytes_to_hex_string(bytes);
+            ASSERT_EQ(hex.size(), 2 * size);
+            std::string decoded;
+            EXPECT_TRUE(turbo::hex_string_to_bytes(hex, &decoded));
+            EXPECT_EQ(decoded, bytes);
+            for (char &c: hex) c = turbo::ascii_toupper(c);
+            EXPECT_TRUE(turbo::hex_string_to_bytes(hex, &decoded));
+            EXPECT_EQ(decoded, bytes);
+            for (size_t pos: {size_t{0}, size, 2 * size - 1}) {
+                for (char c: {'g', 'G', '/', ':', '@', '`', '\xb0'}) {
+                    std::string bad = hex;
+                    bad[pos] = c;
+                    EXPECT_FALSE(turbo::hex_string_to_bytes(bad, &decoded));
+                }
+            }
+        }
+    }
+
 }  // namespace
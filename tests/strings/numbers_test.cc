@@ -23,6 +23,7 @@
 
 #include <cfenv>  // NOLINT(build/c++11)
 #include <cfloat>
+#include <cerrno>
 #include <cinttypes>
 #include <climits>
 #include <cmath>
@@ -1740,4 +1741,159 @@ TEST(FastIntToBuffer, WritesNull) {
   ExpectWritesNull<uint32_t>();
 }
 
+// Every length and placement for the eight-at-a-time digit loop, against the
+// scalar one of other bases.
+TEST(NumbersTest, AtoiDecimalLengths) {
+  std::mt19937_64 rng(7);
+  for (int length = 1; length <= 21; ++length) {
+    for (int i = 0; i < 200; ++i) {
+      std::string digits;
+      for (int j = 0; j < length; ++j) {
+        digits.push_back(static_cast<char>('0' + rng() % 10));
+      }
+      for (const std::string& text : {digits, "-" + digits, " +" + digits + " "}) {
+        char* end;
+        errno = 0;
+        const int64_t expected = std::strtoll(text.c_str(), &end, 10);
+        const bool fits = errno == 0;
+        int64_t value = 0;
+        EXPECT_EQ(simple_atoi(text, &value), fits) << text;
+        if (fits) {
+          EXPECT_EQ(value, expected) << text;
+        }
+
+        const bool fits32 =
+            fits && expected >= std::numeric_limits<int32_t>::min() &&
+            expected <= std::numeric_limits<int32_t>::max();
+        int32_t value32 = 0;
+        EXPECT_EQ(simple_atoi(text, &value32), fits32) << text;
+        if (fits32) {
+          EXPECT_EQ(value32, expected) << text;
+        }
+
+        errno = 0;
+        const uint64_t expected_unsigned = std::strtoull(text.c_str(), &end, 10);
+        const bool fits_unsigned = errno == 0 && text[0] != '-';
+        uint64_t unsigned_value = 0;
+        EXPECT_EQ(simple_atoi(text, &unsigned_value), fits_unsigned) << text;
+        if (fits_unsigned) {
+          EXPECT_EQ(unsigned_value, expected_unsigned) << text;
+        }
+      }
+      digits[rng() % digits.size()] = "x:/"[rng() % 3];
+      int64_t value;
+      EXPECT_FALSE(simple_atoi(digits, &value)) << digits;
+    }
+  }
+}
+
+TEST(NumbersTest, AtoiInto) {
+  int64_t values[8];
+  turbo::simple_parse_result result =
+      turbo::simple_atoi_into("12,-7, 300 ,+4", ',', turbo::MakeSpan(values));
+  EXPECT_EQ(result.count, 4);
+  EXPECT_EQ(result.pos, 14);
+  EXPECT_EQ(result.ec, std::errc());
+  EXPECT_THAT(turbo::MakeSpan(values, 4), testing::ElementsAre(12, -7, 300, 4));
+
+  result = turbo::simple_atoi_into("", ',', turbo::MakeSpan(values));
+  EXPECT_EQ(result.count, 0);
+  EXPECT_EQ(result.pos, 0);
+  EXPECT_EQ(result.ec, std::errc());
+  result = turbo::simple_atoi_into(" \n", ',', turbo::MakeSpan(values));
+  EXPECT_EQ(result.count, 0);
+  EXPECT_EQ(result.ec, std::errc());
+
+  result = turbo::simple_atoi_into(
+      "9223372036854775807\t-9223372036854775808\t000000000000000000000042",
+      '\t', turbo::MakeSpan(values));
+  EXPECT_EQ(result.count, 3);
+  EXPECT_EQ(result.ec, std::errc());
+  EXPECT_EQ(values[0], std::numeric_limits<int64_t>::max());
+  EXPECT_EQ(values[1], std::numeric_limits<int64_t>::min());
+  EXPECT_EQ(values[2], 42);
+
+  result = turbo::simple_atoi_into("1,2,3x,4", ',', turbo::MakeSpan(values));
+  EXPECT_EQ(result.count, 2);
+  EXPECT_EQ(result.pos, 4);
+  EXPECT_EQ(result.ec, std::errc::invalid_argument);
+
+  result = turbo::simple_atoi_into("1,,3", ',', turbo::MakeSpan(values));
+  EXPECT_EQ(result.count, 1);
+  EXPECT_EQ(result.pos, 2);
+  EXPECT_EQ(result.ec, std::errc::invalid_argument);
+
+  result = turbo::simple_atoi_into("1,9223372036854775808", ',',
+                                   turbo::MakeSpan(values));
+  EXPECT_EQ(result.count, 1);
+  EXPECT_EQ(result.pos, 2);
+  EXPECT_EQ(result.ec, std::errc::result_out_of_range);
+
+  result = turbo::simple_atoi_into("1,123456789012345678901234,5", ',',
+                                   turbo::MakeSpan(values));
+  EXPECT_EQ(result.count, 1);
+  EXPECT_EQ(result.ec, std::errc::result_out_of_range);
+
+  // A full output stops at the next field.
+  result = turbo::simple_atoi_into("1,2,3", ',', turbo::MakeSpan(values, 2));
+  EXPECT_EQ(result.count, 2);
+  EXPECT_EQ(result.pos, 4);
+  EXPECT_EQ(result.ec, std::errc());
+}
+
+TEST(NumbersTest, AtoiIntoMatchesAtoi) {
+  std::mt19937_64 rng(11);
+  std::string text;
+  std::vector<int64_t> expected;
+  for (int i = 0; i < 10000; ++i) {
+    const int64_t value = static_cast<int64_t>(rng()) >> (rng() % 64);
+    expected.push_back(value);
+    turbo::str_append(&text, i == 0 ? "" : "\n", value);
+  }
+  std::vector<int64_t> values(expected.size());
+  const turbo::simple_parse_result result =
+      turbo::simple_atoi_into(text, '\n', turbo::MakeSpan(values));
+  EXPECT_EQ(result.count, expected.size());
+  EXPECT_EQ(result.pos, text.size());
+  EXPECT_EQ(result.ec, std::errc());
+  EXPECT_EQ(values, expected);
+}
+
+TEST(NumbersTest, AtodInto) {
+  double values[8];
+  turbo::simple_parse_result result = turbo::simple_atod_into(
+      "1.5, -2e3,+0.25,inf ,1e400", ',', turbo::MakeSpan(values));
+  EXPECT_EQ(result.count, 5);
+  EXPECT_EQ(result.ec, std::errc());
+  EXPECT_EQ(values[0], 1.5);
+  EXPECT_EQ(values[1], -2e3);
+  EXPECT_EQ(values[2], 0.25);
+  EXPECT_EQ(values[3], std::numeric_limits<double>::infinity());
+  EXPECT_EQ(values[4], std::numeric_limits<double>::infinity());
+
+  result = turbo::simple_atod_into("1|2.5.|3", '|', turbo::MakeSpan(values));
+  EXPECT_EQ(result.count, 1);
+  EXPECT_EQ(result.pos, 2);
+  EXPECT_EQ(result.ec, std::errc::invalid_argument);
+
+  result = turbo::simple_atod_into("1|+-2", '|', turbo::MakeSpan(values));
+  EXPECT_EQ(result.count, 1);
+  EXPECT_EQ(result.ec, std::errc::invalid_argument);
+
+  std::mt19937_64 rng(13);
+  std::string text;
+  std::vector<double> expected;
+  for (int i = 0; i < 10000; ++i) {
+    double value = static_cast<double>(rng() % 100000000) / 1000;
+    if (i % 2) value = -value;
+    expected.push_back(value);
+    turbo::str_append(&text, i == 0 ? "" : ",", turbo::shortest_digits(value));
+  }
+  std::vector<double> parsed(expected.size());
+  result = turbo::simple_atod_into(text, ',', turbo::MakeSpan(parsed));
+  EXPECT_EQ(result.count, expected.size());
+  EXPECT_EQ(result.ec, std::errc());
+  EXPECT_EQ(parsed, expected);
+}
+
 }  // namespace
@@ -197,6 +197,15 @@ TEST(str_cat, Basics) {
       turbo::str_cat("A hundred K and a half squared is ", turbo::six_digits(d));
   EXPECT_EQ(result, "A hundred K and a half squared is 1.00001e+10");
 
+  result = turbo::str_cat("Shortest: ", turbo::shortest_digits(d), " ",
+                          turbo::shortest_digits(0.1), " ",
+                          turbo::shortest_digits(1.0f / 3));
+  EXPECT_EQ(result, "Shortest: 10000100000.25 0.1 0.33333334");
+  result = turbo::str_cat(
+      turbo::shortest_digits(-std::numeric_limits<double>::denorm_min()), " ",
+      turbo::shortest_digits(-2.2250738585072014e-308));
+  EXPECT_EQ(result, "-5e-324 -2.2250738585072014e-308");
+
   result = turbo::str_cat(1, 2, 333, 4444, 55555, 666666, 7777777, 88888888,
                         999999999);
   EXPECT_EQ(result, "12333444455555666666777777788888888999999999");
@@ -21,6 +21,7 @@
 #include <cstdarg>
 #include <cstdint>
 #include <cstdio>
+#include <limits>
 #include <ostream>
 #include <sstream>
 #include <string>
@@ -186,6 +187,54 @@ TEST_F(FormatEntryPointTest, PreparsedWithV) {
   EXPECT_EQ("=123=", str_format(ParsedFormat<'v'>(view), 123));
 }
 
+TEST_F(FormatEntryPointTest, Compiled) {
+  EXPECT_EQ("123", str_format(TURBO_FORMAT("%d"), 123));
+  EXPECT_EQ("", str_format(TURBO_FORMAT("")));
+  EXPECT_EQ("100%", str_format(TURBO_FORMAT("100%%")));
+  EXPECT_EQ("a=  1|b=2.50 |%x",
+            str_format(TURBO_FORMAT("a=%3d|b=%-5.2f|%%x"), 1, 2.5));
+  EXPECT_EQ("  7|x", str_format(TURBO_FORMAT("%*d|%s"), 3, 7, "x"));
+  EXPECT_EQ("b a", str_format(TURBO_FORMAT("%2$s %1$s"), "a", "b"));
+  EXPECT_EQ("1 2 3", str_format(TURBO_FORMAT("%v %v %v"), 1, 2u, 3L));
+
+  std::string s = "x";
+  str_append_format(&s, TURBO_FORMAT("[%s:%d]"), "y", 5);
+  EXPECT_EQ("x[y:5]", s);
+
+  char buf[8];
+  EXPECT_EQ(5, SNPrintF(buf, sizeof(buf), TURBO_FORMAT("%05d"), 42));
+  EXPECT_EQ("00042", std::string(buf));
+}
+
+TEST_F(FormatEntryPointTest, CompiledItems) {
+  using str_format_internal::CompileFormat;
+  using str_format_internal::CompiledFormatCapacity;
+  // "a%%b" is one literal, then "%d" and the "!" literal.
+  constexpr std::string_view kFormat = "a%%b%d!";
+  constexpr auto kCompiled =
+      CompileFormat<CompiledFormatCapacity(kFormat)>(kFormat);
+  static_assert(kCompiled.valid, "");
+  static_assert(kCompiled.size == 4, "");
+  static_assert(kCompiled.items[0].text_end == 2, "");
+  static_assert(kCompiled.items[2].is_conversion, "");
+  static_assert(kCompiled.items[2].conv.arg_position == 1, "");
+
+  constexpr std::string_view kBad = "%d %";
+  static_assert(!CompileFormat<CompiledFormatCapacity(kBad)>(kBad).valid, "");
+}
+
+TEST_F(FormatEntryPointTest, CompiledMatchesRuntime) {
+  for (int i : {0, 1, -1, 12345, std::numeric_limits<int>::max()}) {
+    EXPECT_EQ(str_format("%+08d|%-6x|%o|%#X|%s", i, i, i, i, "end"),
+              str_format(TURBO_FORMAT("%+08d|%-6x|%o|%#X|%s"), i, i, i, i,
+                         "end"));
+  }
+  for (double d : {0.0, -1.5, 3.14159, 1e300}) {
+    EXPECT_EQ(str_format("%.3e %g %10.2f%%", d, d, d),
+              str_format(TURBO_FORMAT("%.3e %g %10.2f%%"), d, d, d));
+  }
+}
+
 TEST_F(FormatEntryPointTest, format_count_capture) {
   int n = 0;
   EXPECT_EQ("", str_format("%n", format_count_capture(&n)));
@@ -25,6 +25,9 @@
 #include <vector>
 
 #include <gtest/gtest.h>
+#include <tests/strings/cord_test_helpers.h>
+#include <turbo/random/random.h>
+#include <turbo/strings/cord.h>
 #include <turbo/strings/str_cat.h>
 #include <turbo/strings/str_split.h>
 #include <turbo/strings/string_view.h>
@@ -346,3 +349,88 @@ TEST(str_replace_all, Inplace) {
   EXPECT_EQ(reps, 8);
   EXPECT_EQ(s, "pack my box with five dozen liquor jugs");
 }
+
+TEST(StrReplacer, MatchesStrReplaceAll) {
+  const turbo::StrReplacer replacer(
+      {{"a", "x"}, {"ab", "xy"}, {"abc", "xyz"}, {"", "e"}, {"bcd", "-"}});
+  for (std::string_view s : {"", "abc", "abcd", "aabcd", "zzz", "babcabcdab"}) {
+    EXPECT_EQ(replacer.replace_all(s),
+              turbo::str_replace_all(s, {{"a", "x"},
+                                         {"ab", "xy"},
+                                         {"abc", "xyz"},
+                                         {"", "e"},
+                                         {"bcd", "-"}}))
+        << s;
+  }
+  EXPECT_EQ(turbo::StrReplacer({{"aa", "x"}}).replace_all("aaa"), "xa");
+  EXPECT_EQ(turbo::StrReplacer({{"aa", "a"}}).replace_all("aaa"), "aa");
+  // A longer match starting earlier wins over one found first.
+  EXPECT_EQ(turbo::StrReplacer({{"bc", "1"}, {"abcd", "2"}}).replace_all("abcde"),
+            "2e");
+  EXPECT_EQ(turbo::StrReplacer({{"bcd", "1"}, {"abcx", "2"}}).replace_all("abcd"),
+            "a1");
+}
+
+TEST(StrReplacer, DuplicatePatterns) {
+  // The first of equal patterns is used for every match, which
+  // str_replace_all() does not promise.
+  const turbo::StrReplacer replacer({{"a", "1"}, {"a", "2"}, {"b", "3"}});
+  EXPECT_EQ(replacer.replace_all("xaxa"), "x1x1");
+  EXPECT_EQ(replacer.replace_all("abab"), "1313");
+  std::vector<std::pair<std::string, std::string>> replacements = {
+      {"ab", "x"}, {"b", "y"}, {"ab", "z"}};
+  EXPECT_EQ(turbo::StrReplacer(replacements).replace_all("abab b"), "xx y");
+}
+
+TEST(StrReplacer, Inplace) {
+  std::map<std::string, std::string> replacements = {
+      {"$who", "Bob"}, {"$count", "5"}, {"#Noun", "Apples"}};
+  const turbo::StrReplacer replacer(replacements);
+  std::string s = "$who bought $count #Noun. Thanks $who!";
+  EXPECT_EQ(replacer.replace_all(&s), 4);
+  EXPECT_EQ(s, "Bob bought 5 Apples. Thanks Bob!");
+  EXPECT_EQ(replacer.replace_all(&s), 0);
+  EXPECT_EQ(s, "Bob bought 5 Apples. Thanks Bob!");
+}
+
+TEST(StrReplacer, Cord) {
+  const turbo::StrReplacer replacer({{"quick", "slow"}, {"fox", "dog"}});
+  // Matches span the fragments.
+  turbo::Cord cord = turbo::MakeFragmentedCord(
+      {"the qu", "ick brown f", "o", "x, the quick", " fox"});
+  EXPECT_EQ(std::string(replacer.replace_all(cord)),
+            "the slow brown dog, the slow dog");
+  EXPECT_EQ(replacer.replace_all(&cord), 4);
+  EXPECT_EQ(std::string(cord), "the slow brown dog, the slow dog");
+  EXPECT_EQ(replacer.replace_all(&cord), 0);
+}
+
+TEST(StrReplacer, RandomAgainstStrReplaceAll) {
+  turbo::BitGen gen;
+  // A small alphabet, for many overlapping matches.
+  auto random_string = [&gen](size_t max_size) {
+    std::string s(turbo::Uniform(gen, 0u, max_size), ' ');
+    for (char& c : s) c = static_cast<char>('a' + turbo::Uniform(gen, 0, 3));
+    return s;
+  };
+  for (int iteration = 0; iteration < 500; ++iteration) {
+    std::map<std::string, std::string> replacements;
+    const int num_patterns = turbo::Uniform(gen, 1, 40);
+    for (int i = 0; i < num_patterns; ++i) {
+      replacements[random_string(6)] = turbo::str_cat("<", i, ">");
+    }
+    const turbo::StrReplacer replacer(replacements);
+    const std::string text = random_string(300);
+    const std::string expected = turbo::str_replace_all(text, replacements);
+    EXPECT_EQ(replacer.replace_all(text), expected) << text;
+
+    std::vector<std::string> pieces;
+    for (size_t pos = 0; pos < text.size();) {
+      const size_t n = turbo::Uniform(gen, 1u, size_t{16});
+      pieces.push_back(text.substr(pos, n));
+      pos += n;
+    }
+    EXPECT_EQ(std::string(replacer.replace_all(turbo::MakeFragmentedCord(pieces))),
+              expected);
+  }
+}
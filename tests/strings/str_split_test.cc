@@ -24,6 +24,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <random>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -38,6 +39,7 @@
 #include <turbo/container/btree_set.h>
 #include <turbo/container/flat_hash_map.h>
 #include <turbo/container/node_hash_map.h>
+#include <turbo/strings/charset.h>
 #include <turbo/strings/string_view.h>
 
 namespace {
@@ -987,6 +989,98 @@ TEST(Delimiter, ByLength) {
   EXPECT_FALSE(IsFoundAt("abcd", four_char_delim, 0));
 }
 
+TEST(Delimiter, ByAnyCharMatchesFindFirstOf) {
+  // Small sets are searched with nibble tables, larger ones byte by byte.
+  std::string large;  // 9 high nibbles, each with other low nibbles
+  for (int high = 1; high <= 9; ++high) {
+    for (int low = 0; low < high; ++low) {
+      large.push_back(static_cast<char>(high << 4 | low));
+    }
+  }
+  const std::string sets[] = {
+      ",", ",;", ";:,.", " \t\n\v\f\r", "\x80\xff\x01 ", "0123456789", large,
+  };
+  std::mt19937 rng(7);
+  for (const std::string& set : sets) {
+    const turbo::ByAnyChar delimiter(set);
+    for (int trial = 0; trial < 200; ++trial) {
+      std::string text(rng() % 200, 'x');
+      for (char& c : text) {
+        if (rng() % 8 == 0) c = static_cast<char>(rng());
+      }
+      for (size_t pos = 0; pos <= text.size(); pos += 1 + rng() % 40) {
+        const size_t expected = text.find_first_of(set, pos);
+        std::string_view found = delimiter.Find(text, pos);
+        if (expected == std::string_view::npos) {
+          EXPECT_EQ(found.data(), text.data() + text.size());
+          EXPECT_TRUE(found.empty());
+        } else {
+          EXPECT_EQ(found.data(), text.data() + expected);
+          EXPECT_EQ(found.size(), 1);
+        }
+      }
+    }
+  }
+}
+
+TEST(Split, ByAnyCharSet) {
+  std::vector<std::string_view> v = turbo::str_split(
+      "a b\tc\n\nd", turbo::ByAnyChar(turbo::CharSet::AsciiWhitespace()));
+  EXPECT_THAT(v, ElementsAre("a", "b", "c", "", "d"));
+  v = turbo::str_split("a1b22c", turbo::ByAnyChar(turbo::CharSet::AsciiDigits()),
+                       turbo::SkipEmpty());
+  EXPECT_THAT(v, ElementsAre("a", "b", "c"));
+  v = turbo::str_split("abc", turbo::ByAnyChar(turbo::CharSet()));
+  EXPECT_THAT(v, ElementsAre("a", "b", "c"));
+}
+
+TEST(SplitInto, ByChar) {
+  std::string_view fields[8];
+  EXPECT_EQ(4, turbo::str_split_into("a\tb\t\tc", '\t', fields));
+  EXPECT_THAT(turbo::span<std::string_view>(fields, 4),
+              ElementsAre("a", "b", "", "c"));
+  EXPECT_EQ(1, turbo::str_split_into("", '\t', fields));
+  EXPECT_EQ("", fields[0]);
+  EXPECT_EQ(3, turbo::str_split_into(",,", ',', fields));
+  EXPECT_THAT(turbo::span<std::string_view>(fields, 3), ElementsAre("", "", ""));
+  EXPECT_EQ(0, turbo::str_split_into("a,b", ',', turbo::span<std::string_view>()));
+}
+
+TEST(SplitInto, KeepsTheRestInTheLastPiece) {
+  std::string_view fields[3];
+  EXPECT_EQ(3, turbo::str_split_into("a,b,c,d,e", ',', fields));
+  EXPECT_THAT(fields, ElementsAre("a", "b", "c,d,e"));
+  EXPECT_EQ(3, turbo::str_split_into("a,b;c,d", turbo::ByAnyChar(",;"), fields));
+  EXPECT_THAT(fields, ElementsAre("a", "b", "c,d"));
+  EXPECT_EQ(3, turbo::str_split_into("abcd", turbo::ByAnyChar(""), fields));
+  EXPECT_THAT(fields, ElementsAre("a", "b", "cd"));
+  std::string_view one[1];
+  EXPECT_EQ(1, turbo::str_split_into("a,b", ',', one));
+  EXPECT_EQ("a,b", one[0]);
+}
+
+TEST(SplitInto, MatchesStrSplit) {
+  std::mt19937 rng(11);
+  const turbo::ByAnyChar any(";:,.");
+  std::vector<std::string_view> out(400);
+  for (int trial = 0; trial < 300; ++trial) {
+    std::string text(rng() % 300, 'x');
+    for (char& c : text) {
+      if (rng() % 6 == 0) c = ";:,."[rng() % 4];
+    }
+    std::vector<std::string_view> expected = turbo::str_split(text, ',');
+    size_t n = turbo::str_split_into(text, ',', turbo::MakeSpan(out));
+    EXPECT_EQ(std::vector<std::string_view>(out.begin(), out.begin() + n),
+              expected);
+    expected = turbo::str_split(text, any);
+    n = turbo::str_split_into(text, any, turbo::MakeSpan(out));
+    EXPECT_EQ(std::vector<std::string_view>(out.begin(), out.begin() + n),
+              expected);
+    // Pieces are views of `text`.
+    EXPECT_EQ(out[0].data(), text.data());
+  }
+}
+
 TEST(Split, WorksWithLargeStrings) {
 #if defined(TURBO_HAVE_ADDRESS_SANITIZER) || \
     defined(TURBO_HAVE_MEMORY_SANITIZER) || defined(TURBO_HAVE_THREAD_SANITIZER)
@@ -18,10 +18,14 @@
 #include <turbo/strings/internal/utf8.h>
 
 #include <cstdint>
+#include <random>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include <turbo/base/port.h>
+#include <turbo/strings/utf8.h>
 
 namespace {
 
@@ -66,4 +70,174 @@ TEST(EncodeUTF8Char, BasicFunction) {
 #endif
 #endif  // !defined(__cpp_char8_t)
 
+// Runs on each implementation this build and this CPU support.
+class Utf8Test : public testing::TestWithParam<const char *> {
+ protected:
+  void SetUp() override {
+    saved_ = turbo::strings_internal::Utf8Implementation();
+    if (!turbo::strings_internal::SetUtf8Implementation(GetParam())) {
+      GTEST_SKIP() << GetParam() << " is not supported";
+    }
+  }
+
+  void TearDown() override {
+    turbo::strings_internal::SetUtf8Implementation(saved_);
+  }
+
+ private:
+  std::string saved_;
+};
+
+std::string Encode(const std::u32string &code_points) {
+  std::string out;
+  for (char32_t c : code_points) {
+    char buf[turbo::strings_internal::kMaxEncodedUTF8Size];
+    out.append(buf, turbo::strings_internal::EncodeUTF8Char(buf, c));
+  }
+  return out;
+}
+
+std::u16string EncodeUtf16(const std::u32string &code_points) {
+  std::u16string out;
+  for (char32_t c : code_points) {
+    if (c < 0x10000) {
+      out.push_back(static_cast<char16_t>(c));
+    } else {
+      out.push_back(static_cast<char16_t>(0xd800 + ((c - 0x10000) >> 10)));
+      out.push_back(static_cast<char16_t>(0xdc00 + ((c - 0x10000) & 0x3ff)));
+    }
+  }
+  return out;
+}
+
+// Mostly ASCII, so that the fast paths are taken too.
+std::u32string RandomCodePoints(std::mt19937 *rng, size_t n) {
+  std::u32string out;
+  for (size_t i = 0; i < n; ++i) {
+    const uint32_t kind = (*rng)() % 8;
+    char32_t c;
+    if (kind < 4) {
+      c = (*rng)() % 0x80;
+    } else if (kind == 4) {
+      c = 0x80 + (*rng)() % (0x800 - 0x80);
+    } else if (kind == 5) {
+      c = 0x800 + (*rng)() % (0x10000 - 0x800);
+      if (c >= 0xd800 && c <= 0xdfff) c -= 0x800;
+    } else if (kind == 6) {
+      c = 0x10000 + (*rng)() % (0x110000 - 0x10000);
+    } else {
+      c = (*rng)() % 2 == 0 ? 0x10ffff : 0xffff;
+    }
+    out.push_back(c);
+  }
+  return out;
+}
+
+TEST_P(Utf8Test, ConvertsValidText) {
+  std::mt19937 rng(42);
+  for (size_t n = 0; n < 300; ++n) {
+    const std::u32string code_points = RandomCodePoints(&rng, n);
+    const std::string utf8 = Encode(code_points);
+    const std::u16string utf16 = EncodeUtf16(code_points);
+    ASSERT_TRUE(turbo::validate_utf8(utf8)) << n;
+    EXPECT_EQ(turbo::count_utf8_code_points(utf8), code_points.size());
+    EXPECT_EQ(turbo::utf16_length_from_utf8(utf8), utf16.size());
+    EXPECT_EQ(turbo::utf8_length_from_utf16(utf16), utf8.size());
+
+    std::u16string to16;
+    ASSERT_TRUE(turbo::utf8_to_utf16(utf8, &to16));
+    EXPECT_EQ(to16, utf16);
+    std::u32string to32;
+    ASSERT_TRUE(turbo::utf8_to_utf32(utf8, &to32));
+    EXPECT_EQ(to32, code_points);
+    std::string to8;
+    ASSERT_TRUE(turbo::utf16_to_utf8(utf16, &to8));
+    EXPECT_EQ(to8, utf8);
+  }
+}
+
+TEST_P(Utf8Test, ConvertsAscii) {
+  std::string ascii;
+  std::u16string ascii16;
+  for (int i = 0; i < 200; ++i) {
+    ascii.push_back(static_cast<char>(i % 128));
+    ascii16.push_back(static_cast<char16_t>(i % 128));
+  }
+  std::u16string to16;
+  ASSERT_TRUE(turbo::utf8_to_utf16(ascii, &to16));
+  EXPECT_EQ(to16, ascii16);
+  std::u32string to32;
+  ASSERT_TRUE(turbo::utf8_to_utf32(ascii, &to32));
+  EXPECT_EQ(to32.size(), ascii.size());
+  EXPECT_EQ(to32[199], U'G');
+  std::string to8;
+  ASSERT_TRUE(turbo::utf16_to_utf8(ascii16, &to8));
+  EXPECT_EQ(to8, ascii);
+}
+
+TEST_P(Utf8Test, RejectsInvalidSequences) {
+  const std::vector<std::string> invalid = {
+      "\x80",                  // continuation alone
+      "\xbf",                  //
+      "\xc3",                  // truncated
+      "\xe2\x82",              //
+      "\xf0\x9f\x98",          //
+      "\xc3\x28",              // bad continuation
+      "\xe2\x28\xa1",          //
+      "\xf0\x28\x8c\xbc",      //
+      "\xc0\xaf",              // overlong
+      "\xc1\xbf",              //
+      "\xe0\x80\xaf",          //
+      "\xe0\x9f\xbf",          //
+      "\xf0\x80\x80\xaf",      //
+      "\xf0\x8f\xbf\xbf",      //
+      "\xed\xa0\x80",          // surrogates
+      "\xed\xbf\xbf",          //
+      "\xf4\x90\x80\x80",      // above U+10FFFF
+      "\xf5\x80\x80\x80",      //
+      "\xf8\x88\x80\x80\x80",  // 5 bytes
+      "\xff",                  //
+      "\xc3\xa9\xa9",          // extra continuation
+  };
+  for (const std::string &sequence : invalid) {
+    for (size_t offset = 0; offset < 70; ++offset) {
+      for (size_t after : {size_t{0}, size_t{1}, size_t{40}}) {
+        const std::string s = std::string(offset, 'a') + sequence + std::string(after, 'b');
+        EXPECT_FALSE(turbo::validate_utf8(s)) << offset << " " << after;
+        std::u16string to16;
+        EXPECT_FALSE(turbo::utf8_to_utf16(s, &to16));
+        std::u32string to32;
+        EXPECT_FALSE(turbo::utf8_to_utf32(s, &to32));
+      }
+    }
+  }
+}
+
+TEST_P(Utf8Test, AcceptsBoundaryCodePoints) {
+  for (const char *s : {"\x7f", "\xc2\x80", "\xdf\xbf", "\xe0\xa0\x80", "\xed\x9f\xbf",
+                        "\xee\x80\x80", "\xef\xbf\xbf", "\xf0\x90\x80\x80",
+                        "\xf4\x8f\xbf\xbf"}) {
+    for (size_t offset = 0; offset < 70; ++offset) {
+      EXPECT_TRUE(turbo::validate_utf8(std::string(offset, ' ') + s)) << offset;
+    }
+  }
+}
+
+TEST_P(Utf8Test, RejectsUnpairedSurrogates) {
+  for (size_t offset = 0; offset < 70; ++offset) {
+    for (const std::u16string &bad :
+         {std::u16string(1, 0xd800), std::u16string(1, 0xdc00),
+          std::u16string{0xd800, u'x'}, std::u16string{0xdc00, 0xd800}}) {
+      std::u16string s(offset, u'a');
+      s += bad;
+      s += std::u16string(40, u'b');
+      std::string out;
+      EXPECT_FALSE(turbo::utf16_to_utf8(s, &out)) << offset;
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Implementations, Utf8Test,
+                         testing::Values("scalar", "ssse3", "avx2", "neon"));
+
 }  // namespace
@@ -0,0 +1,118 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/synchronization/distributed_rw_lock.h>
+
+#include <atomic>
+#include <mutex>         // NOLINT(build/c++11)
+#include <shared_mutex>  // NOLINT(build/c++11)
+#include <thread>        // NOLINT(build/c++11)
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <turbo/synchronization/notification.h>
+
+namespace {
+
+TEST(DistributedRWLock, ExclusiveExcludesReaders) {
+  turbo::DistributedRWLock mu;
+  mu.Lock();
+  EXPECT_FALSE(mu.ReaderTryLock());
+  EXPECT_FALSE(mu.TryLock());
+  mu.Unlock();
+
+  EXPECT_TRUE(mu.ReaderTryLock());
+  EXPECT_TRUE(mu.ReaderTryLock());
+  EXPECT_FALSE(mu.TryLock());
+  mu.ReaderUnlock();
+  mu.ReaderUnlock();
+  EXPECT_TRUE(mu.TryLock());
+  mu.Unlock();
+}
+
+TEST(DistributedRWLock, ReaderOnOtherThreadBlocksWriter) {
+  turbo::DistributedRWLock mu;
+  turbo::Notification locked;
+  turbo::Notification release;
+  std::thread reader([&] {
+    turbo::DistributedReaderLock l(&mu);
+    locked.Notify();
+    release.WaitForNotification();
+  });
+  locked.WaitForNotification();
+  EXPECT_FALSE(mu.TryLock());
+  release.Notify();
+  reader.join();
+  EXPECT_TRUE(mu.TryLock());
+  mu.Unlock();
+}
+
+TEST(DistributedRWLock, StandardLockAdapters) {
+  turbo::DistributedRWLock mu;
+  {
+    std::shared_lock<turbo::DistributedRWLock> a(mu);
+    std::shared_lock<turbo::DistributedRWLock> b(mu);
+    EXPECT_FALSE(mu.try_lock());
+  }
+  std::unique_lock<turbo::DistributedRWLock> w(mu);
+  EXPECT_FALSE(mu.try_lock_shared());
+}
+
+TEST(DistributedRWLock, ReadersSeeConsistentStateUnderWrites) {
+  constexpr int kReaders = 8;
+  constexpr int kWriters = 2;
+  constexpr int kWritesPerWriter = 2000;
+  turbo::DistributedRWLock mu;
+  // Writers keep both values equal; readers must never observe them differ.
+  int64_t a = 0;
+  int64_t b = 0;
+  std::atomic<bool> done{false};
+  std::atomic<int64_t> reads{0};
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kReaders; ++i) {
+    threads.emplace_back([&] {
+      while (!done.load(std::memory_order_relaxed)) {
+        turbo::DistributedReaderLock l(&mu);
+        ASSERT_EQ(a, b);
+        reads.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+  std::vector<std::thread> writers;
+  for (int i = 0; i < kWriters; ++i) {
+    writers.emplace_back([&] {
+      for (int j = 0; j < kWritesPerWriter; ++j) {
+        turbo::DistributedWriterLock l(&mu);
+        ++a;
+        ++b;
+      }
+    });
+  }
+  for (auto& t : writers) {
+    t.join();
+  }
+  done.store(true);
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(a, kWriters * kWritesPerWriter);
+  EXPECT_EQ(b, kWriters * kWritesPerWriter);
+  EXPECT_GT(reads.load(), 0);
+}
+
+}  // namespace
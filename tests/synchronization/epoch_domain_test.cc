@@ -0,0 +1,173 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/synchronization/epoch_domain.h>
+
+#include <atomic>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <turbo/synchronization/notification.h>
+
+namespace {
+
+// Counts live instances so tests can observe reclamation.
+struct Tracked {
+  explicit Tracked(int v, std::atomic<int>* live) : value(v), live(live) {
+    live->fetch_add(1);
+  }
+  ~Tracked() {
+    value = -1;
+    live->fetch_sub(1);
+  }
+  int value;
+  std::atomic<int>* live;
+};
+
+TEST(EpochDomain, SynchronizeReclaimsRetired) {
+  std::atomic<int> live{0};
+  turbo::EpochDomain domain;
+  domain.Retire(new Tracked(1, &live));
+  domain.Retire(new Tracked(2, &live));
+  EXPECT_EQ(live.load(), 2);
+  domain.Synchronize();
+  EXPECT_EQ(live.load(), 0);
+}
+
+TEST(EpochDomain, DestructorReclaimsRetired) {
+  std::atomic<int> live{0};
+  {
+    turbo::EpochDomain domain;
+    domain.Retire(new Tracked(1, &live));
+    EXPECT_EQ(live.load(), 1);
+  }
+  EXPECT_EQ(live.load(), 0);
+}
+
+TEST(EpochDomain, PinnedReaderDelaysReclamation) {
+  std::atomic<int> live{0};
+  turbo::EpochDomain domain;
+  turbo::Notification pinned;
+  turbo::Notification release;
+
+  std::thread reader([&] {
+    turbo::EpochDomain::Guard guard = domain.Pin();
+    pinned.Notify();
+    release.WaitForNotification();
+  });
+  pinned.WaitForNotification();
+
+  domain.Retire(new Tracked(1, &live));
+  for (int i = 0; i < 10; ++i) {
+    domain.Reclaim();
+  }
+  EXPECT_EQ(live.load(), 1);
+
+  release.Notify();
+  reader.join();
+  domain.Synchronize();
+  EXPECT_EQ(live.load(), 0);
+}
+
+TEST(EpochDomain, NestedGuards) {
+  turbo::EpochDomain domain;
+  const uint64_t start = domain.epoch();
+  {
+    turbo::EpochDomain::Guard outer = domain.Pin();
+    {
+      turbo::EpochDomain::Guard inner = domain.Pin();
+    }
+    turbo::EpochDomain::Guard moved = std::move(outer);
+  }
+  domain.Synchronize();
+  EXPECT_GE(domain.epoch(), start + 2);
+}
+
+TEST(EpochDomain, ExitedThreadRetiredObjectsAreReclaimed) {
+  std::atomic<int> live{0};
+  turbo::EpochDomain domain;
+  std::thread t([&] { domain.Retire(new Tracked(1, &live)); });
+  t.join();
+  EXPECT_EQ(live.load(), 1);
+  domain.Synchronize();
+  EXPECT_EQ(live.load(), 0);
+}
+
+// Pins and retires from a thread_local destructor that runs after the thread's
+// own records were released.
+struct LateUser {
+  ~LateUser() {
+    for (int i = 0; i < 1000; ++i) {
+      turbo::EpochDomain::Guard guard = domain->Pin();
+    }
+    domain->Retire(new Tracked(1, live));
+  }
+  turbo::EpochDomain* domain = nullptr;
+  std::atomic<int>* live = nullptr;
+};
+
+TEST(EpochDomain, PinsAfterThreadRecordsAreReleasedAreNotLeaked) {
+  std::atomic<int> live{0};
+  turbo::EpochDomain domain;
+  std::thread t([&] {
+    // Constructed before the thread's records, so destroyed after them.
+    static thread_local LateUser late_user;
+    late_user.domain = &domain;
+    late_user.live = &live;
+    turbo::EpochDomain::Guard guard = domain.Pin();
+  });
+  t.join();
+  EXPECT_EQ(live.load(), 1);
+  domain.Synchronize();
+  EXPECT_EQ(live.load(), 0);
+}
+
+TEST(EpochDomain, ConcurrentReadersNeverSeeReclaimedObjects) {
+  constexpr int kReaders = 4;
+  constexpr int kUpdates = 20000;
+  std::atomic<int> live{0};
+  turbo::EpochDomain domain;
+  std::atomic<Tracked*> current{new Tracked(0, &live)};
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < kReaders; ++i) {
+    readers.emplace_back([&] {
+      while (!done.load(std::memory_order_relaxed)) {
+        turbo::EpochDomain::Guard guard = domain.Pin();
+        Tracked* t = current.load(std::memory_order_acquire);
+        ASSERT_GE(t->value, 0);
+      }
+    });
+  }
+
+  for (int i = 1; i <= kUpdates; ++i) {
+    Tracked* old = current.exchange(new Tracked(i, &live),
+                                    std::memory_order_acq_rel);
+    domain.Retire(old);
+  }
+  done.store(true);
+  for (auto& t : readers) {
+    t.join();
+  }
+  domain.Retire(current.exchange(nullptr));
+  domain.Synchronize();
+  EXPECT_EQ(live.load(), 0);
+}
+
+}  // namespace
@@ -0,0 +1,125 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/synchronization/hazard_pointer.h>
+
+#include <atomic>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+struct Tracked {
+  explicit Tracked(int v, std::atomic<int>* live) : value(v), live(live) {
+    live->fetch_add(1);
+  }
+  ~Tracked() {
+    value = -1;
+    live->fetch_sub(1);
+  }
+  int value;
+  std::atomic<int>* live;
+};
+
+TEST(HazardPointer, ProtectedObjectSurvivesReclaim) {
+  std::atomic<int> live{0};
+  turbo::HazardPointerDomain domain;
+  std::atomic<Tracked*> src{new Tracked(1, &live)};
+
+  turbo::HazardPointerDomain::Holder holder(&domain);
+  Tracked* t = holder.Protect(src);
+  ASSERT_EQ(t->value, 1);
+
+  domain.Retire(src.exchange(nullptr));
+  EXPECT_EQ(domain.Reclaim(), 0u);
+  EXPECT_EQ(live.load(), 1);
+  EXPECT_EQ(t->value, 1);
+
+  holder.Reset();
+  EXPECT_EQ(domain.Reclaim(), 1u);
+  EXPECT_EQ(live.load(), 0);
+}
+
+TEST(HazardPointer, TryProtectDetectsChange) {
+  std::atomic<int> live{0};
+  turbo::HazardPointerDomain domain;
+  Tracked* a = new Tracked(1, &live);
+  Tracked* b = new Tracked(2, &live);
+  std::atomic<Tracked*> src{b};
+
+  turbo::HazardPointerDomain::Holder holder(&domain);
+  Tracked* ptr = a;
+  EXPECT_FALSE(holder.TryProtect(ptr, src));
+  EXPECT_EQ(ptr, b);
+  EXPECT_TRUE(holder.TryProtect(ptr, src));
+  holder.Reset();
+
+  domain.Retire(a);
+  domain.Retire(b);
+  EXPECT_EQ(domain.Reclaim(), 2u);
+  EXPECT_EQ(live.load(), 0);
+}
+
+TEST(HazardPointer, SlotsAreReused) {
+  turbo::HazardPointerDomain domain;
+  std::atomic<int> dummy{0};
+  std::atomic<std::atomic<int>*> src{&dummy};
+  for (int i = 0; i < 100; ++i) {
+    turbo::HazardPointerDomain::Holder holder(&domain);
+    EXPECT_EQ(holder.Protect(src), &dummy);
+  }
+  turbo::HazardPointerDomain::Holder a(&domain);
+  turbo::HazardPointerDomain::Holder b = std::move(a);
+  EXPECT_EQ(b.Protect(src), &dummy);
+}
+
+TEST(HazardPointer, ConcurrentReadersNeverSeeReclaimedObjects) {
+  constexpr int kReaders = 4;
+  constexpr int kUpdates = 20000;
+  std::atomic<int> live{0};
+  turbo::HazardPointerDomain domain;
+  std::atomic<Tracked*> current{new Tracked(0, &live)};
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < kReaders; ++i) {
+    readers.emplace_back([&] {
+      turbo::HazardPointerDomain::Holder holder(&domain);
+      while (!done.load(std::memory_order_relaxed)) {
+        Tracked* t = holder.Protect(current);
+        ASSERT_GE(t->value, 0);
+        holder.Reset();
+      }
+    });
+  }
+
+  for (int i = 1; i <= kUpdates; ++i) {
+    domain.Retire(current.exchange(new Tracked(i, &live),
+                                   std::memory_order_acq_rel));
+  }
+  done.store(true);
+  for (auto& t : readers) {
+    t.join();
+  }
+  domain.Retire(current.exchange(nullptr));
+  domain.Reclaim();
+  EXPECT_EQ(live.load(), 0);
+}
+
+}  // namespace
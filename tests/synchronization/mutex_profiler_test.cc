@@ -0,0 +1,107 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/synchronization/mutex_profiler.h>
+
+#include <cstdint>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <turbo/synchronization/mutex.h>
+#include <turbo/synchronization/notification.h>
+#include <turbo/times/clock.h>
+
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::StartsWith;
+
+struct Totals {
+  int64_t count = 0;
+  int64_t wait_cycles = 0;
+  int64_t stacks = 0;
+};
+
+Totals CollectTotals() {
+  Totals t;
+  turbo::IterateMutexContentionProfile(
+      [&](const turbo::MutexContentionSample& s) {
+        t.count += s.count;
+        t.wait_cycles += s.wait_cycles;
+        ++t.stacks;
+        EXPECT_GT(s.depth, 0);
+      });
+  return t;
+}
+
+// Makes a second thread block on `mu` while this thread holds it, so that the
+// release below takes the slow path and reports contention.
+void ContendOnce(turbo::Mutex* mu) {
+  turbo::Notification started;
+  mu->Lock();
+  std::thread waiter([&] {
+    started.Notify();
+    turbo::MutexLock l(mu);
+  });
+  started.WaitForNotification();
+  turbo::sleep_for(turbo::Duration::milliseconds(20));
+  mu->Unlock();
+  waiter.join();
+}
+
+TEST(MutexProfiler, RecordsAndDumpsContention) {
+  turbo::SetMutexContentionSamplingPeriod(1);
+  EXPECT_EQ(turbo::GetMutexContentionSamplingPeriod(), 1);
+  turbo::ResetMutexContentionProfile();
+
+  turbo::Mutex mu;
+  for (int i = 0; i < 5; ++i) {
+    ContendOnce(&mu);
+  }
+
+  Totals t = CollectTotals();
+  EXPECT_GT(t.count, 0);
+  EXPECT_GT(t.wait_cycles, 0);
+  EXPECT_GE(t.stacks, 1);
+  // Every iteration releases from the same call site.
+  EXPECT_LE(t.stacks, t.count);
+
+  const std::string profile = turbo::DumpMutexContentionProfile();
+  EXPECT_THAT(profile, StartsWith("--- contention:\n"));
+  EXPECT_THAT(profile, HasSubstr("cycles/second = "));
+  EXPECT_THAT(profile, HasSubstr("sampling period = 1\n"));
+  EXPECT_THAT(profile, HasSubstr(" @ 0x"));
+
+  turbo::ResetMutexContentionProfile();
+  EXPECT_EQ(CollectTotals().count, 0);
+}
+
+TEST(MutexProfiler, DisabledRecordsNothing) {
+  turbo::SetMutexContentionSamplingPeriod(0);
+  turbo::ResetMutexContentionProfile();
+
+  turbo::Mutex mu;
+  for (int i = 0; i < 3; ++i) {
+    ContendOnce(&mu);
+  }
+  EXPECT_EQ(CollectTotals().count, 0);
+}
+
+}  // namespace
@@ -702,6 +702,28 @@ static void LockWhenTestWaitForIsCond(LockWhenTestStruct *s) {
   s->mu1.Unlock();
 }
 
+TEST(Mutex, AdaptiveSpinning) {
+  turbo::EnableMutexAdaptiveSpinning(true);
+  constexpr int kThreads = 8;
+  constexpr int kIterations = 20000;
+  turbo::Mutex mu;
+  int64_t counter = 0;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&] {
+      for (int j = 0; j < kIterations; ++j) {
+        turbo::MutexLock l(&mu);
+        ++counter;
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  turbo::EnableMutexAdaptiveSpinning(false);
+  EXPECT_EQ(counter, int64_t{kThreads} * kIterations);
+}
+
 TEST(Mutex, LockWhen) {
   LockWhenTestStruct s;
 
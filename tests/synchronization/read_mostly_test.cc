@@ -0,0 +1,116 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/synchronization/read_mostly.h>
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(ReadMostly, DefaultConstructed) {
+  turbo::ReadMostly<int> value;
+  EXPECT_EQ(*value.Read(), 0);
+}
+
+TEST(ReadMostly, StoreAndRead) {
+  turbo::ReadMostly<std::string> value("first");
+  EXPECT_EQ(*value.Read(), "first");
+  value.Store("second");
+  EXPECT_EQ(*value.Read(), "second");
+  EXPECT_EQ(value.With([](const std::string& s) { return s.size(); }), 6u);
+}
+
+TEST(ReadMostly, SnapshotIsStable) {
+  turbo::EpochDomain domain;
+  turbo::ReadMostly<std::string> value(std::string("old"), &domain);
+  {
+    auto snapshot = value.Read();
+    value.Store("new");
+    EXPECT_EQ(*snapshot, "old");
+    EXPECT_EQ(*value.Read(), "new");
+  }
+  value.Synchronize();
+}
+
+TEST(ReadMostly, UpdateAppliesToLatestValue) {
+  turbo::ReadMostly<std::map<std::string, int>> table;
+  table.Update([](std::map<std::string, int>& m) { m["a"] = 1; });
+  table.Update([](std::map<std::string, int>& m) { m["b"] = 2; });
+  auto snapshot = table.Read();
+  EXPECT_EQ(snapshot->size(), 2u);
+  EXPECT_EQ(snapshot->at("a"), 1);
+  EXPECT_EQ(snapshot->at("b"), 2);
+}
+
+TEST(ReadMostly, OldVersionsAreReclaimed) {
+  struct Counted {
+    explicit Counted(std::atomic<int>* live) : live(live) { live->fetch_add(1); }
+    Counted(const Counted& other) : live(other.live) { live->fetch_add(1); }
+    ~Counted() { live->fetch_sub(1); }
+    std::atomic<int>* live;
+  };
+
+  std::atomic<int> live{0};
+  turbo::EpochDomain domain;
+  {
+    turbo::ReadMostly<Counted> value(std::make_unique<Counted>(&live), &domain);
+    for (int i = 0; i < 10; ++i) {
+      value.Store(std::make_unique<Counted>(&live));
+    }
+    value.Synchronize();
+    EXPECT_EQ(live.load(), 1);
+  }
+  EXPECT_EQ(live.load(), 0);
+}
+
+TEST(ReadMostly, ConcurrentReadersAndWriters) {
+  constexpr int kReaders = 4;
+  constexpr int kUpdates = 5000;
+  // Every published vector holds `n` copies of `n`, so a torn or freed value
+  // is detected by the readers.
+  turbo::ReadMostly<std::vector<int>> value(std::vector<int>{});
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < kReaders; ++i) {
+    readers.emplace_back([&] {
+      while (!done.load(std::memory_order_relaxed)) {
+        auto snapshot = value.Read();
+        const int n = static_cast<int>(snapshot->size());
+        for (int v : *snapshot) {
+          ASSERT_EQ(v, n);
+        }
+      }
+    });
+  }
+  for (int n = 1; n <= kUpdates; ++n) {
+    value.Store(std::vector<int>(n % 64, n % 64));
+  }
+  done.store(true);
+  for (auto& t : readers) {
+    t.join();
+  }
+  value.Synchronize();
+}
+
+}  // namespace
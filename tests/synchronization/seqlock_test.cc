@@ -0,0 +1,138 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/synchronization/seqlock.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+struct Small {
+  int32_t a;
+  int16_t b;
+};
+
+// Larger than a cache line and not a multiple of eight bytes.
+struct Large {
+  std::array<uint32_t, 37> values;
+};
+
+Large MakeLarge(uint32_t v) {
+  Large l;
+  l.values.fill(v);
+  return l;
+}
+
+bool IsConsistent(const Large& l) {
+  for (uint32_t v : l.values) {
+    if (v != l.values[0]) return false;
+  }
+  return true;
+}
+
+TEST(SeqLock, LoadReturnsStoredValue) {
+  turbo::SeqLock<Small> lock(Small{1, 2});
+  EXPECT_EQ(lock.Load().a, 1);
+  EXPECT_EQ(lock.Load().b, 2);
+  EXPECT_EQ(lock.version(), 0u);
+
+  lock.Store(Small{3, 4});
+  Small s;
+  ASSERT_TRUE(lock.TryLoad(&s));
+  EXPECT_EQ(s.a, 3);
+  EXPECT_EQ(s.b, 4);
+  EXPECT_EQ(lock.version(), 1u);
+}
+
+TEST(SeqLock, UpdateBatchesFieldWrites) {
+  turbo::SeqLock<Small> lock;
+  lock.Update([](Small& s) {
+    s.a = 10;
+    s.b = 20;
+  });
+  lock.Update([](Small& s) { s.a += 1; });
+  EXPECT_EQ(lock.version(), 2u);
+  EXPECT_EQ(lock.Load().a, 11);
+  EXPECT_EQ(lock.Load().b, 20);
+}
+
+TEST(SeqLock, ConcurrentReadersSeeConsistentSnapshots) {
+  constexpr int kReaders = 4;
+  constexpr uint32_t kWrites = 100000;
+  turbo::SeqLock<Large> lock(MakeLarge(0));
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < kReaders; ++i) {
+    readers.emplace_back([&] {
+      uint32_t last = 0;
+      while (!done.load(std::memory_order_relaxed)) {
+        Large l = lock.Load();
+        ASSERT_TRUE(IsConsistent(l));
+        ASSERT_GE(l.values[0], last);
+        last = l.values[0];
+      }
+    });
+  }
+  for (uint32_t i = 1; i <= kWrites; ++i) {
+    lock.Store(MakeLarge(i));
+  }
+  done.store(true);
+  for (auto& t : readers) {
+    t.join();
+  }
+  EXPECT_EQ(lock.Load().values[0], kWrites);
+}
+
+TEST(MultiWriterSeqLock, ConcurrentWriters) {
+  constexpr int kWriters = 4;
+  constexpr int kIncrements = 10000;
+  turbo::MultiWriterSeqLock<Large> lock(MakeLarge(0));
+  std::atomic<bool> done{false};
+
+  std::thread reader([&] {
+    while (!done.load(std::memory_order_relaxed)) {
+      ASSERT_TRUE(IsConsistent(lock.Load()));
+    }
+  });
+  std::vector<std::thread> writers;
+  for (int i = 0; i < kWriters; ++i) {
+    writers.emplace_back([&] {
+      for (int j = 0; j < kIncrements; ++j) {
+        lock.Update([](Large& l) {
+          for (uint32_t& v : l.values) ++v;
+        });
+      }
+    });
+  }
+  for (auto& t : writers) {
+    t.join();
+  }
+  done.store(true);
+  reader.join();
+
+  EXPECT_EQ(lock.Load().values[0], uint32_t{kWriters * kIncrements});
+  EXPECT_EQ(lock.version(), uint64_t{kWriters * kIncrements});
+}
+
+}  // namespace
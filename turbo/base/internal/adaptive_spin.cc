@@ -0,0 +1,36 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/base/internal/adaptive_spin.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+namespace base_internal {
+
+#ifdef TURBO_INTERNAL_NEED_REDUNDANT_CONSTEXPR_DECL
+constexpr size_t AdaptiveSpin::kNumStripes;
+constexpr int AdaptiveSpin::kMinSpins;
+constexpr uint32_t AdaptiveSpin::kProbePeriod;
+#endif
+
+TURBO_CONST_INIT std::atomic<bool> AdaptiveSpin::enabled_{false};
+TURBO_CONST_INIT std::atomic<int32_t>
+    AdaptiveSpin::estimates_[AdaptiveSpin::kNumStripes] = {};
+
+}  // namespace base_internal
+TURBO_NAMESPACE_END
+}  // namespace turbo
@@ -0,0 +1,121 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// Adaptive spin budgets shared by `SpinLock` and `turbo::Mutex`.
+//
+// Both locks spin a fixed number of iterations before they park the calling
+// thread. That is a good trade when critical sections are short, and wasted
+// CPU when they are long: every waiter burns the whole budget and then sleeps
+// anyway. When adaptive spinning is enabled, each lock instead learns how long
+// spinning usually takes to succeed, in the style of glibc's
+// PTHREAD_MUTEX_ADAPTIVE_NP:
+//
+//   * A spin that sees the lock released after `n` iterations moves the
+//     estimate 1/8 of the way towards `n`.
+//   * A spin that gives up decays the estimate towards zero.
+//   * The next spin is bounded by twice the estimate plus a small floor, and
+//     one in every `kProbePeriod` spins of a thread uses the full budget so
+//     that a lock whose critical sections got shorter can recover.
+//
+// Neither lock has room for extra state, so estimates live in a table of
+// counters indexed by the lock address. Unrelated locks may share a counter;
+// that only costs accuracy. All updates are plain relaxed loads and stores and
+// happen only on contended paths.
+//
+// This file is internal-only; use `turbo::EnableMutexAdaptiveSpinning()`.
+
+#ifndef TURBO_BASE_INTERNAL_ADAPTIVE_SPIN_H_
+#define TURBO_BASE_INTERNAL_ADAPTIVE_SPIN_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <turbo/base/attributes.h>
+#include <turbo/base/config.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+namespace base_internal {
+
+class AdaptiveSpin {
+ public:
+  // Number of estimate counters.
+  static constexpr size_t kNumStripes = 256;
+  // Spins allowed even for locks that never succeed by spinning; enough to
+  // catch a release that is already in flight.
+  static constexpr int kMinSpins = 16;
+  // One in this many spins of each thread probes with the full budget.
+  static constexpr uint32_t kProbePeriod = 16;
+
+  static bool enabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+  static void set_enabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+
+  // Returns the number of spin iterations to attempt for `lock`, at most
+  // `max_spins`.
+  static int SpinLimit(const void* lock, int max_spins) {
+    static TURBO_CONST_INIT thread_local uint32_t spins_since_probe = 0;
+    if (++spins_since_probe >= kProbePeriod) {
+      spins_since_probe = 0;
+      return max_spins;
+    }
+    const int32_t stored = Stripe(lock).load(std::memory_order_relaxed);
+    // Zero means no history; start out with the full budget.
+    if (stored == 0) return max_spins;
+    const int32_t limit = 2 * (stored - 1) + kMinSpins;
+    return limit < max_spins ? limit : max_spins;
+  }
+
+  // Records that the lock was seen released after `spins` iterations.
+  static void RecordSuccess(const void* lock, int spins) {
+    std::atomic<int32_t>& stripe = Stripe(lock);
+    const int32_t stored = stripe.load(std::memory_order_relaxed);
+    int32_t estimate = stored == 0 ? spins : stored - 1;
+    estimate += (spins - estimate) / 8;
+    stripe.store(estimate + 1, std::memory_order_relaxed);
+  }
+
+  // Records that the lock was still held after `spins` iterations.
+  static void RecordFailure(const void* lock, int spins) {
+    std::atomic<int32_t>& stripe = Stripe(lock);
+    const int32_t stored = stripe.load(std::memory_order_relaxed);
+    int32_t estimate = stored == 0 ? spins : stored - 1;
+    estimate -= estimate / 8 + 1;
+    stripe.store((estimate < 0 ? 0 : estimate) + 1, std::memory_order_relaxed);
+  }
+
+ private:
+  static std::atomic<int32_t>& Stripe(const void* lock) {
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(lock);
+    // Locks are at least word aligned; Fibonacci hashing spreads neighbours.
+    const uint64_t h = static_cast<uint64_t>(addr >> 3) * 0x9E3779B97F4A7C15ull;
+    return estimates_[h >> (64 - 8)];
+  }
+  static_assert(kNumStripes == 256, "Stripe() assumes 8 index bits");
+
+  static std::atomic<bool> enabled_;
+  static std::atomic<int32_t> estimates_[kNumStripes];
+};
+
+}  // namespace base_internal
+TURBO_NAMESPACE_END
+}  // namespace turbo
+
+#endif  // TURBO_BASE_INTERNAL_ADAPTIVE_SPIN_H_
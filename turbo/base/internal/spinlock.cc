@@ -23,6 +23,7 @@
 
 #include <turbo/base/attributes.h>
 #include <turbo/base/config.h>
+#include <turbo/base/internal/adaptive_spin.h>
 #include <turbo/base/internal/atomic_hook.h>
 #include <turbo/base/internal/cycleclock.h>
 #include <turbo/base/internal/spinlock_wait.h>
@@ -86,8 +87,9 @@ SpinLock::SpinLock(base_internal::SchedulingMode mode)
 }
 
 // Monitor the lock to see if its value changes within some time period
-// (adaptive_spin_count loop iterations). The last value read from the lock
-// is returned from the method.
+// (adaptive_spin_count loop iterations, or the learned budget of this lock
+// when adaptive spinning is enabled). The last value read from the lock is
+// returned from the method.
 uint32_t SpinLock::SpinLoop() {
   // We are already in the slow path of SpinLock, initialize the
   // adaptive_spin_count here.
@@ -97,11 +99,22 @@ uint32_t SpinLock::SpinLoop() {
     adaptive_spin_count = base_internal::NumCPUs() > 1 ? 1000 : 1;
   });
 
-  int c = adaptive_spin_count;
+  const bool adaptive = adaptive_spin_count > 1 && AdaptiveSpin::enabled();
+  const int limit = adaptive
+                        ? AdaptiveSpin::SpinLimit(this, adaptive_spin_count)
+                        : adaptive_spin_count;
+  int c = limit;
   uint32_t lock_value;
   do {
     lock_value = lockword_.load(std::memory_order_relaxed);
   } while ((lock_value & kSpinLockHeld) != 0 && --c > 0);
+  if (adaptive) {
+    if ((lock_value & kSpinLockHeld) == 0) {
+      AdaptiveSpin::RecordSuccess(this, limit - c);
+    } else {
+      AdaptiveSpin::RecordFailure(this, limit);
+    }
+  }
   return lock_value;
 }
 
@@ -0,0 +1,273 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <turbo/base/optimization.h>
+#include <turbo/container/intrusive_list.h>
+#include <turbo/synchronization/mutex.h>
+#include <turbo/times/time.h>
+
+namespace turbo {
+
+    namespace container_internal {
+
+        // The queue reuses `intrusive_list_node::next` as the producer link. While a
+        // node is owned by the queue the field is only accessed atomically.
+        static_assert(sizeof(std::atomic<intrusive_list_node *>) == sizeof(intrusive_list_node *),
+                      "intrusive_mpsc_queue requires lock-free pointer atomics");
+
+        inline std::atomic<intrusive_list_node *> *mpsc_link(intrusive_list_node *node) noexcept {
+            return reinterpret_cast<std::atomic<intrusive_list_node *> *>(&node->next);
+        }
+
+        // Marks a node that has been published to the queue head but whose link to
+        // the previously pushed node is not written yet.
+        inline intrusive_list_node *mpsc_unlinked() noexcept {
+            return reinterpret_cast<intrusive_list_node *>(uintptr_t{1});
+        }
+
+    }  // namespace container_internal
+
+    /**
+     * @ingroup turbo_container_sequence
+     * @brief intrusive_mpsc_queue is an unbounded multi-producer single-consumer queue whose
+     *        elements inherit from intrusive_list_node, so enqueueing never allocates.
+     *        A producer publishes an element with a single atomic exchange; the consumer
+     *        detaches everything that has been pushed so far with another exchange and
+     *        receives it as an intrusive_list in FIFO order (per producer).
+     *
+     *        push() reports whether the queue went from empty to non-empty, which is the
+     *        only point at which a sleeping consumer has to be woken up. See
+     *        blocking_intrusive_mpsc_queue for a ready-made consumer wake-up.
+     *
+     *        Like intrusive_list, the queue does not own its elements. An element must not
+     *        be in any other list while it is queued, and must stay alive until the
+     *        consumer has popped it.
+     *        Example usage:
+     *        @code
+     *        struct Message : public turbo::intrusive_list_node {
+     *            int payload;
+     *        };
+     *        turbo::intrusive_mpsc_queue<Message> mailbox;
+     *        // any thread
+     *        mailbox.push(*msg);
+     *        // consumer thread
+     *        mailbox.consume_all([](Message *m) { handle(m); });
+     *        @endcode
+     * @tparam T element type, must inherit from intrusive_list_node
+     */
+    template<typename T = intrusive_list_node>
+    class intrusive_mpsc_queue {
+    public:
+        typedef T value_type;
+        typedef T &reference;
+        typedef T *pointer;
+        typedef size_t size_type;
+
+    public:
+        intrusive_mpsc_queue() = default;
+
+        intrusive_mpsc_queue(const intrusive_mpsc_queue &) = delete;
+
+        intrusive_mpsc_queue &operator=(const intrusive_mpsc_queue &) = delete;
+
+        ~intrusive_mpsc_queue() {
+            assert(empty() && "intrusive_mpsc_queue destroyed with queued elements");
+        }
+
+        /**
+         * @brief Enqueues an element; wait-free, callable from any thread.
+         * @param x the element, which must not be in any list.
+         * @return true if the queue was empty before this push, i.e. the consumer may be
+         *         idle and should be woken up.
+         */
+        bool push(value_type &x) noexcept;
+
+        /**
+         * @brief Returns true if no element is queued. May be called from any thread, but
+         *        the answer is only a snapshot unless called by the consumer.
+         */
+        [[nodiscard]] bool empty() const noexcept {
+            return head_.load(std::memory_order_acquire) == nullptr;
+        }
+
+        /**
+         * @brief Detaches all queued elements and appends them to `out` in push order.
+         *        Must only be called by the consumer.
+         * @param out destination list
+         * @return the number of elements moved to `out`.
+         */
+        size_type pop_all(intrusive_list<T> &out);
+
+        /**
+         * @brief Detaches all queued elements and invokes `f(T*)` on each one in push order.
+         *        An element is unlinked before `f` sees it, so `f` may push it again or
+         *        destroy it. Must only be called by the consumer.
+         * @return the number of elements consumed.
+         */
+        template<typename F>
+        size_type consume_all(F &&f);
+
+    private:
+        static intrusive_list_node *wait_link(intrusive_list_node *node);
+
+        // Most recently pushed element; older elements are reachable through the
+        // producer links, nullptr when the queue is empty.
+        std::atomic<intrusive_list_node *> head_{nullptr};
+    };
+
+    /**
+     * @ingroup turbo_container_sequence
+     * @brief blocking_intrusive_mpsc_queue is an intrusive_mpsc_queue whose consumer can
+     *        sleep while the queue is empty. Producers only touch the internal mutex on the
+     *        empty to non-empty transition, so a busy consumer costs them nothing beyond the
+     *        atomic exchange of intrusive_mpsc_queue::push().
+     * @tparam T element type, must inherit from intrusive_list_node
+     */
+    template<typename T = intrusive_list_node>
+    class blocking_intrusive_mpsc_queue {
+    public:
+        typedef T value_type;
+        typedef size_t size_type;
+
+    public:
+        blocking_intrusive_mpsc_queue() = default;
+
+        blocking_intrusive_mpsc_queue(const blocking_intrusive_mpsc_queue &) = delete;
+
+        blocking_intrusive_mpsc_queue &operator=(const blocking_intrusive_mpsc_queue &) = delete;
+
+        /**
+         * @brief Enqueues an element and wakes the consumer if the queue was empty.
+         * @return true if the queue was empty before this push.
+         */
+        bool push(value_type &x) {
+            if (!queue_.push(x)) {
+                return false;
+            }
+            // Releasing the mutex re-evaluates the consumer's wait condition.
+            turbo::MutexLock lock(&mu_);
+            return true;
+        }
+
+        [[nodiscard]] bool empty() const noexcept { return queue_.empty(); }
+
+        /**
+         * @brief Non-blocking drain, see intrusive_mpsc_queue::pop_all().
+         */
+        size_type pop_all(intrusive_list<T> &out) { return queue_.pop_all(out); }
+
+        /**
+         * @brief Blocks until at least one element is queued, then drains the queue into `out`.
+         * @return the number of elements moved to `out`, never zero.
+         */
+        size_type wait_pop_all(intrusive_list<T> &out) {
+            if (queue_.empty()) {
+                turbo::MutexLock lock(&mu_);
+                mu_.Await(turbo::Condition(this, &blocking_intrusive_mpsc_queue::has_items));
+            }
+            return queue_.pop_all(out);
+        }
+
+        /**
+         * @brief Like wait_pop_all(), but gives up once `timeout` has elapsed.
+         * @return the number of elements moved to `out`, zero on timeout.
+         */
+        size_type wait_pop_all_with_timeout(intrusive_list<T> &out, turbo::Duration timeout) {
+            if (queue_.empty()) {
+                turbo::MutexLock lock(&mu_);
+                if (!mu_.AwaitWithTimeout(
+                        turbo::Condition(this, &blocking_intrusive_mpsc_queue::has_items), timeout)) {
+                    return 0;
+                }
+            }
+            return queue_.pop_all(out);
+        }
+
+    private:
+        bool has_items() const { return !queue_.empty(); }
+
+        intrusive_mpsc_queue<T> queue_;
+        mutable turbo::Mutex mu_;
+    };
+
+    ///////////////////////////////////////////////////////////////////////
+    // intrusive_mpsc_queue
+    ///////////////////////////////////////////////////////////////////////
+
+    template<typename T>
+    inline bool intrusive_mpsc_queue<T>::push(value_type &x) noexcept {
+        intrusive_list_node *node = &x;
+        container_internal::mpsc_link(node)->store(container_internal::mpsc_unlinked(),
+                                                   std::memory_order_relaxed);
+        intrusive_list_node *prev = head_.exchange(node, std::memory_order_acq_rel);
+        // The consumer spins on the unlinked marker for the short window between the
+        // exchange above and this store.
+        container_internal::mpsc_link(node)->store(prev, std::memory_order_release);
+        return prev == nullptr;
+    }
+
+    template<typename T>
+    inline intrusive_list_node *intrusive_mpsc_queue<T>::wait_link(intrusive_list_node *node) {
+        intrusive_list_node *link = container_internal::mpsc_link(node)->load(std::memory_order_acquire);
+        for (int spins = 0; TURBO_UNLIKELY(link == container_internal::mpsc_unlinked()); ++spins) {
+            // The producer was preempted between its exchange and its link store.
+            if (spins > 64) {
+                std::this_thread::yield();
+            }
+            link = container_internal::mpsc_link(node)->load(std::memory_order_acquire);
+        }
+        return link;
+    }
+
+    template<typename T>
+    inline typename intrusive_mpsc_queue<T>::size_type intrusive_mpsc_queue<T>::pop_all(intrusive_list<T> &out) {
+        intrusive_list_node *node = head_.exchange(nullptr, std::memory_order_acquire);
+        // The detached chain runs from the newest to the oldest element, so insert each
+        // one in front of the previously inserted one to restore push order.
+        typename intrusive_list<T>::iterator pos = out.end();
+        size_type n = 0;
+        while (node != nullptr) {
+            intrusive_list_node *older = wait_link(node);
+            pos = out.insert(pos, *static_cast<T *>(node));
+            node = older;
+            ++n;
+        }
+        return n;
+    }
+
+    template<typename T>
+    template<typename F>
+    inline typename intrusive_mpsc_queue<T>::size_type intrusive_mpsc_queue<T>::consume_all(F &&f) {
+        intrusive_list<T> batch;
+        const size_type n = pop_all(batch);
+        while (!batch.empty()) {
+            T &x = batch.front();
+            batch.pop_front();
+            x.next = x.prev = &x;
+            f(&x);
+        }
+        return n;
+    }
+
+}  // namespace turbo
@@ -224,6 +224,40 @@ CpuType GetCpuType() {
 
 bool SupportsArmCRC32PMULL() { return false; }
 
+bool SupportsX86SSSE3() {
+  int cpu_info[4];
+  __cpuid(cpu_info, 1);
+  return (cpu_info[2] & (1 << 9)) != 0;
+}
+
+bool SupportsX86AVX2() {
+  int cpu_info[4];
+  __cpuid(cpu_info, 0);
+  if (cpu_info[0] < 7) {
+    return false;
+  }
+  // The OS must save the YMM registers: OSXSAVE, then XCR0 bits 1 and 2.
+  __cpuid(cpu_info, 1);
+  constexpr int kOsxsave = 1 << 27;
+  constexpr int kAvx = 1 << 28;
+  if ((cpu_info[2] & (kOsxsave | kAvx)) != (kOsxsave | kAvx)) {
+    return false;
+  }
+#if defined(_MSC_VER) && !defined(__clang__)
+  const uint64_t xcr0 = _xgetbv(0);
+#else
+  uint32_t xcr0_low;
+  uint32_t xcr0_high;
+  __asm__ volatile("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+  const uint64_t xcr0 = (uint64_t{xcr0_high} << 32) | xcr0_low;
+#endif
+  if ((xcr0 & 0x6) != 0x6) {
+    return false;
+  }
+  __cpuid(cpu_info, 7);
+  return (cpu_info[1] & (1 << 5)) != 0;
+}
+
 #elif defined(__aarch64__) && defined(__linux__)
 
 #ifndef HWCAP_CPUID
@@ -276,12 +310,20 @@ bool SupportsArmCRC32PMULL() {
   return (hwcaps & HWCAP_CRC32) && (hwcaps & HWCAP_PMULL);
 }
 
+bool SupportsX86SSSE3() { return false; }
+
+bool SupportsX86AVX2() { return false; }
+
 #else
 
 CpuType GetCpuType() { return CpuType::kUnknown; }
 
 bool SupportsArmCRC32PMULL() { return false; }
 
+bool SupportsX86SSSE3() { return false; }
+
+bool SupportsX86AVX2() { return false; }
+
 #endif
 
 }  // namespace crc_internal
@@ -57,5 +57,11 @@ CpuType GetCpuType();
 // tuning.
 bool SupportsArmCRC32PMULL();
 
+// Returns whether the host CPU, and the OS for AVX2, support the x86 SSSE3 and
+// AVX2 instructions, for code built without them that selects an
+// implementation at runtime.
+bool SupportsX86SSSE3();
+bool SupportsX86AVX2();
+
 }  // namespace crc_internal
 }  // namespace turbo
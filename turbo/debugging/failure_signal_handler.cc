@@ -73,6 +73,48 @@ TURBO_NAMESPACE_BEGIN
 
 TURBO_CONST_INIT static FailureSignalHandlerOptions fsh_options;
 
+// The flushers registered by `RegisterFailureSignalFlusher()`. A slot is
+// claimed by its `arg` and published by its `flush`.
+struct FailureSignalFlusher {
+  std::atomic<void (*)(void*)> flush;
+  std::atomic<void*> arg;
+};
+static constexpr int kMaxFailureSignalFlushers = 8;
+TURBO_CONST_INIT static FailureSignalFlusher
+    failure_signal_flushers[kMaxFailureSignalFlushers];
+
+bool RegisterFailureSignalFlusher(void (*flush)(void*), void* arg) {
+  for (auto& flusher : failure_signal_flushers) {
+    void* expected = nullptr;
+    if (flusher.arg.compare_exchange_strong(expected, arg,
+                                            std::memory_order_acq_rel)) {
+      flusher.flush.store(flush, std::memory_order_release);
+      return true;
+    }
+  }
+  return false;
+}
+
+void UnregisterFailureSignalFlusher(void (*flush)(void*), void* arg) {
+  for (auto& flusher : failure_signal_flushers) {
+    if (flusher.arg.load(std::memory_order_acquire) == arg &&
+        flusher.flush.load(std::memory_order_relaxed) == flush) {
+      flusher.flush.store(nullptr, std::memory_order_release);
+      flusher.arg.store(nullptr, std::memory_order_release);
+      return;
+    }
+  }
+}
+
+static void RunFailureSignalFlushers() {
+  for (auto& flusher : failure_signal_flushers) {
+    auto flush = flusher.flush.load(std::memory_order_acquire);
+    if (flush != nullptr) {
+      flush(flusher.arg.load(std::memory_order_relaxed));
+    }
+  }
+}
+
 // Resets the signal handler for signo to the default action for that
 // signal, then raises the signal.
 static void RaiseToDefaultHandler(int signo) {
@@ -382,6 +424,7 @@ static void TurboFailureSignalHandler(int signo, siginfo_t*, void* ucontext) {
       signo, ucontext, my_cpu, +[](const char* data) {
         turbo::raw_log_internal::AsyncSignalSafeWriteError(data, strlen(data));
       });
+  RunFailureSignalFlushers();
 
   // Riskier code (because it is less likely to be async-signal-safe)
   // goes after this point.
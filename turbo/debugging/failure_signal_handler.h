@@ -114,6 +114,21 @@ struct FailureSignalHandlerOptions {
 // change.
 void InstallFailureSignalHandler(const FailureSignalHandlerOptions& options);
 
+// RegisterFailureSignalFlusher()
+//
+// Registers `flush(arg)` to be called by the failure signal handler right
+// after it has written the failure data to stderr, so that components keeping
+// data in memory, such as a memory-mapped log, can make it durable before the
+// program terminates. `flush` runs within a signal handler and should be
+// async-signal-safe. `arg` must not be null. Returns false if too many
+// flushers are registered already.
+bool RegisterFailureSignalFlusher(void (*flush)(void*), void* arg);
+
+// UnregisterFailureSignalFlusher()
+//
+// Removes a flusher registered by `RegisterFailureSignalFlusher()`.
+void UnregisterFailureSignalFlusher(void (*flush)(void*), void* arg);
+
 namespace debugging_internal {
 const char* FailureSignalToString(int signo);
 }  // namespace debugging_internal
@@ -26,6 +26,7 @@
 #include <cstring>
 
 #include <turbo/base/optimization.h>
+#include <turbo/synchronization/seqlock.h>
 
 namespace turbo::flags_internal {
 
@@ -54,6 +55,9 @@ namespace turbo::flags_internal {
     // Seqlocks Get Along With Programming Language Memory Models?"[1] by Hans J.
     // Boehm for more details.
     //
+    // The general-purpose, typed variant of this lock is `turbo::SeqLock<T>` in
+    // turbo/synchronization/seqlock.h, which shares the copy routines.
+    //
     // [1] https://www.hpl.hp.com/techreports/2012/HPL-2012-68.pdf
     class SequenceLock {
     public:
@@ -138,42 +142,14 @@ namespace turbo::flags_internal {
         }
 
     private:
-        // Perform the equivalent of "memcpy(dst, src, size)", but using relaxed
-        // atomics.
         static void RelaxedCopyFromAtomic(void *dst, const std::atomic<uint64_t> *src,
                                           size_t size) {
-            char *dst_byte = static_cast<char *>(dst);
-            while (size >= sizeof(uint64_t)) {
-                uint64_t word = src->load(std::memory_order_relaxed);
-                std::memcpy(dst_byte, &word, sizeof(word));
-                dst_byte += sizeof(word);
-                src++;
-                size -= sizeof(word);
-            }
-            if (size > 0) {
-                uint64_t word = src->load(std::memory_order_relaxed);
-                std::memcpy(dst_byte, &word, size);
-            }
+            synchronization_internal::RelaxedCopyFromAtomic(dst, src, size);
         }
 
-        // Perform the equivalent of "memcpy(dst, src, size)", but using relaxed
-        // atomics.
         static void RelaxedCopyToAtomic(std::atomic<uint64_t> *dst, const void *src,
                                         size_t size) {
-            const char *src_byte = static_cast<const char *>(src);
-            while (size >= sizeof(uint64_t)) {
-                uint64_t word;
-                std::memcpy(&word, src_byte, sizeof(word));
-                dst->store(word, std::memory_order_relaxed);
-                src_byte += sizeof(word);
-                dst++;
-                size -= sizeof(word);
-            }
-            if (size > 0) {
-                uint64_t word = 0;
-                std::memcpy(&word, src_byte, size);
-                dst->store(word, std::memory_order_relaxed);
-            }
+            synchronization_internal::RelaxedCopyToAtomic(dst, src, size);
         }
 
         static constexpr int64_t kUninitialized = -1;
@@ -0,0 +1,121 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+// File: log/deferred_log.h
+// -----------------------------------------------------------------------------
+//
+// This header declares `LOG_DEFERRED`, a logging macro that moves formatting
+// off the calling thread.
+//
+// `LOG_DEFERRED` takes a `turbo::str_format` format string literal and its
+// arguments.  While deferred logging is active, a call only appends the id of
+// the call site, a timestamp and the raw argument values to a buffer owned by
+// the calling thread.  A background thread later either formats the records
+// and hands them to the registered `turbo::LogSink`s like `LOG` would, or
+// writes them unformatted to a file which `decode_deferred_log()` (or
+// `tools/deferred_log_decode`) turns into text offline.
+//
+// Example:
+//
+//   turbo::start_deferred_logging();
+//   LOG_DEFERRED(INFO, "request %d from %s took %.3fms", id, peer, ms);
+//
+// Trade-offs compared to `LOG`:
+//
+//   * Arguments are limited to integers, enums, `bool`, floating-point values,
+//     strings (truncated to 1KB) and pointers.  The format string is only
+//     checked when the record is formatted.
+//   * Only `INFO`, `WARNING` and `ERROR` are supported.
+//   * Records are formatted with the thread id and timestamp of the call, but
+//     records of different threads may reach sinks out of order.
+//   * If a thread outpaces the background thread, its buffer fills up and
+//     further records are dropped (see `deferred_log_stats()`) rather than
+//     blocking the caller.
+//
+// While deferred logging is inactive, `LOG_DEFERRED` formats and logs
+// immediately.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <turbo/base/config.h>
+#include <turbo/log/internal/deferred_log.h>
+#include <turbo/strings/string_view.h>
+#include <turbo/times/time.h>
+
+// LOG_DEFERRED()
+//
+// `LOG_DEFERRED(severity, format, args...)` logs `turbo::str_format(format,
+// args...)` at `severity`, formatting it later if deferred logging is active.
+#define LOG_DEFERRED(severity, ...) \
+  TURBO_LOG_INTERNAL_DEFERRED_IMPL(_##severity, __VA_ARGS__)
+
+namespace turbo {
+    TURBO_NAMESPACE_BEGIN
+
+    struct DeferredLogOptions {
+        // Size in bytes of each thread's staging buffer, rounded up to a power
+        // of two.  A record takes a few bytes per argument plus the string
+        // contents.
+        size_t thread_buffer_size = 1 << 20;
+        // How often the background thread drains the staging buffers.
+        turbo::Duration drain_interval = turbo::Duration::milliseconds(10);
+        // When non-empty, records are appended unformatted to this file instead
+        // of being formatted and sent to the registered sinks.
+        std::string binary_path;
+    };
+
+    // start_deferred_logging()
+    //
+    // Makes `LOG_DEFERRED` record into per-thread buffers and starts the
+    // background thread.  Returns false if deferred logging is already active
+    // or `options.binary_path` cannot be opened.
+    bool start_deferred_logging(const DeferredLogOptions &options = DeferredLogOptions());
+
+    // stop_deferred_logging()
+    //
+    // Delivers every record made so far and stops the background thread.
+    // `LOG_DEFERRED` formats immediately again afterwards.
+    void stop_deferred_logging();
+
+    // flush_deferred_log()
+    //
+    // Returns once every record made before the call has been delivered to the
+    // sinks or written to the binary file.
+    void flush_deferred_log();
+
+    struct DeferredLogStats {
+        // Records formatted or written by the background thread.
+        uint64_t delivered;
+        // Records dropped because a staging buffer was full.
+        uint64_t dropped;
+    };
+
+    DeferredLogStats deferred_log_stats();
+
+    // decode_deferred_log()
+    //
+    // Formats a binary file written by the background thread as one line per
+    // record, with the same prefix as `LOG`.  Returns false, after appending
+    // what could be decoded, if `data` is not a deferred log or is truncated.
+    bool decode_deferred_log(std::string_view data, std::string *out);
+
+    TURBO_NAMESPACE_END
+}  // namespace turbo
@@ -171,6 +171,20 @@ TURBO_FLAG(int, log_max_files, 0, "The max files to keep.");
 
 TURBO_FLAG(int, log_max_file_size, 100, "The max file size to rotate. unit is MB.");
 
+TURBO_FLAG(bool, log_batch_write, false,
+           "Buffer log files in aligned blocks and write them in batches"
+           " with writev or io_uring.");
+
+TURBO_FLAG(bool, log_direct_io, false,
+           "Open batch written log files with O_DIRECT.");
+
+TURBO_FLAG(int, log_sync_interval_ms, 0,
+           "The interval to fdatasync batch written log files, 0 to never sync.");
+
+TURBO_FLAG(std::string, log_compression, "",
+           "Compress the log files of the file sinks with lz4: \"rotated\" once they"
+           " are rotated away, \"live\" while they are written, empty for none.");
+
 TURBO_FLAG(int, log_type, 0, "The log type corresponding to LogSinkType."
                              " 0: console log"
                              " 1: daily log file"
@@ -100,6 +100,22 @@ TURBO_DECLARE_FLAG(int, log_max_files);
 // used by rotating log file.
 TURBO_DECLARE_FLAG(int, log_max_file_size);
 
+// Log file writer options. buffer log files in aligned blocks and
+// write them in batches instead of through stdio.
+TURBO_DECLARE_FLAG(bool, log_batch_write);
+
+// open batch written log files with O_DIRECT.
+TURBO_DECLARE_FLAG(bool, log_direct_io);
+
+// fdatasync batch written log files from a background thread
+// at this interval in milliseconds, 0 to never sync.
+TURBO_DECLARE_FLAG(int, log_sync_interval_ms);
+
+// lz4 compress the log files of the file sinks: "rotated" once
+// they are rotated away, "live" while they are written, empty for
+// no compression.
+TURBO_DECLARE_FLAG(std::string, log_compression);
+
 // Log type, 0: console log
 // 1: daily log file
 // 2: hourly log file
@@ -30,6 +30,7 @@
 #include <turbo/base/internal/raw_logging.h>
 #include <turbo/base/log_severity.h>
 #include <turbo/hash/hash.h>
+#include <turbo/log/internal/conditions.h>
 #include <turbo/strings/string_view.h>
 
 namespace turbo {
@@ -177,4 +178,22 @@ namespace turbo {
         TriggerLoggingGlobalsListener();
     }
 
+    void set_log_budget(turbo::LogSeverity severity, const LogBudget &budget) {
+        log_internal::SetLogBudget(severity, budget.lines_per_second, budget.bytes_per_second);
+    }
+
+    LogBudget log_budget(turbo::LogSeverity severity) {
+        LogBudget budget;
+        log_internal::GetLogBudget(severity, &budget.lines_per_second, &budget.bytes_per_second);
+        return budget;
+    }
+
+    uint64_t log_budget_dropped(turbo::LogSeverity severity) {
+        return log_internal::LogBudgetDropped(severity);
+    }
+
+    void set_log_budget_summary_period(double seconds) {
+        log_internal::SetLogBudgetSummaryPeriod(seconds);
+    }
+
 }  // namespace turbo
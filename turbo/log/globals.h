@@ -23,6 +23,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include <turbo/base/attributes.h>
 #include <turbo/base/config.h>
 #include <turbo/base/log_severity.h>
@@ -161,6 +163,44 @@ namespace turbo {
     // This function is async-signal-safe.
     void enable_log_prefix(bool on_off);
 
+    //------------------------------------------------------------------------------
+    // Log Budget
+    //------------------------------------------------------------------------------
+    //
+    // A process-wide limit on how much is logged at a severity, across all `LOG`
+    // sites, so that a log storm cannot saturate the disk or the threads doing
+    // the logging. A statement over budget is dropped before its message is
+    // formatted. FATAL messages are never dropped. Every summary period (10
+    // seconds by default) a WARNING tells how many messages were dropped since
+    // the last one.
+
+    struct LogBudget {
+        // 0 for no limit.
+        int64_t lines_per_second = 0;
+        int64_t bytes_per_second = 0;
+    };
+
+    // set_log_budget()
+    //
+    // Sets the budget of `severity`, INFO, WARNING or ERROR, and refills it.
+    // The budget is off, at no cost to `LOG`, while no severity has a limit.
+    void set_log_budget(turbo::LogSeverity severity, const LogBudget &budget);
+
+    // log_budget()
+    //
+    // Returns the budget of `severity`.
+    TURBO_MUST_USE_RESULT LogBudget log_budget(turbo::LogSeverity severity);
+
+    // log_budget_dropped()
+    //
+    // Returns how many messages at `severity` the budget has dropped so far.
+    TURBO_MUST_USE_RESULT uint64_t log_budget_dropped(turbo::LogSeverity severity);
+
+    // set_log_budget_summary_period()
+    //
+    // Sets how often, at most, the number of dropped messages is logged.
+    void set_log_budget_summary_period(double seconds);
+
     //------------------------------------------------------------------------------
     // Set Global VLOG Level
     //------------------------------------------------------------------------------
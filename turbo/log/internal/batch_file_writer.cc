@@ -0,0 +1,499 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/log/internal/batch_file_writer.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+#include <turbo/base/internal/strerror.h>
+#include <turbo/flags/flag.h>
+#include <turbo/log/flags.h>
+#include <turbo/log/internal/append_file.h>
+#include <turbo/log/internal/fs_helper.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define TURBO_LOG_INTERNAL_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace turbo::log_internal {
+
+    namespace {
+
+        // Alignment of the blocks, of their size and, with `O_DIRECT`, of the
+        // file offsets written to.
+        constexpr size_t kAlignment = 4096;
+
+#ifdef IOV_MAX
+        constexpr int kMaxIov = IOV_MAX;
+#else
+        constexpr int kMaxIov = 1024;
+#endif
+
+        size_t round_up(size_t n, size_t alignment) {
+            return (n + alignment - 1) & ~(alignment - 1);
+        }
+
+        // Drops the first `bytes` bytes from the `count` buffers at `iov`.
+        void advance_iov(iovec *&iov, int &count, size_t bytes) {
+            while (count > 0 && bytes >= iov->iov_len) {
+                bytes -= iov->iov_len;
+                ++iov;
+                --count;
+            }
+            if (count > 0) {
+                iov->iov_base = static_cast<char *>(iov->iov_base) + bytes;
+                iov->iov_len -= bytes;
+            }
+        }
+
+    }  // namespace
+
+#ifdef TURBO_LOG_INTERNAL_HAVE_IO_URING
+
+    // A minimal io_uring with a single write in flight, driven through the
+    // raw system calls so that liburing is not required.
+    class BatchFileWriter::Ring {
+    public:
+        static std::unique_ptr<Ring> create(size_t max_iov) {
+            io_uring_params params;
+            memset(&params, 0, sizeof(params));
+            int fd = static_cast<int>(syscall(__NR_io_uring_setup, 2, &params));
+            if (fd < 0) {
+                return nullptr;
+            }
+            std::unique_ptr<Ring> ring(new Ring(fd, max_iov));
+            if (!ring->map(params)) {
+                return nullptr;
+            }
+            return ring;
+        }
+
+        ~Ring() {
+            if (_sq_ring != MAP_FAILED) {
+                ::munmap(_sq_ring, _sq_ring_size);
+            }
+            if (_cq_ring != MAP_FAILED) {
+                ::munmap(_cq_ring, _cq_ring_size);
+            }
+            if (_sqes != MAP_FAILED) {
+                ::munmap(_sqes, _sqes_size);
+            }
+            ::close(_fd);
+        }
+
+        // Queues a `pwritev(fd, iov, count, offset)`. Returns false if the
+        // kernel did not accept it.
+        bool submit_writev(int fd, const iovec *iov, int count, uint64_t offset) {
+            std::copy(iov, iov + count, _iov.begin());
+            const unsigned tail = *_sq_tail;
+            const unsigned index = tail & *_sq_mask;
+            io_uring_sqe *sqe = static_cast<io_uring_sqe *>(_sqes) + index;
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = IORING_OP_WRITEV;
+            sqe->fd = fd;
+            sqe->addr = reinterpret_cast<uint64_t>(_iov.data());
+            sqe->len = static_cast<uint32_t>(count);
+            sqe->off = offset;
+            _sq_array[index] = index;
+            __atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+            for (;;) {
+                long submitted = syscall(__NR_io_uring_enter, _fd, 1, 0, 0, nullptr, 0);
+                if (submitted == 1) {
+                    return true;
+                }
+                if (submitted < 0 && errno == EINTR) {
+                    continue;
+                }
+                // Take the entry back so that the ring stays consistent.
+                __atomic_store_n(_sq_tail, tail, __ATOMIC_RELEASE);
+                return false;
+            }
+        }
+
+        // Waits for the queued write and returns its result: the number of
+        // bytes written or a negated errno.
+        int wait() {
+            for (;;) {
+                const unsigned head = *_cq_head;
+                if (head != __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE)) {
+                    const int res = _cqes[head & *_cq_mask].res;
+                    __atomic_store_n(_cq_head, head + 1, __ATOMIC_RELEASE);
+                    return res;
+                }
+                long r = syscall(__NR_io_uring_enter, _fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+                if (r < 0 && errno != EINTR) {
+                    return -errno;
+                }
+            }
+        }
+
+    private:
+        Ring(int fd, size_t max_iov) : _fd(fd), _iov(max_iov) {}
+
+        bool map(const io_uring_params &params) {
+            _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+            _sq_ring = ::mmap(nullptr, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd,
+                              IORING_OFF_SQ_RING);
+            _cq_ring = ::mmap(nullptr, _cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd,
+                              IORING_OFF_CQ_RING);
+            _sqes = ::mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd,
+                           IORING_OFF_SQES);
+            if (_sq_ring == MAP_FAILED || _cq_ring == MAP_FAILED || _sqes == MAP_FAILED) {
+                return false;
+            }
+            char *sq = static_cast<char *>(_sq_ring);
+            _sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+            _sq_mask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+            _sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+            char *cq = static_cast<char *>(_cq_ring);
+            _cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+            _cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+            _cq_mask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+            _cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+            return true;
+        }
+
+        const int _fd;
+        // Kernels without IORING_FEAT_SUBMIT_STABLE read the iovecs after
+        // `io_uring_enter()` returns, so they live here until completion.
+        std::vector<iovec> _iov;
+        void *_sq_ring = MAP_FAILED;
+        size_t _sq_ring_size = 0;
+        void *_cq_ring = MAP_FAILED;
+        size_t _cq_ring_size = 0;
+        void *_sqes = MAP_FAILED;
+        size_t _sqes_size = 0;
+        unsigned *_sq_tail = nullptr;
+        unsigned *_sq_mask = nullptr;
+        unsigned *_sq_array = nullptr;
+        unsigned *_cq_head = nullptr;
+        unsigned *_cq_tail = nullptr;
+        unsigned *_cq_mask = nullptr;
+        io_uring_cqe *_cqes = nullptr;
+    };
+
+#else  // TURBO_LOG_INTERNAL_HAVE_IO_URING
+
+    class BatchFileWriter::Ring {
+    public:
+        static std::unique_ptr<Ring> create(size_t) {
+            return nullptr;
+        }
+
+        bool submit_writev(int, const iovec *, int, uint64_t) {
+            return false;
+        }
+
+        int wait() {
+            return -ENOSYS;
+        }
+    };
+
+#endif  // TURBO_LOG_INTERNAL_HAVE_IO_URING
+
+    BatchFileWriter::BatchFileWriter(const BatchFileWriterOptions &options)
+            : _options(options), _block_size(round_up(std::max<size_t>(options.block_size, 1), kAlignment)) {
+        const size_t block_count = std::min<size_t>(std::max<size_t>(options.block_count, 2), kMaxIov);
+        for (size_t i = 0; i < block_count; ++i) {
+            _blocks.push_back(static_cast<char *>(::operator new(_block_size, std::align_val_t(kAlignment))));
+        }
+        if (options.use_io_uring) {
+            _ring = Ring::create(block_count);
+        }
+        if (options.sync_policy == FileSyncPolicy::kPeriodic) {
+            _sync_thread = std::thread(&BatchFileWriter::sync_loop, this);
+        }
+    }
+
+    BatchFileWriter::~BatchFileWriter() {
+        close_file();
+        if (_sync_thread.joinable()) {
+            {
+                turbo::MutexLock lock(&_fd_mutex);
+                _stop = true;
+            }
+            _sync_thread.join();
+        }
+        for (char *block: _blocks) {
+            ::operator delete(block, std::align_val_t(kAlignment));
+        }
+    }
+
+    int BatchFileWriter::initialize(std::string_view path) {
+        close_file();
+        _path.assign(path.data(), path.size());
+        return open_file();
+    }
+
+    int BatchFileWriter::reopen() {
+        close_file();
+        return open_file();
+    }
+
+    int BatchFileWriter::open_file() {
+        create_dir(dir_name(_path));
+        _first = _in_flight = _sealed = _fill = 0;
+        _offset = 0;
+        _direct = false;
+        int fd = -1;
+        struct stat st;
+#ifdef O_DIRECT
+        if (_options.direct_io) {
+            fd = ::open(_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | O_DIRECT, 0644);
+            if (fd >= 0 && ::fstat(fd, &st) == 0) {
+                // Writes start at the last aligned offset, so an unaligned
+                // tail already in the file is carried in the first block.
+                _offset = static_cast<uint64_t>(st.st_size) & ~static_cast<uint64_t>(kAlignment - 1);
+                _fill = static_cast<size_t>(st.st_size - _offset);
+                _direct = _fill == 0 || ::pread(fd, block(0), kAlignment, _offset) >= static_cast<ssize_t>(_fill);
+            }
+            if (!_direct && fd >= 0) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+#endif
+        if (fd < 0) {
+            _offset = 0;
+            _fill = 0;
+            fd = ::open(_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+            if (fd < 0) {
+                return errno;
+            }
+        }
+        _written = ::fstat(fd, &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+        turbo::MutexLock lock(&_fd_mutex);
+        _fd = fd;
+        return 0;
+    }
+
+    void BatchFileWriter::close_file() {
+        if (_fd < 0) {
+            return;
+        }
+        flush();
+        int fd;
+        {
+            turbo::MutexLock lock(&_fd_mutex);
+            fd = _fd;
+            _fd = -1;
+        }
+        ::close(fd);
+    }
+
+    void BatchFileWriter::close() {
+        close_file();
+    }
+
+    ssize_t BatchFileWriter::write(std::string_view message) {
+        if (_fd < 0) {
+            return -1;
+        }
+        const char *data = message.data();
+        size_t left = message.size();
+        while (left > 0) {
+            const size_t n = std::min(left, _block_size - _fill);
+            memcpy(block(active_index()) + _fill, data, n);
+            _fill += n;
+            data += n;
+            left -= n;
+            if (_fill == _block_size) {
+                seal_active();
+            }
+        }
+        _written += message.size();
+        return static_cast<ssize_t>(message.size());
+    }
+
+    void BatchFileWriter::seal_active() {
+        ++_sealed;
+        _fill = 0;
+        const size_t block_count = _blocks.size();
+        if (_ring != nullptr) {
+            // Keep one write in flight; everything sealed meanwhile goes
+            // out with the next one.
+            if (_in_flight == 0) {
+                submit_sealed();
+            } else if (_in_flight + _sealed == block_count) {
+                wait_in_flight();
+                submit_sealed();
+            }
+        } else if (_sealed == block_count) {
+            write_sealed_and_active();
+        }
+    }
+
+    void BatchFileWriter::submit_sealed() {
+        iovec iov[kMaxIov];
+        const int count = static_cast<int>(_sealed);
+        for (int i = 0; i < count; ++i) {
+            iov[i].iov_base = block(_first + i);
+            iov[i].iov_len = _block_size;
+        }
+        if (!_ring->submit_writev(_fd, iov, count, _direct ? _offset : 0)) {
+            write_sealed_and_active();
+            return;
+        }
+        ++_submissions;
+        _in_flight = _sealed;
+        _sealed = 0;
+        if (_direct) {
+            _offset += _in_flight * _block_size;
+        }
+    }
+
+    void BatchFileWriter::wait_in_flight() {
+        if (_in_flight == 0) {
+            return;
+        }
+        const size_t expected = _in_flight * _block_size;
+        const int res = _ring->wait();
+        if (res < 0) {
+            fprintf(stderr, "BatchFileWriter: writing %s failed: %s\n", _path.c_str(),
+                    turbo::base_internal::StrError(-res).c_str());
+        } else if (static_cast<size_t>(res) < expected) {
+            // Short write; finish it synchronously.
+            iovec iov[kMaxIov];
+            int count = static_cast<int>(_in_flight);
+            for (int i = 0; i < count; ++i) {
+                iov[i].iov_base = block(_first + i);
+                iov[i].iov_len = _block_size;
+            }
+            iovec *rest = iov;
+            advance_iov(rest, count, static_cast<size_t>(res));
+            write_blocks(rest, count, _offset - expected + static_cast<size_t>(res));
+        }
+        _unsynced.store(true, std::memory_order_relaxed);
+        _first += _in_flight;
+        _in_flight = 0;
+    }
+
+    void BatchFileWriter::write_sealed_and_active() {
+        if (_sealed == 0 && _fill == 0) {
+            return;
+        }
+        // At most `block_count` sealed blocks plus the active one.
+        iovec iov[kMaxIov + 1];
+        int count = 0;
+        for (size_t i = 0; i < _sealed; ++i) {
+            iov[count].iov_base = block(_first + i);
+            iov[count].iov_len = _block_size;
+            ++count;
+        }
+        // After `seal_active()` fills the last free block the active block
+        // wraps onto `_first`; it is empty then and must not be written.
+        if (_fill > 0) {
+            char *active = block(active_index());
+            size_t size = _fill;
+            if (_direct) {
+                // O_DIRECT only writes whole aligned blocks; the padding is
+                // truncated away below and the tail is written again, at
+                // the same offset, once more data follows.
+                size = round_up(_fill, kAlignment);
+                memset(active + _fill, 0, size - _fill);
+            }
+            iov[count].iov_base = active;
+            iov[count].iov_len = size;
+            ++count;
+        }
+        write_blocks(iov, count, _offset);
+        if (_direct) {
+            _offset += _sealed * _block_size;
+            if (_fill > 0 && ::ftruncate(_fd, static_cast<off_t>(_offset + _fill)) != 0) {
+                fprintf(stderr, "BatchFileWriter: truncating %s failed: %s\n", _path.c_str(),
+                        turbo::base_internal::StrError(errno).c_str());
+            }
+        } else {
+            _fill = 0;
+        }
+        _first += _sealed;
+        _sealed = 0;
+    }
+
+    bool BatchFileWriter::write_blocks(iovec *iov, int count, uint64_t offset) {
+        while (count > 0) {
+            const int n = std::min(count, kMaxIov);
+            const ssize_t written = _direct ? ::pwritev(_fd, iov, n, static_cast<off_t>(offset))
+                                            : ::writev(_fd, iov, n);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                fprintf(stderr, "BatchFileWriter: writing %s failed: %s\n", _path.c_str(),
+                        turbo::base_internal::StrError(errno).c_str());
+                return false;
+            }
+            ++_submissions;
+            offset += static_cast<uint64_t>(written);
+            advance_iov(iov, count, static_cast<size_t>(written));
+        }
+        _unsynced.store(true, std::memory_order_relaxed);
+        return true;
+    }
+
+    void BatchFileWriter::flush() {
+        if (_fd < 0) {
+            return;
+        }
+        wait_in_flight();
+        write_sealed_and_active();
+        if (_options.sync_policy == FileSyncPolicy::kOnFlush && _unsynced.exchange(false)) {
+            ::fdatasync(_fd);
+        }
+    }
+
+    void BatchFileWriter::sync_loop() {
+        turbo::MutexLock lock(&_fd_mutex);
+        while (!_fd_mutex.AwaitWithTimeout(turbo::Condition(&_stop), _options.sync_interval)) {
+            if (_fd >= 0 && _unsynced.exchange(false)) {
+                ::fdatasync(_fd);
+            }
+        }
+    }
+
+    std::unique_ptr<turbo::FileWriter> make_log_file_writer() {
+        if (!turbo::get_flag(FLAGS_log_batch_write)) {
+            return std::make_unique<AppendFile>();
+        }
+        BatchFileWriterOptions options;
+        options.direct_io = turbo::get_flag(FLAGS_log_direct_io);
+        const int sync_interval_ms = turbo::get_flag(FLAGS_log_sync_interval_ms);
+        if (sync_interval_ms > 0) {
+            options.sync_policy = FileSyncPolicy::kPeriodic;
+            options.sync_interval = turbo::Duration::milliseconds(sync_interval_ms);
+        }
+        return std::make_unique<BatchFileWriter>(options);
+    }
+
+}  // namespace turbo::log_internal
@@ -0,0 +1,176 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/uio.h>
+
+#include <turbo/base/thread_annotations.h>
+#include <turbo/log/file_write.h>
+#include <turbo/synchronization/mutex.h>
+#include <turbo/times/time.h>
+
+namespace turbo::log_internal {
+
+    // When `BatchFileWriter` calls `fdatasync()`.
+    enum class FileSyncPolicy {
+        // Never; the kernel writes the page cache back on its own schedule.
+        kNone,
+        // At the end of every `flush()`.
+        kOnFlush,
+        // Every `sync_interval`, from a background thread, if anything was
+        // written since the last sync.
+        kPeriodic,
+    };
+
+    struct BatchFileWriterOptions {
+        // Size of each buffer block. Rounded up to a multiple of 4KB.
+        size_t block_size = 256 * 1024;
+        // Number of blocks; at least 2. Full blocks are written together, so
+        // this bounds both the batch size and the memory used.
+        size_t block_count = 4;
+        // Submit full blocks through io_uring, so that filling the next block
+        // overlaps the write. Falls back to `writev()` when io_uring is not
+        // available.
+        bool use_io_uring = true;
+        // Open the file with `O_DIRECT`, bypassing the page cache. Falls back
+        // to buffered writes on file systems that reject it.
+        bool direct_io = false;
+        FileSyncPolicy sync_policy = FileSyncPolicy::kNone;
+        turbo::Duration sync_interval = turbo::Duration::seconds(1);
+    };
+
+    // BatchFileWriter
+    //
+    // An alternative to `AppendFile` for high volume logs. `write()` copies the
+    // message into the current block of a small ring of page aligned blocks
+    // and only reaches the kernel when a block fills up: all full blocks are
+    // then handed over in a single `writev()`, or queued on io_uring while
+    // the caller keeps filling the next block. `flush()` writes the partially
+    // filled block as well.
+    //
+    // Like `AppendFile`, a `BatchFileWriter` must be used from one thread at a
+    // time; the sinks call it under their own lock.
+    class BatchFileWriter : public turbo::FileWriter {
+    public:
+        explicit BatchFileWriter(const BatchFileWriterOptions &options = BatchFileWriterOptions());
+
+        ~BatchFileWriter() override;
+
+        int initialize(std::string_view path) override;
+
+        int reopen() override;
+
+        ssize_t write(std::string_view message) override;
+
+        void flush() override;
+
+        void close() override;
+
+        size_t file_size() const override {
+            return _written;
+        }
+
+        std::string file_path() const override {
+            return _path;
+        }
+
+        // Whether full blocks are submitted through io_uring.
+        bool using_io_uring() const {
+            return _ring != nullptr;
+        }
+
+        // Whether the current file was opened with `O_DIRECT`.
+        bool using_direct_io() const {
+            return _direct;
+        }
+
+        // Number of write system calls or io_uring submissions made so far.
+        uint64_t submissions() const {
+            return _submissions;
+        }
+
+    private:
+        class Ring;
+
+        int open_file();
+
+        void close_file();
+
+        char *block(size_t index) const {
+            return _blocks[index % _blocks.size()];
+        }
+
+        size_t active_index() const {
+            return _first + _in_flight + _sealed;
+        }
+
+        void seal_active();
+
+        void submit_sealed();
+
+        void wait_in_flight();
+
+        void write_sealed_and_active();
+
+        bool write_blocks(iovec *iov, int count, uint64_t offset);
+
+        void sync_loop();
+
+        const BatchFileWriterOptions _options;
+        // `_options.block_size` rounded up to the alignment.
+        const size_t _block_size;
+        std::string _path;
+        std::vector<char *> _blocks;
+        // Blocks in ring order starting at `_first`: `_in_flight` submitted to
+        // io_uring, `_sealed` full but not yet written, then the active block
+        // holding `_fill` bytes. The rest are free.
+        size_t _first = 0;
+        size_t _in_flight = 0;
+        size_t _sealed = 0;
+        size_t _fill = 0;
+        // With `O_DIRECT` the file is written at explicit, aligned offsets;
+        // this is the offset of the block at `_first + _in_flight`.
+        uint64_t _offset = 0;
+        size_t _written = 0;
+        bool _direct = false;
+        uint64_t _submissions = 0;
+        std::unique_ptr<Ring> _ring;
+
+        // Only the writing thread changes `_fd`, under `_fd_mutex`, so that
+        // the sync thread never syncs a descriptor that is being closed.
+        turbo::Mutex _fd_mutex;
+        int _fd = -1;
+        bool _stop TURBO_GUARDED_BY(_fd_mutex) = false;
+        std::atomic<bool> _unsynced{false};
+        std::thread _sync_thread;
+    };
+
+    // Returns the writer used by the file sinks: an `AppendFile`, or a
+    // `BatchFileWriter` configured from the `log_batch_write`,
+    // `log_direct_io` and `log_sync_interval_ms` flags.
+    std::unique_ptr<turbo::FileWriter> make_log_file_writer();
+
+}  // namespace turbo::log_internal
@@ -0,0 +1,310 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/log/internal/compressed_file.h>
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <utility>
+
+#include <turbo/base/internal/strerror.h>
+#include <turbo/log/internal/batch_file_writer.h>
+#include <turbo/log/internal/fs_helper.h>
+#include <turbo/times/clock.h>
+
+namespace turbo::log_internal {
+
+    namespace {
+
+        // Rotated files are compressed this much at a time.
+        constexpr size_t kCompressChunkSize = 1 << 20;
+
+        // `CompressedFileWriter::write()` only waits for the background thread
+        // once it is this many chunks behind.
+        constexpr size_t kMaxQueuedChunks = 4;
+
+    }  // namespace
+
+    bool get_file_id(const std::string &path, FileId *id) {
+        struct stat st;
+        if (::stat(path.c_str(), &st) != 0) {
+            return false;
+        }
+        id->device = st.st_dev;
+        id->inode = st.st_ino;
+        return true;
+    }
+
+    int compress_file(const turbo::LogCodec &codec, std::FILE *src, const std::string &dst) {
+        FILE *out = ::fopen(dst.c_str(), "wb");
+        if (out == nullptr) {
+            return errno;
+        }
+        std::string chunk(kCompressChunkSize, '\0');
+        std::string compressed;
+        int err = 0;
+        for (;;) {
+            const size_t n = ::fread(&chunk[0], 1, chunk.size(), src);
+            if (n == 0) {
+                if (::ferror(src)) {
+                    err = EIO;
+                }
+                break;
+            }
+            compressed.clear();
+            codec.compress(std::string_view(chunk.data(), n), &compressed);
+            if (::fwrite(compressed.data(), 1, compressed.size(), out) != compressed.size()) {
+                err = errno != 0 ? errno : EIO;
+                break;
+            }
+        }
+        if (::fclose(out) != 0 && err == 0) {
+            err = errno;
+        }
+        return err;
+    }
+
+    CompressedFileWriter::CompressedFileWriter(const turbo::LogCompressionOptions &options,
+                                               std::unique_ptr<turbo::FileWriter> file)
+            : _options(options), _file(std::move(file)), _thread(&CompressedFileWriter::run, this) {}
+
+    CompressedFileWriter::~CompressedFileWriter() {
+        drain();
+        {
+            turbo::MutexLock lock(&_mutex);
+            _stop = true;
+        }
+        _thread.join();
+    }
+
+    int CompressedFileWriter::initialize(std::string_view path) {
+        drain();
+        turbo::MutexLock lock(&_file_mutex);
+        return _file->initialize(path);
+    }
+
+    int CompressedFileWriter::reopen() {
+        drain();
+        turbo::MutexLock lock(&_file_mutex);
+        return _file->reopen();
+    }
+
+    ssize_t CompressedFileWriter::write(std::string_view message) {
+        turbo::MutexLock lock(&_mutex);
+        if (_pending.empty()) {
+            _deadline = turbo::Time::current_time() + _options.sync_interval;
+        }
+        _pending.append(message.data(), message.size());
+        if (_pending.size() >= _options.chunk_size) {
+            _mutex.Await(turbo::Condition(
+                    +[](CompressedFileWriter *self) TURBO_EXCLUSIVE_LOCKS_REQUIRED(self->_mutex) {
+                        return self->_chunks.size() < kMaxQueuedChunks;
+                    },
+                    this));
+            seal_pending();
+        }
+        return static_cast<ssize_t>(message.size());
+    }
+
+    void CompressedFileWriter::flush() {
+        drain();
+        turbo::MutexLock lock(&_file_mutex);
+        _file->flush();
+    }
+
+    void CompressedFileWriter::close() {
+        drain();
+        turbo::MutexLock lock(&_file_mutex);
+        _file->close();
+    }
+
+    void CompressedFileWriter::seal_pending() {
+        if (_pending.empty()) {
+            return;
+        }
+        _chunks.push_back(std::move(_pending));
+        _pending.clear();
+    }
+
+    void CompressedFileWriter::drain() {
+        turbo::MutexLock lock(&_mutex);
+        seal_pending();
+        _mutex.Await(turbo::Condition(
+                +[](CompressedFileWriter *self) TURBO_EXCLUSIVE_LOCKS_REQUIRED(self->_mutex) {
+                    return self->_chunks.empty() && !self->_busy;
+                },
+                this));
+    }
+
+    void CompressedFileWriter::run() {
+        std::string compressed;
+        _mutex.Lock();
+        for (;;) {
+            _busy = false;
+            const auto has_chunk = +[](CompressedFileWriter *self) TURBO_EXCLUSIVE_LOCKS_REQUIRED(self->_mutex) {
+                return self->_stop || !self->_chunks.empty();
+            };
+            // Whether the chunk is the pending text come due, which is then
+            // a sync point: it is flushed once written.
+            bool sync = false;
+            if (!_pending.empty()) {
+                // Seal the pending text when it comes due, unless a full chunk
+                // turns up first.
+                if (!_mutex.AwaitWithDeadline(turbo::Condition(has_chunk, this), _deadline)) {
+                    seal_pending();
+                    sync = true;
+                }
+            } else {
+                _mutex.Await(turbo::Condition(
+                        +[](CompressedFileWriter *self) TURBO_EXCLUSIVE_LOCKS_REQUIRED(self->_mutex) {
+                            return self->_stop || !self->_chunks.empty() || !self->_pending.empty();
+                        },
+                        this));
+            }
+            if (_chunks.empty()) {
+                if (_stop) {
+                    _mutex.Unlock();
+                    return;
+                }
+                continue;
+            }
+            std::string chunk = std::move(_chunks.front());
+            _chunks.pop_front();
+            _busy = true;
+            _mutex.Unlock();
+            compressed.clear();
+            _options.codec->compress(chunk, &compressed);
+            {
+                turbo::MutexLock file_lock(&_file_mutex);
+                _file->write(compressed);
+                if (sync) {
+                    _file->flush();
+                }
+            }
+            _mutex.Lock();
+        }
+    }
+
+    RotatedFileCompressor::RotatedFileCompressor(std::shared_ptr<const turbo::LogCodec> codec, Commit commit)
+            : _codec(std::move(codec)), _commit(std::move(commit)), _thread(&RotatedFileCompressor::run, this) {}
+
+    RotatedFileCompressor::~RotatedFileCompressor() {
+        {
+            turbo::MutexLock lock(&_mutex);
+            _stop = true;
+        }
+        _thread.join();
+    }
+
+    void RotatedFileCompressor::add(const std::string &path) {
+        Job job{path, FileId(), ::fopen(path.c_str(), "rb")};
+        if (job.file == nullptr) {
+            return;
+        }
+        struct stat st;
+        if (::fstat(::fileno(job.file), &st) != 0) {
+            ::fclose(job.file);
+            return;
+        }
+        job.id.device = st.st_dev;
+        job.id.inode = st.st_ino;
+        turbo::MutexLock lock(&_mutex);
+        _jobs.push_back(std::move(job));
+    }
+
+    void RotatedFileCompressor::wait_idle() {
+        turbo::MutexLock lock(&_mutex);
+        _mutex.Await(turbo::Condition(
+                +[](RotatedFileCompressor *self) TURBO_EXCLUSIVE_LOCKS_REQUIRED(self->_mutex) {
+                    return self->_jobs.empty() && !self->_busy;
+                },
+                this));
+    }
+
+    void RotatedFileCompressor::run() {
+        for (;;) {
+            Job job;
+            {
+                turbo::MutexLock lock(&_mutex);
+                _busy = false;
+                _mutex.Await(turbo::Condition(
+                        +[](RotatedFileCompressor *self) TURBO_EXCLUSIVE_LOCKS_REQUIRED(self->_mutex) {
+                            return self->_stop || !self->_jobs.empty();
+                        },
+                        this));
+                if (_jobs.empty()) {
+                    return;
+                }
+                job = std::move(_jobs.front());
+                _jobs.pop_front();
+                _busy = true;
+            }
+            std::string tmp = job.path;
+            tmp.append(_codec->extension().data(), _codec->extension().size());
+            tmp.append(".tmp");
+            const int err = compress_file(*_codec, job.file, tmp);
+            if (err != 0) {
+                ::fclose(job.file);
+                fprintf(stderr, "RotatedFileCompressor: compressing %s failed: %s\n", job.path.c_str(),
+                        turbo::base_internal::StrError(err).c_str());
+                (void) remove(tmp);
+                continue;
+            }
+            _commit(job.path, job.id, tmp);
+            ::fclose(job.file);
+        }
+    }
+
+    void commit_compressed_file(const std::string &path, const FileId &id, const std::string &tmp,
+                                std::string_view extension) {
+        FileId current;
+        if (!get_file_id(path, &current) || !(current == id)) {
+            (void) remove(tmp);
+            return;
+        }
+        std::string target = path;
+        target.append(extension.data(), extension.size());
+        if (rename(tmp, target) == 0) {
+            (void) remove(path);
+        }
+    }
+
+    std::unique_ptr<turbo::FileWriter> make_log_file_writer(const turbo::LogCompressionOptions &options) {
+        if (options.codec == nullptr || options.mode != turbo::LogCompressionOptions::Mode::kLive) {
+            return make_log_file_writer();
+        }
+        return std::make_unique<CompressedFileWriter>(options, make_log_file_writer());
+    }
+
+    std::string_view live_extension(const turbo::LogCompressionOptions &options) {
+        if (options.codec == nullptr || options.mode != turbo::LogCompressionOptions::Mode::kLive) {
+            return {};
+        }
+        return options.codec->extension();
+    }
+
+    std::unique_ptr<RotatedFileCompressor> make_rotated_file_compressor(const turbo::LogCompressionOptions &options,
+                                                                        RotatedFileCompressor::Commit commit) {
+        if (options.codec == nullptr || options.mode != turbo::LogCompressionOptions::Mode::kRotated) {
+            return nullptr;
+        }
+        return std::make_unique<RotatedFileCompressor>(options.codec, std::move(commit));
+    }
+
+}  // namespace turbo::log_internal
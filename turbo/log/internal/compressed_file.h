@@ -0,0 +1,180 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <turbo/base/thread_annotations.h>
+#include <turbo/log/file_write.h>
+#include <turbo/log/log_codec.h>
+#include <turbo/synchronization/mutex.h>
+#include <turbo/times/time.h>
+
+namespace turbo::log_internal {
+
+    // Identifies a file across renames.
+    struct FileId {
+        dev_t device = 0;
+        ino_t inode = 0;
+
+        bool operator==(const FileId &other) const {
+            return device == other.device && inode == other.inode;
+        }
+    };
+
+    // Returns false if `path` does not exist.
+    bool get_file_id(const std::string &path, FileId *id);
+
+    // Writes what is left to read from `src`, compressed with `codec` one
+    // chunk at a time, to `dst`. Returns 0 or an errno value.
+    int compress_file(const turbo::LogCodec &codec, std::FILE *src, const std::string &dst);
+
+    // CompressedFileWriter
+    //
+    // The `LogCompressionOptions::Mode::kLive` writer: buffers the text written
+    // to it and hands it to the wrapped writer as one compressed chunk at a
+    // time. A background thread compresses and writes the chunks, and also
+    // writes and flushes the buffered text once the oldest of it is
+    // `sync_interval` old, so `write()` only copies the text. `file_size()` counts compressed
+    // bytes, so size based rotation bounds the disk usage; it does not count
+    // the chunks still queued for the background thread.
+    class CompressedFileWriter : public turbo::FileWriter {
+    public:
+        CompressedFileWriter(const turbo::LogCompressionOptions &options, std::unique_ptr<turbo::FileWriter> file);
+
+        ~CompressedFileWriter() override;
+
+        int initialize(std::string_view path) override;
+
+        int reopen() override;
+
+        ssize_t write(std::string_view message) override;
+
+        void flush() override;
+
+        void close() override;
+
+        size_t file_size() const override {
+            turbo::MutexLock lock(&_file_mutex);
+            return _file->file_size();
+        }
+
+        std::string file_path() const override {
+            turbo::MutexLock lock(&_file_mutex);
+            return _file->file_path();
+        }
+
+    private:
+        // Queues `_pending` as a chunk.
+        void seal_pending() TURBO_EXCLUSIVE_LOCKS_REQUIRED(_mutex);
+
+        // Blocks until the text written so far has reached `_file`.
+        void drain();
+
+        void run();
+
+        const turbo::LogCompressionOptions _options;
+        turbo::Mutex _mutex;
+        std::string _pending TURBO_GUARDED_BY(_mutex);
+        // When the oldest text in `_pending` must be written.
+        turbo::Time _deadline TURBO_GUARDED_BY(_mutex);
+        // Chunks waiting for the background thread, oldest first.
+        std::deque<std::string> _chunks TURBO_GUARDED_BY(_mutex);
+        bool _busy TURBO_GUARDED_BY(_mutex) = false;
+        bool _stop TURBO_GUARDED_BY(_mutex) = false;
+        // Taken by the background thread while it writes, and by the caller
+        // for everything else it does with `_file`.
+        mutable turbo::Mutex _file_mutex;
+        std::unique_ptr<turbo::FileWriter> _file TURBO_PT_GUARDED_BY(_file_mutex);
+        std::thread _thread;
+    };
+
+    // RotatedFileCompressor
+    //
+    // Compresses files handed to `add()` on a background thread, so that
+    // rotation never waits for compression. Each file is compressed into a
+    // temporary file; then `commit` decides, usually under the sink's lock,
+    // what to do with it, since the sink may have renamed or removed the
+    // original meanwhile. Files are opened by `add()`, so they can be
+    // renamed while queued, and their `FileId` cannot be reused before
+    // they are committed.
+    class RotatedFileCompressor {
+    public:
+        // `commit(path, id, tmp)`: `tmp` holds the compressed content of the
+        // file that was `path`, with identity `id`, when it was added.
+        using Commit = std::function<void(const std::string &path, const FileId &id, const std::string &tmp)>;
+
+        RotatedFileCompressor(std::shared_ptr<const turbo::LogCodec> codec, Commit commit);
+
+        // Compresses the files still queued.
+        ~RotatedFileCompressor();
+
+        // Queues `path` for compression.
+        void add(const std::string &path);
+
+        // Blocks until every file added so far has been committed.
+        void wait_idle();
+
+        std::string_view extension() const {
+            return _codec->extension();
+        }
+
+    private:
+        struct Job {
+            std::string path;
+            FileId id;
+            std::FILE *file = nullptr;
+        };
+
+        void run();
+
+        const std::shared_ptr<const turbo::LogCodec> _codec;
+        const Commit _commit;
+        turbo::Mutex _mutex;
+        std::deque<Job> _jobs TURBO_GUARDED_BY(_mutex);
+        bool _busy TURBO_GUARDED_BY(_mutex) = false;
+        bool _stop TURBO_GUARDED_BY(_mutex) = false;
+        std::thread _thread;
+    };
+
+    // The usual `RotatedFileCompressor::Commit`: if `path` is still the file
+    // that was compressed, moves `tmp` to `path` plus `extension` and removes
+    // `path`; otherwise discards `tmp`.
+    void commit_compressed_file(const std::string &path, const FileId &id, const std::string &tmp,
+                                std::string_view extension);
+
+    // The writer of a file sink: `make_log_file_writer()`, wrapped in a
+    // `CompressedFileWriter` in live mode.
+    std::unique_ptr<turbo::FileWriter> make_log_file_writer(const turbo::LogCompressionOptions &options);
+
+    // What a file sink appends to the names of the files it writes: the codec
+    // extension in live mode, nothing otherwise.
+    std::string_view live_extension(const turbo::LogCompressionOptions &options);
+
+    // The background compressor of a file sink in rotated mode, null otherwise.
+    std::unique_ptr<RotatedFileCompressor> make_rotated_file_compressor(const turbo::LogCompressionOptions &options,
+                                                                        RotatedFileCompressor::Commit commit);
+
+}  // namespace turbo::log_internal
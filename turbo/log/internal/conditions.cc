@@ -17,11 +17,14 @@
 
 #include <turbo/log/internal/conditions.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 
 #include <turbo/base/config.h>
 #include <turbo/base/internal/cycleclock.h>
+#include <turbo/log/globals.h>
+#include <turbo/log/internal/log_message.h>
 
 namespace turbo {
 TURBO_NAMESPACE_BEGIN
@@ -81,6 +84,258 @@ bool LogEveryNSecState::ShouldLog(double seconds) {
 #endif
 }
 
+namespace {
+
+// The budget of each severity is split in stripes, a thread taking from its
+// own stripe first, so that threads logging at once do not all contend on
+// the same cache lines.  A budget of fewer lines per second than there are
+// stripes is kept in one stripe, as its share would not hold a whole line.
+constexpr int kBudgetStripes = 8;
+// Tokens are counted in 1/kTokenScale of a line or byte, so that even a
+// small budget refills a little at a time.
+constexpr int64_t kTokenScale = 1024;
+// A stripe is refilled at most this often.
+constexpr double kRefillSeconds = 0.001;
+
+struct alignas(64) BudgetStripe {
+  std::atomic<int64_t> lines{0};
+  std::atomic<int64_t> bytes{0};
+  std::atomic<int64_t> refill_cycles{0};
+  std::atomic<uint64_t> dropped{0};
+};
+
+struct SeverityBudget {
+  // Per second; 0 for no limit.
+  std::atomic<int64_t> lines_per_second{0};
+  std::atomic<int64_t> bytes_per_second{0};
+  // How many of `stripes` are in use.
+  std::atomic<int> num_stripes{kBudgetStripes};
+  // Sum of `dropped` over the stripes when the last summary was logged.
+  std::atomic<uint64_t> reported_dropped{0};
+  BudgetStripe stripes[kBudgetStripes];
+};
+
+// Budgets of INFO, WARNING and ERROR.
+constexpr int kBudgetedSeverities = 3;
+SeverityBudget budgets[kBudgetedSeverities];
+
+TURBO_CONST_INIT std::atomic<int> next_stripe{0};
+TURBO_CONST_INIT std::atomic<double> summary_period_seconds{10.0};
+TURBO_CONST_INIT std::atomic<int64_t> next_summary_cycles{0};
+
+int ThisThreadStripe() {
+  thread_local const int stripe =
+      next_stripe.fetch_add(1, std::memory_order_relaxed) % kBudgetStripes;
+  return stripe;
+}
+
+// The stripe the last line of this thread was taken from, which is charged
+// the bytes of that line.
+thread_local int granting_stripe = 0;
+
+// What one stripe holds at most: a second worth of its share of `rate`.
+int64_t StripeCapacity(int64_t rate, int num_stripes) {
+  return rate * kTokenScale / num_stripes;
+}
+
+void AddTokens(std::atomic<int64_t>* tokens, int64_t add, int64_t capacity) {
+  int64_t value = tokens->load(std::memory_order_relaxed);
+  while (value < capacity &&
+         !tokens->compare_exchange_weak(value, std::min(value + add, capacity),
+                                        std::memory_order_relaxed)) {
+  }
+}
+
+void Refill(const SeverityBudget& budget, BudgetStripe& stripe,
+            int64_t now_cycles) {
+  using turbo::base_internal::CycleClock;
+  int64_t last = stripe.refill_cycles.load(std::memory_order_relaxed);
+  const double elapsed = static_cast<double>(now_cycles - last);
+  if (elapsed < kRefillSeconds * CycleClock::Frequency() ||
+      !stripe.refill_cycles.compare_exchange_strong(
+          last, now_cycles, std::memory_order_relaxed)) {
+    return;
+  }
+  const int num_stripes = budget.num_stripes.load(std::memory_order_relaxed);
+  const double stripe_seconds =
+      elapsed / CycleClock::Frequency() / num_stripes;
+  const int64_t lines = budget.lines_per_second.load(std::memory_order_relaxed);
+  if (lines > 0) {
+    AddTokens(&stripe.lines,
+              static_cast<int64_t>(stripe_seconds * lines * kTokenScale),
+              StripeCapacity(lines, num_stripes));
+  }
+  const int64_t bytes = budget.bytes_per_second.load(std::memory_order_relaxed);
+  if (bytes > 0) {
+    AddTokens(&stripe.bytes,
+              static_cast<int64_t>(stripe_seconds * bytes * kTokenScale),
+              StripeCapacity(bytes, num_stripes));
+  }
+}
+
+// Takes a line from `stripe` if both its line and byte budgets allow it.
+bool TakeLine(const SeverityBudget& budget, BudgetStripe& stripe) {
+  if (budget.bytes_per_second.load(std::memory_order_relaxed) > 0 &&
+      stripe.bytes.load(std::memory_order_relaxed) <= 0) {
+    return false;
+  }
+  if (budget.lines_per_second.load(std::memory_order_relaxed) <= 0) {
+    return true;
+  }
+  int64_t lines = stripe.lines.load(std::memory_order_relaxed);
+  do {
+    if (lines < kTokenScale) return false;
+  } while (!stripe.lines.compare_exchange_weak(lines, lines - kTokenScale,
+                                               std::memory_order_relaxed));
+  return true;
+}
+
+uint64_t Dropped(const SeverityBudget& budget) {
+  uint64_t dropped = 0;
+  for (const BudgetStripe& stripe : budget.stripes) {
+    dropped += stripe.dropped.load(std::memory_order_relaxed);
+  }
+  return dropped;
+}
+
+// Set while this thread logs the summary, which is not charged to the
+// budget.
+thread_local bool logging_summary = false;
+
+// Makes a summary due, at most once per summary period.
+void MaybeScheduleSummary(int64_t now_cycles) {
+  int64_t next = next_summary_cycles.load(std::memory_order_relaxed);
+  if (now_cycles < next ||
+      !next_summary_cycles.compare_exchange_strong(
+          next,
+          now_cycles +
+              static_cast<int64_t>(
+                  summary_period_seconds.load(std::memory_order_relaxed) *
+                  turbo::base_internal::CycleClock::Frequency()),
+          std::memory_order_relaxed)) {
+    return;
+  }
+  log_budget_summary_due.store(true, std::memory_order_relaxed);
+}
+
+}  // namespace
+
+TURBO_CONST_INIT std::atomic<bool> log_budget_enabled{false};
+TURBO_CONST_INIT std::atomic<bool> log_budget_summary_due{false};
+
+bool LogBudgetAllowsSlow(turbo::LogSeverity severity) {
+  const int index = static_cast<int>(severity);
+  if (index < 0 || index >= kBudgetedSeverities) return true;
+  SeverityBudget& budget = budgets[index];
+  const int64_t now_cycles = turbo::base_internal::CycleClock::Now();
+  const int num_stripes = budget.num_stripes.load(std::memory_order_relaxed);
+  const int own = ThisThreadStripe() % num_stripes;
+  bool allowed = false;
+  // Fall back to the other stripes before dropping, so that one busy thread
+  // can use the whole budget.
+  for (int i = 0; i < num_stripes && !allowed; ++i) {
+    granting_stripe = (own + i) % num_stripes;
+    BudgetStripe& stripe = budget.stripes[granting_stripe];
+    Refill(budget, stripe, now_cycles);
+    allowed = TakeLine(budget, stripe);
+  }
+  if (!allowed) {
+    budget.stripes[own].dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+  MaybeScheduleSummary(now_cycles);
+  return allowed;
+}
+
+// Logs how many messages the budget dropped since the last summary.
+void LogBudgetSummarySlow() {
+  if (!log_budget_summary_due.exchange(false, std::memory_order_relaxed)) {
+    return;
+  }
+  uint64_t suppressed[kBudgetedSeverities];
+  uint64_t total = 0;
+  for (int i = 0; i < kBudgetedSeverities; ++i) {
+    const uint64_t dropped = Dropped(budgets[i]);
+    suppressed[i] =
+        dropped - budgets[i].reported_dropped.exchange(
+                      dropped, std::memory_order_relaxed);
+    total += suppressed[i];
+  }
+  if (total == 0) return;
+  logging_summary = true;
+  LogMessage(__FILE__, __LINE__, turbo::LogSeverity::kWarning)
+      << "Log budget exceeded: " << total << " messages suppressed ("
+      << suppressed[0] << " INFO, " << suppressed[1] << " WARNING, "
+      << suppressed[2] << " ERROR)";
+  logging_summary = false;
+}
+
+void ChargeLogBudgetSlow(turbo::LogSeverity severity, size_t bytes) {
+  const int index = static_cast<int>(severity);
+  if (index < 0 || index >= kBudgetedSeverities || logging_summary) return;
+  SeverityBudget& budget = budgets[index];
+  if (budget.bytes_per_second.load(std::memory_order_relaxed) <= 0) return;
+  budget.stripes[granting_stripe].bytes.fetch_sub(
+      static_cast<int64_t>(bytes) * kTokenScale, std::memory_order_relaxed);
+}
+
+void SetLogBudget(turbo::LogSeverity severity, int64_t lines_per_second,
+                  int64_t bytes_per_second) {
+  const int index = static_cast<int>(severity);
+  if (index < 0 || index >= kBudgetedSeverities) return;
+  SeverityBudget& budget = budgets[index];
+  lines_per_second = std::max<int64_t>(lines_per_second, 0);
+  bytes_per_second = std::max<int64_t>(bytes_per_second, 0);
+  budget.lines_per_second.store(lines_per_second, std::memory_order_relaxed);
+  budget.bytes_per_second.store(bytes_per_second, std::memory_order_relaxed);
+  const int num_stripes =
+      lines_per_second > 0 && lines_per_second < kBudgetStripes
+          ? 1
+          : kBudgetStripes;
+  budget.num_stripes.store(num_stripes, std::memory_order_relaxed);
+  // Start full.
+  const int64_t now_cycles = turbo::base_internal::CycleClock::Now();
+  for (BudgetStripe& stripe : budget.stripes) {
+    stripe.lines.store(StripeCapacity(lines_per_second, num_stripes),
+                       std::memory_order_relaxed);
+    stripe.bytes.store(StripeCapacity(bytes_per_second, num_stripes),
+                       std::memory_order_relaxed);
+    stripe.refill_cycles.store(now_cycles, std::memory_order_relaxed);
+  }
+  bool enabled = false;
+  for (const SeverityBudget& b : budgets) {
+    enabled = enabled || b.lines_per_second.load(std::memory_order_relaxed) > 0 ||
+              b.bytes_per_second.load(std::memory_order_relaxed) > 0;
+  }
+  log_budget_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void GetLogBudget(turbo::LogSeverity severity, int64_t* lines_per_second,
+                  int64_t* bytes_per_second) {
+  const int index = static_cast<int>(severity);
+  *lines_per_second = 0;
+  *bytes_per_second = 0;
+  if (index < 0 || index >= kBudgetedSeverities) return;
+  *lines_per_second =
+      budgets[index].lines_per_second.load(std::memory_order_relaxed);
+  *bytes_per_second =
+      budgets[index].bytes_per_second.load(std::memory_order_relaxed);
+}
+
+uint64_t LogBudgetDropped(turbo::LogSeverity severity) {
+  const int index = static_cast<int>(severity);
+  if (index < 0 || index >= kBudgetedSeverities) return 0;
+  return Dropped(budgets[index]);
+}
+
+void SetLogBudgetSummaryPeriod(double seconds) {
+  summary_period_seconds.store(seconds, std::memory_order_relaxed);
+  next_summary_cycles.store(
+      turbo::base_internal::CycleClock::Now() +
+          static_cast<int64_t>(seconds *
+                               turbo::base_internal::CycleClock::Frequency()),
+      std::memory_order_relaxed);
+}
+
 }  // namespace log_internal
 TURBO_NAMESPACE_END
 }  // namespace turbo
@@ -34,10 +34,12 @@
 #include <stdlib.h>
 
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 
 #include <turbo/base/attributes.h>
 #include <turbo/base/config.h>
+#include <turbo/base/log_severity.h>
 #include <turbo/log/internal/voidify.h>
 
 // `TURBO_LOG_INTERNAL_CONDITION` prefixes another macro that expands to a
@@ -101,6 +103,46 @@
          turbo_log_internal_stateful_condition_do_log;                     \
          turbo_log_internal_stateful_condition_do_log = false)
 
+// `TURBO_LOG_INTERNAL_BUDGETED_*_CONDITION` are the same as the above, but
+// also charge a line against the process-wide log budget (see `set_log_budget`
+// in log/globals.h) for `severity`, once every other condition has passed and
+// before anything is formatted.  A statement over budget is dropped.
+//
+// A summary of the dropped messages which fell due during the condition is
+// logged once the statement is done with: in place of the message of a
+// stateless statement the budget dropped, and otherwise after the next message
+// flushed.  A statement whose own condition is false never looks at the
+// budget or the summary, so disabled logging stays free.
+#define TURBO_LOG_INTERNAL_BUDGETED_STATELESS_CONDITION(severity, condition) \
+  switch (0)                                                                 \
+  case 0:                                                                    \
+  default:                                                                   \
+    !(condition) ? (void)0                                                   \
+    : !::turbo::log_internal::LogBudgetAllows(severity)                      \
+        ? ::turbo::log_internal::LogBudgetSummaryIfDue()                     \
+        : ::turbo::log_internal::Voidify()&&
+#define TURBO_LOG_INTERNAL_BUDGETED_STATEFUL_CONDITION(severity, condition) \
+  for (bool turbo_log_internal_stateful_condition_do_log(condition);        \
+       turbo_log_internal_stateful_condition_do_log;                        \
+       turbo_log_internal_stateful_condition_do_log = false)                \
+    for (const ::turbo::LogSeverity turbo_log_internal_budget_severity =    \
+             (severity);                                                    \
+         turbo_log_internal_stateful_condition_do_log;                      \
+         turbo_log_internal_stateful_condition_do_log = false)              \
+  TURBO_LOG_INTERNAL_BUDGETED_STATEFUL_CONDITION_IMPL
+#define TURBO_LOG_INTERNAL_BUDGETED_STATEFUL_CONDITION_IMPL(kind, ...)       \
+  for (static ::turbo::log_internal::Log##kind##State                      \
+           turbo_log_internal_stateful_condition_state;                    \
+       turbo_log_internal_stateful_condition_do_log &&                     \
+       turbo_log_internal_stateful_condition_state.ShouldLog(__VA_ARGS__) && \
+       ::turbo::log_internal::LogBudgetAllows(                             \
+           turbo_log_internal_budget_severity);                            \
+       turbo_log_internal_stateful_condition_do_log = false)               \
+    for (const uint32_t COUNTER TURBO_ATTRIBUTE_UNUSED =                   \
+             turbo_log_internal_stateful_condition_state.counter();        \
+         turbo_log_internal_stateful_condition_do_log;                     \
+         turbo_log_internal_stateful_condition_do_log = false)
+
 // `TURBO_LOG_INTERNAL_CONDITION_*` serve to combine any conditions from the
 // macro (e.g. `LOG_IF` or `VLOG`) with inherent conditions (e.g.
 // `TURBO_MIN_LOG_LEVEL`) into a single boolean expression.  We could chain
@@ -109,15 +151,18 @@
 // bug.
 #ifdef TURBO_MIN_LOG_LEVEL
 #define TURBO_LOG_INTERNAL_CONDITION_INFO(type, condition) \
-  TURBO_LOG_INTERNAL_##type##_CONDITION(                   \
+  TURBO_LOG_INTERNAL_BUDGETED_##type##_CONDITION(          \
+      ::turbo::LogSeverity::kInfo,                         \
       (condition) && ::turbo::LogSeverity::kInfo >=        \
                          static_cast<::turbo::LogSeverity>(TURBO_MIN_LOG_LEVEL))
 #define TURBO_LOG_INTERNAL_CONDITION_WARNING(type, condition) \
-  TURBO_LOG_INTERNAL_##type##_CONDITION(                      \
+  TURBO_LOG_INTERNAL_BUDGETED_##type##_CONDITION(             \
+      ::turbo::LogSeverity::kWarning,                         \
       (condition) && ::turbo::LogSeverity::kWarning >=        \
                          static_cast<::turbo::LogSeverity>(TURBO_MIN_LOG_LEVEL))
 #define TURBO_LOG_INTERNAL_CONDITION_ERROR(type, condition) \
-  TURBO_LOG_INTERNAL_##type##_CONDITION(                    \
+  TURBO_LOG_INTERNAL_BUDGETED_##type##_CONDITION(           \
+      ::turbo::LogSeverity::kError,                         \
       (condition) && ::turbo::LogSeverity::kError >=        \
                          static_cast<::turbo::LogSeverity>(TURBO_MIN_LOG_LEVEL))
 // NOTE: Use ternary operators instead of short-circuiting to mitigate
@@ -158,19 +203,23 @@
          turbo_log_internal_severity_loop; turbo_log_internal_severity_loop = 0) \
   TURBO_LOG_INTERNAL_CONDITION_LEVEL_IMPL
 #define TURBO_LOG_INTERNAL_CONDITION_LEVEL_IMPL(type, condition)          \
-  TURBO_LOG_INTERNAL_##type##_CONDITION((                                  \
-      (condition) &&                                                     \
-          (turbo_log_internal_severity >=                                 \
-               static_cast<::turbo::LogSeverity>(TURBO_MIN_LOG_LEVEL) ||   \
-           (turbo_log_internal_severity == ::turbo::LogSeverity::kFatal && \
-            (::turbo::log_internal::AbortQuietly(), false)))))
+  TURBO_LOG_INTERNAL_BUDGETED_##type##_CONDITION(                          \
+      turbo_log_internal_severity,                                         \
+      ((condition) &&                                                      \
+       (turbo_log_internal_severity >=                                     \
+            static_cast<::turbo::LogSeverity>(TURBO_MIN_LOG_LEVEL) ||       \
+        (turbo_log_internal_severity == ::turbo::LogSeverity::kFatal &&     \
+         (::turbo::log_internal::AbortQuietly(), false)))))
 #else  // ndef TURBO_MIN_LOG_LEVEL
-#define TURBO_LOG_INTERNAL_CONDITION_INFO(type, condition) \
-  TURBO_LOG_INTERNAL_##type##_CONDITION(condition)
-#define TURBO_LOG_INTERNAL_CONDITION_WARNING(type, condition) \
-  TURBO_LOG_INTERNAL_##type##_CONDITION(condition)
-#define TURBO_LOG_INTERNAL_CONDITION_ERROR(type, condition) \
-  TURBO_LOG_INTERNAL_##type##_CONDITION(condition)
+#define TURBO_LOG_INTERNAL_CONDITION_INFO(type, condition)                    \
+  TURBO_LOG_INTERNAL_BUDGETED_##type##_CONDITION(::turbo::LogSeverity::kInfo, \
+                                                condition)
+#define TURBO_LOG_INTERNAL_CONDITION_WARNING(type, condition)                    \
+  TURBO_LOG_INTERNAL_BUDGETED_##type##_CONDITION(::turbo::LogSeverity::kWarning, \
+                                                condition)
+#define TURBO_LOG_INTERNAL_CONDITION_ERROR(type, condition)                    \
+  TURBO_LOG_INTERNAL_BUDGETED_##type##_CONDITION(::turbo::LogSeverity::kError, \
+                                                condition)
 #define TURBO_LOG_INTERNAL_CONDITION_FATAL(type, condition) \
   TURBO_LOG_INTERNAL_##type##_CONDITION(condition)
 #define TURBO_LOG_INTERNAL_CONDITION_QFATAL(type, condition) \
@@ -185,7 +234,8 @@
          turbo_log_internal_severity_loop; turbo_log_internal_severity_loop = 0) \
   TURBO_LOG_INTERNAL_CONDITION_LEVEL_IMPL
 #define TURBO_LOG_INTERNAL_CONDITION_LEVEL_IMPL(type, condition) \
-  TURBO_LOG_INTERNAL_##type##_CONDITION(condition)
+  TURBO_LOG_INTERNAL_BUDGETED_##type##_CONDITION(                 \
+      turbo_log_internal_severity, condition)
 #endif  // ndef TURBO_MIN_LOG_LEVEL
 
 namespace turbo {
@@ -231,6 +281,49 @@ class LogEveryNSecState final {
   std::atomic<int64_t> next_log_time_cycles_{0};
 };
 
+// The process-wide log budget behind `set_log_budget()`.  `LogBudgetAllows`
+// takes a line from the budget of `severity`, or returns false and counts a
+// dropped message when that budget is spent; FATAL is never budgeted.  Bytes
+// are only known once a message has been formatted, so `ChargeLogBudget`
+// takes them afterwards and an overdrawn byte budget stops the next lines.
+extern std::atomic<bool> log_budget_enabled;
+
+bool LogBudgetAllowsSlow(turbo::LogSeverity severity);
+
+inline bool LogBudgetAllows(turbo::LogSeverity severity) {
+  return !log_budget_enabled.load(std::memory_order_relaxed) ||
+         LogBudgetAllowsSlow(severity);
+}
+
+void ChargeLogBudgetSlow(turbo::LogSeverity severity, size_t bytes);
+
+// `LogBudgetAllows` only makes the periodic summary of dropped messages due,
+// as it runs inside the condition of a `LOG` statement; `LogBudgetSummaryIfDue`
+// logs it, uncharged, from outside of one.
+extern std::atomic<bool> log_budget_summary_due;
+
+void LogBudgetSummarySlow();
+
+inline void LogBudgetSummaryIfDue() {
+  if (log_budget_summary_due.load(std::memory_order_relaxed)) {
+    LogBudgetSummarySlow();
+  }
+}
+
+inline void ChargeLogBudget(turbo::LogSeverity severity, size_t bytes) {
+  if (log_budget_enabled.load(std::memory_order_relaxed)) {
+    ChargeLogBudgetSlow(severity, bytes);
+  }
+}
+
+// Implementation of the log budget functions of log/globals.h.
+void SetLogBudget(turbo::LogSeverity severity, int64_t lines_per_second,
+                  int64_t bytes_per_second);
+void GetLogBudget(turbo::LogSeverity severity, int64_t* lines_per_second,
+                  int64_t* bytes_per_second);
+uint64_t LogBudgetDropped(turbo::LogSeverity severity);
+void SetLogBudgetSummaryPeriod(double seconds);
+
 // Helper routines to abort the application quietly
 
 TURBO_ATTRIBUTE_NORETURN inline void AbortQuietly() { abort(); }
@@ -0,0 +1,571 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/log/internal/deferred_log.h>
+
+#include <array>
+#include <cstdio>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include <turbo/base/const_init.h>
+#include <turbo/base/internal/sysinfo.h>
+#include <turbo/base/no_destructor.h>
+#include <turbo/base/thread_annotations.h>
+#include <turbo/container/inlined_vector.h>
+#include <turbo/log/deferred_log.h>
+#include <turbo/log/internal/log_format.h>
+#include <turbo/log/internal/log_message.h>
+#include <turbo/log/log.h>
+#include <turbo/strings/str_format.h>
+#include <turbo/synchronization/mutex.h>
+#include <turbo/times/time.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+namespace log_internal {
+
+namespace {
+
+TURBO_CONST_INIT turbo::Mutex site_registry_mutex(turbo::kConstInit);
+
+// Sites indexed by id - 1.  Sites are statics and never unregistered.
+std::vector<DeferredLogSite*>& RegisteredSites()
+    TURBO_EXCLUSIVE_LOCKS_REQUIRED(site_registry_mutex) {
+  static turbo::NoDestructor<std::vector<DeferredLogSite*>> sites;
+  return *sites;
+}
+
+struct DeferredArgValue {
+  DeferredRecordTag kind;
+  union {
+    int64_t i;
+    uint64_t u;
+    double d;
+    bool b;
+    const void* p;
+  };
+  std::string_view s;
+};
+
+struct DeferredRecord {
+  uint32_t site = 0;
+  int64_t timestamp_ns = 0;
+  turbo::InlinedVector<DeferredArgValue, 8> args;
+};
+
+// Decodes the contents of a `kStreamRecord` field.
+void DecodeDeferredRecord(turbo::span<const char> contents,
+                          DeferredRecord* record) {
+  record->args.clear();
+  ProtoField field;
+  while (field.DecodeFrom(&contents)) {
+    DeferredArgValue value;
+    value.kind = static_cast<DeferredRecordTag>(field.tag());
+    switch (field.tag()) {
+      case kRecordSite:
+        record->site = field.uint32_value();
+        continue;
+      case kRecordTimestamp:
+        record->timestamp_ns = field.int64_value();
+        continue;
+      case kArgSigned:
+        value.i = field.sint64_value();
+        break;
+      case kArgUnsigned:
+        value.u = field.uint64_value();
+        break;
+      case kArgDouble:
+        value.d = field.double_value();
+        break;
+      case kArgBool:
+        value.b = field.bool_value();
+        break;
+      case kArgString:
+        value.u = 0;
+        value.s = field.string_value();
+        break;
+      case kArgPointer:
+        value.p = reinterpret_cast<const void*>(
+            static_cast<uintptr_t>(field.uint64_value()));
+        break;
+      default:
+        continue;
+    }
+    record->args.push_back(value);
+  }
+}
+
+// Replaces `*text` with the arguments of `record` formatted by `format`, or by
+// its compiled form if there is one.
+void FormatDeferredRecord(
+    const char* format,
+    const str_format_internal::CompiledFormatView* compiled_format,
+    const DeferredRecord& record, std::string* text) {
+  turbo::InlinedVector<turbo::FormatArg, 8> args;
+  for (const DeferredArgValue& value : record.args) {
+    switch (value.kind) {
+      case kArgSigned:
+        args.emplace_back(value.i);
+        break;
+      case kArgUnsigned:
+        args.emplace_back(value.u);
+        break;
+      case kArgDouble:
+        args.emplace_back(value.d);
+        break;
+      case kArgBool:
+        args.emplace_back(value.b);
+        break;
+      case kArgString:
+        args.emplace_back(value.s);
+        break;
+      default:
+        args.emplace_back(value.p);
+        break;
+    }
+  }
+  text->clear();
+  const str_format_internal::UntypedFormatSpecImpl spec =
+      compiled_format != nullptr
+          ? str_format_internal::UntypedFormatSpecImpl(compiled_format)
+          : str_format_internal::UntypedFormatSpecImpl(format);
+  if (!str_format_internal::format_untyped(text, spec, args)) {
+    text->assign(format);
+    text->append(" [LOG_DEFERRED: format does not match arguments]");
+  }
+}
+
+// Returns the contents of the record field whose complete bytes are `field`.
+turbo::span<const char> RecordContents(turbo::span<const char> field) {
+  ProtoField decoded;
+  decoded.DecodeFrom(&field);
+  return decoded.bytes_value();
+}
+
+size_t RoundUpToPowerOfTwo(size_t n) {
+  size_t p = 4096;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+// Owns the staging buffers and the thread that drains them.
+class DeferredLogCollector final {
+ public:
+  bool Start(const DeferredLogOptions& options)
+      TURBO_LOCKS_EXCLUDED(mu_, drain_mu_);
+  void Stop() TURBO_LOCKS_EXCLUDED(mu_, drain_mu_);
+  void Flush() TURBO_LOCKS_EXCLUDED(mu_, drain_mu_);
+  DeferredStagingBuffer* Attach() TURBO_LOCKS_EXCLUDED(mu_);
+  DeferredLogStats Stats() TURBO_LOCKS_EXCLUDED(mu_);
+
+ private:
+  void Run() TURBO_LOCKS_EXCLUDED(mu_, drain_mu_);
+  void Drain() TURBO_LOCKS_EXCLUDED(mu_, drain_mu_);
+  void DrainLocked() TURBO_EXCLUSIVE_LOCKS_REQUIRED(drain_mu_)
+      TURBO_LOCKS_EXCLUDED(mu_);
+  // Writes the definitions of sites registered since the last call.
+  void WriteNewSites(std::string* out) TURBO_EXCLUSIVE_LOCKS_REQUIRED(drain_mu_);
+  uint64_t TotalDropped() TURBO_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  turbo::Mutex mu_;
+  turbo::CondVar cv_;
+  std::vector<DeferredStagingBuffer*> buffers_ TURBO_GUARDED_BY(mu_);
+  size_t buffer_size_ TURBO_GUARDED_BY(mu_) = 0;
+  turbo::Duration drain_interval_ TURBO_GUARDED_BY(mu_);
+  bool running_ TURBO_GUARDED_BY(mu_) = false;
+  bool stop_ TURBO_GUARDED_BY(mu_) = false;
+  // Drops counted by buffers that have since been freed.
+  uint64_t retired_dropped_ TURBO_GUARDED_BY(mu_) = 0;
+  std::thread thread_;
+
+  // Serializes draining.  Acquired before `mu_` when both are held.
+  turbo::Mutex drain_mu_;
+  std::FILE* binary_file_ TURBO_GUARDED_BY(drain_mu_) = nullptr;
+  uint32_t sites_written_ TURBO_GUARDED_BY(drain_mu_) = 0;
+  uint64_t reported_dropped_ TURBO_GUARDED_BY(drain_mu_) = 0;
+  std::atomic<uint64_t> delivered_{0};
+};
+
+DeferredLogCollector& Collector() {
+  static turbo::NoDestructor<DeferredLogCollector> collector;
+  return *collector;
+}
+
+bool DeferredLogCollector::Start(const DeferredLogOptions& options) {
+  turbo::MutexLock drain_lock(&drain_mu_);
+  turbo::MutexLock lock(&mu_);
+  if (running_) return false;
+  if (!options.binary_path.empty()) {
+    std::FILE* file = std::fopen(options.binary_path.c_str(), "ab");
+    if (file == nullptr) return false;
+    std::array<char, BufferSizeFor(WireType::kLengthDelimited) +
+                         kDeferredLogMagic.size()>
+        header;
+    turbo::span<char> buf = turbo::MakeSpan(header);
+    EncodeString(kStreamHeader, kDeferredLogMagic, &buf);
+    std::fwrite(header.data(), 1, header.size() - buf.size(), file);
+    binary_file_ = file;
+    sites_written_ = 0;
+  }
+  buffer_size_ = RoundUpToPowerOfTwo(options.thread_buffer_size);
+  drain_interval_ = options.drain_interval;
+  running_ = true;
+  stop_ = false;
+  deferred_logging_active.store(true, std::memory_order_relaxed);
+  thread_ = std::thread([this] { Run(); });
+  return true;
+}
+
+void DeferredLogCollector::Stop() {
+  {
+    turbo::MutexLock lock(&mu_);
+    if (!running_ || stop_) return;
+    stop_ = true;
+    cv_.Signal();
+  }
+  // A call that began its record before the flag was cleared may still be
+  // writing it; wait for it so the final drain below picks the record up.
+  // Later calls see the flag clear and format immediately.
+  deferred_logging_active.store(false, std::memory_order_seq_cst);
+  thread_.join();
+  {
+    turbo::MutexLock lock(&mu_);
+    for (const DeferredStagingBuffer* buffer : buffers_) {
+      while (buffer->writing()) std::this_thread::yield();
+    }
+  }
+  {
+    turbo::MutexLock drain_lock(&drain_mu_);
+    DrainLocked();
+    if (binary_file_ != nullptr) {
+      std::fclose(binary_file_);
+      binary_file_ = nullptr;
+    }
+  }
+  turbo::MutexLock lock(&mu_);
+  running_ = false;
+}
+
+void DeferredLogCollector::Flush() {
+  {
+    turbo::MutexLock lock(&mu_);
+    if (!running_) return;
+  }
+  Drain();
+}
+
+DeferredStagingBuffer* DeferredLogCollector::Attach() {
+  turbo::MutexLock lock(&mu_);
+  if (!running_) return nullptr;
+  auto* buffer = new DeferredStagingBuffer(buffer_size_,
+                                           turbo::base_internal::GetCachedTID());
+  buffers_.push_back(buffer);
+  return buffer;
+}
+
+uint64_t DeferredLogCollector::TotalDropped() {
+  uint64_t dropped = retired_dropped_;
+  for (const DeferredStagingBuffer* buffer : buffers_) {
+    dropped += buffer->dropped();
+  }
+  return dropped;
+}
+
+DeferredLogStats DeferredLogCollector::Stats() {
+  turbo::MutexLock lock(&mu_);
+  DeferredLogStats stats;
+  stats.delivered = delivered_.load(std::memory_order_relaxed);
+  stats.dropped = TotalDropped();
+  return stats;
+}
+
+void DeferredLogCollector::Run() {
+  for (;;) {
+    {
+      turbo::MutexLock lock(&mu_);
+      if (!stop_) cv_.WaitWithTimeout(&mu_, drain_interval_);
+      if (stop_) return;
+    }
+    Drain();
+  }
+}
+
+void DeferredLogCollector::Drain() {
+  turbo::MutexLock drain_lock(&drain_mu_);
+  DrainLocked();
+}
+
+void DeferredLogCollector::WriteNewSites(std::string* out) {
+  turbo::MutexLock lock(&site_registry_mutex);
+  const std::vector<DeferredLogSite*>& sites = RegisteredSites();
+  for (; sites_written_ < sites.size(); ++sites_written_) {
+    const DeferredLogSite& site = *sites[sites_written_];
+    const std::string_view file = site.file();
+    const std::string_view format = site.format();
+    std::string field(BufferSizeFor(WireType::kLengthDelimited, WireType::kVarint,
+                                    WireType::kLengthDelimited, WireType::kVarint,
+                                    WireType::kVarint,
+                                    WireType::kLengthDelimited) +
+                          file.size() + format.size(),
+                      '\0');
+    turbo::span<char> buf = turbo::MakeSpan(field);
+    turbo::span<char> msg = EncodeMessageStart(kStreamSite, buf.size(), &buf);
+    EncodeVarint(kSiteId, sites_written_ + 1, &buf);
+    EncodeString(kSiteFile, file, &buf);
+    EncodeVarint(kSiteLine, site.line(), &buf);
+    EncodeVarint(kSiteSeverity, static_cast<int>(site.severity()), &buf);
+    EncodeString(kSiteFormat, format, &buf);
+    EncodeMessageLength(msg, &buf);
+    out->append(field.data(), field.size() - buf.size());
+  }
+}
+
+void DeferredLogCollector::DrainLocked() {
+  std::vector<DeferredStagingBuffer*> buffers;
+  {
+    turbo::MutexLock lock(&mu_);
+    buffers = buffers_;
+  }
+  // Every site referenced by a record published below these limits was
+  // registered before the record, so a site snapshot taken afterwards
+  // covers them all.
+  std::vector<uint64_t> limits;
+  limits.reserve(buffers.size());
+  for (const DeferredStagingBuffer* buffer : buffers) {
+    limits.push_back(buffer->produced());
+  }
+
+  DeferredRecord record;
+  std::string text;
+  std::string out;
+  if (binary_file_ != nullptr) WriteNewSites(&out);
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    DeferredStagingBuffer* buffer = buffers[i];
+    if (binary_file_ != nullptr) {
+      const size_t thread_field = out.size();
+      out.resize(thread_field + BufferSizeFor(WireType::kVarint));
+      turbo::span<char> buf =
+          turbo::MakeSpan(&out[thread_field], out.size() - thread_field);
+      EncodeVarint(kStreamThread, buffer->tid(), &buf);
+      out.resize(out.size() - buf.size());
+      const size_t records_start = out.size();
+      buffer->Consume(limits[i], [&](turbo::span<const char> field) {
+        out.append(field.data(), field.size());
+        delivered_.fetch_add(1, std::memory_order_relaxed);
+      });
+      if (out.size() == records_start) out.resize(thread_field);
+      continue;
+    }
+    buffer->Consume(limits[i], [&](turbo::span<const char> field) {
+      DecodeDeferredRecord(RecordContents(field), &record);
+      const DeferredLogSite* site = FindDeferredLogSite(record.site);
+      if (site == nullptr) return;
+      FormatDeferredRecord(site->format(), site->compiled_format(), record,
+                           &text);
+      LogMessage(site->file(), site->line(), site->severity())
+              .WithTimestamp(turbo::Time::from_nanoseconds(record.timestamp_ns))
+              .WithThreadID(buffer->tid())
+          << text;
+      delivered_.fetch_add(1, std::memory_order_relaxed);
+    });
+  }
+  if (binary_file_ != nullptr && !out.empty()) {
+    std::fwrite(out.data(), 1, out.size(), binary_file_);
+    std::fflush(binary_file_);
+  }
+
+  uint64_t dropped;
+  {
+    turbo::MutexLock lock(&mu_);
+    for (auto it = buffers_.begin(); it != buffers_.end();) {
+      DeferredStagingBuffer* buffer = *it;
+      if (buffer->retired() && buffer->empty()) {
+        retired_dropped_ += buffer->dropped();
+        delete buffer;
+        it = buffers_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    dropped = TotalDropped();
+  }
+  if (dropped > reported_dropped_) {
+    LOG(WARNING) << "LOG_DEFERRED dropped " << dropped - reported_dropped_
+                 << " records because a thread's staging buffer was full";
+    reported_dropped_ = dropped;
+  }
+}
+
+// Retires the thread's staging buffer when the thread exits.
+TURBO_CONST_INIT thread_local bool tls_deferred_detached = false;
+
+struct ThreadDetacher {
+  ~ThreadDetacher() {
+    tls_deferred_detached = true;
+    if (tls_deferred_buffer != nullptr) {
+      tls_deferred_buffer->Retire();
+      tls_deferred_buffer = nullptr;
+    }
+  }
+};
+
+}  // namespace
+
+uint32_t RegisterDeferredLogSite(DeferredLogSite* site, const char* format) {
+  turbo::MutexLock lock(&site_registry_mutex);
+  uint32_t id = site->id_.load(std::memory_order_relaxed);
+  if (id != 0) return id;
+  std::vector<DeferredLogSite*>& sites = RegisteredSites();
+  site->format_ = format;
+  sites.push_back(site);
+  id = static_cast<uint32_t>(sites.size());
+  site->id_.store(id, std::memory_order_release);
+  return id;
+}
+
+const DeferredLogSite* FindDeferredLogSite(uint32_t id) {
+  turbo::MutexLock lock(&site_registry_mutex);
+  const std::vector<DeferredLogSite*>& sites = RegisteredSites();
+  return id - 1 < sites.size() ? sites[id - 1] : nullptr;
+}
+
+DeferredStagingBuffer::DeferredStagingBuffer(size_t size, Tid tid)
+    : data_(new char[size]), size_(size), tid_(tid) {}
+
+DeferredStagingBuffer::~DeferredStagingBuffer() { delete[] data_; }
+
+DeferredStagingBuffer* AttachDeferredStagingBuffer() {
+  if (tls_deferred_detached) return nullptr;
+  DeferredStagingBuffer* buffer = Collector().Attach();
+  if (buffer == nullptr) return nullptr;
+  static thread_local ThreadDetacher detacher;
+  (void)detacher;
+  tls_deferred_buffer = buffer;
+  return buffer;
+}
+
+void LogDeferredRecordNow(const DeferredLogSite& site, const char* format,
+                          turbo::span<const char> record) {
+  DeferredRecord decoded;
+  DecodeDeferredRecord(RecordContents(record), &decoded);
+  std::string text;
+  FormatDeferredRecord(format, site.compiled_format(), decoded, &text);
+  LogMessage(site.file(), site.line(), site.severity())
+          .WithTimestamp(turbo::Time::from_nanoseconds(decoded.timestamp_ns))
+      << text;
+}
+
+}  // namespace log_internal
+
+bool start_deferred_logging(const DeferredLogOptions& options) {
+  return log_internal::Collector().Start(options);
+}
+
+void stop_deferred_logging() { log_internal::Collector().Stop(); }
+
+void flush_deferred_log() { log_internal::Collector().Flush(); }
+
+DeferredLogStats deferred_log_stats() {
+  return log_internal::Collector().Stats();
+}
+
+bool decode_deferred_log(std::string_view data, std::string* out) {
+  struct Site {
+    std::string_view file;
+    int line = 0;
+    turbo::LogSeverity severity = turbo::LogSeverity::kInfo;
+    std::string format;
+  };
+  std::vector<Site> sites;
+  bool seen_header = false;
+  log_internal::Tid tid = 0;
+  log_internal::DeferredRecord record;
+  std::string text;
+  turbo::span<const char> buf(data.data(), data.size());
+  log_internal::ProtoField field;
+  while (field.DecodeFrom(&buf)) {
+    if (field.type() == log_internal::WireType::kLengthDelimited &&
+        field.bytes_value().size() != field.encoded_length()) {
+      return false;
+    }
+    if (field.tag() == log_internal::kStreamHeader) {
+      if (field.string_value() != log_internal::kDeferredLogMagic) return false;
+      seen_header = true;
+      sites.clear();
+      continue;
+    }
+    if (!seen_header) return false;
+    switch (field.tag()) {
+      case log_internal::kStreamSite: {
+        Site site;
+        uint32_t id = 0;
+        turbo::span<const char> contents = field.bytes_value();
+        log_internal::ProtoField site_field;
+        while (site_field.DecodeFrom(&contents)) {
+          switch (site_field.tag()) {
+            case log_internal::kSiteId:
+              id = site_field.uint32_value();
+              break;
+            case log_internal::kSiteFile:
+              site.file = site_field.string_value();
+              break;
+            case log_internal::kSiteLine:
+              site.line = site_field.int32_value();
+              break;
+            case log_internal::kSiteSeverity:
+              site.severity =
+                  static_cast<turbo::LogSeverity>(site_field.int32_value());
+              break;
+            case log_internal::kSiteFormat:
+              site.format = std::string(site_field.string_value());
+              break;
+          }
+        }
+        if (id == 0) return false;
+        if (sites.size() < id) sites.resize(id);
+        sites[id - 1] = std::move(site);
+        break;
+      }
+      case log_internal::kStreamThread:
+        tid = static_cast<log_internal::Tid>(field.uint64_value());
+        break;
+      case log_internal::kStreamRecord: {
+        log_internal::DecodeDeferredRecord(field.bytes_value(), &record);
+        if (record.site == 0 || record.site > sites.size()) return false;
+        const Site& site = sites[record.site - 1];
+        log_internal::FormatDeferredRecord(site.format.c_str(), nullptr, record,
+                                           &text);
+        std::array<char, 256> prefix;
+        turbo::span<char> prefix_buf = turbo::MakeSpan(prefix);
+        const size_t prefix_size = log_internal::FormatLogPrefix(
+            site.severity, turbo::Time::from_nanoseconds(record.timestamp_ns),
+            tid, site.file.substr(site.file.rfind('/') + 1), site.line,
+            log_internal::PrefixFormat::kNotRaw, prefix_buf);
+        out->append(prefix.data(), prefix_size);
+        out->append(text);
+        out->push_back('\n');
+        break;
+      }
+    }
+  }
+  return seen_header;
+}
+
+TURBO_NAMESPACE_END
+}  // namespace turbo
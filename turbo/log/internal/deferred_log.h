@@ -0,0 +1,484 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+// File: log/internal/deferred_log.h
+// -----------------------------------------------------------------------------
+//
+// Hot path of `LOG_DEFERRED`.  A call records the id of its call site, a
+// timestamp and the raw argument values into a staging buffer owned by the
+// calling thread, encoded with the `proto.h` primitives.  Formatting happens
+// later on the drain thread or in an offline decoder.
+//
+// Stream layout (protocol buffer wire format, no schema file):
+//
+//   stream  := { header | site | thread | record }
+//   header  := kStreamHeader: string "turbo.deferred_log.1"
+//   site    := kStreamSite: { kSiteId kSiteFile kSiteLine kSiteSeverity
+//                             kSiteFormat }
+//   thread  := kStreamThread: varint tid of the records that follow
+//   record  := kStreamRecord: { kRecordSite kRecordTimestamp arg* }
+//
+// Staging buffers only ever hold records; the other fields are written by the
+// drain thread when it emits a binary stream.
+
+#ifndef TURBO_LOG_INTERNAL_DEFERRED_LOG_H_
+#define TURBO_LOG_INTERNAL_DEFERRED_LOG_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include <turbo/base/attributes.h>
+#include <turbo/base/config.h>
+#include <turbo/base/log_severity.h>
+#include <turbo/base/optimization.h>
+#include <turbo/container/span.h>
+#include <turbo/log/globals.h>
+#include <turbo/log/internal/conditions.h>
+#include <turbo/log/internal/config.h>
+#include <turbo/log/internal/proto.h>
+#include <turbo/strings/internal/str_format/compiled_format.h>
+#include <turbo/strings/string_view.h>
+#include <turbo/times/clock.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+namespace log_internal {
+
+// Top-level fields of a deferred log stream.
+enum DeferredStreamTag : uint8_t {
+  kStreamHeader = 1,
+  kStreamSite = 2,
+  kStreamThread = 3,
+  kStreamRecord = 4,
+};
+
+// Fields of a site definition.
+enum DeferredSiteTag : uint8_t {
+  kSiteId = 1,
+  kSiteFile = 2,
+  kSiteLine = 3,
+  kSiteSeverity = 4,
+  kSiteFormat = 5,
+};
+
+// Fields of a record.  Arguments follow in order, each tagged with its kind.
+enum DeferredRecordTag : uint8_t {
+  kRecordSite = 1,
+  kRecordTimestamp = 2,
+  kArgSigned = 3,
+  kArgUnsigned = 4,
+  kArgDouble = 5,
+  kArgBool = 6,
+  kArgString = 7,
+  kArgPointer = 8,
+};
+
+inline constexpr std::string_view kDeferredLogMagic = "turbo.deferred_log.1";
+
+// String arguments longer than this are truncated.
+inline constexpr size_t kDeferredMaxStringSize = 1024;
+
+// A `LOG_DEFERRED` call site.  Instances are function-local statics with
+// constant initialization; the id is assigned on first use.
+class DeferredLogSite final {
+ public:
+  constexpr DeferredLogSite(
+      const char* file, int line, turbo::LogSeverity severity,
+      const str_format_internal::CompiledFormatView* compiled_format)
+      : file_(file),
+        line_(line),
+        severity_(severity),
+        compiled_format_(compiled_format),
+        format_(nullptr) {}
+  DeferredLogSite(const DeferredLogSite&) = delete;
+  DeferredLogSite& operator=(const DeferredLogSite&) = delete;
+
+  const char* file() const { return file_; }
+  int line() const { return line_; }
+  turbo::LogSeverity severity() const { return severity_; }
+  // Only valid once `id()` is non-zero.
+  const char* format() const { return format_; }
+  // `format()` parsed at compile time, or nullptr if it is malformed.
+  const str_format_internal::CompiledFormatView* compiled_format() const {
+    return compiled_format_;
+  }
+
+  uint32_t id() const { return id_.load(std::memory_order_acquire); }
+
+ private:
+  friend uint32_t RegisterDeferredLogSite(DeferredLogSite* site,
+                                          const char* format);
+
+  const char* const file_;
+  const int line_;
+  const turbo::LogSeverity severity_;
+  const str_format_internal::CompiledFormatView* const compiled_format_;
+  const char* format_;
+  std::atomic<uint32_t> id_{0};
+};
+
+// Assigns `site` the next id and remembers `format` for it.  Returns the id.
+uint32_t RegisterDeferredLogSite(DeferredLogSite* site, const char* format);
+
+// Returns the site registered under `id`, or nullptr.
+const DeferredLogSite* FindDeferredLogSite(uint32_t id);
+
+// Whether `turbo::start_deferred_logging()` is in effect.
+inline std::atomic<bool> deferred_logging_active{false};
+
+// A single-producer single-consumer ring of encoded records.  The owning
+// thread reserves and commits records; the drain thread consumes them.  A
+// record never wraps around the end of the ring: if it does not fit in the
+// tail, a zero byte (an invalid field header) marks the rest of the tail as
+// padding and the record starts over at offset zero.
+class DeferredStagingBuffer final {
+ public:
+  // `size` must be a power of two.
+  DeferredStagingBuffer(size_t size, Tid tid);
+  ~DeferredStagingBuffer();
+  DeferredStagingBuffer(const DeferredStagingBuffer&) = delete;
+  DeferredStagingBuffer& operator=(const DeferredStagingBuffer&) = delete;
+
+  // Brackets the `Reserve()` and `Commit()` of a record.  `BeginRecord()`
+  // returns false, and the record must not be staged, if deferred logging is
+  // not active.  Otherwise the collector waits for `EndRecord()` before its
+  // final drain, so a record begun while it was being stopped is delivered.
+  bool BeginRecord() {
+    writing_.store(true, std::memory_order_seq_cst);
+    if (deferred_logging_active.load(std::memory_order_seq_cst)) return true;
+    writing_.store(false, std::memory_order_relaxed);
+    return false;
+  }
+  void EndRecord() { writing_.store(false, std::memory_order_release); }
+
+  // Returns `n` contiguous bytes to encode a record into, or an empty span if
+  // the ring is too full, in which case the record is counted as dropped.
+  turbo::span<char> Reserve(size_t n) {
+    const uint64_t pos = produced_.load(std::memory_order_relaxed);
+    const size_t tail = size_ - static_cast<size_t>(pos & (size_ - 1));
+    const size_t need = n <= tail ? n : tail + n;
+    if (pos + need - consumed_cache_ > size_) {
+      consumed_cache_ = consumed_.load(std::memory_order_acquire);
+      if (pos + need - consumed_cache_ > size_) {
+        dropped_.store(dropped_.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+        return turbo::span<char>();
+      }
+    }
+    if (n > tail) {
+      data_[size_ - tail] = '\0';
+      skipped_ = tail;
+      return turbo::span<char>(data_, n);
+    }
+    skipped_ = 0;
+    return turbo::span<char>(data_ + (size_ - tail), n);
+  }
+
+  // Publishes the first `used` bytes of the span returned by `Reserve()`.
+  void Commit(size_t used) {
+    produced_.store(
+        produced_.load(std::memory_order_relaxed) + skipped_ + used,
+        std::memory_order_release);
+  }
+
+  // Drain side.  Returns the position up to which records are published.
+  uint64_t produced() const {
+    return produced_.load(std::memory_order_acquire);
+  }
+
+  // Drain side.  Calls `fn(turbo::span<const char>)` with the complete bytes of
+  // every record published below `limit`, then releases their space.
+  template <typename Fn>
+  void Consume(uint64_t limit, Fn fn) {
+    uint64_t pos = consumed_.load(std::memory_order_relaxed);
+    while (pos < limit) {
+      const size_t offset = static_cast<size_t>(pos & (size_ - 1));
+      if (data_[offset] == '\0') {
+        pos += size_ - offset;
+        continue;
+      }
+      const size_t avail = static_cast<size_t>(
+          limit - pos < size_ - offset ? limit - pos : size_ - offset);
+      turbo::span<const char> rest(data_ + offset, avail);
+      ProtoField field;
+      field.DecodeFrom(&rest);
+      const size_t used = avail - rest.size();
+      fn(turbo::span<const char>(data_ + offset, used));
+      pos += used;
+    }
+    consumed_.store(pos, std::memory_order_release);
+  }
+
+  bool empty() const {
+    return consumed_.load(std::memory_order_acquire) == produced();
+  }
+
+  // Drain side.  Whether the owning thread is between `BeginRecord()` and
+  // `EndRecord()`.
+  bool writing() const { return writing_.load(std::memory_order_seq_cst); }
+
+  Tid tid() const { return tid_; }
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+  // Set when the owning thread exits; the drain thread frees the buffer once
+  // it is empty.
+  void Retire() { retired_.store(true, std::memory_order_release); }
+  bool retired() const { return retired_.load(std::memory_order_acquire); }
+
+ private:
+  char* const data_;
+  const size_t size_;
+  const Tid tid_;
+
+  // Owned by the producing thread.
+  alignas(64) std::atomic<uint64_t> produced_{0};
+  uint64_t consumed_cache_ = 0;
+  size_t skipped_ = 0;
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<bool> writing_{false};
+
+  // Owned by the drain thread.
+  alignas(64) std::atomic<uint64_t> consumed_{0};
+  std::atomic<bool> retired_{false};
+};
+
+// The calling thread's staging buffer, once it has logged while deferred
+// logging was active.
+inline TURBO_CONST_INIT thread_local DeferredStagingBuffer* tls_deferred_buffer =
+    nullptr;
+
+// Creates and registers the calling thread's staging buffer.  Returns nullptr
+// if the thread is exiting.
+DeferredStagingBuffer* AttachDeferredStagingBuffer();
+
+// Formats and logs a record through `LogMessage` right away.  Used while
+// deferred logging is inactive.
+void LogDeferredRecordNow(const DeferredLogSite& site, const char* format,
+                          turbo::span<const char> record);
+
+// Argument encoding.  Each argument kind has an upper bound on its encoded
+// size so that the whole record can be reserved in one step.
+
+template <typename T, typename = void>
+struct DeferredArgTraits {
+  static_assert(sizeof(T) == 0,
+                "LOG_DEFERRED arguments must be integers, enums, floating-point "
+                "values, strings or pointers");
+};
+
+template <typename T>
+struct DeferredArgTraits<
+    T, std::enable_if_t<std::is_integral<T>::value &&
+                        !std::is_same<T, bool>::value>> {
+  static constexpr size_t Bound(T) {
+    return BufferSizeFor(WireType::kVarint);
+  }
+  static void Encode(T v, turbo::span<char>* buf) {
+    if (std::is_signed<T>::value) {
+      EncodeVarintZigZag(kArgSigned, static_cast<int64_t>(v), buf);
+    } else {
+      EncodeVarint(kArgUnsigned, static_cast<uint64_t>(v), buf);
+    }
+  }
+};
+
+template <>
+struct DeferredArgTraits<bool> {
+  static constexpr size_t Bound(bool) {
+    return BufferSizeFor(WireType::kVarint);
+  }
+  static void Encode(bool v, turbo::span<char>* buf) {
+    EncodeVarint(kArgBool, uint64_t{v}, buf);
+  }
+};
+
+template <typename T>
+struct DeferredArgTraits<T, std::enable_if_t<std::is_enum<T>::value>> {
+  using Underlying = std::underlying_type_t<T>;
+  static constexpr size_t Bound(T) {
+    return BufferSizeFor(WireType::kVarint);
+  }
+  static void Encode(T v, turbo::span<char>* buf) {
+    DeferredArgTraits<Underlying>::Encode(static_cast<Underlying>(v), buf);
+  }
+};
+
+template <typename T>
+struct DeferredArgTraits<T,
+                         std::enable_if_t<std::is_floating_point<T>::value>> {
+  static constexpr size_t Bound(T) { return BufferSizeFor(WireType::k64Bit); }
+  static void Encode(T v, turbo::span<char>* buf) {
+    EncodeDouble(kArgDouble, static_cast<double>(v), buf);
+  }
+};
+
+struct DeferredStringArgTraits {
+  static size_t Bound(std::string_view v) {
+    return BufferSizeFor(WireType::kLengthDelimited) +
+           (v.size() < kDeferredMaxStringSize ? v.size()
+                                              : kDeferredMaxStringSize);
+  }
+  static void Encode(std::string_view v, turbo::span<char>* buf) {
+    EncodeString(kArgString, v.substr(0, kDeferredMaxStringSize), buf);
+  }
+};
+
+template <>
+struct DeferredArgTraits<std::string_view> : DeferredStringArgTraits {};
+template <>
+struct DeferredArgTraits<std::string> : DeferredStringArgTraits {};
+template <>
+struct DeferredArgTraits<const char*> : DeferredStringArgTraits {
+  static size_t Bound(const char* v) {
+    return DeferredStringArgTraits::Bound(v == nullptr ? "" : v);
+  }
+  static void Encode(const char* v, turbo::span<char>* buf) {
+    DeferredStringArgTraits::Encode(v == nullptr ? "" : v, buf);
+  }
+};
+template <>
+struct DeferredArgTraits<char*> : DeferredArgTraits<const char*> {};
+
+template <typename T>
+struct DeferredArgTraits<
+    T*, std::enable_if_t<!std::is_same<std::remove_cv_t<T>, char>::value>> {
+  static constexpr size_t Bound(const T*) {
+    return BufferSizeFor(WireType::kVarint);
+  }
+  static void Encode(const T* v, turbo::span<char>* buf) {
+    EncodeVarint(kArgPointer, reinterpret_cast<uintptr_t>(v), buf);
+  }
+};
+
+// Arrays (string literals) decay like they do for `str_format`.
+template <typename T>
+using DeferredArgType = std::conditional_t<std::is_array<T>::value,
+                                           std::decay_t<T>, std::remove_cv_t<T>>;
+
+template <typename T>
+size_t DeferredArgBound(const T& v) {
+  return DeferredArgTraits<DeferredArgType<T>>::Bound(v);
+}
+
+template <typename T>
+void EncodeDeferredArg(const T& v, turbo::span<char>* buf) {
+  DeferredArgTraits<DeferredArgType<T>>::Encode(v, buf);
+}
+
+// Encodes a record for `site_id` into `buf` and returns the number of bytes
+// written.  `buf` must hold at least `DeferredRecordBound(args...)` bytes.
+template <typename... Args>
+size_t EncodeDeferredRecord(uint32_t site_id, turbo::span<char> buf,
+                            const Args&... args) {
+  const size_t size = buf.size();
+  turbo::span<char> record = EncodeMessageStart(kStreamRecord, size, &buf);
+  EncodeVarint(kRecordSite, site_id, &buf);
+  Encode64Bit(kRecordTimestamp, turbo::GetCurrentTimeNanos(), &buf);
+  (EncodeDeferredArg(args, &buf), ...);
+  EncodeMessageLength(record, &buf);
+  return size - buf.size();
+}
+
+template <typename... Args>
+size_t DeferredRecordBound(const Args&... args) {
+  return BufferSizeFor(WireType::kLengthDelimited, WireType::kVarint,
+                       WireType::k64Bit) +
+         (size_t{0} + ... + DeferredArgBound(args));
+}
+
+template <typename... Args>
+void LogDeferredSlow(DeferredLogSite& site, const char* format,
+                     const Args&... args);
+
+// `format` must be a string literal: it is kept, not copied, by the site.
+template <size_t N, typename... Args>
+TURBO_ATTRIBUTE_ALWAYS_INLINE inline bool LogDeferred(DeferredLogSite& site,
+                                                      const char (&format)[N],
+                                                      const Args&... args) {
+  if (site.severity() < turbo::min_log_level()) return false;
+  DeferredStagingBuffer* buffer = tls_deferred_buffer;
+  const uint32_t id = site.id();
+  if (TURBO_UNLIKELY(buffer == nullptr || id == 0 ||
+                     !buffer->BeginRecord())) {
+    LogDeferredSlow(site, format, args...);
+    return true;
+  }
+  turbo::span<char> buf = buffer->Reserve(DeferredRecordBound(args...));
+  if (TURBO_UNLIKELY(buf.empty())) {
+    buffer->EndRecord();
+    return false;
+  }
+  buffer->Commit(EncodeDeferredRecord(id, buf, args...));
+  buffer->EndRecord();
+  return true;
+}
+
+template <typename... Args>
+TURBO_ATTRIBUTE_NOINLINE void LogDeferredSlow(DeferredLogSite& site,
+                                              const char* format,
+                                              const Args&... args) {
+  uint32_t id = site.id();
+  if (id == 0) id = RegisterDeferredLogSite(&site, format);
+  DeferredStagingBuffer* buffer = tls_deferred_buffer;
+  if (buffer == nullptr &&
+      deferred_logging_active.load(std::memory_order_relaxed)) {
+    buffer = AttachDeferredStagingBuffer();
+  }
+  if (buffer != nullptr && buffer->BeginRecord()) {
+    turbo::span<char> buf = buffer->Reserve(DeferredRecordBound(args...));
+    if (!buf.empty()) buffer->Commit(EncodeDeferredRecord(id, buf, args...));
+    buffer->EndRecord();
+    return;
+  }
+  std::string record(DeferredRecordBound(args...), '\0');
+  record.resize(EncodeDeferredRecord(id, turbo::MakeSpan(record), args...));
+  LogDeferredRecordNow(site, format, record);
+}
+
+}  // namespace log_internal
+TURBO_NAMESPACE_END
+}  // namespace turbo
+
+// Severities accepted by `LOG_DEFERRED`.  `FATAL` and its variants must not be
+// deferred, so they are deliberately missing.
+#define TURBO_LOG_INTERNAL_DEFERRED_SEVERITY_INFO ::turbo::LogSeverity::kInfo
+#define TURBO_LOG_INTERNAL_DEFERRED_SEVERITY_WARNING \
+  ::turbo::LogSeverity::kWarning
+#define TURBO_LOG_INTERNAL_DEFERRED_SEVERITY_ERROR ::turbo::LogSeverity::kError
+
+// The format string, which comes first in the arguments of `LOG_DEFERRED`.
+#define TURBO_LOG_INTERNAL_DEFERRED_FORMAT(format, ...) format
+
+#define TURBO_LOG_INTERNAL_DEFERRED_IMPL(severity, ...)                      \
+  TURBO_LOG_INTERNAL_CONDITION##severity(STATELESS, true)::turbo::           \
+      log_internal::LogDeferred(                                             \
+          []() -> ::turbo::log_internal::DeferredLogSite& {                  \
+            static TURBO_CONST_INIT ::turbo::log_internal::DeferredLogSite   \
+                turbo_log_internal_deferred_site(                            \
+                    __FILE__, __LINE__,                                      \
+                    TURBO_LOG_INTERNAL_DEFERRED_SEVERITY##severity,          \
+                    TURBO_STR_FORMAT_INTERNAL_COMPILE(                       \
+                        TURBO_LOG_INTERNAL_DEFERRED_FORMAT(__VA_ARGS__, _))  \
+                        .view());                                            \
+            return turbo_log_internal_deferred_site;                         \
+          }(),                                                               \
+          __VA_ARGS__)
+
+#endif  // TURBO_LOG_INTERNAL_DEFERRED_LOG_H_
@@ -26,6 +26,7 @@
 #include <sys/time.h>
 #endif
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
@@ -75,6 +76,86 @@ PutLeadingWhitespace(T tid, char*& p) {
   if (tid > -100000 && tid < 1000000) *p++ = ' ';
 }
 
+// "MMDD HH:MM:SS"
+constexpr size_t kCivilSecondSize = 13;
+// Leading whitespace, digits and a trailing space.
+constexpr size_t kThreadIdMaxSize =
+    (1 + std::numeric_limits<log_internal::Tid>::digits10 + 1) + 7;
+
+char* PutCivilSecond(const turbo::CivilSecond& cs, char* p) {
+  turbo::numbers_internal::PutTwoDigits(static_cast<uint32_t>(cs.month()), p);
+  p += 2;
+  turbo::numbers_internal::PutTwoDigits(static_cast<uint32_t>(cs.day()), p);
+  p += 2;
+  *p++ = ' ';
+  turbo::numbers_internal::PutTwoDigits(static_cast<uint32_t>(cs.hour()), p);
+  p += 2;
+  *p++ = ':';
+  turbo::numbers_internal::PutTwoDigits(static_cast<uint32_t>(cs.minute()), p);
+  p += 2;
+  *p++ = ':';
+  turbo::numbers_internal::PutTwoDigits(static_cast<uint32_t>(cs.second()), p);
+  return p + 2;
+}
+
+// Writes `usecs` (less than one second) as six digits, two at a time from
+// the digit-pair table.
+char* PutMicroseconds(int64_t usecs, char* p) {
+  const auto u = static_cast<uint32_t>(usecs);
+  const uint32_t high = u / 10000;
+  const uint32_t low = u - high * 10000;
+  turbo::numbers_internal::PutTwoDigits(high, p);
+  turbo::numbers_internal::PutTwoDigits(low / 100, p + 2);
+  turbo::numbers_internal::PutTwoDigits(low % 100, p + 4);
+  return p + 6;
+}
+
+char* PutThreadId(log_internal::Tid tid, char* p) {
+  PutLeadingWhitespace(tid, p);
+  p = turbo::numbers_internal::FastIntToBuffer(tid, p);
+  *p++ = ' ';
+  return p;
+}
+
+// Per-thread cache of the prefix fields that change at most once a second:
+// the rendered civil second of the last timestamp formatted on this thread,
+// and the rendered thread ID, which rarely changes at all.  Within the same
+// second only the microseconds are formatted.
+//
+// `FormatLogPrefix` may run in a signal handler that interrupted an update
+// of the cache on the same thread.  `busy` is set for the duration of every
+// update, and the handler then bypasses the cache.
+struct PrefixCache {
+  const turbo::TimeZone* tz;
+  int64_t unix_seconds;
+  char civil_second[kCivilSecondSize];
+  log_internal::Tid tid;
+  uint8_t tid_size;
+  char tid_text[kThreadIdMaxSize];
+  bool busy;
+};
+
+TURBO_CONST_INIT thread_local PrefixCache tls_prefix_cache = {};
+
+void UpdatePrefixCache(PrefixCache& cache, const turbo::TimeZone* tz,
+                       int64_t unix_seconds, log_internal::Tid tid) {
+  cache.busy = true;
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  if (cache.tz != tz || cache.unix_seconds != unix_seconds) {
+    PutCivilSecond(tz->at(turbo::Time::from_seconds(unix_seconds)).cs,
+                   cache.civil_second);
+    cache.tz = tz;
+    cache.unix_seconds = unix_seconds;
+  }
+  if (cache.tid != tid || cache.tid_size == 0) {
+    cache.tid_size = static_cast<uint8_t>(PutThreadId(tid, cache.tid_text) -
+                                          cache.tid_text);
+    cache.tid = tid;
+  }
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  cache.busy = false;
+}
+
 // The fields before the filename are all fixed-width except for the thread ID,
 // which is of bounded width.
 size_t FormatBoundedFields(turbo::LogSeverity severity, turbo::Time timestamp,
@@ -115,35 +196,39 @@ size_t FormatBoundedFields(turbo::LogSeverity severity, turbo::Time timestamp,
 
   char* p = buf.data();
   *p++ = turbo::LogSeverityName(severity)[0];
-  const turbo::TimeZone::CivilInfo ci = tz->at(timestamp);
-  turbo::numbers_internal::PutTwoDigits(static_cast<uint32_t>(ci.cs.month()), p);
-  p += 2;
-  turbo::numbers_internal::PutTwoDigits(static_cast<uint32_t>(ci.cs.day()), p);
-  p += 2;
-  *p++ = ' ';
-  turbo::numbers_internal::PutTwoDigits(static_cast<uint32_t>(ci.cs.hour()), p);
-  p += 2;
-  *p++ = ':';
-  turbo::numbers_internal::PutTwoDigits(static_cast<uint32_t>(ci.cs.minute()),
-                                       p);
-  p += 2;
-  *p++ = ':';
-  turbo::numbers_internal::PutTwoDigits(static_cast<uint32_t>(ci.cs.second()),
-                                       p);
-  p += 2;
-  *p++ = '.';
-  const int64_t usecs = turbo::Duration::to_microseconds(ci.subsecond);
-  turbo::numbers_internal::PutTwoDigits(static_cast<uint32_t>(usecs / 10000), p);
-  p += 2;
-  turbo::numbers_internal::PutTwoDigits(static_cast<uint32_t>(usecs / 100 % 100),
-                                       p);
-  p += 2;
-  turbo::numbers_internal::PutTwoDigits(static_cast<uint32_t>(usecs % 100), p);
-  p += 2;
-  *p++ = ' ';
-  PutLeadingWhitespace(tid, p);
-  p = turbo::numbers_internal::FastIntToBuffer(tid, p);
-  *p++ = ' ';
+  const int64_t unix_usecs = turbo::Time::to_microseconds(timestamp);
+  int64_t unix_seconds = unix_usecs / 1000000;
+  int64_t usecs = unix_usecs % 1000000;
+  if (usecs < 0) {
+    usecs += 1000000;
+    --unix_seconds;
+  }
+
+  PrefixCache& cache = tls_prefix_cache;
+  if (TURBO_UNLIKELY(cache.busy ||
+                     unix_usecs == (std::numeric_limits<int64_t>::max)() ||
+                     unix_usecs == (std::numeric_limits<int64_t>::min)())) {
+    // A signal handler interrupted an update of the cache, or the timestamp
+    // is infinite; format everything from scratch.
+    const turbo::TimeZone::CivilInfo ci = tz->at(timestamp);
+    p = PutCivilSecond(ci.cs, p);
+    *p++ = '.';
+    p = PutMicroseconds(turbo::Duration::to_microseconds(ci.subsecond), p);
+    *p++ = ' ';
+    p = PutThreadId(tid, p);
+  } else {
+    if (cache.tz != tz || cache.unix_seconds != unix_seconds ||
+        cache.tid != tid || cache.tid_size == 0) {
+      UpdatePrefixCache(cache, tz, unix_seconds, tid);
+    }
+    memcpy(p, cache.civil_second, kCivilSecondSize);
+    p += kCivilSecondSize;
+    *p++ = '.';
+    p = PutMicroseconds(usecs, p);
+    *p++ = ' ';
+    memcpy(p, cache.tid_text, cache.tid_size);
+    p += cache.tid_size;
+  }
   const size_t bytes_formatted = static_cast<size_t>(p - buf.data());
   buf.remove_prefix(bytes_formatted);
   return bytes_formatted;
@@ -176,7 +261,7 @@ std::string FormatLogMessage(turbo::LogSeverity severity,
                              std::string_view basename, int line,
                              PrefixFormat format, std::string_view message) {
   return turbo::str_format(
-      "%c%02d%02d %02d:%02d:%02d.%06d %7d %s:%d] %s%s",
+      TURBO_FORMAT("%c%02d%02d %02d:%02d:%02d.%06d %7d %s:%d] %s%s"),
       turbo::LogSeverityName(severity)[0], civil_second.month(),
       civil_second.day(), civil_second.hour(), civil_second.minute(),
       civil_second.second(), turbo::Duration::to_microseconds(subsecond), tid,
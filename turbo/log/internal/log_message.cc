@@ -41,10 +41,12 @@
 #include <turbo/base/internal/strerror.h>
 #include <turbo/base/internal/sysinfo.h>
 #include <turbo/base/log_severity.h>
+#include <turbo/base/optimization.h>
 #include <turbo/container/inlined_vector.h>
 #include <turbo/debugging/internal/examine_stack.h>
 #include <turbo/log/globals.h>
 #include <turbo/log/internal/append_truncated.h>
+#include <turbo/log/internal/conditions.h>
 #include <turbo/log/internal/globals.h>
 #include <turbo/log/internal/log_format.h>
 #include <turbo/log/internal/log_sink_set.h>
@@ -113,6 +115,70 @@ std::string_view Basename(std::string_view filepath) {
   return filepath;
 }
 
+// Size of each staging buffer.  Messages that outgrow it spill into heap
+// buffers of `kLogMessageBufferSize` bytes, which still bounds their length.
+constexpr size_t kLogMessageStagingSize = 4096;
+
+// Staging space for one message: the encoded `logging.proto.Event` and the
+// formatted text.
+struct LogMessageBuffers {
+  std::array<char, kLogMessageStagingSize> encoded;
+  std::array<char, kLogMessageStagingSize> string;
+};
+
+// Each thread keeps the buffers of its last message for the next one, so the
+// common case of one `LOG` at a time needs no allocation per message.
+// Messages logged while another is alive on the same thread (from stream
+// operators, sinks or signal handlers) take freshly allocated buffers.
+//
+// The cache pointer is constant-initialized and never destroyed, so it stays
+// usable while other thread-local destructors log; `ThreadBufferReaper` frees
+// the cached buffers at thread exit and turns the cache off afterwards.
+TURBO_CONST_INIT thread_local LogMessageBuffers* tls_cached_buffers = nullptr;
+TURBO_CONST_INIT thread_local bool tls_buffer_cache_disabled = false;
+
+struct ThreadBufferReaper {
+  ~ThreadBufferReaper() {
+    tls_buffer_cache_disabled = true;
+    delete tls_cached_buffers;
+    tls_cached_buffers = nullptr;
+  }
+};
+
+LogMessageBuffers* AcquireLogMessageBuffers() {
+  LogMessageBuffers* buffers = tls_cached_buffers;
+  if (TURBO_LIKELY(buffers != nullptr)) {
+    tls_cached_buffers = nullptr;
+    return buffers;
+  }
+  return new LogMessageBuffers;
+}
+
+void ReleaseLogMessageBuffers(LogMessageBuffers* buffers) {
+  if (tls_cached_buffers == nullptr && !tls_buffer_cache_disabled) {
+    // Registers the reaper on the first release in this thread.
+    static thread_local ThreadBufferReaper reaper;
+    (void)reaper;
+    tls_cached_buffers = buffers;
+    return;
+  }
+  delete buffers;
+}
+
+// Owns the buffers for the lifetime of a `LogMessageData`.
+class LogMessageBuffersLease {
+ public:
+  LogMessageBuffersLease() : buffers_(AcquireLogMessageBuffers()) {}
+  LogMessageBuffersLease(const LogMessageBuffersLease&) = delete;
+  LogMessageBuffersLease& operator=(const LogMessageBuffersLease&) = delete;
+  ~LogMessageBuffersLease() { ReleaseLogMessageBuffers(buffers_); }
+
+  LogMessageBuffers* get() const { return buffers_; }
+
+ private:
+  LogMessageBuffers* const buffers_;
+};
+
 void WriteToString(const char* data, void* str) {
   reinterpret_cast<std::string*>(str)->append(data);
 }
@@ -146,8 +212,10 @@ struct LogMessage::LogMessageData final {
 
   std::ostream manipulated;  // ostream with IO manipulators applied
 
+  LogMessageBuffersLease buffers;
+
   // A `logging.proto.Event` proto message is built into `encoded_buf`.
-  std::array<char, kLogMessageBufferSize> encoded_buf;
+  turbo::span<char> encoded_buf;
   // `encoded_remaining` is the suffix of `encoded_buf` that has not been filled
   // yet.  If a datum to be encoded does not fit into `encoded_remaining` and
   // cannot be truncated to fit, the size of `encoded_remaining` will be zeroed
@@ -156,9 +224,28 @@ struct LogMessage::LogMessageData final {
   turbo::span<char> encoded_remaining;
 
   // A formatted string message is built in `string_buf`.
-  std::array<char, kLogMessageBufferSize> string_buf;
+  turbo::span<char> string_buf;
+
+  // Heap buffers of `kLogMessageBufferSize` bytes which replace the staging
+  // buffers once a message does not fit into them.
+  std::unique_ptr<char[]> spilled_encoded;
+  std::unique_ptr<char[]> spilled_string;
+
+  // Makes room for `size` more bytes of encoded data, spilling into
+  // `spilled_encoded` if they do not fit into the staging buffer.
+  void ReserveEncoded(size_t size) {
+    if (TURBO_UNLIKELY(size > encoded_remaining.size())) SpillEncoded();
+  }
+  // Moves the encoded data into `spilled_encoded`.  Returns false if it is
+  // there already.
+  bool SpillEncoded();
 
   void FinalizeEncodingAndFormat();
+
+ private:
+  // Formats the prefix and `encoded_data` into `string_buf`.  Returns false if
+  // it had to be truncated.
+  bool Format(turbo::span<const char> encoded_data);
 };
 
 LogMessage::LogMessageData::LogMessageData(const char* file, int line,
@@ -166,8 +253,9 @@ LogMessage::LogMessageData::LogMessageData(const char* file, int line,
                                            turbo::Time timestamp)
     : extra_sinks_only(false),
       manipulated(nullptr),
-      // This `turbo::MakeSpan` silences spurious -Wuninitialized from GCC:
-      encoded_remaining(turbo::MakeSpan(encoded_buf)) {
+      encoded_buf(turbo::MakeSpan(buffers.get()->encoded)),
+      encoded_remaining(encoded_buf),
+      string_buf(turbo::MakeSpan(buffers.get()->string)) {
   // Legacy defaults for LOG's ostream:
   manipulated.setf(std::ios_base::showbase | std::ios_base::boolalpha);
   entry.full_filename_ = file;
@@ -180,6 +268,17 @@ LogMessage::LogMessageData::LogMessageData(const char* file, int line,
   entry.tid_ = turbo::base_internal::GetCachedTID();
 }
 
+bool LogMessage::LogMessageData::SpillEncoded() {
+  if (spilled_encoded != nullptr) return false;
+  const size_t used =
+      static_cast<size_t>(encoded_remaining.data() - encoded_buf.data());
+  spilled_encoded.reset(new char[kLogMessageBufferSize]);
+  memcpy(spilled_encoded.get(), encoded_buf.data(), used);
+  encoded_buf = turbo::MakeSpan(spilled_encoded.get(), kLogMessageBufferSize);
+  encoded_remaining = encoded_buf.subspan(used);
+  return true;
+}
+
 void LogMessage::LogMessageData::FinalizeEncodingAndFormat() {
   // Note that `encoded_remaining` may have zero size without pointing past the
   // end of `encoded_buf`, so the difference between `data()` pointers is used
@@ -187,6 +286,17 @@ void LogMessage::LogMessageData::FinalizeEncodingAndFormat() {
   turbo::span<const char> encoded_data(
       encoded_buf.data(),
       static_cast<size_t>(encoded_remaining.data() - encoded_buf.data()));
+  // A message whose encoding spilled is formatted into a heap buffer straight
+  // away; any other one only if its prefix and text overflow the staging
+  // buffer.
+  if (spilled_encoded != nullptr || !Format(encoded_data)) {
+    spilled_string.reset(new char[kLogMessageBufferSize]);
+    string_buf = turbo::MakeSpan(spilled_string.get(), kLogMessageBufferSize);
+    Format(encoded_data);
+  }
+}
+
+bool LogMessage::LogMessageData::Format(turbo::span<const char> encoded_data) {
   // `string_remaining` is the suffix of `string_buf` that has not been filled
   // yet.
   turbo::span<char> string_remaining(string_buf);
@@ -221,7 +331,9 @@ void LogMessage::LogMessageData::FinalizeEncodingAndFormat() {
     string_buf[chars_written++] = '\n';
   string_buf[chars_written++] = '\0';
   entry.text_message_with_prefix_and_newline_and_nul_ =
-      turbo::MakeSpan(string_buf).subspan(0, chars_written);
+      string_buf.subspan(0, chars_written);
+  // A full buffer may have cut the message short.
+  return string_remaining.size() > 1;
 }
 
 LogMessage::LogMessage(const char* file, int line, turbo::LogSeverity severity)
@@ -418,19 +530,25 @@ void LogMessage::Flush() {
       std::string_view(data_->encoded_buf.data(),
                         static_cast<size_t>(data_->encoded_remaining.data() -
                                             data_->encoded_buf.data()));
+  turbo::log_internal::ChargeLogBudget(
+      data_->entry.log_severity(),
+      data_->entry.text_message_with_prefix_and_newline().size());
   SendToLog();
+  turbo::log_internal::LogBudgetSummaryIfDue();
 }
 
 void LogMessage::SetFailQuietly() { data_->fail_quietly = true; }
 
 LogMessage::OstreamView::OstreamView(LogMessageData& message_data)
-    : data_(message_data), encoded_remaining_copy_(data_.encoded_remaining) {
+    : data_(message_data) {
   // This constructor sets the `streambuf` up so that streaming into an attached
   // ostream encodes string data in-place.  To do that, we write appropriate
   // headers into the buffer using a copy of the buffer view so that we can
   // decide not to keep them later if nothing is ever streamed in.  We don't
   // know how much data we'll get, but we can use the size of the remaining
   // buffer as an upper bound and fill in the right size once we know it.
+  data_.ReserveEncoded(2 * BufferSizeFor(WireType::kLengthDelimited) + 1);
+  encoded_remaining_copy_ = data_.encoded_remaining;
   message_start_ =
       EncodeMessageStart(EventTag::kValue, encoded_remaining_copy_.size(),
                          &encoded_remaining_copy_);
@@ -462,6 +580,31 @@ LogMessage::OstreamView::~OstreamView() {
 
 std::ostream& LogMessage::OstreamView::stream() { return data_.manipulated; }
 
+LogMessage::OstreamView::int_type LogMessage::OstreamView::overflow(
+    int_type ch) {
+  // The staging buffer is full: move to the heap buffer and start over there,
+  // since the field headers were sized for the staging buffer.  The staging
+  // buffer stays alive until the message is destroyed.
+  if (!data_.SpillEncoded()) return traits_type::eof();
+  const turbo::span<const char> contents(pbase(),
+                                        static_cast<size_t>(pptr() - pbase()));
+  encoded_remaining_copy_ = data_.encoded_remaining;
+  message_start_ =
+      EncodeMessageStart(EventTag::kValue, encoded_remaining_copy_.size(),
+                         &encoded_remaining_copy_);
+  string_start_ =
+      EncodeMessageStart(ValueTag::kString, encoded_remaining_copy_.size(),
+                         &encoded_remaining_copy_);
+  memcpy(encoded_remaining_copy_.data(), contents.data(), contents.size());
+  setp(encoded_remaining_copy_.data(),
+       encoded_remaining_copy_.data() + encoded_remaining_copy_.size());
+  pbump(static_cast<int>(contents.size()));
+  if (traits_type::eq_int_type(ch, traits_type::eof())) {
+    return traits_type::not_eof(ch);
+  }
+  return sputc(traits_type::to_char_type(ch));
+}
+
 bool LogMessage::IsFatal() const {
   return data_->entry.log_severity() == turbo::LogSeverity::kFatal &&
          turbo::log_internal::ExitOnDFatal();
@@ -530,6 +673,8 @@ void LogMessage::LogBacktraceIfNeeded() {
 // buffer full if  even the field headers do not fit.
 template <LogMessage::StringType str_type>
 void LogMessage::CopyToEncodedBuffer(std::string_view str) {
+  data_->ReserveEncoded(2 * BufferSizeFor(WireType::kLengthDelimited) +
+                        str.size());
   auto encoded_remaining_copy = data_->encoded_remaining;
   auto start = EncodeMessageStart(
       EventTag::kValue, BufferSizeFor(WireType::kLengthDelimited) + str.size(),
@@ -556,6 +701,7 @@ template void LogMessage::CopyToEncodedBuffer<
     LogMessage::StringType::kNotLiteral>(std::string_view str);
 template <LogMessage::StringType str_type>
 void LogMessage::CopyToEncodedBuffer(char ch, size_t num) {
+  data_->ReserveEncoded(2 * BufferSizeFor(WireType::kLengthDelimited) + num);
   auto encoded_remaining_copy = data_->encoded_remaining;
   auto value_start = EncodeMessageStart(
       EventTag::kValue, BufferSizeFor(WireType::kLengthDelimited) + num,
@@ -223,6 +223,9 @@ class LogMessage {
     OstreamView& operator=(const OstreamView&) = delete;
     std::ostream& stream();
 
+   protected:
+    int_type overflow(int_type ch) override;
+
    private:
     LogMessageData& data_;
     turbo::span<char> encoded_remaining_copy_;
@@ -39,7 +39,6 @@
 #include <turbo/base/internal/raw_logging.h>
 #include <turbo/base/log_severity.h>
 #include <turbo/base/no_destructor.h>
-#include <turbo/base/thread_annotations.h>
 #include <turbo/bootstrap/cleanup.h>
 #include <turbo/log/globals.h>
 #include <turbo/log/internal/config.h>
@@ -47,7 +46,8 @@
 #include <turbo/log/log_entry.h>
 #include <turbo/log/log_sink.h>
 #include <turbo/strings/string_view.h>
-#include <turbo/synchronization/mutex.h>
+#include <turbo/synchronization/epoch_domain.h>
+#include <turbo/synchronization/read_mostly.h>
 #include <turbo/container/span.h>
 
 namespace turbo::log_internal {
@@ -184,8 +184,7 @@ namespace turbo::log_internal {
             }
 
             void log_to_sinks(const turbo::LogEntry &entry,
-                            turbo::span<turbo::LogSink *> extra_sinks, bool extra_sinks_only)
-            TURBO_LOCKS_EXCLUDED(guard_) {
+                            turbo::span<turbo::LogSink *> extra_sinks, bool extra_sinks_only) {
                 SendToSinks(entry, extra_sinks);
 
                 if (!extra_sinks_only) {
@@ -193,78 +192,88 @@ namespace turbo::log_internal {
                         turbo::log_internal::WriteToStderr(
                                 entry.text_message_with_prefix_and_newline(), entry.log_severity());
                     } else {
-                        turbo::ReaderMutexLock global_sinks_lock(&guard_);
+                        LogSinks::Snapshot sinks = sinks_.Read();
                         thread_is_logging_status() = true;
                         // Ensure the "thread is logging" status is reverted upon leaving the
                         // scope even in case of exceptions.
                         auto status_cleanup =
                                 turbo::MakeCleanup([] { thread_is_logging_status() = false; });
-                        SendToSinks(entry, turbo::MakeSpan(sinks_));
+                        SendToSinks(entry, turbo::MakeConstSpan(*sinks));
                     }
                 }
             }
 
-            void add_log_sink(turbo::LogSink *sink) TURBO_LOCKS_EXCLUDED(guard_) {
-                {
-                    turbo::WriterMutexLock global_sinks_lock(&guard_);
-                    auto pos = std::find(sinks_.begin(), sinks_.end(), sink);
-                    if (pos == sinks_.end()) {
-                        sinks_.push_back(sink);
-                        return;
+            void add_log_sink(turbo::LogSink *sink) {
+                bool duplicate = false;
+                sinks_.Update([&](LogSinksSet &sinks) {
+                    duplicate = std::find(sinks.begin(), sinks.end(), sink) != sinks.end();
+                    if (!duplicate) {
+                        sinks.push_back(sink);
                     }
+                });
+                if (duplicate) {
+                    TURBO_INTERNAL_LOG(FATAL, "Duplicate log sinks are not supported");
                 }
-                TURBO_INTERNAL_LOG(FATAL, "Duplicate log sinks are not supported");
             }
 
-            void remove_log_sink(turbo::LogSink *sink) TURBO_LOCKS_EXCLUDED(guard_) {
-                {
-                    turbo::WriterMutexLock global_sinks_lock(&guard_);
-                    auto pos = std::find(sinks_.begin(), sinks_.end(), sink);
-                    if (pos != sinks_.end()) {
-                        sinks_.erase(pos);
-                        return;
+            void remove_log_sink(turbo::LogSink *sink) {
+                bool found = false;
+                sinks_.Update([&](LogSinksSet &sinks) {
+                    auto pos = std::find(sinks.begin(), sinks.end(), sink);
+                    found = pos != sinks.end();
+                    if (found) {
+                        sinks.erase(pos);
                     }
+                });
+                if (!found) {
+                    TURBO_INTERNAL_LOG(FATAL, "Mismatched log sink being removed");
                 }
-                TURBO_INTERNAL_LOG(FATAL, "Mismatched log sink being removed");
+                // The caller may destroy `sink` as soon as this returns, so wait
+                // for dispatches that may still be using the previous set.
+                sinks_.Synchronize();
             }
 
-            void flush_log_sinks() TURBO_LOCKS_EXCLUDED(guard_) {
+            void flush_log_sinks() {
+                // Pinning nests, so this also works from within `LogSink::Send()`.
+                LogSinks::Snapshot sinks = sinks_.Read();
                 if (thread_is_logging_to_log_sink()) {
-                    // The thread_local condition demonstrates that we're already holding the
-                    // lock in order to iterate over `sinks_` for dispatch.  The thread-safety
-                    // annotations don't know this, so we use `TURBO_NO_THREAD_SAFETY_ANALYSIS`
-                    guard_.AssertReaderHeld();
-                    FlushLogSinksLocked();
+                    FlushLogSinks(*sinks);
                 } else {
-                    turbo::ReaderMutexLock global_sinks_lock(&guard_);
                     // In case if LogSink::Flush overload decides to log
                     thread_is_logging_status() = true;
                     // Ensure the "thread is logging" status is reverted upon leaving the
                     // scope even in case of exceptions.
                     auto status_cleanup =
                             turbo::MakeCleanup([] { thread_is_logging_status() = false; });
-                    FlushLogSinksLocked();
+                    FlushLogSinks(*sinks);
                 }
             }
 
         private:
-            void FlushLogSinksLocked() TURBO_SHARED_LOCKS_REQUIRED(guard_) {
-                for (turbo::LogSink *sink: sinks_) {
+            using LogSinksSet = std::vector<turbo::LogSink *>;
+            using LogSinks = turbo::ReadMostly<LogSinksSet>;
+
+            static void FlushLogSinks(const LogSinksSet &sinks) {
+                for (turbo::LogSink *sink: sinks) {
                     sink->Flush();
                 }
             }
 
             // Helper routine for log_to_sinks.
             static void SendToSinks(const turbo::LogEntry &entry,
-                                    turbo::span<turbo::LogSink *> sinks) {
+                                    turbo::span<turbo::LogSink *const> sinks) {
                 for (turbo::LogSink *sink: sinks) {
                     sink->Send(entry);
                 }
             }
 
-            using LogSinksSet = std::vector<turbo::LogSink *>;
-            turbo::Mutex guard_;
-            LogSinksSet sinks_ TURBO_GUARDED_BY(guard_);
+            // Dispatch reads an immutable snapshot of the registered sinks, so
+            // logging threads do not write to memory shared with each other;
+            // registration publishes a new copy. Pins in this dedicated domain
+            // last as long as the sinks' `Send()`, so they would otherwise hold
+            // back reclamation in `EpochDomain::Default()`.
+            turbo::EpochDomain domain_;
+            LogSinks sinks_{LogSinksSet(), &domain_};
         };
 
         // Returns reference to the global LogSinks set.
@@ -0,0 +1,378 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/log/internal/lz4.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <turbo/base/config.h>
+#include <turbo/numeric/bits.h>
+
+namespace turbo::log_internal {
+
+    namespace {
+
+        constexpr uint32_t kFrameMagic = 0x184D2204;
+        constexpr uint32_t kSkippableMagicMask = 0xFFFFFFF0;
+        constexpr uint32_t kSkippableMagic = 0x184D2A50;
+        // Frame descriptor: version 01, independent blocks, no checksums.
+        constexpr uint8_t kFrameFlags = 0x60;
+        // Block maximum size id 7: 4MB.
+        constexpr uint8_t kFrameBlockDescriptor = 0x70;
+        constexpr uint32_t kUncompressedBlockFlag = 0x80000000u;
+
+        // Format constants: the last 5 bytes of a block are always literals and
+        // the last match starts at least 12 bytes before the end.
+        constexpr size_t kMinMatch = 4;
+        constexpr size_t kLastLiterals = 5;
+        constexpr size_t kMatchFindLimit = 12;
+        constexpr size_t kMaxOffset = 65535;
+        constexpr int kHashLog = 13;
+
+        uint32_t load32(const char *p) {
+            uint32_t v;
+            memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        uint32_t load_le32(const char *p) {
+            const auto *u = reinterpret_cast<const unsigned char *>(p);
+            return static_cast<uint32_t>(u[0]) | static_cast<uint32_t>(u[1]) << 8 |
+                   static_cast<uint32_t>(u[2]) << 16 | static_cast<uint32_t>(u[3]) << 24;
+        }
+
+        void store_le32(uint32_t v, char *p) {
+            p[0] = static_cast<char>(v);
+            p[1] = static_cast<char>(v >> 8);
+            p[2] = static_cast<char>(v >> 16);
+            p[3] = static_cast<char>(v >> 24);
+        }
+
+        void append_le32(uint32_t v, std::string *out) {
+            char bytes[4];
+            store_le32(v, bytes);
+            out->append(bytes, sizeof(bytes));
+        }
+
+        // Length of the common prefix of `a` and `b`, with `b` stopping at `limit`.
+        size_t count_common(const char *a, const char *b, const char *limit) {
+            const char *const start = b;
+            while (limit - b >= 8) {
+                uint64_t x, y;
+                memcpy(&x, a, 8);
+                memcpy(&y, b, 8);
+                if (x != y) {
+#if defined(TURBO_IS_LITTLE_ENDIAN)
+                    return static_cast<size_t>(b - start) + (turbo::countr_zero(x ^ y) >> 3);
+#else
+                    break;
+#endif
+                }
+                a += 8;
+                b += 8;
+            }
+            while (b < limit && *a == *b) {
+                ++a;
+                ++b;
+            }
+            return static_cast<size_t>(b - start);
+        }
+
+        uint32_t hash4(uint32_t v) {
+            return (v * 2654435761u) >> (32 - kHashLog);
+        }
+
+        uint32_t rotl32(uint32_t v, int r) {
+            return (v << r) | (v >> (32 - r));
+        }
+
+        // Writes a length continuation: runs of 255 and the remainder.
+        char *put_length(size_t length, char *op) {
+            while (length >= 255) {
+                *op++ = static_cast<char>(255);
+                length -= 255;
+            }
+            *op++ = static_cast<char>(length);
+            return op;
+        }
+
+        char *put_sequence(const char *literals, size_t literal_size, size_t offset, size_t match_size, char *op) {
+            char *token = op++;
+            uint8_t t;
+            if (literal_size >= 15) {
+                t = 15 << 4;
+                op = put_length(literal_size - 15, op);
+            } else {
+                t = static_cast<uint8_t>(literal_size << 4);
+            }
+            memcpy(op, literals, literal_size);
+            op += literal_size;
+            if (match_size == 0) {
+                *token = static_cast<char>(t);
+                return op;
+            }
+            *op++ = static_cast<char>(offset);
+            *op++ = static_cast<char>(offset >> 8);
+            const size_t ml = match_size - kMinMatch;
+            if (ml >= 15) {
+                t |= 15;
+                op = put_length(ml - 15, op);
+            } else {
+                t |= static_cast<uint8_t>(ml);
+            }
+            *token = static_cast<char>(t);
+            return op;
+        }
+
+        // Reads a length continuation; false if it runs past `end`.
+        bool get_length(const unsigned char *&ip, const unsigned char *end, size_t *length) {
+            unsigned char b;
+            do {
+                if (ip == end) {
+                    return false;
+                }
+                b = *ip++;
+                *length += b;
+            } while (b == 255);
+            return true;
+        }
+
+    }  // namespace
+
+    size_t lz4_compress_block(const char *src, size_t size, char *dst) {
+        char *op = dst;
+        size_t anchor = 0;
+        if (size > kMatchFindLimit) {
+            uint32_t table[1 << kHashLog] = {};
+            const size_t match_limit = size - kLastLiterals;
+            const size_t find_limit = size - kMatchFindLimit;
+            size_t ip = 0;
+            while (ip < find_limit) {
+                const uint32_t sequence = load32(src + ip);
+                const uint32_t h = hash4(sequence);
+                size_t ref = table[h];
+                table[h] = static_cast<uint32_t>(ip);
+                if (ref >= ip || ip - ref > kMaxOffset || load32(src + ref) != sequence) {
+                    // Skip faster through data that does not compress.
+                    ip += 1 + ((ip - anchor) >> 6);
+                    continue;
+                }
+                while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1]) {
+                    --ip;
+                    --ref;
+                }
+                size_t match = kMinMatch + count_common(src + ref + kMinMatch, src + ip + kMinMatch,
+                                                        src + match_limit);
+                op = put_sequence(src + anchor, ip - anchor, ip - ref, match, op);
+                ip += match;
+                anchor = ip;
+                if (ip - 2 < find_limit) {
+                    table[hash4(load32(src + ip - 2))] = static_cast<uint32_t>(ip - 2);
+                }
+            }
+        }
+        op = put_sequence(src + anchor, size - anchor, 0, 0, op);
+        return static_cast<size_t>(op - dst);
+    }
+
+    bool lz4_decompress_block(std::string_view src, size_t history, size_t max_size, std::string *out) {
+        const size_t base = out->size();
+        const size_t window_start = base - std::min(history, base);
+        out->resize(base + max_size);
+        char *const dst = &(*out)[0];
+        size_t op = base;
+        const size_t oend = base + max_size;
+        const auto *ip = reinterpret_cast<const unsigned char *>(src.data());
+        const auto *const iend = ip + src.size();
+        bool ok = false;
+        while (ip < iend) {
+            const unsigned token = *ip++;
+            size_t literal_size = token >> 4;
+            if (literal_size == 15 && !get_length(ip, iend, &literal_size)) {
+                break;
+            }
+            if (literal_size > static_cast<size_t>(iend - ip) || literal_size > oend - op) {
+                break;
+            }
+            memcpy(dst + op, ip, literal_size);
+            ip += literal_size;
+            op += literal_size;
+            if (ip == iend) {
+                // The last sequence has literals only.
+                ok = true;
+                break;
+            }
+            if (iend - ip < 2) {
+                break;
+            }
+            const size_t offset = static_cast<size_t>(ip[0]) | static_cast<size_t>(ip[1]) << 8;
+            ip += 2;
+            if (offset == 0 || offset > op - window_start) {
+                break;
+            }
+            size_t match_size = token & 15;
+            if (match_size == 15 && !get_length(ip, iend, &match_size)) {
+                break;
+            }
+            match_size += kMinMatch;
+            if (match_size > oend - op) {
+                break;
+            }
+            const char *match = dst + op - offset;
+            if (offset >= match_size) {
+                memcpy(dst + op, match, match_size);
+            } else {
+                // Overlapping copy repeats the last `offset` bytes.
+                for (size_t i = 0; i < match_size; ++i) {
+                    dst[op + i] = match[i];
+                }
+            }
+            op += match_size;
+        }
+        out->resize(op);
+        return ok || src.empty();
+    }
+
+    void lz4_compress_frame(std::string_view input, std::string *out) {
+        const char descriptor[2] = {static_cast<char>(kFrameFlags), static_cast<char>(kFrameBlockDescriptor)};
+        append_le32(kFrameMagic, out);
+        out->append(descriptor, sizeof(descriptor));
+        out->push_back(static_cast<char>((xxh32(descriptor, sizeof(descriptor), 0) >> 8) & 0xFF));
+        while (!input.empty()) {
+            const size_t block_size = std::min(input.size(), kLz4MaxBlockSize);
+            const size_t header = out->size();
+            out->resize(header + 4 + lz4_compress_bound(block_size));
+            const size_t compressed = lz4_compress_block(input.data(), block_size, &(*out)[header + 4]);
+            if (compressed < block_size) {
+                out->resize(header + 4 + compressed);
+                store_le32(static_cast<uint32_t>(compressed), &(*out)[header]);
+            } else {
+                // Incompressible; stored as is.
+                out->resize(header);
+                append_le32(static_cast<uint32_t>(block_size) | kUncompressedBlockFlag, out);
+                out->append(input.data(), block_size);
+            }
+            input.remove_prefix(block_size);
+        }
+        append_le32(0, out);
+    }
+
+    bool lz4_decompress_frames(std::string_view input, std::string *out) {
+        while (!input.empty()) {
+            if (input.size() < 4) {
+                return false;
+            }
+            const uint32_t magic = load_le32(input.data());
+            input.remove_prefix(4);
+            if ((magic & kSkippableMagicMask) == kSkippableMagic) {
+                if (input.size() < 4 || input.size() - 4 < load_le32(input.data())) {
+                    return false;
+                }
+                input.remove_prefix(4 + load_le32(input.data()));
+                continue;
+            }
+            if (magic != kFrameMagic || input.size() < 3) {
+                return false;
+            }
+            const auto flags = static_cast<uint8_t>(input[0]);
+            const auto block_descriptor = static_cast<uint8_t>(input[1]);
+            const int block_size_id = (block_descriptor >> 4) & 7;
+            if ((flags >> 6) != 1 || block_size_id < 4) {
+                return false;
+            }
+            const bool independent = (flags & 0x20) != 0;
+            const bool block_checksum = (flags & 0x10) != 0;
+            const bool content_size = (flags & 0x08) != 0;
+            const bool content_checksum = (flags & 0x04) != 0;
+            const bool dictionary_id = (flags & 0x01) != 0;
+            const size_t header_size = 2 + (content_size ? 8 : 0) + (dictionary_id ? 4 : 0) + 1;
+            if (input.size() < header_size) {
+                return false;
+            }
+            input.remove_prefix(header_size);
+            const size_t max_block_size = size_t{1} << (8 + 2 * block_size_id);
+            const size_t frame_start = out->size();
+            for (;;) {
+                if (input.size() < 4) {
+                    return false;
+                }
+                const uint32_t block_header = load_le32(input.data());
+                input.remove_prefix(4);
+                if (block_header == 0) {
+                    break;
+                }
+                const size_t block_size = block_header & ~kUncompressedBlockFlag;
+                if (input.size() < block_size + (block_checksum ? 4 : 0) || block_size > max_block_size) {
+                    return false;
+                }
+                if ((block_header & kUncompressedBlockFlag) != 0) {
+                    out->append(input.data(), block_size);
+                } else {
+                    const size_t history = independent ? 0 : std::min(out->size() - frame_start, kMaxOffset);
+                    if (!lz4_decompress_block(input.substr(0, block_size), history, max_block_size, out)) {
+                        return false;
+                    }
+                }
+                input.remove_prefix(block_size + (block_checksum ? 4 : 0));
+            }
+            if (content_checksum) {
+                if (input.size() < 4) {
+                    return false;
+                }
+                input.remove_prefix(4);
+            }
+        }
+        return true;
+    }
+
+    uint32_t xxh32(const void *data, size_t size, uint32_t seed) {
+        constexpr uint32_t kPrime1 = 2654435761u;
+        constexpr uint32_t kPrime2 = 2246822519u;
+        constexpr uint32_t kPrime3 = 3266489917u;
+        constexpr uint32_t kPrime4 = 668265263u;
+        constexpr uint32_t kPrime5 = 374761393u;
+        const char *p = static_cast<const char *>(data);
+        const char *const end = p + size;
+        uint32_t h;
+        if (size >= 16) {
+            uint32_t v[4] = {seed + kPrime1 + kPrime2, seed + kPrime2, seed, seed - kPrime1};
+            for (; end - p >= 16; p += 16) {
+                for (int i = 0; i < 4; ++i) {
+                    v[i] = rotl32(v[i] + load_le32(p + 4 * i) * kPrime2, 13) * kPrime1;
+                }
+            }
+            h = rotl32(v[0], 1) + rotl32(v[1], 7) + rotl32(v[2], 12) + rotl32(v[3], 18);
+        } else {
+            h = seed + kPrime5;
+        }
+        h += static_cast<uint32_t>(size);
+        for (; end - p >= 4; p += 4) {
+            h = rotl32(h + load_le32(p) * kPrime3, 17) * kPrime4;
+        }
+        for (; p < end; ++p) {
+            h = rotl32(h + static_cast<uint8_t>(*p) * kPrime5, 11) * kPrime1;
+        }
+        h ^= h >> 15;
+        h *= kPrime2;
+        h ^= h >> 13;
+        h *= kPrime3;
+        h ^= h >> 16;
+        return h;
+    }
+
+}  // namespace turbo::log_internal
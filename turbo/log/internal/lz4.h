@@ -0,0 +1,62 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// A self-contained implementation of the LZ4 block and frame formats, just
+// enough to compress log files without an external dependency. Frames are
+// written with independent blocks and no checksums; the output can be read by
+// the `lz4` command line tool.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <turbo/strings/string_view.h>
+
+namespace turbo::log_internal {
+
+    // Largest block the frame writer emits (LZ4 block maximum size id 7).
+    inline constexpr size_t kLz4MaxBlockSize = 4 << 20;
+
+    // Upper bound of the compressed size of `size` input bytes.
+    inline constexpr size_t lz4_compress_bound(size_t size) {
+        return size + size / 255 + 16;
+    }
+
+    // Compresses `size` bytes at `src` into `dst`, which must hold at least
+    // `lz4_compress_bound(size)` bytes, as one LZ4 block. Returns the number of
+    // bytes written. `size` must not exceed `kLz4MaxBlockSize`.
+    size_t lz4_compress_block(const char *src, size_t size, char *dst);
+
+    // Decompresses the LZ4 block `src` and appends the result to `out`. Matches
+    // may reach back into `out` up to `history` bytes before its current end,
+    // which linked-block frames rely on. Fails if the block is malformed or
+    // would decompress to more than `max_size` bytes.
+    bool lz4_decompress_block(std::string_view src, size_t history, size_t max_size, std::string *out);
+
+    // Appends one LZ4 frame holding `input` to `out`.
+    void lz4_compress_frame(std::string_view input, std::string *out);
+
+    // Decompresses a sequence of concatenated LZ4 frames (skippable frames are
+    // ignored) and appends the result to `out`. Returns false, after appending
+    // what could be decoded, on malformed or truncated input.
+    bool lz4_decompress_frames(std::string_view input, std::string *out);
+
+    // XXH32 of `size` bytes; used for the frame header checksum.
+    uint32_t xxh32(const void *data, size_t size, uint32_t seed);
+
+}  // namespace turbo::log_internal
@@ -0,0 +1,76 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/log/internal/owned_log_entry.h>
+
+#include <string_view>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+namespace log_internal {
+
+OwnedLogEntry::OwnedLogEntry() {
+  text_.assign(2, '\0');
+  entry_.line_ = 0;
+  entry_.prefix_ = false;
+  entry_.severity_ = turbo::LogSeverity::kInfo;
+  entry_.verbose_level_ = turbo::LogEntry::kNoVerbosityLevel;
+  entry_.tid_ = 0;
+  entry_.prefix_len_ = 0;
+  entry_.text_message_with_prefix_and_newline_and_nul_ =
+      turbo::span<const char>(text_.data(), text_.size());
+}
+
+void OwnedLogEntry::Reserve(size_t bytes) { text_.reserve(bytes); }
+
+void OwnedLogEntry::Assign(const turbo::LogEntry& entry) {
+  full_filename_.assign(entry.full_filename_.data(),
+                        entry.full_filename_.size());
+  entry_.full_filename_ = full_filename_;
+  // The base name normally points into the full name; keep it that way so
+  // only one copy is made.
+  const std::string_view full = entry.full_filename_;
+  const std::string_view base = entry.base_filename_;
+  if (!full.empty() && base.data() >= full.data() &&
+      base.data() + base.size() <= full.data() + full.size()) {
+    entry_.base_filename_ = std::string_view(
+        full_filename_.data() + (base.data() - full.data()), base.size());
+  } else {
+    base_filename_.assign(base.data(), base.size());
+    entry_.base_filename_ = base_filename_;
+  }
+
+  const auto& text = entry.text_message_with_prefix_and_newline_and_nul_;
+  text_.assign(text.data(), text.size());
+  entry_.text_message_with_prefix_and_newline_and_nul_ =
+      turbo::span<const char>(text_.data(), text_.size());
+  encoding_.assign(entry.encoding_.data(), entry.encoding_.size());
+  entry_.encoding_ = encoding_;
+  entry_.stacktrace_.assign(entry.stacktrace_);
+
+  entry_.line_ = entry.line_;
+  entry_.prefix_ = entry.prefix_;
+  entry_.severity_ = entry.severity_;
+  entry_.verbose_level_ = entry.verbose_level_;
+  entry_.timestamp_ = entry.timestamp_;
+  entry_.tid_ = entry.tid_;
+  entry_.prefix_len_ = entry.prefix_len_;
+}
+
+}  // namespace log_internal
+TURBO_NAMESPACE_END
+}  // namespace turbo
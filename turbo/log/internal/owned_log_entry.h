@@ -0,0 +1,69 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+// -----------------------------------------------------------------------------
+// File: log/internal/owned_log_entry.h
+// -----------------------------------------------------------------------------
+//
+// `OwnedLogEntry` holds a deep copy of a `turbo::LogEntry`, for sinks that
+// hand entries to another thread. A `LogEntry` only views buffers owned by
+// the `LOG` statement, so it cannot outlive `LogSink::Send()`.
+
+#ifndef TURBO_LOG_INTERNAL_OWNED_LOG_ENTRY_H_
+#define TURBO_LOG_INTERNAL_OWNED_LOG_ENTRY_H_
+
+#include <cstddef>
+#include <string>
+
+#include <turbo/base/config.h>
+#include <turbo/log/log_entry.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+namespace log_internal {
+
+class OwnedLogEntry final {
+ public:
+  OwnedLogEntry();
+  OwnedLogEntry(const OwnedLogEntry&) = delete;
+  OwnedLogEntry& operator=(const OwnedLogEntry&) = delete;
+
+  // Copies `entry`. Buffers are reused, so once they have grown to the usual
+  // entry size copying does not allocate.
+  void Assign(const turbo::LogEntry& entry);
+
+  // Preallocates `bytes` for the message text.
+  void Reserve(size_t bytes);
+
+  // Returns an entry viewing the copied data. It stays valid until the next
+  // call to `Assign()`.
+  const turbo::LogEntry& entry() const { return entry_; }
+
+ private:
+  std::string full_filename_;
+  std::string base_filename_;
+  // The message with prefix, trailing newline and NUL.
+  std::string text_;
+  std::string encoding_;
+  turbo::LogEntry entry_;
+};
+
+}  // namespace log_internal
+TURBO_NAMESPACE_END
+}  // namespace turbo
+
+#endif  // TURBO_LOG_INTERNAL_OWNED_LOG_ENTRY_H_
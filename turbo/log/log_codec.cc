@@ -0,0 +1,51 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/log/log_codec.h>
+
+#include <turbo/base/no_destructor.h>
+#include <turbo/log/internal/lz4.h>
+
+namespace turbo {
+    TURBO_NAMESPACE_BEGIN
+
+    namespace {
+
+        class Lz4LogCodec final : public LogCodec {
+        public:
+            std::string_view extension() const override {
+                return ".lz4";
+            }
+
+            void compress(std::string_view input, std::string *out) const override {
+                log_internal::lz4_compress_frame(input, out);
+            }
+
+            bool decompress(std::string_view input, std::string *out) const override {
+                return log_internal::lz4_decompress_frames(input, out);
+            }
+        };
+
+    }  // namespace
+
+    std::shared_ptr<const LogCodec> lz4_log_codec() {
+        static turbo::NoDestructor<std::shared_ptr<const LogCodec>> codec(std::make_shared<Lz4LogCodec>());
+        return *codec;
+    }
+
+    TURBO_NAMESPACE_END
+}  // namespace turbo
@@ -0,0 +1,85 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+// File: log/log_codec.h
+// -----------------------------------------------------------------------------
+//
+// This header declares `LogCodec`, the compression used by the file sinks
+// (`RotatingFileSink`, `DailyFileSink`, `HourlyFileSink`) when they are given
+// `LogCompressionOptions`, and `lz4_log_codec()`, the built-in codec.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <turbo/base/config.h>
+#include <turbo/strings/string_view.h>
+#include <turbo/times/time.h>
+
+namespace turbo {
+    TURBO_NAMESPACE_BEGIN
+
+    class LogCodec {
+    public:
+        virtual ~LogCodec() = default;
+
+        // Appended to the name of compressed files, e.g. ".lz4".
+        virtual std::string_view extension() const = 0;
+
+        // Appends `input`, compressed, to `out`. The output of consecutive
+        // calls, concatenated, must be a valid compressed file: the live mode
+        // compresses a file in chunks.
+        virtual void compress(std::string_view input, std::string *out) const = 0;
+
+        // Appends the content of the compressed file `input` to `out`. Returns
+        // false if `input` is malformed or truncated.
+        virtual bool decompress(std::string_view input, std::string *out) const = 0;
+    };
+
+    // lz4_log_codec()
+    //
+    // The built-in codec: LZ4 frames with independent blocks, written without
+    // an external dependency and readable with `lz4 -d` or `lz4cat`.
+    std::shared_ptr<const LogCodec> lz4_log_codec();
+
+    struct LogCompressionOptions {
+        enum class Mode {
+            // Files are written as usual and compressed by a background
+            // thread once they have been rotated away.
+            kRotated,
+            // The file being written is compressed too, one chunk at a time,
+            // by a background thread. Each chunk can be decompressed on its
+            // own, so the file stays readable up to the last chunk written
+            // even after a crash.
+            kLive,
+        };
+
+        // Compression is off while this is null.
+        std::shared_ptr<const LogCodec> codec;
+        Mode mode = Mode::kRotated;
+        // kLive: a chunk is written once this much text has been buffered...
+        size_t chunk_size = 1 << 20;
+        // ...or when the oldest buffered text is this old, whichever comes
+        // first, even if nothing else is logged; such a chunk is flushed to
+        // the file too. A sink `Flush()` also writes a chunk.
+        turbo::Duration sync_interval = turbo::Duration::seconds(5);
+    };
+
+    TURBO_NAMESPACE_END
+}  // namespace turbo
@@ -44,6 +44,8 @@ namespace turbo {
         class LogEntryTestPeer;
 
         class LogMessage;
+
+        class OwnedLogEntry;
     }  // namespace log_internal
 
     // LogEntry
@@ -223,6 +225,8 @@ namespace turbo {
         friend class log_internal::LogEntryTestPeer;
 
         friend class log_internal::LogMessage;
+
+        friend class log_internal::OwnedLogEntry;
     };
 
 }  // namespace turbo
@@ -41,7 +41,8 @@ namespace turbo {
                                int rotation_minute,
                                int check_interval_s,
                                bool truncate,
-                               uint16_t max_files) {
+                               uint16_t max_files,
+                               const LogCompressionOptions &compression) {
         std::unique_lock lock(g_sink_mutex);
         if (g_sink != nullptr) {
             std::cerr << g_multi_register_die_message << std::endl;
@@ -49,7 +50,7 @@ namespace turbo {
         }
 
         g_sink = std::make_shared<DailyFileSink>(base_filename, rotation_hour, rotation_minute, check_interval_s,
-                                                 truncate, max_files);
+                                                 truncate, max_files, compression);
         initialize_log();
         add_log_sink(g_sink.get());
     }
@@ -58,7 +59,8 @@ namespace turbo {
                                 int rotation_minute,
                                 int check_interval_s,
                                 bool truncate,
-                                uint16_t max_files) {
+                                uint16_t max_files,
+                                const LogCompressionOptions &compression) {
         std::unique_lock lock(g_sink_mutex);
         if (g_sink != nullptr) {
             std::cerr << g_multi_register_die_message << std::endl;
@@ -66,7 +68,7 @@ namespace turbo {
         }
 
         g_sink = std::make_shared<HourlyFileSink>(base_filename, rotation_minute, check_interval_s, truncate,
-                                                  max_files);
+                                                  max_files, compression);
         initialize_log();
         add_log_sink(g_sink.get());
     }
@@ -75,14 +77,16 @@ namespace turbo {
                                   int max_file_size_mb,
                                   uint16_t max_files,
                                   bool truncate,
-                                  int check_interval_s) {
+                                  int check_interval_s,
+                                  const LogCompressionOptions &compression) {
         std::unique_lock lock(g_sink_mutex);
         if (g_sink != nullptr) {
             std::cerr << g_multi_register_die_message << std::endl;
             return;
         }
         static const int one_mb = 1024 * 1024;
-        g_sink = std::make_shared<RotatingFileSink>(base_filename, max_file_size_mb * one_mb, check_interval_s, max_files);
+        g_sink = std::make_shared<RotatingFileSink>(base_filename, max_file_size_mb * one_mb, max_files, check_interval_s,
+                                                    compression);
         initialize_log();
         add_log_sink(g_sink.get());
     }
@@ -139,6 +143,21 @@ namespace turbo {
         (void)turbo::get_flag(FLAGS_vlog_module);
     }
 
+    static LogCompressionOptions compression_by_flags() {
+        LogCompressionOptions options;
+        auto mode = turbo::get_flag(FLAGS_log_compression);
+        if (mode.empty()) {
+            return options;
+        }
+        if (mode == "live") {
+            options.mode = LogCompressionOptions::Mode::kLive;
+        } else if (mode != "rotated") {
+            std::cerr << "Unknown log_compression \"" << mode << "\", compressing rotated files" << std::endl;
+        }
+        options.codec = lz4_log_codec();
+        return options;
+    }
+
     void setup_log_by_flags() {
         auto lt = static_cast<LogSinkType>(turbo::get_flag(FLAGS_log_type));
         switch (lt) {
@@ -150,19 +169,22 @@ namespace turbo {
                                       turbo::get_flag(FLAGS_log_rotation_minute),
                                       turbo::get_flag(FLAGS_log_check_interval_s),
                                       turbo::get_flag(FLAGS_log_truncate),
-                                      turbo::get_flag(FLAGS_log_max_files));
+                                      turbo::get_flag(FLAGS_log_max_files),
+                                      compression_by_flags());
                 break;
             case LogSinkType::kHourlyFile:
                 setup_hourly_file_sink(turbo::get_flag(FLAGS_log_base_filename), turbo::get_flag(FLAGS_log_rotation_minute),
                                        turbo::get_flag(FLAGS_log_check_interval_s),
                                        turbo::get_flag(FLAGS_log_truncate),
-                                       turbo::get_flag(FLAGS_log_max_files));
+                                       turbo::get_flag(FLAGS_log_max_files),
+                                       compression_by_flags());
                 break;
             case LogSinkType::kRotatingFile:
                 setup_rotating_file_sink(turbo::get_flag(FLAGS_log_base_filename), turbo::get_flag(FLAGS_log_max_file_size),
                                          turbo::get_flag(FLAGS_log_max_files),
                                          turbo::get_flag(FLAGS_log_truncate),
-                                         turbo::get_flag(FLAGS_log_check_interval_s));
+                                         turbo::get_flag(FLAGS_log_check_interval_s),
+                                         compression_by_flags());
                 break;
             default:
                 setup_ansi_color_stdout_sink();
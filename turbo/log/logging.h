@@ -24,6 +24,7 @@
 #include <turbo/log/vlog_is_on.h>
 #include <turbo/log/globals.h>
 #include <turbo/log/initialize.h>
+#include <turbo/log/log_codec.h>
 
 namespace turbo {
 
@@ -52,19 +53,22 @@ namespace turbo {
                                    int rotation_minute = 0,
                                    int check_interval_s = 60,
                                    bool truncate = false,
-                                   uint16_t max_files = 0);
+                                   uint16_t max_files = 0,
+                                   const LogCompressionOptions& compression = LogCompressionOptions());
 
     void setup_hourly_file_sink(const std::string& base_filename,
                                   int rotation_minute = 0,
                                   int check_interval_s = 60,
                                   bool truncate = false,
-                                  uint16_t max_files = 0);
+                                  uint16_t max_files = 0,
+                                  const LogCompressionOptions& compression = LogCompressionOptions());
 
     void setup_rotating_file_sink(const std::string& base_filename,
                                     int max_file_size_mb = 100,
                                     uint16_t max_files = 100,
                                     bool truncate = false,
-                                    int check_interval_s = 60);
+                                    int check_interval_s = 60,
+                                    const LogCompressionOptions& compression = LogCompressionOptions());
 
     void setup_ansi_color_stdout_sink();
 
@@ -0,0 +1,237 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+
+#include <turbo/log/sinks/async_sink.h>
+
+#include <thread>
+#include <utility>
+
+#include <turbo/base/optimization.h>
+#include <turbo/times/time.h>
+
+namespace turbo {
+
+    namespace {
+
+        // The sink whose drain thread is the current thread, if any. Sends and
+        // flushes issued from the wrapped sinks are handled inline to avoid
+        // waiting on ourselves.
+        thread_local const AsyncLogSink *tls_draining_sink = nullptr;
+
+        std::size_t round_up_to_power_of_two(std::size_t n) {
+            std::size_t p = 2;
+            while (p < n) {
+                p <<= 1;
+            }
+            return p;
+        }
+
+        // Idle drain threads wake up this often even without being signalled.
+        constexpr turbo::Duration kIdleWait = turbo::Duration::milliseconds(100);
+        // Wait used while a flush or a blocked producer is outstanding.
+        constexpr turbo::Duration kBusyWait = turbo::Duration::milliseconds(1);
+
+    }  // namespace
+
+    AsyncLogSink::AsyncLogSink(std::vector<LogSink *> sinks, std::size_t capacity,
+                               AsyncOverflowPolicy policy, std::size_t slot_reserve_bytes)
+            : _sinks(std::move(sinks)),
+              _policy(policy),
+              _mask(round_up_to_power_of_two(capacity) - 1),
+              _slots(new Slot[_mask + 1]),
+              _spare(new log_internal::OwnedLogEntry) {
+        for (std::size_t i = 0; i <= _mask; ++i) {
+            _slots[i].seq.store(i, std::memory_order_relaxed);
+            _slots[i].record.reset(new log_internal::OwnedLogEntry);
+            _slots[i].record->Reserve(slot_reserve_bytes);
+        }
+        _spare->Reserve(slot_reserve_bytes);
+        _drain_thread = std::thread([this] { run(); });
+    }
+
+    AsyncLogSink::~AsyncLogSink() {
+        {
+            turbo::MutexLock lock(&_mutex);
+            _stop = true;
+            _work_cv.Signal();
+        }
+        _drain_thread.join();
+    }
+
+    bool AsyncLogSink::try_push(const LogEntry &entry) {
+        std::size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+        Slot *slot;
+        for (;;) {
+            slot = &_slots[pos & _mask];
+            const std::size_t seq = slot->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        slot->record->Assign(entry);
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool AsyncLogSink::try_pop(std::unique_ptr<log_internal::OwnedLogEntry> *out) {
+        std::size_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+        Slot *slot;
+        for (;;) {
+            slot = &_slots[pos & _mask];
+            const std::size_t seq = slot->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        if (out != nullptr) {
+            out->swap(slot->record);
+        }
+        slot->seq.store(pos + _mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool AsyncLogSink::empty() const {
+        const std::size_t pos = _dequeue_pos.load(std::memory_order_acquire);
+        return _slots[pos & _mask].seq.load(std::memory_order_acquire) != pos + 1;
+    }
+
+    void AsyncLogSink::deliver(const LogEntry &entry) {
+        for (LogSink *sink : _sinks) {
+            sink->Send(entry);
+        }
+    }
+
+    void AsyncLogSink::wake_drain_thread() {
+        // Pairs with the fence in `run()`: either the drain thread sees the new
+        // entry before it sleeps, or this thread sees it sleeping.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_drain_sleeping.load(std::memory_order_relaxed)) {
+            turbo::MutexLock lock(&_mutex);
+            _work_cv.Signal();
+        }
+    }
+
+    void AsyncLogSink::Send(const LogEntry &entry) {
+        if (TURBO_UNLIKELY(tls_draining_sink == this)) {
+            deliver(entry);
+            return;
+        }
+        bool counted_block = false;
+        while (!try_push(entry)) {
+            switch (_policy) {
+                case AsyncOverflowPolicy::kDropNewest:
+                    _dropped_newest.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                case AsyncOverflowPolicy::kDropOldest:
+                    if (try_pop(nullptr)) {
+                        _dropped_oldest.fetch_add(1, std::memory_order_relaxed);
+                    } else {
+                        // The oldest slot is still being written or released.
+                        std::this_thread::yield();
+                    }
+                    break;
+                case AsyncOverflowPolicy::kBlock: {
+                    if (!counted_block) {
+                        counted_block = true;
+                        _blocked.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    turbo::MutexLock lock(&_mutex);
+                    ++_blocked_producers;
+                    _work_cv.Signal();
+                    _drained_cv.WaitWithTimeout(&_mutex, kBusyWait);
+                    --_blocked_producers;
+                    break;
+                }
+            }
+        }
+        _enqueued.fetch_add(1, std::memory_order_relaxed);
+        wake_drain_thread();
+        if (TURBO_UNLIKELY(entry.log_severity() == LogSeverity::kFatal)) {
+            Flush();
+        }
+    }
+
+    void AsyncLogSink::Flush() {
+        if (tls_draining_sink != this) {
+            const std::size_t ticket = _enqueue_pos.load(std::memory_order_acquire);
+            turbo::MutexLock lock(&_mutex);
+            ++_flush_waiters;
+            _work_cv.Signal();
+            while (_drained < ticket) {
+                _drained_cv.Wait(&_mutex);
+            }
+            --_flush_waiters;
+        }
+        for (LogSink *sink : _sinks) {
+            sink->Flush();
+        }
+    }
+
+    AsyncLogSink::Stats AsyncLogSink::stats() const {
+        Stats s;
+        s.enqueued = _enqueued.load(std::memory_order_relaxed);
+        s.dropped_newest = _dropped_newest.load(std::memory_order_relaxed);
+        s.dropped_oldest = _dropped_oldest.load(std::memory_order_relaxed);
+        s.blocked = _blocked.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    void AsyncLogSink::run() {
+        tls_draining_sink = this;
+        for (;;) {
+            while (try_pop(&_spare)) {
+                deliver(_spare->entry());
+            }
+
+            turbo::MutexLock lock(&_mutex);
+            // The ring was just seen empty, so every claimed position has been
+            // delivered here or dropped by a producer. Positions claimed but not
+            // yet published keep `_drained` behind until the next pass.
+            _drained = _dequeue_pos.load(std::memory_order_acquire);
+            if (_flush_waiters > 0 || _blocked_producers > 0) {
+                _drained_cv.SignalAll();
+            }
+            if (_stop && empty()) {
+                break;
+            }
+            _drain_sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (empty() && !_stop) {
+                const bool busy = _flush_waiters > 0 || _blocked_producers > 0;
+                _work_cv.WaitWithTimeout(&_mutex, busy ? kBusyWait : kIdleWait);
+            }
+            _drain_sleeping.store(false, std::memory_order_relaxed);
+        }
+        tls_draining_sink = nullptr;
+    }
+
+}  // namespace turbo
@@ -0,0 +1,143 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <turbo/base/thread_annotations.h>
+#include <turbo/log/internal/owned_log_entry.h>
+#include <turbo/log/log_sink.h>
+#include <turbo/synchronization/mutex.h>
+
+namespace turbo {
+
+    // What `AsyncLogSink::Send()` does when the queue is full.
+    enum class AsyncOverflowPolicy {
+        // Wait until the drain thread makes room.
+        kBlock,
+        // Discard the entry being sent.
+        kDropNewest,
+        // Discard the oldest queued entry to make room.
+        kDropOldest,
+    };
+
+    // AsyncLogSink
+    //
+    // Moves the cost of the wrapped sinks (formatting aside, usually a locked
+    // `fwrite`) off the logging thread. `Send()` copies the entry into a
+    // preallocated slot of a bounded multi-producer ring and returns; a
+    // dedicated thread drains the ring in order into the wrapped sinks.
+    //
+    // Slots keep their buffers between uses, so in steady state `Send()` does
+    // not allocate. Entries of `kFatal` severity are delivered before `Send()`
+    // returns, since the process is about to terminate.
+    //
+    // The wrapped sinks are not owned and must outlive the `AsyncLogSink`.
+    // Destroying the `AsyncLogSink` delivers everything still queued.
+    class AsyncLogSink : public LogSink {
+    public:
+        struct Stats {
+            // Entries accepted into the queue.
+            uint64_t enqueued;
+            // Entries discarded by `kDropNewest`.
+            uint64_t dropped_newest;
+            // Entries discarded by `kDropOldest`.
+            uint64_t dropped_oldest;
+            // `Send()` calls that had to wait under `kBlock`.
+            uint64_t blocked;
+        };
+
+        // `capacity` is rounded up to a power of two and does not include the
+        // entry being delivered. Each slot reserves `slot_reserve_bytes` for
+        // the message text up front.
+        explicit AsyncLogSink(std::vector<LogSink *> sinks,
+                              std::size_t capacity = 8192,
+                              AsyncOverflowPolicy policy = AsyncOverflowPolicy::kBlock,
+                              std::size_t slot_reserve_bytes = 256);
+
+        ~AsyncLogSink() override;
+
+        void Send(const LogEntry &entry) override;
+
+        // Returns once every entry sent before the call has been delivered,
+        // then flushes the wrapped sinks.
+        void Flush() override;
+
+        Stats stats() const;
+
+        std::size_t capacity() const { return _mask + 1; }
+
+    private:
+        struct Slot {
+            std::atomic<std::size_t> seq;
+            std::unique_ptr<log_internal::OwnedLogEntry> record;
+        };
+
+        bool try_push(const LogEntry &entry);
+
+        // Pops the oldest entry. If `out` is not null the popped record is
+        // swapped into it, so the slot is free again before the entry is
+        // delivered; otherwise the entry is discarded.
+        bool try_pop(std::unique_ptr<log_internal::OwnedLogEntry> *out);
+
+        bool empty() const;
+
+        void deliver(const LogEntry &entry);
+
+        void run();
+
+        void wake_drain_thread();
+
+    private:
+        const std::vector<LogSink *> _sinks;
+        const AsyncOverflowPolicy _policy;
+        const std::size_t _mask;
+        std::unique_ptr<Slot[]> _slots;
+
+        // Bounded MPMC ring in the style of Dmitry Vyukov's queue; producers
+        // dropping the oldest entry act as additional consumers.
+        alignas(64) std::atomic<std::size_t> _enqueue_pos{0};
+        alignas(64) std::atomic<std::size_t> _dequeue_pos{0};
+        alignas(64) std::atomic<bool> _drain_sleeping{false};
+
+        std::atomic<uint64_t> _enqueued{0};
+        std::atomic<uint64_t> _dropped_newest{0};
+        std::atomic<uint64_t> _dropped_oldest{0};
+        std::atomic<uint64_t> _blocked{0};
+
+        // Owned by the drain thread; swapped with the slot being drained.
+        std::unique_ptr<log_internal::OwnedLogEntry> _spare;
+
+        turbo::Mutex _mutex;
+        turbo::CondVar _work_cv;
+        turbo::CondVar _drained_cv;
+        // Every position below `_drained` has been delivered or dropped.
+        std::size_t _drained TURBO_GUARDED_BY(_mutex) = 0;
+        int _flush_waiters TURBO_GUARDED_BY(_mutex) = 0;
+        int _blocked_producers TURBO_GUARDED_BY(_mutex) = 0;
+        bool _stop TURBO_GUARDED_BY(_mutex) = false;
+
+        std::thread _drain_thread;
+    };
+
+}  // namespace turbo
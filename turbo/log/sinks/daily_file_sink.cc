@@ -50,21 +50,32 @@ namespace turbo {
                                  int rotation_minute,
                                  int check_interval_s,
                                  bool truncate,
-                                 uint16_t max_files)
+                                 uint16_t max_files,
+                                 const LogCompressionOptions &compression)
             : _base_filename(base_filename),
               _rotation_hour(rotation_hour),
               _rotation_minute(rotation_minute),
               _truncate(truncate),
               _max_files(max_files),
               _check_interval_s(check_interval_s),
-              _next_check_time(turbo::Time::current_time() + turbo::Duration::seconds(check_interval_s)) {
+              _next_check_time(turbo::Time::current_time() + turbo::Duration::seconds(check_interval_s)),
+              _compression(compression),
+              _live_extension(log_internal::live_extension(compression)) {
+        _compressor = log_internal::make_rotated_file_compressor(
+                compression, [this](const std::string &path, const log_internal::FileId &id, const std::string &tmp) {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    log_internal::commit_compressed_file(path, id, tmp, _compressed_extension);
+                });
+        if (_compressor != nullptr) {
+            _compressed_extension = std::string(_compressor->extension());
+        }
         _next_rotation_time = next_rotation_time(turbo::Time::current_time());
         if (_max_files > 0) {
             init_file_queue();
         }
         auto now = turbo::Time::current_time();
-        auto filename = calc_filename(_base_filename, turbo::Time::to_tm(now, turbo::TimeZone::local()));
-        _file_writer = std::make_unique<log_internal::AppendFile>();
+        auto filename = calc_filename(_base_filename, turbo::Time::to_tm(now, turbo::TimeZone::local())) + _live_extension;
+        _file_writer = log_internal::make_log_file_writer(_compression);
         if (_truncate) {
             ::remove(filename.c_str());
         }
@@ -100,8 +111,9 @@ namespace turbo {
         _files = circular_queue<std::string>(static_cast<size_t>(_max_files));
         auto now = turbo::Time::current_time();
         while (filenames.size() < _max_files) {
-            auto filename = calc_filename(_base_filename, turbo::Time::to_tm(now, turbo::TimeZone::local()));
-            if (!log_internal::path_exists(filename)) {
+            auto filename = calc_filename(_base_filename, turbo::Time::to_tm(now, turbo::TimeZone::local())) + _live_extension;
+            if (!log_internal::path_exists(filename) &&
+                (_compressor == nullptr || !log_internal::path_exists(filename + _compressed_extension))) {
                 break;
             }
             filenames.emplace_back(filename);
@@ -122,11 +134,15 @@ namespace turbo {
             return;
         }
         _next_rotation_time = next_rotation_time(stamp);
-        auto filename = calc_filename(_base_filename, turbo::Time::to_tm(stamp, turbo::TimeZone::local()));
+        auto filename = calc_filename(_base_filename, turbo::Time::to_tm(stamp, turbo::TimeZone::local())) + _live_extension;
+        auto previous_file = _file_writer->file_path();
         _file_writer->close();
         _file_writer.reset();
-        _file_writer = std::make_unique<log_internal::AppendFile>();
+        _file_writer = log_internal::make_log_file_writer(_compression);
         _file_writer->initialize(filename);
+        if (_compressor != nullptr && previous_file != filename) {
+            _compressor->add(previous_file);
+        }
         if (_max_files == 0) {
             return;
         }
@@ -136,6 +152,9 @@ namespace turbo {
             auto old_filename = std::move(_files.front());
             _files.pop_front();
             bool ok = log_internal::remove_if_exists(old_filename) == 0;
+            if (_compressor != nullptr) {
+                ok = log_internal::remove_if_exists(old_filename + _compressed_extension) == 0 && ok;
+            }
             if (!ok) {
                 _files.push_back(std::move(current_file));
                 std::cerr << "Failed removing daily file " + old_filename << std::endl;
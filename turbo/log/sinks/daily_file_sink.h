@@ -25,6 +25,8 @@
 #include <mutex>
 #include <turbo/times/time.h>
 #include <turbo/log/internal/append_file.h>
+#include <turbo/log/internal/compressed_file.h>
+#include <turbo/log/log_codec.h>
 #include <turbo/container/circular_queue.h>
 #include <turbo/log/log_sink_registry.h>
 
@@ -37,7 +39,8 @@ namespace turbo {
                       int rotation_minute = 0,
                       int check_interval_s = 60,
                       bool truncate = false,
-                      uint16_t max_files = 0);
+                      uint16_t max_files = 0,
+                      const LogCompressionOptions &compression = LogCompressionOptions());
 
         ~DailyFileSink() override;
 
@@ -60,6 +63,12 @@ namespace turbo {
         circular_queue<std::string> _files;
         std::unique_ptr<FileWriter> _file_writer;
         std::mutex _mutex;
-
+        LogCompressionOptions _compression;
+        // Appended to every file name in live compression mode.
+        std::string _live_extension;
+        // Appended to the names of rotated files once compressed.
+        std::string _compressed_extension;
+        // Last, so that it is stopped before anything its commits touch.
+        std::unique_ptr<log_internal::RotatedFileCompressor> _compressor;
     };
 }  // namespace  turbo
@@ -0,0 +1,311 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+
+#include <turbo/log/sinks/json_sink.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#include <turbo/base/log_severity.h>
+#include <turbo/container/span.h>
+#include <turbo/log/internal/batch_file_writer.h>
+#include <turbo/log/internal/proto.h>
+#include <turbo/strings/numbers.h>
+#include <turbo/times/time.h>
+
+namespace turbo {
+
+    namespace {
+
+        // message `logging.proto.Event`
+        constexpr uint64_t kEventValue = 7;
+        // message `logging.proto.Value`
+        constexpr uint64_t kValueString = 1;
+        constexpr uint64_t kValueStringLiteral = 6;
+
+        constexpr std::string_view kKeyNames[] = {
+                "time", "severity", "tid", "file", "line", "verbosity", "message", "fields", "stacktrace",
+        };
+
+        void append_json_string(std::string_view s, std::string *out) {
+            static constexpr char kHex[] = "0123456789abcdef";
+            out->push_back('"');
+            size_t run = 0;
+            for (size_t i = 0; i < s.size(); ++i) {
+                const auto c = static_cast<unsigned char>(s[i]);
+                if (c >= 0x20 && c != '"' && c != '\\' && c != 0x7f) {
+                    continue;
+                }
+                out->append(s.data() + run, i - run);
+                run = i + 1;
+                switch (c) {
+                    case '"':
+                        out->append("\\\"", 2);
+                        break;
+                    case '\\':
+                        out->append("\\\\", 2);
+                        break;
+                    case '\n':
+                        out->append("\\n", 2);
+                        break;
+                    case '\r':
+                        out->append("\\r", 2);
+                        break;
+                    case '\t':
+                        out->append("\\t", 2);
+                        break;
+                    default: {
+                        const char escaped[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xf]};
+                        out->append(escaped, sizeof(escaped));
+                        break;
+                    }
+                }
+            }
+            out->append(s.data() + run, s.size() - run);
+            out->push_back('"');
+        }
+
+        void append_key(std::string_view key, bool *first, std::string *out) {
+            if (!*first) {
+                out->push_back(',');
+            }
+            *first = false;
+            out->push_back('"');
+            out->append(key.data(), key.size());
+            out->append("\":", 2);
+        }
+
+        template<typename Int>
+        void append_int(Int value, std::string *out) {
+            char buf[numbers_internal::kFastToBufferSize];
+            char *end = numbers_internal::FastIntToBuffer(value, buf);
+            out->append(buf, static_cast<size_t>(end - buf));
+        }
+
+        char *put_digits(int value, int width, char *p) {
+            for (int i = width - 1; i >= 0; --i) {
+                p[i] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+            return p + width;
+        }
+
+        // RFC 3339 in UTC with microseconds, e.g. "2024-05-01T12:34:56.789012Z".
+        void append_time(turbo::Time time, std::string *out) {
+            const int64_t micros = turbo::Time::to_microseconds(time);
+            int64_t seconds = micros / 1000000;
+            int64_t fraction = micros % 1000000;
+            if (fraction < 0) {
+                fraction += 1000000;
+                --seconds;
+            }
+            int64_t days = seconds / 86400;
+            int64_t day_seconds = seconds % 86400;
+            if (day_seconds < 0) {
+                day_seconds += 86400;
+                --days;
+            }
+            // Civil date from days since 1970-01-01, see
+            // http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+            days += 719468;
+            const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+            const int64_t doe = days - era * 146097;
+            const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+            const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+            const int64_t mp = (5 * doy + 2) / 153;
+            const int day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+            const int month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+            const int year = static_cast<int>(yoe + era * 400 + (month <= 2));
+
+            char buf[32];
+            char *p = buf;
+            *p++ = '"';
+            p = put_digits(year, 4, p);
+            *p++ = '-';
+            p = put_digits(month, 2, p);
+            *p++ = '-';
+            p = put_digits(day, 2, p);
+            *p++ = 'T';
+            p = put_digits(static_cast<int>(day_seconds / 3600), 2, p);
+            *p++ = ':';
+            p = put_digits(static_cast<int>(day_seconds / 60 % 60), 2, p);
+            *p++ = ':';
+            p = put_digits(static_cast<int>(day_seconds % 60), 2, p);
+            *p++ = '.';
+            p = put_digits(static_cast<int>(fraction), 6, p);
+            *p++ = 'Z';
+            *p++ = '"';
+            out->append(buf, static_cast<size_t>(p - buf));
+        }
+
+        bool is_key_char(char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' ||
+                   c == '.' || c == '-';
+        }
+
+        // The key named by a literal ending in "key=", or empty.
+        std::string_view trailing_key(std::string_view literal) {
+            if (literal.empty() || literal.back() != '=') {
+                return {};
+            }
+            literal.remove_suffix(1);
+            size_t begin = literal.size();
+            while (begin > 0 && is_key_char(literal[begin - 1])) {
+                --begin;
+            }
+            return literal.substr(begin);
+        }
+
+    }  // namespace
+
+    JsonSink::JsonSink(std::unique_ptr<FileWriter> writer, const JsonSinkOptions &options)
+            : _fields(options.fields), _writer(std::move(writer)) {
+        for (const auto &name: options.keys) {
+            auto it = std::find(std::begin(kKeyNames), std::end(kKeyNames), name);
+            if (it != std::end(kKeyNames)) {
+                _keys.push_back(static_cast<Key>(it - std::begin(kKeyNames)));
+            }
+        }
+        if (options.keys.empty()) {
+            for (size_t i = 0; i < std::size(kKeyNames); ++i) {
+                _keys.push_back(static_cast<Key>(i));
+            }
+        }
+    }
+
+    JsonSink::JsonSink(std::string_view filename, const JsonSinkOptions &options)
+            : JsonSink(log_internal::make_log_file_writer(), options) {
+        _writer->initialize(filename);
+    }
+
+    JsonSink::~JsonSink() {
+        if (_writer != nullptr) {
+            _writer->close();
+        }
+    }
+
+    void JsonSink::Send(const LogEntry &entry) {
+        thread_local std::string buffer;
+        buffer.clear();
+        append_json_line(entry, &buffer);
+        std::lock_guard<std::mutex> lock(_mutex);
+        _writer->write(buffer);
+    }
+
+    void JsonSink::Flush() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _writer->flush();
+    }
+
+    void JsonSink::append_json_line(const LogEntry &entry, std::string *out) const {
+        out->push_back('{');
+        bool first = true;
+        for (Key key: _keys) {
+            const std::string_view name = kKeyNames[static_cast<size_t>(key)];
+            switch (key) {
+                case Key::kTime:
+                    append_key(name, &first, out);
+                    append_time(entry.timestamp(), out);
+                    break;
+                case Key::kSeverity:
+                    append_key(name, &first, out);
+                    append_json_string(LogSeverityName(entry.log_severity()), out);
+                    break;
+                case Key::kTid:
+                    append_key(name, &first, out);
+                    append_int(static_cast<int64_t>(entry.tid()), out);
+                    break;
+                case Key::kFile:
+                    append_key(name, &first, out);
+                    append_json_string(entry.source_basename(), out);
+                    break;
+                case Key::kLine:
+                    append_key(name, &first, out);
+                    append_int(entry.source_line(), out);
+                    break;
+                case Key::kVerbosity:
+                    if (entry.verbosity() != LogEntry::kNoVerbosityLevel) {
+                        append_key(name, &first, out);
+                        append_int(entry.verbosity(), out);
+                    }
+                    break;
+                case Key::kMessage:
+                    append_key(name, &first, out);
+                    append_json_string(entry.text_message(), out);
+                    break;
+                case Key::kFields:
+                    append_key(name, &first, out);
+                    append_fields(entry, out);
+                    break;
+                case Key::kStacktrace:
+                    if (!entry.stacktrace().empty()) {
+                        append_key(name, &first, out);
+                        append_json_string(entry.stacktrace(), out);
+                    }
+                    break;
+            }
+        }
+        out->append("}\n", 2);
+    }
+
+    bool JsonSink::field_allowed(std::string_view name) const {
+        return _fields.empty() || std::find(_fields.begin(), _fields.end(), name) != _fields.end();
+    }
+
+    void JsonSink::append_fields(const LogEntry &entry, std::string *out) const {
+        out->push_back('{');
+        bool first = true;
+        std::string_view key;
+        turbo::span<const char> event(entry.encoded_message().data(), entry.encoded_message().size());
+        log_internal::ProtoField field;
+        while (field.DecodeFrom(&event)) {
+            if (field.tag() != kEventValue || field.type() != log_internal::WireType::kLengthDelimited) {
+                continue;
+            }
+            turbo::span<const char> value = field.bytes_value();
+            log_internal::ProtoField part;
+            std::string_view text;
+            bool literal = false;
+            while (part.DecodeFrom(&value)) {
+                if ((part.tag() == kValueString || part.tag() == kValueStringLiteral) &&
+                    part.type() == log_internal::WireType::kLengthDelimited) {
+                    text = part.string_value();
+                    literal = part.tag() == kValueStringLiteral;
+                }
+            }
+            if (!key.empty()) {
+                // The operand following a `key=` literal is its value, whatever
+                // it holds.
+                if (field_allowed(key)) {
+                    if (!first) {
+                        out->push_back(',');
+                    }
+                    first = false;
+                    append_json_string(key, out);
+                    out->push_back(':');
+                    append_json_string(text, out);
+                }
+                key = {};
+            } else if (literal) {
+                key = trailing_key(text);
+            }
+        }
+        out->push_back('}');
+    }
+
+}  // namespace turbo
@@ -0,0 +1,111 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <turbo/log/file_write.h>
+#include <turbo/log/log_entry.h>
+#include <turbo/log/log_sink.h>
+
+namespace turbo {
+
+    // JsonSinkOptions
+    //
+    // The keys of a line written by `JsonSink`:
+    //
+    //   "time"       UTC, RFC 3339 with microseconds
+    //   "severity"   "INFO", "WARNING", "ERROR" or "FATAL"
+    //   "tid"        thread id
+    //   "file"       source file basename
+    //   "line"       source line
+    //   "verbosity"  only for `VLOG`
+    //   "message"    the text of the message, without prefix
+    //   "fields"     an object holding the structured fields of the message
+    //   "stacktrace" only for entries carrying one
+    //
+    // Like the text sinks, a `JsonSink` writes a FATAL message twice when it
+    // is sent twice: first without, then with its stack trace.
+    //
+    // The structured fields are read from the operands streamed into the
+    // message: a string literal ending in `key=` names the operand that
+    // follows it, so that
+    //
+    //   LOG(INFO) << "request done user=" << user << " latency_ms=" << ms;
+    //
+    // gives `"fields":{"user":"alice","latency_ms":"12"}`.
+    struct JsonSinkOptions {
+        // The keys to write, in this order. Empty for all of them in the
+        // order above.
+        std::vector<std::string> keys;
+        // The structured fields to write. Empty for all of them.
+        std::vector<std::string> fields;
+    };
+
+    // JsonSink
+    //
+    // Writes each entry as a JSON object on its own line, for log pipelines
+    // that ingest JSON. The line is encoded straight from the entry into a
+    // per-thread buffer, without a lock and without allocating once the
+    // buffer has grown to the size of the longest line.
+    class JsonSink : public LogSink {
+    public:
+        // Writes to `writer`, which must be initialized already.
+        explicit JsonSink(std::unique_ptr<FileWriter> writer, const JsonSinkOptions &options = JsonSinkOptions());
+
+        // Writes to the file `filename`.
+        explicit JsonSink(std::string_view filename, const JsonSinkOptions &options = JsonSinkOptions());
+
+        ~JsonSink() override;
+
+        void Send(const LogEntry &entry) override;
+
+        void Flush() override;
+
+        // Appends the line `JsonSink` writes for `entry`, newline included, to
+        // `out`.
+        void append_json_line(const LogEntry &entry, std::string *out) const;
+
+    private:
+        enum class Key : uint8_t {
+            kTime,
+            kSeverity,
+            kTid,
+            kFile,
+            kLine,
+            kVerbosity,
+            kMessage,
+            kFields,
+            kStacktrace,
+        };
+
+        bool field_allowed(std::string_view name) const;
+
+        void append_fields(const LogEntry &entry, std::string *out) const;
+
+        std::vector<Key> _keys;
+        std::vector<std::string> _fields;
+        std::unique_ptr<FileWriter> _writer;
+        std::mutex _mutex;
+    };
+
+}  // namespace turbo
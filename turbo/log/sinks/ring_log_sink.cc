@@ -0,0 +1,241 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+
+#include <turbo/log/sinks/ring_log_sink.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <turbo/base/internal/raw_logging.h>
+#include <turbo/base/log_severity.h>
+#include <turbo/debugging/failure_signal_handler.h>
+
+namespace turbo {
+
+    namespace {
+
+        // File layout: a header page, then the ring.
+        //
+        //   header: magic, capacity, head, sequence (8 bytes each)
+        //   ring:   records, 8 byte aligned, wrapping around the end
+        //
+        // `head` counts the bytes ever reserved, so that a record is known by
+        // its offset in that endless stream; its place in the ring is the
+        // offset modulo the capacity. A record is
+        //
+        //   commit (8)   its offset ^ kCommitMagic, stored last
+        //   length (4)   of the text
+        //   severity (4)
+        //   sequence (8)
+        //   text, padded to 8 bytes
+        //
+        // A reader accepts a record only if its commit word matches its
+        // offset, which neither a record of an earlier lap nor one being
+        // written does.
+        constexpr char kMagic[8] = {'T', 'R', 'B', 'R', 'I', 'N', 'G', '1'};
+        constexpr size_t kHeaderSize = 4096;
+        constexpr size_t kCapacityOffset = 8;
+        constexpr size_t kHeadOffset = 16;
+        constexpr size_t kSequenceOffset = 24;
+        constexpr uint64_t kRecordHeaderSize = 24;
+        constexpr uint64_t kCommitMagic = 0x9e3779b97f4a7c15ull;
+        constexpr uint64_t kMinCapacity = 4096;
+
+        constexpr uint64_t align8(uint64_t n) {
+            return (n + 7) & ~uint64_t{7};
+        }
+
+        uint64_t load_word(const char *p) {
+            uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            return word;
+        }
+
+        // Copies `size` bytes to the ring at `pos`, wrapping around its end.
+        void copy_to_ring(char *ring, uint64_t capacity, uint64_t pos, const void *src, size_t size) {
+            const size_t first = static_cast<size_t>(std::min<uint64_t>(size, capacity - pos));
+            std::memcpy(ring + pos, src, first);
+            if (first < size) {
+                std::memcpy(ring, static_cast<const char *>(src) + first, size - first);
+            }
+        }
+
+        void copy_from_ring(const char *ring, uint64_t capacity, uint64_t pos, void *dst, size_t size) {
+            const size_t first = static_cast<size_t>(std::min<uint64_t>(size, capacity - pos));
+            std::memcpy(dst, ring + pos, first);
+            if (first < size) {
+                std::memcpy(static_cast<char *>(dst) + first, ring, size - first);
+            }
+        }
+
+    }  // namespace
+
+    RingLogSink::RingLogSink(std::string_view filename, std::size_t capacity) {
+        _capacity = std::max(align8(capacity), kMinCapacity);
+        const std::string path(filename);
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            TURBO_RAW_LOG(ERROR, "RingLogSink: cannot open %s: %s", path.c_str(), std::strerror(errno));
+            return;
+        }
+        const size_t file_size = kHeaderSize + _capacity;
+        struct stat st;
+        bool reuse = false;
+        if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) == file_size) {
+            char header[kCapacityOffset + 8];
+            reuse = ::pread(fd, header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                    std::memcmp(header, kMagic, sizeof(kMagic)) == 0 &&
+                    load_word(header + kCapacityOffset) == _capacity;
+        }
+        if (!reuse && (::ftruncate(fd, 0) != 0 || ::ftruncate(fd, static_cast<off_t>(file_size)) != 0)) {
+            TURBO_RAW_LOG(ERROR, "RingLogSink: cannot resize %s: %s", path.c_str(), std::strerror(errno));
+            ::close(fd);
+            return;
+        }
+        void *map = ::mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            TURBO_RAW_LOG(ERROR, "RingLogSink: cannot map %s: %s", path.c_str(), std::strerror(errno));
+            return;
+        }
+        _map = static_cast<char *>(map);
+        _map_size = file_size;
+        _head = reinterpret_cast<uint64_t *>(_map + kHeadOffset);
+        _sequence = reinterpret_cast<uint64_t *>(_map + kSequenceOffset);
+        _data = _map + kHeaderSize;
+        if (!reuse) {
+            std::memcpy(_map + kCapacityOffset, &_capacity, sizeof(_capacity));
+            std::memcpy(_map, kMagic, sizeof(kMagic));
+        }
+        RegisterFailureSignalFlusher(&RingLogSink::sync_on_failure, this);
+    }
+
+    RingLogSink::~RingLogSink() {
+        if (_map != nullptr) {
+            UnregisterFailureSignalFlusher(&RingLogSink::sync_on_failure, this);
+            ::munmap(_map, _map_size);
+        }
+    }
+
+    void RingLogSink::Send(const LogEntry &entry) {
+        if (_map == nullptr) {
+            return;
+        }
+        const bool fatal = entry.log_severity() == LogSeverity::kFatal;
+        std::string_view text = entry.text_message_with_prefix_and_newline();
+        // A single entry never takes more than a quarter of the ring; a cut
+        // entry still ends with a newline.
+        const size_t max_length = static_cast<size_t>(_capacity / 4 - kRecordHeaderSize);
+        const bool truncated = text.size() > max_length;
+        if (truncated) {
+            text = text.substr(0, max_length);
+        }
+        const uint64_t size = kRecordHeaderSize + align8(text.size());
+        const uint64_t offset = __atomic_fetch_add(_head, size, __ATOMIC_RELAXED);
+        const uint64_t sequence = __atomic_fetch_add(_sequence, 1, __ATOMIC_RELAXED);
+        const uint64_t pos = offset % _capacity;
+
+        char header[kRecordHeaderSize - 8];
+        const uint32_t length = static_cast<uint32_t>(text.size());
+        const uint32_t severity = static_cast<uint32_t>(entry.log_severity());
+        std::memcpy(header, &length, 4);
+        std::memcpy(header + 4, &severity, 4);
+        std::memcpy(header + 8, &sequence, 8);
+        copy_to_ring(_data, _capacity, (pos + 8) % _capacity, header, sizeof(header));
+        copy_to_ring(_data, _capacity, (pos + kRecordHeaderSize) % _capacity, text.data(), text.size());
+        if (truncated) {
+            copy_to_ring(_data, _capacity, (pos + kRecordHeaderSize + text.size() - 1) % _capacity, "\n", 1);
+        }
+        // `pos` is 8 byte aligned and so is the capacity: the commit word
+        // never wraps.
+        __atomic_store_n(reinterpret_cast<uint64_t *>(_data + pos), offset ^ kCommitMagic, __ATOMIC_RELEASE);
+
+        if (fatal) {
+            sync();
+        }
+    }
+
+    void RingLogSink::Flush() {}
+
+    void RingLogSink::sync() {
+        if (_map != nullptr) {
+            ::msync(_map, _map_size, MS_SYNC);
+        }
+    }
+
+    void RingLogSink::sync_on_failure(void *sink) {
+        static_cast<RingLogSink *>(sink)->sync();
+    }
+
+    bool decode_ring_log(std::string_view data, std::string *out) {
+        if (data.size() < kHeaderSize || std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+            return false;
+        }
+        const uint64_t capacity = load_word(data.data() + kCapacityOffset);
+        const uint64_t head = load_word(data.data() + kHeadOffset);
+        if (capacity < kMinCapacity || capacity % 8 != 0 || data.size() - kHeaderSize < capacity ||
+            head % 8 != 0) {
+            return false;
+        }
+        const char *ring = data.data() + kHeaderSize;
+
+        struct Record {
+            uint64_t sequence;
+            uint64_t pos;
+            uint32_t length;
+        };
+        std::vector<Record> records;
+        uint64_t offset = head > capacity ? head - capacity : 0;
+        while (offset + kRecordHeaderSize <= head) {
+            const uint64_t pos = offset % capacity;
+            if (load_word(ring + pos) != (offset ^ kCommitMagic)) {
+                offset += 8;
+                continue;
+            }
+            char header[kRecordHeaderSize - 8];
+            copy_from_ring(ring, capacity, (pos + 8) % capacity, header, sizeof(header));
+            Record record;
+            std::memcpy(&record.length, header, 4);
+            std::memcpy(&record.sequence, header + 8, 8);
+            const uint64_t size = kRecordHeaderSize + align8(record.length);
+            if (record.length > capacity / 4 || offset + size > head) {
+                offset += 8;
+                continue;
+            }
+            record.pos = (pos + kRecordHeaderSize) % capacity;
+            records.push_back(record);
+            offset += size;
+        }
+        std::sort(records.begin(), records.end(),
+                  [](const Record &a, const Record &b) { return a.sequence < b.sequence; });
+        for (const Record &record: records) {
+            const size_t start = out->size();
+            out->resize(start + record.length);
+            copy_from_ring(ring, capacity, record.pos, &(*out)[start], record.length);
+        }
+        return true;
+    }
+
+}  // namespace turbo
@@ -0,0 +1,86 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <turbo/log/log_entry.h>
+#include <turbo/log/log_sink.h>
+
+namespace turbo {
+
+    // RingLogSink
+    //
+    // A flight recorder: keeps the last `capacity` bytes of log in a file
+    // mapped into memory, used as a ring. Writing an entry reserves its place
+    // with an atomic add and copies it in, without a lock or a system call;
+    // since the pages are shared with the file, what was written survives a
+    // crash of the process, and `decode_ring_log()` reads it back in order.
+    //
+    // The kernel writes the pages back to disk in the background. Put the file
+    // on a tmpfs such as /dev/shm to keep verbose logging always on without
+    // any disk traffic, at the cost of losing it on a crash of the machine.
+    //
+    // The ring is synced to the file when a FATAL entry is logged and, if the
+    // failure signal handler is installed, on fatal signals. A FATAL message
+    // sent a second time with its stack trace is recorded again.
+    class RingLogSink : public LogSink {
+    public:
+        // Maps `filename`, created or resized to hold `capacity` bytes of
+        // records. An existing ring of the same capacity is appended to, so
+        // that what a crashed run left is kept until it is overwritten.
+        RingLogSink(std::string_view filename, std::size_t capacity);
+
+        ~RingLogSink() override;
+
+        // False if the file could not be mapped; entries are dropped then.
+        bool is_open() const {
+            return _map != nullptr;
+        }
+
+        void Send(const LogEntry &entry) override;
+
+        // Does nothing: the ring is always up to date in memory.
+        void Flush() override;
+
+        // Writes the ring back to the file and waits for it.
+        void sync();
+
+    private:
+        static void sync_on_failure(void *sink);
+
+        char *_map = nullptr;
+        std::size_t _map_size = 0;
+        uint64_t *_head = nullptr;
+        uint64_t *_sequence = nullptr;
+        char *_data = nullptr;
+        uint64_t _capacity = 0;
+    };
+
+    // decode_ring_log()
+    //
+    // Appends the entries held by the content of a `RingLogSink` file to `out`,
+    // oldest first. Entries being written when the file was read, or when the
+    // process died, are skipped. Returns false if `data` is not a ring log.
+    bool decode_ring_log(std::string_view data, std::string *out);
+
+}  // namespace turbo
@@ -37,9 +37,17 @@ namespace turbo {
     }
 
     RotatingFileSink::RotatingFileSink(std::string_view base_filename,std::size_t max_size,
-            std::size_t max_files,int check_interval_s) : _base_filename(base_filename), max_size_(max_size), max_files_(max_files), _check_interval_s(check_interval_s), _next_check_time(turbo::Time::current_time() + turbo::Duration::seconds(check_interval_s)) {
-        _file_writer = std::make_unique<log_internal::AppendFile>();
-        _file_writer->initialize(_base_filename);
+            std::size_t max_files,int check_interval_s, const LogCompressionOptions &compression) : _base_filename(base_filename), max_size_(max_size), max_files_(max_files), _check_interval_s(check_interval_s), _next_check_time(turbo::Time::current_time() + turbo::Duration::seconds(check_interval_s)),
+            _live_extension(log_internal::live_extension(compression)) {
+        _compressor = log_internal::make_rotated_file_compressor(
+                compression, [this](const std::string &path, const log_internal::FileId &id, const std::string &tmp) {
+                    commit_compressed(path, id, tmp);
+                });
+        if (_compressor != nullptr) {
+            _compressed_extension = std::string(_compressor->extension());
+        }
+        _file_writer = log_internal::make_log_file_writer(compression);
+        _file_writer->initialize(_base_filename + _live_extension);
         do_rotate(turbo::Time::current_time());
     }
 
@@ -89,15 +97,43 @@ namespace turbo {
         }
         _file_writer->close();
         for (auto i = max_files_; i > 0; --i) {
-            std::string src = calc_filename(_base_filename, i - 1);
+            std::string src = calc_filename(_base_filename, i - 1) + _live_extension;
+            std::string target = calc_filename(_base_filename, i) + _live_extension;
+            if (_compressor != nullptr) {
+                // Rotated files are either compressed already or waiting in
+                // `_compressor`; both move along.
+                const std::string &ext = _compressed_extension;
+                if (log_internal::path_exists(src + ext)) {
+                    rename_file(src + ext, target + ext);
+                } else if (log_internal::path_exists(src)) {
+                    (void)log_internal::remove_if_exists(target + ext);
+                }
+            }
             if (!log_internal::path_exists(src)) {
                 continue;
             }
-            std::string target = calc_filename(_base_filename, i);
 
             rename_file(src, target);
         }
         _file_writer->reopen();
+        if (_compressor != nullptr && max_files_ > 0) {
+            _compressor->add(calc_filename(_base_filename, 1));
+        }
+    }
+
+    void RotatingFileSink::commit_compressed(const std::string &, const log_internal::FileId &id,
+                                             const std::string &tmp) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        // Rotations may have moved the file since it was queued.
+        for (std::size_t i = 1; i <= max_files_; ++i) {
+            std::string filename = calc_filename(_base_filename, i);
+            log_internal::FileId current;
+            if (log_internal::get_file_id(filename, &current) && current == id) {
+                log_internal::commit_compressed_file(filename, id, tmp, _compressed_extension);
+                return;
+            }
+        }
+        (void)log_internal::remove(tmp);
     }
     bool RotatingFileSink::rename_file(const std::string &src_filename, const std::string &target_filename) {
         (void)log_internal::remove(target_filename);
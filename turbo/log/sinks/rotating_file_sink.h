@@ -24,6 +24,8 @@
 #include <memory>
 #include <mutex>
 #include <turbo/log/internal/append_file.h>
+#include <turbo/log/internal/compressed_file.h>
+#include <turbo/log/log_codec.h>
 #include <turbo/times/time.h>
 #include <turbo/container/circular_queue.h>
 #include <turbo/log/log_sink_registry.h>
@@ -35,7 +37,8 @@ namespace turbo {
         RotatingFileSink(std::string_view base_filename,
                          std::size_t max_size,
                          std::size_t max_files = 0,
-                         int check_interval_s = 60);
+                         int check_interval_s = 60,
+                         const LogCompressionOptions &compression = LogCompressionOptions());
 
         ~RotatingFileSink() override;
 
@@ -50,6 +53,9 @@ namespace turbo {
 
         bool rename_file(const std::string &src_filename, const std::string &target_filename);
 
+        // Called by `_compressor` once the file that was `path` is compressed.
+        void commit_compressed(const std::string &path, const log_internal::FileId &id, const std::string &tmp);
+
     private:
         std::string _base_filename;
         std::size_t max_size_;
@@ -58,6 +64,11 @@ namespace turbo {
         turbo::Time _next_check_time;
         std::unique_ptr<FileWriter> _file_writer;
         std::mutex _mutex;
-
+        // Appended to every file name in live compression mode.
+        std::string _live_extension;
+        // Appended to the names of rotated files once compressed.
+        std::string _compressed_extension;
+        // Last, so that it is stopped before anything its commits touch.
+        std::unique_ptr<log_internal::RotatedFileCompressor> _compressor;
     };
 }  // namespace  turbo
@@ -19,6 +19,7 @@
 
 #include <climits>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <string>
 
@@ -26,6 +27,15 @@
 #include <turbo/base/config.h>
 #include <turbo/base/nullability.h>
 #include <turbo/base/optimization.h>
+#include <turbo/numeric/bits.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(TURBO_INTERNAL_HAVE_SSE2)
+#include <emmintrin.h>
+#elif defined(TURBO_INTERNAL_HAVE_ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace turbo {
     namespace ascii_internal {
@@ -179,41 +189,140 @@ namespace turbo {
             return static_cast<signed char>(u) < threshold;
         }
 
-// Force-inline so the compiler won't merge the short and long implementations.
-        template<bool ToUpper>
-        TURBO_ATTRIBUTE_ALWAYS_INLINE inline constexpr void AsciiStrCaseFoldImpl(
-                turbo::Nonnull<char *> p, size_t size) {
-            // The upper- and lowercase versions of ASCII characters differ by only 1 bit.
-            // When we need to flip the case, we can xor with this bit to achieve the
-            // desired result. Note that the choice of 'a' and 'A' here is arbitrary. We
-            // could have chosen 'z' and 'Z', or any other pair of characters as they all
-            // have the same single bit difference.
-            constexpr unsigned char kAsciiCaseBitFlip = 'a' ^ 'A';
+// The upper- and lowercase versions of ASCII characters differ by only 1 bit.
+// When we need to flip the case, we can xor with this bit to achieve the
+// desired result. Note that the choice of 'a' and 'A' here is arbitrary. We
+// could have chosen 'z' and 'Z', or any other pair of characters as they all
+// have the same single bit difference.
+        constexpr unsigned char kAsciiCaseBitFlip = 'a' ^ 'A';
 
+        template<bool ToUpper>
+        constexpr void AsciiStrCaseFoldScalar(turbo::Nonnull<char *> dst, const char *src, size_t size) {
             for (size_t i = 0; i < size; ++i) {
-                unsigned char v = static_cast<unsigned char>(p[i]);
+                unsigned char v = static_cast<unsigned char>(src[i]);
                 v ^= AsciiInAZRange<ToUpper>(v) ? kAsciiCaseBitFlip : 0;
-                p[i] = static_cast<char>(v);
+                dst[i] = static_cast<char>(v);
             }
         }
 
-// The string size threshold for starting using the long string version.
-        constexpr size_t kCaseFoldThreshold = 16;
+// Vectors of `kVectorWidth` bytes, and the masks comparisons give: all ones
+// in the lanes where the comparison holds. `ToBits()` turns a mask into
+// `kBitsPerLane` bits per lane, lowest lane first.
+#if defined(__AVX2__)
+#define TURBO_INTERNAL_ASCII_SIMD 1
+        using Vector = __m256i;
+        constexpr size_t kVectorWidth = 32;
+        constexpr int kBitsPerLane = 1;
+
+        inline Vector Load(const char *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+
+        inline void Store(char *p, Vector v) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+
+        inline Vector Splat(char c) { return _mm256_set1_epi8(c); }
+
+        inline Vector And(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+
+        inline Vector Or(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+
+        inline Vector Xor(Vector a, Vector b) { return _mm256_xor_si256(a, b); }
+
+        inline Vector Add(Vector a, Vector b) { return _mm256_add_epi8(a, b); }
+
+        inline Vector Equal(Vector a, Vector b) { return _mm256_cmpeq_epi8(a, b); }
+
+        // Signed comparison.
+        inline Vector Less(Vector a, Vector b) { return _mm256_cmpgt_epi8(b, a); }
+
+        inline uint64_t ToBits(Vector mask) {
+            return static_cast<uint32_t>(_mm256_movemask_epi8(mask));
+        }
+#elif defined(TURBO_INTERNAL_HAVE_SSE2)
+#define TURBO_INTERNAL_ASCII_SIMD 1
+        using Vector = __m128i;
+        constexpr size_t kVectorWidth = 16;
+        constexpr int kBitsPerLane = 1;
+
+        inline Vector Load(const char *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+
+        inline void Store(char *p, Vector v) { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+
+        inline Vector Splat(char c) { return _mm_set1_epi8(c); }
+
+        inline Vector And(Vector a, Vector b) { return _mm_and_si128(a, b); }
+
+        inline Vector Or(Vector a, Vector b) { return _mm_or_si128(a, b); }
+
+        inline Vector Xor(Vector a, Vector b) { return _mm_xor_si128(a, b); }
+
+        inline Vector Add(Vector a, Vector b) { return _mm_add_epi8(a, b); }
+
+        inline Vector Equal(Vector a, Vector b) { return _mm_cmpeq_epi8(a, b); }
+
+        inline Vector Less(Vector a, Vector b) { return _mm_cmplt_epi8(a, b); }
+
+        inline uint64_t ToBits(Vector mask) {
+            return static_cast<uint32_t>(_mm_movemask_epi8(mask));
+        }
+#elif defined(TURBO_INTERNAL_HAVE_ARM_NEON) && defined(TURBO_IS_LITTLE_ENDIAN)
+#define TURBO_INTERNAL_ASCII_SIMD 1
+        using Vector = int8x16_t;
+        constexpr size_t kVectorWidth = 16;
+        constexpr int kBitsPerLane = 4;
+
+        inline Vector Load(const char *p) { return vld1q_s8(reinterpret_cast<const int8_t *>(p)); }
+
+        inline void Store(char *p, Vector v) { vst1q_s8(reinterpret_cast<int8_t *>(p), v); }
+
+        inline Vector Splat(char c) { return vdupq_n_s8(static_cast<int8_t>(c)); }
+
+        inline Vector And(Vector a, Vector b) { return vandq_s8(a, b); }
+
+        inline Vector Or(Vector a, Vector b) { return vorrq_s8(a, b); }
 
-// No-inline so the compiler won't merge the short and long implementations.
+        inline Vector Xor(Vector a, Vector b) { return veorq_s8(a, b); }
+
+        inline Vector Add(Vector a, Vector b) { return vaddq_s8(a, b); }
+
+        inline Vector Equal(Vector a, Vector b) { return vreinterpretq_s8_u8(vceqq_s8(a, b)); }
+
+        inline Vector Less(Vector a, Vector b) { return vreinterpretq_s8_u8(vcltq_s8(a, b)); }
+
+        // Narrows each lane to a nibble.
+        inline uint64_t ToBits(Vector mask) {
+            const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_s8(mask), 4);
+            return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+        }
+#endif
+
+#ifdef TURBO_INTERNAL_ASCII_SIMD
         template<bool ToUpper>
-        TURBO_ATTRIBUTE_NOINLINE constexpr void AsciiStrCaseFoldLong(
-                turbo::Nonnull<char *> p, size_t size) {
-            TURBO_ASSUME(size >= kCaseFoldThreshold);
-            AsciiStrCaseFoldImpl<ToUpper>(p, size);
+        inline Vector CaseFold(Vector v) {
+            // `AsciiInAZRange`, one lane at a time.
+            const Vector shifted = Add(v, Splat(static_cast<char>(SCHAR_MIN - (ToUpper ? 'a' : 'A'))));
+            const Vector in_range = Less(shifted, Splat(static_cast<char>(SCHAR_MIN + 26)));
+            return Xor(v, And(in_range, Splat(static_cast<char>(kAsciiCaseBitFlip))));
         }
+#endif
 
-// Splitting to short and long strings to allow vectorization decisions
-// to be made separately in the long and short cases.
         template<bool ToUpper>
-        constexpr void AsciiStrCaseFold(turbo::Nonnull<char *> p, size_t size) {
-            size < kCaseFoldThreshold ? AsciiStrCaseFoldImpl<ToUpper>(p, size)
-                                      : AsciiStrCaseFoldLong<ToUpper>(p, size);
+        void AsciiStrCaseFold(turbo::Nonnull<char *> dst, const char *src, size_t size) {
+#ifdef TURBO_INTERNAL_ASCII_SIMD
+            if (size >= kVectorWidth) {
+                size_t i = 0;
+                for (; i + kVectorWidth <= size; i += kVectorWidth) {
+                    Store(dst + i, CaseFold<ToUpper>(Load(src + i)));
+                }
+                if (i < size) {
+                    // The last vector overlaps the one before. When `dst` is
+                    // `src`, those bytes are converted already, and converting
+                    // them again changes nothing.
+                    i = size - kVectorWidth;
+                    Store(dst + i, CaseFold<ToUpper>(Load(src + i)));
+                }
+                return;
+            }
+#endif
+            AsciiStrCaseFoldScalar<ToUpper>(dst, src, size);
         }
 
         static constexpr size_t ValidateAsciiCasefold() {
@@ -224,8 +333,8 @@ namespace turbo {
             for (unsigned int i = 0; i < num_chars; ++i) {
                 uppered[i] = lowered[i] = static_cast<char>(i);
             }
-            AsciiStrCaseFold<false>(&lowered[0], num_chars);
-            AsciiStrCaseFold<true>(&uppered[0], num_chars);
+            AsciiStrCaseFoldScalar<false>(&lowered[0], &lowered[0], num_chars);
+            AsciiStrCaseFoldScalar<true>(&uppered[0], &uppered[0], num_chars);
             for (size_t i = 0; i < num_chars; ++i) {
                 const char ch = static_cast<char>(i),
                         ch_upper = ('a' <= ch && ch <= 'z' ? 'A' + (ch - 'a') : ch),
@@ -240,14 +349,140 @@ namespace turbo {
 
         static_assert(ValidateAsciiCasefold() == 0, "error in case conversion");
 
+        void AsciiStrToLower(turbo::Nonnull<char *> dst, turbo::Nullable<const char *> src, size_t size) {
+            AsciiStrCaseFold<false>(dst, src, size);
+        }
+
+        void AsciiStrToUpper(turbo::Nonnull<char *> dst, turbo::Nullable<const char *> src, size_t size) {
+            AsciiStrCaseFold<true>(dst, src, size);
+        }
+
+// Classes of characters, tested one character or one vector at a time.
+        struct NonAscii {
+            static bool Test(unsigned char c) { return c >= 128; }
+#ifdef TURBO_INTERNAL_ASCII_SIMD
+            static Vector Test(Vector v) { return Less(v, Splat(0)); }
+#endif
+        };
+
+        struct NonPrintable {
+            static bool Test(unsigned char c) { return !turbo::ascii_isprint(c); }
+#ifdef TURBO_INTERNAL_ASCII_SIMD
+            // Printable: from 32 to 126, signed.
+            static Vector Test(Vector v) { return Or(Less(v, Splat(32)), Equal(v, Splat(127))); }
+#endif
+        };
+
+        struct Whitespace {
+            static bool Test(unsigned char c) { return turbo::ascii_isspace(c); }
+#ifdef TURBO_INTERNAL_ASCII_SIMD
+            // ' ', or from '\t' to '\r': below SCHAR_MIN + 5 once '\t' is
+            // moved to SCHAR_MIN.
+            static Vector Test(Vector v) {
+                const Vector shifted = Add(v, Splat(static_cast<char>(SCHAR_MIN - '\t')));
+                return Or(Equal(v, Splat(' ')), Less(shifted, Splat(static_cast<char>(SCHAR_MIN + 5))));
+            }
+#endif
+        };
+
+        template<typename Class>
+        struct Not {
+            static bool Test(unsigned char c) { return !Class::Test(c); }
+#ifdef TURBO_INTERNAL_ASCII_SIMD
+            static Vector Test(Vector v) { return Xor(Class::Test(v), Splat(static_cast<char>(-1))); }
+#endif
+        };
+
+        template<typename Class>
+        size_t FindFirst(std::string_view s) {
+            const char *p = s.data();
+            size_t i = 0;
+#ifdef TURBO_INTERNAL_ASCII_SIMD
+            for (; i + kVectorWidth <= s.size(); i += kVectorWidth) {
+                const uint64_t bits = ToBits(Class::Test(Load(p + i)));
+                if (bits != 0) {
+                    return i + static_cast<size_t>(turbo::countr_zero(bits) / kBitsPerLane);
+                }
+            }
+#endif
+            for (; i < s.size(); ++i) {
+                if (Class::Test(static_cast<unsigned char>(p[i]))) {
+                    return i;
+                }
+            }
+            return std::string_view::npos;
+        }
+
+        template<typename Class>
+        size_t FindLast(std::string_view s) {
+            const char *p = s.data();
+            size_t i = s.size();
+#ifdef TURBO_INTERNAL_ASCII_SIMD
+            for (; i >= kVectorWidth; i -= kVectorWidth) {
+                const uint64_t bits = ToBits(Class::Test(Load(p + i - kVectorWidth)));
+                if (bits != 0) {
+                    return i - kVectorWidth + static_cast<size_t>((63 - turbo::countl_zero(bits)) / kBitsPerLane);
+                }
+            }
+#endif
+            while (i > 0) {
+                --i;
+                if (Class::Test(static_cast<unsigned char>(p[i]))) {
+                    return i;
+                }
+            }
+            return std::string_view::npos;
+        }
+
+        template<typename Class>
+        size_t Count(std::string_view s) {
+            const char *p = s.data();
+            size_t i = 0;
+            size_t count = 0;
+#ifdef TURBO_INTERNAL_ASCII_SIMD
+            for (; i + kVectorWidth <= s.size(); i += kVectorWidth) {
+                count += static_cast<size_t>(turbo::popcount(ToBits(Class::Test(Load(p + i)))));
+            }
+            count /= kBitsPerLane;
+#endif
+            for (; i < s.size(); ++i) {
+                count += Class::Test(static_cast<unsigned char>(p[i])) ? 1 : 0;
+            }
+            return count;
+        }
+
     }  // namespace ascii_internal
 
     void str_to_lower(turbo::Nonnull<std::string *> s) {
-        return ascii_internal::AsciiStrCaseFold<false>(&(*s)[0], s->size());
+        return ascii_internal::AsciiStrCaseFold<false>(&(*s)[0], s->data(), s->size());
     }
 
     void str_to_upper(turbo::Nonnull<std::string *> s) {
-        return ascii_internal::AsciiStrCaseFold<true>(&(*s)[0], s->size());
+        return ascii_internal::AsciiStrCaseFold<true>(&(*s)[0], s->data(), s->size());
+    }
+
+    bool str_is_ascii(std::string_view s) {
+        return ascii_internal::FindFirst<ascii_internal::NonAscii>(s) == std::string_view::npos;
+    }
+
+    size_t str_count_non_printable(std::string_view s) {
+        return ascii_internal::Count<ascii_internal::NonPrintable>(s);
+    }
+
+    size_t str_find_first_non_printable(std::string_view s) {
+        return ascii_internal::FindFirst<ascii_internal::NonPrintable>(s);
+    }
+
+    size_t str_find_first_whitespace(std::string_view s) {
+        return ascii_internal::FindFirst<ascii_internal::Whitespace>(s);
+    }
+
+    size_t str_find_first_non_whitespace(std::string_view s) {
+        return ascii_internal::FindFirst<ascii_internal::Not<ascii_internal::Whitespace>>(s);
+    }
+
+    size_t str_find_last_non_whitespace(std::string_view s) {
+        return ascii_internal::FindLast<ascii_internal::Not<ascii_internal::Whitespace>>(s);
     }
 
     void trim_complete(turbo::Nonnull<std::string *> str) {
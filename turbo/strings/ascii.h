@@ -50,6 +50,13 @@
 //   If the input character is not an ASCII {lower,upper}-case letter (including
 //   numerical values greater than 127) then the functions return the same value
 //   as the input character.
+//
+// `str_is_ascii()`, `str_count_non_printable()`, `str_find_first_non_printable()`,
+// `str_find_first_whitespace()`, `str_find_first_non_whitespace()`,
+// `str_find_last_non_whitespace()`
+//   Classify a whole string at once, many bytes per instruction where SSE2,
+//   AVX2 or NEON is available. Case conversion and trimming use the same
+//   vectorized loops.
 
 #pragma once
 
@@ -60,6 +67,7 @@
 #include <turbo/base/attributes.h>
 #include <turbo/base/config.h>
 #include <turbo/base/nullability.h>
+#include <turbo/strings/internal/resize_uninitialized.h>
 #include <turbo/strings/string_view.h>
 
 namespace turbo {
@@ -74,6 +82,12 @@ namespace turbo {
         // Declaration for the array of characters to lower-case characters.
         TURBO_DLL extern const char kToLower[256];
 
+        // Writes the `size` characters at `src` to `dst`, converted to lower
+        // (upper) case. `dst` may be `src`.
+        void AsciiStrToLower(turbo::Nonnull<char *> dst, turbo::Nullable<const char *> src, size_t size);
+
+        void AsciiStrToUpper(turbo::Nonnull<char *> dst, turbo::Nullable<const char *> src, size_t size);
+
     }  // namespace ascii_internal
 
         // ascii_isalpha()
@@ -171,8 +185,9 @@ namespace turbo {
 
     // Creates a lowercase string from a given std::string_view.
     TURBO_MUST_USE_RESULT inline std::string str_to_lower(std::string_view s) {
-        std::string result(s);
-        turbo::str_to_lower(&result);
+        std::string result;
+        strings_internal::STLStringResizeUninitialized(&result, s.size());
+        ascii_internal::AsciiStrToLower(&result[0], s.data(), s.size());
         return result;
     }
 
@@ -189,37 +204,84 @@ namespace turbo {
 
     // Creates an uppercase string from a given std::string_view.
     TURBO_MUST_USE_RESULT inline std::string str_to_upper(std::string_view s) {
-        std::string result(s);
-        turbo::str_to_upper(&result);
+        std::string result;
+        strings_internal::STLStringResizeUninitialized(&result, s.size());
+        ascii_internal::AsciiStrToUpper(&result[0], s.data(), s.size());
         return result;
     }
 
+    // str_is_ascii()
+    //
+    // Returns whether every character of `s` is ASCII, i.e. below 128.
+    TURBO_MUST_USE_RESULT bool str_is_ascii(std::string_view s);
+
+    // str_count_non_printable()
+    //
+    // Returns the number of characters of `s` for which `ascii_isprint()` is
+    // false, including every character above 127.
+    TURBO_MUST_USE_RESULT size_t str_count_non_printable(std::string_view s);
+
+    // str_find_first_non_printable()
+    //
+    // Returns the position of the first character of `s` for which
+    // `ascii_isprint()` is false, or `std::string_view::npos`.
+    TURBO_MUST_USE_RESULT size_t str_find_first_non_printable(std::string_view s);
+
+    // str_find_first_whitespace()
+    //
+    // Returns the position of the first character of `s` for which
+    // `ascii_isspace()` is true, or `std::string_view::npos`.
+    TURBO_MUST_USE_RESULT size_t str_find_first_whitespace(std::string_view s);
+
+    // str_find_first_non_whitespace()
+    //
+    // Returns the position of the first character of `s` for which
+    // `ascii_isspace()` is false, or `std::string_view::npos`.
+    TURBO_MUST_USE_RESULT size_t str_find_first_non_whitespace(std::string_view s);
+
+    // str_find_last_non_whitespace()
+    //
+    // Returns the position of the last character of `s` for which
+    // `ascii_isspace()` is false, or `std::string_view::npos`.
+    TURBO_MUST_USE_RESULT size_t str_find_last_non_whitespace(std::string_view s);
+
     // Returns std::string_view with whitespace stripped from the beginning of the
     // given string_view.
     TURBO_MUST_USE_RESULT inline std::string_view trim_left(
             std::string_view str) {
-        auto it = std::find_if_not(str.begin(), str.end(), turbo::ascii_isspace);
-        return str.substr(static_cast<size_t>(it - str.begin()));
+        // Most strings have no leading whitespace at all, or a single space.
+        if (str.empty() || !turbo::ascii_isspace(static_cast<unsigned char>(str.front()))) {
+            return str;
+        }
+        if (str.size() == 1 || !turbo::ascii_isspace(static_cast<unsigned char>(str[1]))) {
+            return str.substr(1);
+        }
+        const size_t pos = turbo::str_find_first_non_whitespace(str);
+        return pos == std::string_view::npos ? str.substr(str.size()) : str.substr(pos);
     }
 
     // Strips in place whitespace from the beginning of the given string.
     inline void trim_left(turbo::Nonnull<std::string *> str) {
-        auto it = std::find_if_not(str->begin(), str->end(), turbo::ascii_isspace);
-        str->erase(str->begin(), it);
+        str->erase(0, str->size() - turbo::trim_left(std::string_view(*str)).size());
     }
 
     // Returns std::string_view with whitespace stripped from the end of the given
     // string_view.
     TURBO_MUST_USE_RESULT inline std::string_view trim_right(
             std::string_view str) {
-        auto it = std::find_if_not(str.rbegin(), str.rend(), turbo::ascii_isspace);
-        return str.substr(0, static_cast<size_t>(str.rend() - it));
+        if (str.empty() || !turbo::ascii_isspace(static_cast<unsigned char>(str.back()))) {
+            return str;
+        }
+        if (str.size() == 1 || !turbo::ascii_isspace(static_cast<unsigned char>(str[str.size() - 2]))) {
+            return str.substr(0, str.size() - 1);
+        }
+        const size_t pos = turbo::str_find_last_non_whitespace(str);
+        return str.substr(0, pos == std::string_view::npos ? 0 : pos + 1);
     }
 
     // Strips in place whitespace from the end of the given string
     inline void trim_right(turbo::Nonnull<std::string *> str) {
-        auto it = std::find_if_not(str->rbegin(), str->rend(), turbo::ascii_isspace);
-        str->erase(static_cast<size_t>(str->rend() - it));
+        str->erase(turbo::trim_right(std::string_view(*str)).size());
     }
 
     // Returns std::string_view with whitespace stripped from both ends of the
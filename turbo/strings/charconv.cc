@@ -21,7 +21,10 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <limits>
+#include <string>
 #include <system_error>  // NOLINT(build/c++11)
 
 #include <turbo/base/casts.h>
@@ -31,6 +34,7 @@
 #include <turbo/numeric/int128.h>
 #include <turbo/strings/internal/charconv_bigint.h>
 #include <turbo/strings/internal/charconv_parse.h>
+#include <turbo/strings/internal/shortest_decimal.h>
 
 // The macro TURBO_BIT_PACK_FLOATS is defined on x86-64, where IEEE floating
 // point numbers have the same endianness in memory as a bitfield struct
@@ -1444,4 +1448,296 @@ namespace turbo {
         };
 
     }  // namespace
+
+    namespace {
+
+        using strings_internal::ShortestDecimal;
+
+        // The layout of an IEEE binary floating point type.
+        struct FloatLayout {
+            int mantissa_bits;
+            int exponent_bits;
+        };
+
+        constexpr FloatLayout kDoubleLayout = {52, 11};
+        constexpr FloatLayout kFloatLayout = {23, 8};
+        constexpr FloatLayout kFloat16Layout = {10, 5};
+
+        // Writes the `count` decimal digits of `digits` at `out`.
+        void WriteDigits(char *out, uint64_t digits, int count) {
+            for (int i = count - 1; i >= 0; --i) {
+                out[i] = static_cast<char>('0' + digits % 10);
+                digits /= 10;
+            }
+        }
+
+        // The decimal exponent of the first digit of `d`.
+        int LeadingExponent(const ShortestDecimal &d) {
+            return d.exponent + d.num_digits - 1;
+        }
+
+        int ScientificLength(const ShortestDecimal &d) {
+            const int exponent = std::abs(LeadingExponent(d));
+            return d.num_digits + (d.num_digits > 1 ? 1 : 0) + 2 +
+                   (exponent >= 100 ? 3 : 2);
+        }
+
+        char *WriteScientific(char *out, const ShortestDecimal &d) {
+            WriteDigits(out + 1, d.digits, d.num_digits);
+            out[0] = out[1];
+            if (d.num_digits > 1) {
+                out[1] = '.';
+                out += d.num_digits + 1;
+            } else {
+                out += 1;
+            }
+            int exponent = LeadingExponent(d);
+            *out++ = 'e';
+            *out++ = exponent < 0 ? '-' : '+';
+            exponent = std::abs(exponent);
+            if (exponent >= 100) {
+                *out++ = static_cast<char>('0' + exponent / 100);
+                exponent %= 100;
+            }
+            *out++ = static_cast<char>('0' + exponent / 10);
+            *out++ = static_cast<char>('0' + exponent % 10);
+            return out;
+        }
+
+        int FixedLength(const ShortestDecimal &d) {
+            if (d.exponent >= 0) {
+                return d.num_digits + d.exponent;
+            }
+            const int point = d.num_digits + d.exponent;
+            return point > 0 ? d.num_digits + 1 : 2 - point + d.num_digits;
+        }
+
+        char *WriteFixed(char *out, const ShortestDecimal &d) {
+            if (d.exponent >= 0) {
+                WriteDigits(out, d.digits, d.num_digits);
+                out += d.num_digits;
+                std::memset(out, '0', static_cast<size_t>(d.exponent));
+                return out + d.exponent;
+            }
+            const int point = d.num_digits + d.exponent;
+            if (point > 0) {
+                WriteDigits(out + 1, d.digits, d.num_digits);
+                std::memmove(out, out + 1, static_cast<size_t>(point));
+                out[point] = '.';
+                return out + d.num_digits + 1;
+            }
+            out[0] = '0';
+            out[1] = '.';
+            std::memset(out + 2, '0', static_cast<size_t>(-point));
+            out += 2 - point;
+            WriteDigits(out, d.digits, d.num_digits);
+            return out + d.num_digits;
+        }
+
+        // printf's "%g" picks scientific notation for exponents below -4 or
+        // from its precision up; that is 6 when the digits are the shortest.
+        bool GeneralIsScientific(const ShortestDecimal &d) {
+            const int exponent = LeadingExponent(d);
+            return exponent < -4 || exponent >= 6;
+        }
+
+        int HexLength(int exponent, int fraction_digits) {
+            // "h", the fraction digits with their point, "p+", the exponent.
+            int length = 1 + (fraction_digits > 0 ? fraction_digits + 1 : 0) + 2;
+            exponent = std::abs(exponent);
+            do {
+                ++length;
+                exponent /= 10;
+            } while (exponent != 0);
+            return length;
+        }
+
+        // Returns the result of writing `length` characters with `write`, or
+        // value_too_large if they do not fit.
+        template <typename Write>
+        to_chars_result WriteIfFits(char *first, char *last, int length,
+                                    Write write) {
+            if (last - first < length) {
+                return {last, std::errc::value_too_large};
+            }
+            char *end = write(first);
+            assert(end - first == length);
+            return {end, std::errc()};
+        }
+
+        to_chars_result ToCharsHex(char *first, char *last, uint64_t bits,
+                                   FloatLayout layout) {
+            const uint64_t mantissa_mask =
+                    (uint64_t{1} << layout.mantissa_bits) - 1;
+            const int biased_exponent = static_cast<int>(bits >> layout.mantissa_bits);
+            const int bias = (1 << (layout.exponent_bits - 1)) - 1;
+            // The fraction, padded to whole hex digits.
+            const int padding = (4 - layout.mantissa_bits % 4) % 4;
+            uint64_t fraction = (bits & mantissa_mask) << padding;
+            int fraction_digits = (layout.mantissa_bits + padding) / 4;
+            int leading = 1;
+            int exponent = biased_exponent - bias;
+            if (biased_exponent == 0) {
+                leading = 0;
+                exponent = fraction == 0 ? 0 : 1 - bias;
+            }
+            while (fraction_digits > 0 && (fraction & 0xf) == 0) {
+                fraction >>= 4;
+                --fraction_digits;
+            }
+            const int length = HexLength(exponent, fraction_digits);
+            return WriteIfFits(first, last, length, [&](char *out) {
+                *out++ = static_cast<char>('0' + leading);
+                if (fraction_digits > 0) {
+                    *out++ = '.';
+                    for (int i = fraction_digits - 1; i >= 0; --i) {
+                        out[i] = "0123456789abcdef"[fraction & 0xf];
+                        fraction >>= 4;
+                    }
+                    out += fraction_digits;
+                }
+                *out++ = 'p';
+                *out++ = exponent < 0 ? '-' : '+';
+                char digits[8];
+                int count = 0;
+                int e = std::abs(exponent);
+                do {
+                    digits[count++] = static_cast<char>('0' + e % 10);
+                    e /= 10;
+                } while (e != 0);
+                while (count > 0) {
+                    *out++ = digits[--count];
+                }
+                return out;
+            });
+        }
+
+        // Writes a value given by its bits, `fmt` being 0 for the shortest of
+        // fixed and scientific.
+        to_chars_result ToCharsImpl(char *first, char *last, uint64_t bits,
+                                    FloatLayout layout,
+                                    ShortestDecimal (*shortest)(uint64_t),
+                                    int fmt) {
+            const int total_bits = 1 + layout.exponent_bits + layout.mantissa_bits;
+            const uint64_t sign_bit = uint64_t{1} << (total_bits - 1);
+            const uint64_t exponent_max = (uint64_t{1} << layout.exponent_bits) - 1;
+            if (bits & sign_bit) {
+                if (first == last) {
+                    return {last, std::errc::value_too_large};
+                }
+                *first++ = '-';
+                bits &= ~sign_bit;
+            }
+            if ((bits >> layout.mantissa_bits) == exponent_max) {
+                const bool nan = (bits & ((uint64_t{1} << layout.mantissa_bits) - 1)) != 0;
+                return WriteIfFits(first, last, 3, [&](char *out) {
+                    std::memcpy(out, nan ? "nan" : "inf", 3);
+                    return out + 3;
+                });
+            }
+            if (fmt == static_cast<int>(chars_format::hex)) {
+                return ToCharsHex(first, last, bits, layout);
+            }
+            const ShortestDecimal d = shortest(bits);
+            bool scientific;
+            switch (fmt) {
+                case static_cast<int>(chars_format::scientific):
+                    scientific = true;
+                    break;
+                case static_cast<int>(chars_format::fixed):
+                    scientific = false;
+                    break;
+                case static_cast<int>(chars_format::general):
+                    scientific = GeneralIsScientific(d);
+                    break;
+                default:
+                    // The exact integer below may be one digit shorter.
+                    scientific = ScientificLength(d) + 1 < FixedLength(d);
+                    break;
+            }
+            // Integers from 2^(mantissa_bits + 1) up are written exactly in
+            // fixed notation, as printf's "%.0f" would, rather than as the
+            // shortest digits padded with zeros.
+            std::string exact;
+            const int biased_exponent = static_cast<int>(bits >> layout.mantissa_bits);
+            const int e2 = biased_exponent - ((1 << (layout.exponent_bits - 1)) - 1) -
+                           layout.mantissa_bits;
+            if (!scientific && e2 > 0 && d.exponent > 0) {
+                strings_internal::BigUnsigned<84> integer(
+                        (bits & ((uint64_t{1} << layout.mantissa_bits) - 1)) |
+                        (uint64_t{1} << layout.mantissa_bits));
+                integer.ShiftLeft(e2);
+                exact = integer.ToString();
+            }
+            const int fixed_length =
+                    exact.empty() ? FixedLength(d) : static_cast<int>(exact.size());
+            if (fmt == 0) {
+                scientific = ScientificLength(d) < fixed_length;
+            }
+            if (scientific) {
+                return WriteIfFits(first, last, ScientificLength(d), [&](char *out) {
+                    return WriteScientific(out, d);
+                });
+            }
+            return WriteIfFits(first, last, fixed_length, [&](char *out) {
+                if (!exact.empty()) {
+                    std::memcpy(out, exact.data(), exact.size());
+                    return out + exact.size();
+                }
+                return WriteFixed(out, d);
+            });
+        }
+
+        ShortestDecimal ShortestFromDoubleBits(uint64_t bits) {
+            return strings_internal::ShortestDecimalFromDouble(
+                    turbo::bit_cast<double>(bits));
+        }
+
+        ShortestDecimal ShortestFromFloatBits(uint64_t bits) {
+            return strings_internal::ShortestDecimalFromFloat(
+                    turbo::bit_cast<float>(static_cast<uint32_t>(bits)));
+        }
+
+        ShortestDecimal ShortestFromFloat16Bits(uint64_t bits) {
+            return strings_internal::ShortestDecimalFromFloat16(
+                    static_cast<uint16_t>(bits));
+        }
+
+    }  // namespace
+
+    to_chars_result to_chars(char *first, char *last, double value) {
+        return ToCharsImpl(first, last, turbo::bit_cast<uint64_t>(value),
+                           kDoubleLayout, ShortestFromDoubleBits, 0);
+    }
+
+    to_chars_result to_chars(char *first, char *last, float value) {
+        return ToCharsImpl(first, last, turbo::bit_cast<uint32_t>(value),
+                           kFloatLayout, ShortestFromFloatBits, 0);
+    }
+
+    to_chars_result to_chars(char *first, char *last, Float16 value) {
+        return ToCharsImpl(first, last, value.bits(), kFloat16Layout,
+                           ShortestFromFloat16Bits, 0);
+    }
+
+    to_chars_result to_chars(char *first, char *last, double value,
+                             chars_format fmt) {
+        return ToCharsImpl(first, last, turbo::bit_cast<uint64_t>(value),
+                           kDoubleLayout, ShortestFromDoubleBits,
+                           static_cast<int>(fmt));
+    }
+
+    to_chars_result to_chars(char *first, char *last, float value,
+                             chars_format fmt) {
+        return ToCharsImpl(first, last, turbo::bit_cast<uint32_t>(value),
+                           kFloatLayout, ShortestFromFloatBits,
+                           static_cast<int>(fmt));
+    }
+
+    to_chars_result to_chars(char *first, char *last, Float16 value,
+                             chars_format fmt) {
+        return ToCharsImpl(first, last, value.bits(), kFloat16Layout,
+                           ShortestFromFloat16Bits, static_cast<int>(fmt));
+    }
+
 }  // namespace turbo
@@ -21,6 +21,7 @@
 
 #include <turbo/base/config.h>
 #include <turbo/base/nullability.h>
+#include <turbo/numeric/float16.h>
 
 namespace turbo {
 
@@ -88,6 +89,51 @@ namespace turbo {
                                         float &value,  // NOLINT
                                         chars_format fmt = chars_format::general);
 
+// The return result of a number-to-string conversion.
+//
+// `ec` is std::errc() on success, with `ptr` one past the last character
+// written, or `value_too_large` if the output did not fit, with `ptr` set to
+// the `last` argument to to_chars.  The output is not NUL-terminated.
+    struct to_chars_result {
+        turbo::Nonnull<char *> ptr;
+        std::errc ec;
+    };
+
+// Workalike compatibility version of std::to_chars from C++17, for `double`,
+// `float` and turbo::Float16.
+//
+// Without `fmt`, writes the shortest string which from_chars() reads back as
+// `value` exactly: of the decimals with the fewest significant digits that
+// round to `value`, the one closest to it, written in fixed or scientific
+// notation, whichever is shorter (fixed on a tie).  For example 0.1 is
+// written as "0.1", 1e23 as "1e+23" and 1.0 / 3 as "0.3333333333333333".
+//
+// With `fmt`, the same digits are written in the given notation: `scientific`
+// as "d.ddde+XX", `fixed` without an exponent, `general` as printf's "%g"
+// would place them, and `hex` as the shortest exact hexadecimal float
+// without a "0x" prefix, as "1.8p+1" for 3.  Like std::to_chars, fixed
+// notation writes integers beyond the precision of the type exactly, so 1e23
+// is "99999999999999991611392".
+//
+// Infinities are written as "inf" and NaNs as "nan", with a leading '-' for
+// negative values.
+    turbo::to_chars_result to_chars(turbo::Nonnull<char *> first,
+                                    turbo::Nonnull<char *> last, double value);
+    turbo::to_chars_result to_chars(turbo::Nonnull<char *> first,
+                                    turbo::Nonnull<char *> last, float value);
+    turbo::to_chars_result to_chars(turbo::Nonnull<char *> first,
+                                    turbo::Nonnull<char *> last, Float16 value);
+
+    turbo::to_chars_result to_chars(turbo::Nonnull<char *> first,
+                                    turbo::Nonnull<char *> last, double value,
+                                    chars_format fmt);
+    turbo::to_chars_result to_chars(turbo::Nonnull<char *> first,
+                                    turbo::Nonnull<char *> last, float value,
+                                    chars_format fmt);
+    turbo::to_chars_result to_chars(turbo::Nonnull<char *> first,
+                                    turbo::Nonnull<char *> last, Float16 value,
+                                    chars_format fmt);
+
 // std::chars_format is specified as a bitmask type, which means the following
 // operations must be provided:
     inline constexpr chars_format operator&(chars_format lhs, chars_format rhs) {
@@ -33,6 +33,7 @@
 #include <turbo/strings/ascii.h>
 #include <turbo/strings/charset.h>
 #include <turbo/strings/internal/escaping.h>
+#include <turbo/strings/internal/escaping_simd.h>
 #include <turbo/strings/internal/resize_uninitialized.h>
 #include <turbo/strings/internal/utf8.h>
 #include <turbo/strings/numbers.h>
@@ -505,242 +506,6 @@ namespace turbo {
             }
         }
 
-// Reverses the mapping in Base64EscapeInternal; see that method's
-// documentation for details of the mapping.
-        bool Base64UnescapeInternal(turbo::Nullable<const char *> src_param, size_t szsrc,
-                                    turbo::Nullable<char *> dest, size_t szdest,
-                                    turbo::Nonnull<const signed char *> unbase64,
-                                    turbo::Nonnull<size_t *> len) {
-            static const char kPad64Equals = '=';
-            static const char kPad64Dot = '.';
-
-            size_t destidx = 0;
-            int decode = 0;
-            int state = 0;
-            unsigned char ch = 0;
-            unsigned int temp = 0;
-
-            // If "char" is signed by default, using *src as an array index results in
-            // accessing negative array elements. Treat the input as a pointer to
-            // unsigned char to avoid this.
-            const unsigned char *src = reinterpret_cast<const unsigned char *>(src_param);
-
-            // The GET_INPUT macro gets the next input character, skipping
-            // over any whitespace, and stopping when we reach the end of the
-            // string or when we read any non-data character.  The arguments are
-            // an arbitrary identifier (used as a label for goto) and the number
-            // of data bytes that must remain in the input to avoid aborting the
-            // loop.
-#define GET_INPUT(label, remain)                                \
-  label:                                                        \
-  --szsrc;                                                      \
-  ch = *src++;                                                  \
-  decode = unbase64[ch];                                        \
-  if (decode < 0) {                                             \
-    if (turbo::ascii_isspace(ch) && szsrc >= remain) goto label; \
-    state = 4 - remain;                                         \
-    break;                                                      \
-  }
-
-            // if dest is null, we're just checking to see if it's legal input
-            // rather than producing output.  (I suspect this could just be done
-            // with a regexp...).  We duplicate the loop so this test can be
-            // outside it instead of in every iteration.
-
-            if (dest) {
-                // This loop consumes 4 input bytes and produces 3 output bytes
-                // per iteration.  We can't know at the start that there is enough
-                // data left in the string for a full iteration, so the loop may
-                // break out in the middle; if so 'state' will be set to the
-                // number of input bytes read.
-
-                while (szsrc >= 4) {
-                    // We'll start by optimistically assuming that the next four
-                    // bytes of the string (src[0..3]) are four good data bytes
-                    // (that is, no nulls, whitespace, padding chars, or illegal
-                    // chars).  We need to test src[0..2] for nulls individually
-                    // before constructing temp to preserve the property that we
-                    // never read past a null in the string (no matter how long
-                    // szsrc claims the string is).
-
-                    if (!src[0] || !src[1] || !src[2] ||
-                        ((temp = ((unsigned(unbase64[src[0]]) << 18) |
-                                  (unsigned(unbase64[src[1]]) << 12) |
-                                  (unsigned(unbase64[src[2]]) << 6) |
-                                  (unsigned(unbase64[src[3]])))) &
-                         0x80000000)) {
-                        // Iff any of those four characters was bad (null, illegal,
-                        // whitespace, padding), then temp's high bit will be set
-                        // (because unbase64[] is -1 for all bad characters).
-                        //
-                        // We'll back up and resort to the slower decoder, which knows
-                        // how to handle those cases.
-
-                    GET_INPUT(first, 4);
-                        temp = static_cast<unsigned char>(decode);
-                    GET_INPUT(second, 3);
-                        temp = (temp << 6) | static_cast<unsigned char>(decode);
-                    GET_INPUT(third, 2);
-                        temp = (temp << 6) | static_cast<unsigned char>(decode);
-                    GET_INPUT(fourth, 1);
-                        temp = (temp << 6) | static_cast<unsigned char>(decode);
-                    } else {
-                        // We really did have four good data bytes, so advance four
-                        // characters in the string.
-
-                        szsrc -= 4;
-                        src += 4;
-                    }
-
-                    // temp has 24 bits of input, so write that out as three bytes.
-
-                    if (destidx + 3 > szdest) return false;
-                    dest[destidx + 2] = static_cast<char>(temp);
-                    temp >>= 8;
-                    dest[destidx + 1] = static_cast<char>(temp);
-                    temp >>= 8;
-                    dest[destidx] = static_cast<char>(temp);
-                    destidx += 3;
-                }
-            } else {
-                while (szsrc >= 4) {
-                    if (!src[0] || !src[1] || !src[2] ||
-                        ((temp = ((unsigned(unbase64[src[0]]) << 18) |
-                                  (unsigned(unbase64[src[1]]) << 12) |
-                                  (unsigned(unbase64[src[2]]) << 6) |
-                                  (unsigned(unbase64[src[3]])))) &
-                         0x80000000)) {
-                    GET_INPUT(first_no_dest, 4);
-                    GET_INPUT(second_no_dest, 3);
-                    GET_INPUT(third_no_dest, 2);
-                    GET_INPUT(fourth_no_dest, 1);
-                    } else {
-                        szsrc -= 4;
-                        src += 4;
-                    }
-                    destidx += 3;
-                }
-            }
-
-#undef GET_INPUT
-
-            // if the loop terminated because we read a bad character, return
-            // now.
-            if (decode < 0 && ch != kPad64Equals && ch != kPad64Dot &&
-                !turbo::ascii_isspace(ch))
-                return false;
-
-            if (ch == kPad64Equals || ch == kPad64Dot) {
-                // if we stopped by hitting an '=' or '.', un-read that character -- we'll
-                // look at it again when we count to check for the proper number of
-                // equals signs at the end.
-                ++szsrc;
-                --src;
-            } else {
-                // This loop consumes 1 input byte per iteration.  It's used to
-                // clean up the 0-3 input bytes remaining when the first, faster
-                // loop finishes.  'temp' contains the data from 'state' input
-                // characters read by the first loop.
-                while (szsrc > 0) {
-                    --szsrc;
-                    ch = *src++;
-                    decode = unbase64[ch];
-                    if (decode < 0) {
-                        if (turbo::ascii_isspace(ch)) {
-                            continue;
-                        } else if (ch == kPad64Equals || ch == kPad64Dot) {
-                            // back up one character; we'll read it again when we check
-                            // for the correct number of pad characters at the end.
-                            ++szsrc;
-                            --src;
-                            break;
-                        } else {
-                            return false;
-                        }
-                    }
-
-                    // Each input character gives us six bits of output.
-                    temp = (temp << 6) | static_cast<unsigned char>(decode);
-                    ++state;
-                    if (state == 4) {
-                        // If we've accumulated 24 bits of output, write that out as
-                        // three bytes.
-                        if (dest) {
-                            if (destidx + 3 > szdest) return false;
-                            dest[destidx + 2] = static_cast<char>(temp);
-                            temp >>= 8;
-                            dest[destidx + 1] = static_cast<char>(temp);
-                            temp >>= 8;
-                            dest[destidx] = static_cast<char>(temp);
-                        }
-                        destidx += 3;
-                        state = 0;
-                        temp = 0;
-                    }
-                }
-            }
-
-            // Process the leftover data contained in 'temp' at the end of the input.
-            int expected_equals = 0;
-            switch (state) {
-                case 0:
-                    // Nothing left over; output is a multiple of 3 bytes.
-                    break;
-
-                case 1:
-                    // Bad input; we have 6 bits left over.
-                    return false;
-
-                case 2:
-                    // Produce one more output byte from the 12 input bits we have left.
-                    if (dest) {
-                        if (destidx + 1 > szdest) return false;
-                        temp >>= 4;
-                        dest[destidx] = static_cast<char>(temp);
-                    }
-                    ++destidx;
-                    expected_equals = 2;
-                    break;
-
-                case 3:
-                    // Produce two more output bytes from the 18 input bits we have left.
-                    if (dest) {
-                        if (destidx + 2 > szdest) return false;
-                        temp >>= 2;
-                        dest[destidx + 1] = static_cast<char>(temp);
-                        temp >>= 8;
-                        dest[destidx] = static_cast<char>(temp);
-                    }
-                    destidx += 2;
-                    expected_equals = 1;
-                    break;
-
-                default:
-                    // state should have no other values at this point.
-                    TURBO_RAW_LOG(FATAL, "This can't happen; base64 decoder state = %d",
-                                  state);
-            }
-
-            // The remainder of the string should be all whitespace, mixed with
-            // exactly 0 equals signs, or exactly 'expected_equals' equals
-            // signs.  (Always accepting 0 equals signs is an Turbo extension
-            // not covered in the RFC, as is accepting dot as the pad character.)
-
-            int equals = 0;
-            while (szsrc > 0) {
-                if (*src == kPad64Equals || *src == kPad64Dot)
-                    ++equals;
-                else if (!turbo::ascii_isspace(*src))
-                    return false;
-                --szsrc;
-                ++src;
-            }
-
-            const bool ok = (equals == 0 || equals == expected_equals);
-            if (ok) *len = destidx;
-            return ok;
-        }
-
 // The arrays below map base64-escaped characters back to their original values.
 // For the inverse case, see k(WebSafe)Base64Chars in the internal
 // escaping.cc.
@@ -846,33 +611,6 @@ namespace turbo {
 
 /* clang-format on */
 
-        template<typename String>
-        bool Base64UnescapeInternal(turbo::Nullable<const char *> src, size_t slen,
-                                    turbo::Nonnull<String *> dest,
-                                    turbo::Nonnull<const signed char *> unbase64) {
-            // Determine the size of the output string.  Base64 encodes every 3 bytes into
-            // 4 characters.  Any leftover chars are added directly for good measure.
-            const size_t dest_len = 3 * (slen / 4) + (slen % 4);
-
-            strings_internal::STLStringResizeUninitialized(dest, dest_len);
-
-            // We are getting the destination buffer by getting the beginning of the
-            // string and converting it into a char *.
-            size_t len;
-            const bool ok =
-                    Base64UnescapeInternal(src, slen, &(*dest)[0], dest_len, unbase64, &len);
-            if (!ok) {
-                dest->clear();
-                return false;
-            }
-
-            // could be shorter if there was padding
-            assert(len <= dest_len);
-            dest->erase(len);
-
-            return true;
-        }
-
 /* clang-format off */
         constexpr char kHexValueLenient[256] = {
                 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -968,12 +706,130 @@ namespace turbo {
     }
 
     bool base64_decode(std::string_view src, turbo::Nonnull<std::string *> dest) {
-        return Base64UnescapeInternal(src.data(), src.size(), dest, kUnBase64);
+        Base64Decoder decoder;
+        dest->clear();
+        if (!decoder.decode(src, dest) || !decoder.finish(dest)) {
+            dest->clear();
+            return false;
+        }
+        return true;
     }
 
     bool web_safe_base64_decode(std::string_view src,
                                 turbo::Nonnull<std::string *> dest) {
-        return Base64UnescapeInternal(src.data(), src.size(), dest, kUnWebSafeBase64);
+        Base64Decoder decoder(/*web_safe=*/true);
+        dest->clear();
+        if (!decoder.decode(src, dest) || !decoder.finish(dest)) {
+            dest->clear();
+            return false;
+        }
+        return true;
+    }
+
+    bool Base64Decoder::decode(std::string_view src,
+                               turbo::Nonnull<std::string *> dest) {
+        if (failed()) return false;
+        // Four characters give three bytes, with up to three left over from
+        // before.
+        const size_t size = dest->size();
+        strings_internal::STLStringResizeUninitialized(
+                dest, size + (src.size() + 3) / 4 * 3);
+        dest->erase(size + decode_to(src, &(*dest)[size]));
+        return !failed();
+    }
+
+    size_t Base64Decoder::decode_to(std::string_view src,
+                                    turbo::Nonnull<char *> dest) {
+        static const char kPad64Equals = '=';
+        static const char kPad64Dot = '.';
+
+        const char *alphabet = web_safe_ ? strings_internal::kWebSafeBase64Chars
+                                         : strings_internal::kBase64Chars;
+        const signed char *unbase64 = web_safe_ ? kUnWebSafeBase64 : kUnBase64;
+        // If "char" is signed by default, using *src as an array index results in
+        // accessing negative array elements. Treat the input as a pointer to
+        // unsigned char to avoid this.
+        const unsigned char *p = reinterpret_cast<const unsigned char *>(src.data());
+        const size_t n = src.size();
+        char *out = dest;
+        size_t i = 0;
+        while (i < n) {
+            if (count_ == 0 && pads_ == 0) {
+                // Whole groups of four, as many as the vector kernels take, then
+                // one at a time until something else than four data characters
+                // comes up.
+                const size_t bulk = strings_internal::Base64DecodeBlocks(
+                        src.data() + i, n - i, out, alphabet);
+                i += bulk;
+                out += bulk / 4 * 3;
+                while (n - i >= 4) {
+                    // unbase64[] is -1 for all bad characters, which sets the high
+                    // bit.
+                    const unsigned int temp = (unsigned(unbase64[p[i]]) << 18) |
+                                              (unsigned(unbase64[p[i + 1]]) << 12) |
+                                              (unsigned(unbase64[p[i + 2]]) << 6) |
+                                              (unsigned(unbase64[p[i + 3]]));
+                    if (temp & 0x80000000) break;
+                    out[0] = static_cast<char>(temp >> 16);
+                    out[1] = static_cast<char>(temp >> 8);
+                    out[2] = static_cast<char>(temp);
+                    i += 4;
+                    out += 3;
+                }
+                if (i == n) break;
+            }
+
+            const unsigned char ch = p[i];
+            const int decode = unbase64[ch];
+            if (decode >= 0 && pads_ == 0) {
+                // Each input character gives us six bits of output.
+                bits_ = (bits_ << 6) | static_cast<unsigned char>(decode);
+                if (++count_ == 4) {
+                    out[0] = static_cast<char>(bits_ >> 16);
+                    out[1] = static_cast<char>(bits_ >> 8);
+                    out[2] = static_cast<char>(bits_);
+                    out += 3;
+                    bits_ = 0;
+                    count_ = 0;
+                }
+            } else if (ch == kPad64Equals || ch == kPad64Dot) {
+                // Padding ends the data, and rounds out its last group to four
+                // characters. It may be left out altogether (an Turbo extension
+                // not covered in the RFC, as is accepting dot as the pad
+                // character), but not in part.
+                if (pads_ == 0) {
+                    expected_pads_ = count_ < 2 ? 0 : 4 - count_;
+                }
+                if (++pads_ > expected_pads_) {
+                    error_offset_ = offset_ + i;
+                    break;
+                }
+            } else if (!turbo::ascii_isspace(ch)) {
+                error_offset_ = offset_ + i;
+                break;
+            }
+            ++i;
+        }
+        offset_ += n;
+        return static_cast<size_t>(out - dest);
+    }
+
+    bool Base64Decoder::finish(turbo::Nonnull<std::string *> dest) {
+        if (failed()) return false;
+        // Six bits are not a byte, and the padding must be complete.
+        if (count_ == 1 || (pads_ != 0 && pads_ != expected_pads_)) {
+            error_offset_ = offset_;
+            return false;
+        }
+        if (count_ == 2) {
+            dest->push_back(static_cast<char>(bits_ >> 4));
+        } else if (count_ == 3) {
+            dest->push_back(static_cast<char>(bits_ >> 10));
+            dest->push_back(static_cast<char>(bits_ >> 2));
+        }
+        bits_ = 0;
+        count_ = 0;
+        return true;
     }
 
     void base64_encode(std::string_view src, turbo::Nonnull<std::string *> dest) {
@@ -1015,11 +871,13 @@ namespace turbo {
         }
 
         turbo::strings_internal::STLStringResizeUninitialized(&output, num_bytes);
-        auto hex_p = hex.cbegin();
-        for (std::string::iterator bin_p = output.begin(); bin_p != output.end();
-             ++bin_p) {
-            int h1 = turbo::kHexValueStrict[static_cast<size_t>(*hex_p++)];
-            int h2 = turbo::kHexValueStrict[static_cast<size_t>(*hex_p++)];
+        const size_t bulk =
+                strings_internal::HexDecodeBlocks(hex.data(), hex.size(), &output[0]);
+        auto hex_p = hex.cbegin() + static_cast<std::ptrdiff_t>(bulk);
+        for (std::string::iterator bin_p = output.begin() + static_cast<std::ptrdiff_t>(bulk / 2);
+             bin_p != output.end(); ++bin_p) {
+            int h1 = turbo::kHexValueStrict[static_cast<unsigned char>(*hex_p++)];
+            int h2 = turbo::kHexValueStrict[static_cast<unsigned char>(*hex_p++)];
             if (h1 == -1 || h2 == -1) {
                 output.resize(static_cast<size_t>(bin_p - output.begin()));
                 return false;
@@ -1042,7 +900,10 @@ namespace turbo {
     std::string bytes_to_hex_string(std::string_view from) {
         std::string result;
         strings_internal::STLStringResizeUninitialized(&result, 2 * from.size());
-        turbo::BytesToHexStringInternal<std::string &>(reinterpret_cast<const unsigned char *>(from.data()), result, from.size());
+        const unsigned char *src = reinterpret_cast<const unsigned char *>(from.data());
+        const size_t bulk = strings_internal::HexEncodeBlocks(src, from.size(), &result[0]);
+        turbo::BytesToHexStringInternal<char *>(src + bulk, &result[2 * bulk],
+                                                from.size() - bulk);
         return result;
     }
 
@@ -25,6 +25,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -159,6 +160,64 @@ namespace turbo {
     bool web_safe_base64_decode(std::string_view src,
                                turbo::Nonnull<std::string *> dest);
 
+    // Base64Decoder
+    //
+    // Decodes Base64, or its web safe variant, which arrives in pieces, such as
+    // a large payload read off a socket, taking the same input as
+    // base64_decode(): whitespace may appear anywhere, and padding, if any, must
+    // be correct. Unlike base64_decode(), it reports where the input went wrong.
+    //
+    // Example:
+    //
+    //   turbo::Base64Decoder decoder;
+    //   std::string bytes;
+    //   for (std::string_view piece : pieces) {
+    //     if (!decoder.decode(piece, &bytes)) break;
+    //   }
+    //   if (!decoder.finish(&bytes)) {
+    //     return turbo::invalid_argument_error(turbo::str_cat(
+    //         "bad base64 at offset ", decoder.error_offset()));
+    //   }
+    class Base64Decoder {
+    public:
+        explicit Base64Decoder(bool web_safe = false) : web_safe_(web_safe) {}
+
+        // Appends the bytes of the complete groups of four characters seen so far
+        // to `dest`. Returns false, having appended those before it, on the first
+        // byte which is neither in the alphabet, whitespace nor correct padding,
+        // and on every call after that.
+        bool decode(std::string_view src, turbo::Nonnull<std::string *> dest);
+
+        // Ends the input, appending the bytes of a last, padded or unpadded,
+        // group to `dest`. Returns false if the input is not valid Base64.
+        bool finish(turbo::Nonnull<std::string *> dest);
+
+        // Starts over with a new input.
+        void reset() { *this = Base64Decoder(web_safe_); }
+
+        // Whether some input was rejected.
+        bool failed() const { return error_offset_ != std::string_view::npos; }
+
+        // The offset in the whole input of the rejected byte, which is its size
+        // when it ended too early, or std::string_view::npos.
+        size_t error_offset() const { return error_offset_; }
+
+    private:
+        // Decodes `src` to `dest`, which has room for all its groups, and returns
+        // the number of bytes written.
+        size_t decode_to(std::string_view src, turbo::Nonnull<char *> dest);
+
+        bool web_safe_;
+        // The values of the characters of the group being read, 6 bits each.
+        uint32_t bits_ = 0;
+        int count_ = 0;
+        // The padding seen, and how much the group before it needs.
+        int pads_ = 0;
+        int expected_pads_ = 0;
+        size_t offset_ = 0;
+        size_t error_offset_ = std::string_view::npos;
+    };
+
     // hex_string_to_bytes()
     //
     // Converts the hexadecimal encoded data in `hex` into raw bytes in the `bytes`
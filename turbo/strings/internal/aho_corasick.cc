@@ -0,0 +1,197 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/strings/internal/aho_corasick.h>
+
+#include <string>
+
+#include <turbo/strings/charset.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+namespace strings_internal {
+
+namespace {
+
+CharSet FirstBytes(turbo::span<const std::string_view> patterns) {
+  std::string bytes;
+  for (std::string_view pattern : patterns) {
+    if (!pattern.empty()) bytes.push_back(pattern.front());
+  }
+  return CharSet(bytes);
+}
+
+}  // namespace
+
+AhoCorasick::AhoCorasick(turbo::span<const std::string_view> patterns)
+    : first_bytes_(FirstBytes(patterns)) {
+  // Bytes which occur in no pattern share class 0.
+  for (std::string_view pattern : patterns) {
+    for (char c : pattern) {
+      uint16_t& cls = byte_class_[static_cast<unsigned char>(c)];
+      if (cls == 0) cls = static_cast<uint16_t>(num_classes_++);
+    }
+  }
+
+  // The trie, where 0 is the root and stands for a missing edge.
+  next_.assign(num_classes_, 0);
+  depth_.push_back(0);
+  output_.push_back(kNoPattern);
+  pattern_sizes_.reserve(patterns.size());
+  for (size_t i = 0; i < patterns.size(); ++i) {
+    const std::string_view pattern = patterns[i];
+    pattern_sizes_.push_back(static_cast<uint32_t>(pattern.size()));
+    if (pattern.empty()) continue;
+    uint32_t node = 0;
+    for (char c : pattern) {
+      const size_t edge =
+          node * num_classes_ + byte_class_[static_cast<unsigned char>(c)];
+      if (next_[edge] == 0) {
+        const auto child = static_cast<uint32_t>(depth_.size());
+        next_[edge] = child;
+        next_.resize(next_.size() + num_classes_, 0);
+        depth_.push_back(depth_[node] + 1);
+        output_.push_back(kNoPattern);
+      }
+      node = next_[edge];
+    }
+    if (output_[node] == kNoPattern) output_[node] = static_cast<uint32_t>(i);
+  }
+
+  // Failure links breadth first, filling in the missing edges of each node
+  // from those of its failure link, which is shallower and so already done.
+  const size_t num_nodes = depth_.size();
+  std::vector<uint32_t> fail(num_nodes, 0);
+  match_.assign(num_nodes, 0);
+  output_link_.assign(num_nodes, 0);
+  std::vector<uint32_t> queue;
+  queue.reserve(num_nodes);
+  queue.push_back(0);
+  for (size_t k = 0; k < queue.size(); ++k) {
+    const uint32_t node = queue[k];
+    if (node != 0) {
+      const uint32_t link = fail[node];
+      output_link_[node] = match_[link];
+      match_[node] = output_[node] != kNoPattern ? node : output_link_[node];
+    }
+    for (size_t cls = 0; cls < num_classes_; ++cls) {
+      uint32_t& edge = next_[node * num_classes_ + cls];
+      if (edge != 0) {
+        fail[edge] = node == 0 ? 0 : next_[fail[node] * num_classes_ + cls];
+        queue.push_back(edge);
+      } else if (node != 0) {
+        edge = next_[fail[node] * num_classes_ + cls];
+      }
+    }
+  }
+
+  // Skipping to the next possible start only pays off with the vector
+  // kernels.
+  prefilter_ = !first_bytes_.empty() && first_bytes_.vectorized();
+}
+
+// The matches are found as in the online algorithm, but among those ending
+// at a byte only the longest one which does not overlap the previous match
+// can be the next one, and which does depends on where that one ends. So the
+// best match so far is only a candidate until no later match can start at or
+// before it, which is once the text the current node stands for begins after
+// it. The hits in the meantime are kept, and gone through again once the
+// candidate is settled, for the matches following it.
+void AhoCorasick::Scan(std::string_view piece, State* state,
+                       std::vector<Match>* out) const {
+  const auto* data = reinterpret_cast<const unsigned char*>(piece.data());
+  const size_t size = piece.size();
+  const size_t base = state->pos_;
+  uint32_t node = state->node_;
+  size_t i = 0;
+  while (i < size) {
+    if (node == 0 && !state->has_candidate_ && prefilter_ &&
+        !first_bytes_.contains(static_cast<char>(data[i]))) {
+      i = FindFirstOf(first_bytes_, piece, i + 1);
+      if (i == std::string_view::npos) break;
+    }
+    node = Next(node, data[i]);
+    ++i;
+    // Hits without matches only matter for settling the candidate.
+    if (match_[node] != 0 ||
+        (state->has_candidate_ &&
+         state->candidate_.pos < base + i - depth_[node])) {
+      Visit({base + i, node}, state, out);
+    }
+  }
+  state->node_ = node;
+  state->pos_ = base + size;
+}
+
+void AhoCorasick::Finish(State* state, std::vector<Match>* out) const {
+  while (state->has_candidate_) {
+    Commit(state, out);
+    Replay(state, out);
+  }
+}
+
+void AhoCorasick::Visit(Hit hit, State* state, std::vector<Match>* out) const {
+  if (!VisitOnce(hit, state, out)) Replay(state, out);
+}
+
+bool AhoCorasick::VisitOnce(Hit hit, State* state,
+                            std::vector<Match>* out) const {
+  if (state->has_candidate_ &&
+      state->candidate_.pos < hit.end - depth_[hit.node]) {
+    state->replay_.push_back(hit);
+    Commit(state, out);
+    return false;
+  }
+  for (uint32_t m = match_[hit.node]; m != 0; m = output_link_[m]) {
+    const size_t start = hit.end - depth_[m];
+    if (start < state->min_start_) continue;
+    // A candidate which this overlaps ends before it or starts before it.
+    if (!state->has_candidate_ || start <= state->candidate_.pos) {
+      state->candidate_ = {start, output_[m]};
+      state->has_candidate_ = true;
+      return true;
+    }
+    break;
+  }
+  if (state->has_candidate_ && match_[hit.node] != 0) {
+    state->pending_.push_back(hit);
+  }
+  return true;
+}
+
+void AhoCorasick::Commit(State* state, std::vector<Match>* out) const {
+  const Match& match = state->candidate_;
+  out->push_back(match);
+  state->min_start_ = match.pos + pattern_sizes_[match.pattern];
+  state->has_candidate_ = false;
+  state->replay_.insert(state->replay_.end(), state->pending_.rbegin(),
+                        state->pending_.rend());
+  state->pending_.clear();
+}
+
+void AhoCorasick::Replay(State* state, std::vector<Match>* out) const {
+  while (!state->replay_.empty()) {
+    const Hit hit = state->replay_.back();
+    state->replay_.pop_back();
+    // Nothing that ends by the last match can follow it.
+    if (hit.end > state->min_start_) VisitOnce(hit, state, out);
+  }
+}
+
+}  // namespace strings_internal
+TURBO_NAMESPACE_END
+}  // namespace turbo
@@ -0,0 +1,136 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+// The multi-pattern matcher behind turbo::StrReplacer.
+
+#ifndef TURBO_STRINGS_INTERNAL_AHO_CORASICK_H_
+#define TURBO_STRINGS_INTERNAL_AHO_CORASICK_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <turbo/base/config.h>
+#include <turbo/container/span.h>
+#include <turbo/strings/internal/charset_scan.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+namespace strings_internal {
+
+// An Aho-Corasick automaton (Aho and Corasick, "Efficient String Matching: An
+// Aid to Bibliographic Search", CACM 1975) over a set of patterns, unrolled
+// into a DFA on classes of bytes so that each byte of the text costs one
+// table lookup.
+//
+// It reports the matches str_replace_all() makes: the leftmost one, the
+// longest of those starting there, then the next one starting after it, and
+// so on. Empty patterns never match; of equal patterns, the first one does.
+//
+// Text is fed in pieces through a `State`, so that a turbo::Cord can be
+// scanned chunk by chunk.
+class AhoCorasick {
+ public:
+  explicit AhoCorasick(turbo::span<const std::string_view> patterns);
+
+  struct Match {
+    // The position of the match in the whole text.
+    size_t pos;
+    // The index of the pattern in the constructor's list.
+    size_t pattern;
+  };
+
+  // A node with patterns ending at it, reached with the byte before `end`.
+  struct Hit {
+    size_t end;
+    uint32_t node;
+  };
+
+  // The progress of a scan.
+  class State {
+   public:
+    State() = default;
+
+   private:
+    friend class AhoCorasick;
+
+    uint32_t node_ = 0;
+    // The position of the next byte in the whole text.
+    size_t pos_ = 0;
+    // Matches may not start before this, the end of the last one.
+    size_t min_start_ = 0;
+    // The best match found that a later one may still beat.
+    bool has_candidate_ = false;
+    Match candidate_ = {0, 0};
+    // Hits since the candidate was found, whose matches may follow it.
+    std::vector<Hit> pending_;
+    // Hits to go through again, the next one last.
+    std::vector<Hit> replay_;
+  };
+
+  // Scans `piece`, which follows the text `state` has seen so far, and
+  // appends the matches that are settled to `out`.
+  void Scan(std::string_view piece, State* state,
+            std::vector<Match>* out) const;
+  // Ends the text and appends the last match, if any, to `out`.
+  void Finish(State* state, std::vector<Match>* out) const;
+
+  size_t pattern_size(size_t pattern) const { return pattern_sizes_[pattern]; }
+
+ private:
+  static constexpr uint32_t kNoPattern = ~uint32_t{};
+
+  uint32_t Next(uint32_t node, unsigned char c) const {
+    return next_[node * num_classes_ + byte_class_[c]];
+  }
+
+  // Takes the matches of `hit` into account, and those of the hits it causes
+  // to be replayed.
+  void Visit(Hit hit, State* state, std::vector<Match>* out) const;
+  // Returns false if `hit` settles the candidate, after queueing it again
+  // behind the pending hits.
+  bool VisitOnce(Hit hit, State* state, std::vector<Match>* out) const;
+  void Commit(State* state, std::vector<Match>* out) const;
+  void Replay(State* state, std::vector<Match>* out) const;
+
+  size_t num_classes_ = 1;
+  uint16_t byte_class_[256] = {};
+  // next_[node * num_classes_ + class] is the node after reading a byte.
+  std::vector<uint32_t> next_;
+  // The length of the text a node stands for: a match can only start this
+  // far back from the current byte, or later.
+  std::vector<uint32_t> depth_;
+  // The pattern a node spells, or kNoPattern.
+  std::vector<uint32_t> output_;
+  // The first node with an output along the failure links, starting from
+  // the node itself, or 0. These are the patterns ending at the node, longest
+  // first.
+  std::vector<uint32_t> match_;
+  // The same, starting from the failure link of the node.
+  std::vector<uint32_t> output_link_;
+  std::vector<uint32_t> pattern_sizes_;
+  // The first bytes of the patterns, to skip text quickly from the root.
+  CharSetMatcher first_bytes_;
+  bool prefilter_ = false;
+};
+
+}  // namespace strings_internal
+TURBO_NAMESPACE_END
+}  // namespace turbo
+
+#endif  // TURBO_STRINGS_INTERNAL_AHO_CORASICK_H_
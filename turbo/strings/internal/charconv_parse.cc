@@ -23,6 +23,7 @@
 #include <limits>
 
 #include <turbo/strings/internal/memutil.h>
+#include <turbo/strings/internal/swar_digits.h>
 
 namespace turbo {
 TURBO_NAMESPACE_BEGIN
@@ -266,6 +267,17 @@ int ConsumeDigits(const char* begin, const char* end, int max_digits, T* out,
   T accumulator = *out;
   const char* significant_digits_end =
       (end - begin > max_digits) ? begin + max_digits : end;
+  if (base == 10) {
+    // Eight digits at a time while they last. This is exact for the same
+    // reason as the loop below.
+    while (significant_digits_end - begin >= 8) {
+      const uint64_t chunk = strings_internal::LoadEightChars(begin);
+      if (!strings_internal::IsEightDigits(chunk)) break;
+      accumulator = static_cast<T>(accumulator * T{100000000} +
+                                   strings_internal::ParseEightDigits(chunk));
+      begin += 8;
+    }
+  }
   while (begin < significant_digits_end && IsDigit<base>(*begin)) {
     // Do not guard against *out overflow; max_digits was chosen to avoid this.
     // Do assert against it, to detect problems in debug builds.
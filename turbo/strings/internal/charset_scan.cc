@@ -0,0 +1,364 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/strings/internal/charset_scan.h>
+
+#include <cstring>
+
+#include <turbo/crypto/internal/cpu_detect.h>
+#include <turbo/numeric/bits.h>
+
+// As in utf8.cc, the x86 code is compiled for SSSE3 and AVX2 whatever the
+// flags of the build and picked at runtime.
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define TURBO_CHARSET_SCAN_X86 1
+#include <immintrin.h>
+#elif defined(TURBO_INTERNAL_HAVE_ARM_NEON) && defined(__aarch64__) && defined(TURBO_IS_LITTLE_ENDIAN)
+#define TURBO_CHARSET_SCAN_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+namespace strings_internal {
+
+CharSetMatcher::CharSetMatcher(const CharSet& set) : set_(set) {
+  // The low nibbles of the set under each high nibble, and the distinct
+  // ones among them.
+  uint16_t rows[16] = {};
+  for (int c = 0; c < 256; ++c) {
+    if (set.contains(static_cast<char>(c))) {
+      rows[c >> 4] |= static_cast<uint16_t>(1 << (c & 0xf));
+      empty_ = false;
+    }
+  }
+  uint16_t classes[8];
+  int num_classes = 0;
+  for (int high = 0; high < 16 && vectorized_; ++high) {
+    if (rows[high] == 0) continue;
+    int k = 0;
+    while (k < num_classes && classes[k] != rows[high]) ++k;
+    if (k == num_classes) {
+      if (num_classes == 8) {
+        vectorized_ = false;
+        break;
+      }
+      classes[num_classes++] = rows[high];
+    }
+    high_[high] = static_cast<uint8_t>(1 << k);
+  }
+  for (int low = 0; low < 16; ++low) {
+    for (int k = 0; k < num_classes; ++k) {
+      if (classes[k] & (1 << low)) low_[low] |= static_cast<uint8_t>(1 << k);
+    }
+  }
+}
+
+namespace {
+
+struct ScanKernels {
+  size_t (*find_first_of)(const CharSetMatcher& matcher, const char* p,
+                          size_t n, size_t pos);
+  size_t (*split_by_char)(const char* p, size_t n, char delimiter,
+                          std::string_view* out, size_t capacity);
+  size_t (*split_by_set)(const char* p, size_t n,
+                         const CharSetMatcher& matcher, std::string_view* out,
+                         size_t capacity);
+};
+
+namespace scalar {
+
+class CharMatch {
+ public:
+  explicit CharMatch(char c) : c_(c) {}
+
+  uint64_t operator()(const char* p) const {
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; ++i) {
+      mask |= uint64_t{p[i] == c_} << i;
+    }
+    return mask;
+  }
+
+ private:
+  char c_;
+};
+
+class SetMatch {
+ public:
+  explicit SetMatch(const CharSetMatcher& matcher) : matcher_(matcher) {}
+
+  uint64_t operator()(const char* p) const {
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; ++i) {
+      mask |= uint64_t{matcher_.contains(p[i])} << i;
+    }
+    return mask;
+  }
+
+ private:
+  const CharSetMatcher& matcher_;
+};
+
+#include "turbo/strings/internal/charset_scan.inc"
+
+}  // namespace scalar
+
+#if defined(TURBO_CHARSET_SCAN_X86)
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("ssse3"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("ssse3")
+#endif
+
+namespace ssse3 {
+
+inline uint64_t Mask64(__m128i a, __m128i b, __m128i c, __m128i d) {
+  return static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(a))) |
+         static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(b))) << 16 |
+         static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(c))) << 32 |
+         static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(d))) << 48;
+}
+
+inline __m128i Load(const char* p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+class CharMatch {
+ public:
+  explicit CharMatch(char c) : c_(_mm_set1_epi8(c)) {}
+
+  uint64_t operator()(const char* p) const {
+    return Mask64(_mm_cmpeq_epi8(Load(p), c_), _mm_cmpeq_epi8(Load(p + 16), c_),
+                  _mm_cmpeq_epi8(Load(p + 32), c_),
+                  _mm_cmpeq_epi8(Load(p + 48), c_));
+  }
+
+ private:
+  __m128i c_;
+};
+
+class SetMatch {
+ public:
+  explicit SetMatch(const CharSetMatcher& matcher)
+      : low_(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(matcher.low_table()))),
+        high_(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(matcher.high_table()))) {}
+
+  uint64_t operator()(const char* p) const {
+    return ~Mask64(Miss(Load(p)), Miss(Load(p + 16)), Miss(Load(p + 32)),
+                   Miss(Load(p + 48)));
+  }
+
+ private:
+  __m128i Miss(__m128i v) const {
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    const __m128i classes = _mm_and_si128(
+        _mm_shuffle_epi8(low_, _mm_and_si128(v, nibble)),
+        _mm_shuffle_epi8(high_, _mm_and_si128(_mm_srli_epi16(v, 4), nibble)));
+    return _mm_cmpeq_epi8(classes, _mm_setzero_si128());
+  }
+
+  __m128i low_;
+  __m128i high_;
+};
+
+#include "turbo/strings/internal/charset_scan.inc"
+
+}  // namespace ssse3
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace avx2 {
+
+inline uint64_t Mask64(__m256i a, __m256i b) {
+  return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(a))) |
+         static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(b)))
+             << 32;
+}
+
+inline __m256i Load(const char* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+class CharMatch {
+ public:
+  explicit CharMatch(char c) : c_(_mm256_set1_epi8(c)) {}
+
+  uint64_t operator()(const char* p) const {
+    return Mask64(_mm256_cmpeq_epi8(Load(p), c_),
+                  _mm256_cmpeq_epi8(Load(p + 32), c_));
+  }
+
+ private:
+  __m256i c_;
+};
+
+class SetMatch {
+ public:
+  explicit SetMatch(const CharSetMatcher& matcher)
+      : low_(Table(matcher.low_table())), high_(Table(matcher.high_table())) {}
+
+  uint64_t operator()(const char* p) const {
+    return ~Mask64(Miss(Load(p)), Miss(Load(p + 32)));
+  }
+
+ private:
+  static __m256i Table(const uint8_t* table) {
+    return _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(table)));
+  }
+
+  __m256i Miss(__m256i v) const {
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const __m256i classes = _mm256_and_si256(
+        _mm256_shuffle_epi8(low_, _mm256_and_si256(v, nibble)),
+        _mm256_shuffle_epi8(high_,
+                            _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble)));
+    return _mm256_cmpeq_epi8(classes, _mm256_setzero_si256());
+  }
+
+  __m256i low_;
+  __m256i high_;
+};
+
+#include "turbo/strings/internal/charset_scan.inc"
+
+}  // namespace avx2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#elif defined(TURBO_CHARSET_SCAN_NEON)
+
+namespace neon {
+
+// One bit a lane of four vectors of 0x00 and 0xff lanes.
+inline uint64_t Mask64(uint8x16_t a, uint8x16_t b, uint8x16_t c,
+                       uint8x16_t d) {
+  const uint8x16_t bits = {1, 2, 4, 8, 16, 32, 64, 128,
+                           1, 2, 4, 8, 16, 32, 64, 128};
+  uint8x16_t sum = vpaddq_u8(vpaddq_u8(vandq_u8(a, bits), vandq_u8(b, bits)),
+                             vpaddq_u8(vandq_u8(c, bits), vandq_u8(d, bits)));
+  sum = vpaddq_u8(sum, sum);
+  return vgetq_lane_u64(vreinterpretq_u64_u8(sum), 0);
+}
+
+inline uint8x16_t Load(const char* p) {
+  return vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+}
+
+class CharMatch {
+ public:
+  explicit CharMatch(char c) : c_(vdupq_n_u8(static_cast<uint8_t>(c))) {}
+
+  uint64_t operator()(const char* p) const {
+    return Mask64(vceqq_u8(Load(p), c_), vceqq_u8(Load(p + 16), c_),
+                  vceqq_u8(Load(p + 32), c_), vceqq_u8(Load(p + 48), c_));
+  }
+
+ private:
+  uint8x16_t c_;
+};
+
+class SetMatch {
+ public:
+  explicit SetMatch(const CharSetMatcher& matcher)
+      : low_(vld1q_u8(matcher.low_table())),
+        high_(vld1q_u8(matcher.high_table())) {}
+
+  uint64_t operator()(const char* p) const {
+    return Mask64(Hit(Load(p)), Hit(Load(p + 16)), Hit(Load(p + 32)),
+                  Hit(Load(p + 48)));
+  }
+
+ private:
+  uint8x16_t Hit(uint8x16_t v) const {
+    return vtstq_u8(vqtbl1q_u8(low_, vandq_u8(v, vdupq_n_u8(0x0f))),
+                    vqtbl1q_u8(high_, vshrq_n_u8(v, 4)));
+  }
+
+  uint8x16_t low_;
+  uint8x16_t high_;
+};
+
+#include "turbo/strings/internal/charset_scan.inc"
+
+}  // namespace neon
+
+#endif
+
+const ScanKernels& Kernels() {
+  static const ScanKernels* const kernels = [] {
+#if defined(TURBO_CHARSET_SCAN_X86)
+    if (crc_internal::SupportsX86AVX2()) return &avx2::kKernels;
+    if (crc_internal::SupportsX86SSSE3()) return &ssse3::kKernels;
+#elif defined(TURBO_CHARSET_SCAN_NEON)
+    return &neon::kKernels;
+#endif
+    return &scalar::kKernels;
+  }();
+  return *kernels;
+}
+
+}  // namespace
+
+size_t FindFirstOf(const CharSetMatcher& matcher, std::string_view text,
+                   size_t pos) {
+  if (!matcher.vectorized()) {
+    return scalar::kKernels.find_first_of(matcher, text.data(), text.size(),
+                                          pos);
+  }
+  return Kernels().find_first_of(matcher, text.data(), text.size(), pos);
+}
+
+size_t SplitByChar(std::string_view text, char delimiter,
+                   turbo::span<std::string_view> out) {
+  return Kernels().split_by_char(text.data(), text.size(), delimiter,
+                                 out.data(), out.size());
+}
+
+size_t SplitByCharSet(std::string_view text, const CharSetMatcher& delimiters,
+                      turbo::span<std::string_view> out) {
+  if (!delimiters.vectorized()) {
+    return scalar::kKernels.split_by_set(text.data(), text.size(), delimiters,
+                                         out.data(), out.size());
+  }
+  return Kernels().split_by_set(text.data(), text.size(), delimiters,
+                                out.data(), out.size());
+}
+
+}  // namespace strings_internal
+TURBO_NAMESPACE_END
+}  // namespace turbo
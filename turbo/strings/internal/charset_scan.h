@@ -0,0 +1,82 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+// Vectorized search for the bytes of a turbo::CharSet, behind the ByAnyChar
+// and ByAsciiWhitespace delimiters and str_split_into().
+
+#ifndef TURBO_STRINGS_INTERNAL_CHARSET_SCAN_H_
+#define TURBO_STRINGS_INTERNAL_CHARSET_SCAN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include <turbo/base/config.h>
+#include <turbo/container/span.h>
+#include <turbo/strings/charset.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+namespace strings_internal {
+
+// A CharSet laid out for a shuffle instruction (pshufb, tbl) to test 16 or
+// 32 bytes at a time: `c` is in the set when
+//
+//   low_table()[c & 0xf] & high_table()[c >> 4]
+//
+// is not zero. Each bit stands for a class of high nibbles which go with the
+// same low nibbles, so that this is exact for sets with at most 8 such
+// classes, which covers delimiters and the usual character classes. Larger
+// sets are matched a byte at a time.
+class CharSetMatcher {
+ public:
+  explicit CharSetMatcher(const CharSet& set);
+
+  bool contains(char c) const { return set_.contains(c); }
+  bool empty() const { return empty_; }
+
+  // Whether the tables hold the set exactly.
+  bool vectorized() const { return vectorized_; }
+  const uint8_t* low_table() const { return low_; }
+  const uint8_t* high_table() const { return high_; }
+
+ private:
+  CharSet set_;
+  uint8_t low_[16] = {};
+  uint8_t high_[16] = {};
+  bool vectorized_ = true;
+  bool empty_ = true;
+};
+
+// Returns the position of the first byte of `text` at or after `pos` which
+// is in `matcher`, or std::string_view::npos.
+size_t FindFirstOf(const CharSetMatcher& matcher, std::string_view text,
+                   size_t pos);
+
+// Split `text` at each `delimiter`, or each byte of `delimiters`, into
+// `out`, and return the number of pieces. If there are more than `out`
+// holds, the last one is the rest of `text`. `out` must not be empty.
+size_t SplitByChar(std::string_view text, char delimiter,
+                   turbo::span<std::string_view> out);
+size_t SplitByCharSet(std::string_view text, const CharSetMatcher& delimiters,
+                      turbo::span<std::string_view> out);
+
+}  // namespace strings_internal
+TURBO_NAMESPACE_END
+}  // namespace turbo
+
+#endif  // TURBO_STRINGS_INTERNAL_CHARSET_SCAN_H_
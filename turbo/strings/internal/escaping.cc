@@ -21,6 +21,7 @@
 
 #include <turbo/base/endian.h>
 #include <turbo/base/internal/raw_logging.h>
+#include <turbo/strings/internal/escaping_simd.h>
 
 namespace turbo {
 TURBO_NAMESPACE_BEGIN
@@ -115,7 +116,11 @@ size_t Base64EscapeInternal(const unsigned char* src, size_t szsrc, char* dest,
   // output padding uses the '=' character.
 
   // Three bytes of data encodes to four characters of cyphertext.
-  // So we can pump through three-byte chunks atomically.
+  // So we can pump through three-byte chunks atomically, as many as the
+  // vector kernels take and then one at a time.
+  const size_t bulk = Base64EncodeBlocks(src, szsrc, dest, base64);
+  cur_src += bulk;
+  cur_dest += bulk / 3 * 4;
   if (szsrc >= 3) {                    // "limit_src - 3" is UB if szsrc < 3.
     while (cur_src < limit_src - 3) {  // While we have >= 32 bits.
       uint32_t in = turbo::big_endian::load32(cur_src) >> 8;
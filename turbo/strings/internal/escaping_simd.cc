@@ -0,0 +1,648 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/strings/internal/escaping_simd.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include <turbo/crypto/internal/cpu_detect.h>
+
+// As in charset_scan.cc, the x86 code is compiled for SSSE3 and AVX2
+// whatever the flags of the build and picked at runtime.
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define TURBO_ESCAPING_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(TURBO_INTERNAL_HAVE_ARM_NEON) && defined(__aarch64__) && defined(TURBO_IS_LITTLE_ENDIAN)
+#define TURBO_ESCAPING_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+namespace strings_internal {
+namespace {
+
+struct EscapingKernels {
+  size_t (*base64_encode)(const unsigned char* src, size_t n, char* dest,
+                          const char* alphabet);
+  size_t (*base64_decode)(const char* src, size_t n, char* dest,
+                          const char* alphabet);
+  size_t (*hex_encode)(const unsigned char* src, size_t n, char* dest);
+  size_t (*hex_decode)(const char* src, size_t n, char* dest);
+};
+
+// Base64 digits are told apart by their nibbles, the way CharSetMatcher
+// does it: `c` is a letter or a decimal digit when
+//
+//   kAlnumLow[c & 0xf] & kAlnumHigh[c >> 4]
+//
+// is not zero, with a bit for the digits (high nibble 3), one for the
+// letters with high nibble 4 or 6 (low nibble 1 to f) and one for those
+// with 5 or 7 (0 to a). Adding kAlnumShift[c >> 4] then gives its value.
+// The last two characters of the alphabet are compared for directly, as
+// they differ between the alphabets.
+alignas(16) constexpr uint8_t kAlnumLow[16] = {5, 7, 7, 7, 7, 7, 7, 7,
+                                               7, 7, 6, 2, 2, 2, 2, 2};
+alignas(16) constexpr uint8_t kAlnumHigh[16] = {0, 0, 0, 1, 2, 4, 2, 4,
+                                                0, 0, 0, 0, 0, 0, 0, 0};
+alignas(16) constexpr int8_t kAlnumShift[16] = {
+    0, 0, 0, 52 - '0', -'A', -'A', 26 - 'a', 26 - 'a', 0, 0, 0, 0, 0, 0, 0, 0};
+
+alignas(16) constexpr char kHexDigits[16] = {'0', '1', '2', '3', '4', '5',
+                                             '6', '7', '8', '9', 'a', 'b',
+                                             'c', 'd', 'e', 'f'};
+
+namespace scalar {
+
+// Everything is left to the loops of the callers.
+size_t EncodeBase64(const unsigned char*, size_t, char*, const char*) {
+  return 0;
+}
+size_t DecodeBase64(const char*, size_t, char*, const char*) { return 0; }
+size_t EncodeHex(const unsigned char*, size_t, char*) { return 0; }
+size_t DecodeHex(const char*, size_t, char*) { return 0; }
+
+constexpr EscapingKernels kKernels = {EncodeBase64, DecodeBase64, EncodeHex,
+                                      DecodeHex};
+
+}  // namespace scalar
+
+#if defined(TURBO_ESCAPING_SIMD_X86)
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("ssse3"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("ssse3")
+#endif
+
+namespace ssse3 {
+
+inline __m128i Load(const void* p) {
+  return _mm_loadu_si128(static_cast<const __m128i*>(p));
+}
+
+// Spreads 12 bytes, in the low three quarters of `in`, to 16 values of 6
+// bits, as in Wojciech Muła and Daniel Lemire, "Faster Base64 Encoding and
+// Decoding Using AVX2 Instructions" (ACM TOW 2018).
+inline __m128i SplitSextets(__m128i in) {
+  in = _mm_shuffle_epi8(
+      in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+  const __m128i ac = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)),
+                                     _mm_set1_epi32(0x04000040));
+  const __m128i bd = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)),
+                                     _mm_set1_epi32(0x01000010));
+  return _mm_or_si128(ac, bd);
+}
+
+// The inverse of SplitSextets(), leaving 12 bytes in the low three quarters.
+inline __m128i JoinSextets(__m128i values) {
+  const __m128i pairs =
+      _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+  const __m128i triples = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+  return _mm_shuffle_epi8(triples, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8,
+                                                 14, 13, 12, -1, -1, -1, -1));
+}
+
+// The characters are the values plus an offset which only depends on their
+// range: 0-25, 26-51, 52-61, 62 and 63.
+class Base64Alphabet {
+ public:
+  explicit Base64Alphabet(const char* alphabet)
+      : offsets_(_mm_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            static_cast<char>(alphabet[62] - 62),
+            static_cast<char>(alphabet[63] - 63), 'A', 0, 0)),
+        c62_(_mm_set1_epi8(alphabet[62])),
+        c63_(_mm_set1_epi8(alphabet[63])) {}
+
+  __m128i Encode(__m128i values) const {
+    __m128i range = _mm_subs_epu8(values, _mm_set1_epi8(51));
+    range = _mm_or_si128(
+        range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), values),
+                             _mm_set1_epi8(13)));
+    return _mm_add_epi8(_mm_shuffle_epi8(offsets_, range), values);
+  }
+
+  // Returns false if a byte of `chars` is not in the alphabet.
+  bool Decode(__m128i chars, __m128i* values) const {
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    const __m128i high = _mm_and_si128(_mm_srli_epi16(chars, 4), nibble);
+    const __m128i alnum = _mm_and_si128(
+        _mm_shuffle_epi8(Load(kAlnumLow), _mm_and_si128(chars, nibble)),
+        _mm_shuffle_epi8(Load(kAlnumHigh), high));
+    const __m128i is62 = _mm_cmpeq_epi8(chars, c62_);
+    const __m128i is63 = _mm_cmpeq_epi8(chars, c63_);
+    const __m128i last = _mm_or_si128(is62, is63);
+    const __m128i invalid =
+        _mm_andnot_si128(last, _mm_cmpeq_epi8(alnum, _mm_setzero_si128()));
+    if (_mm_movemask_epi8(invalid) != 0) return false;
+    const __m128i shifted =
+        _mm_add_epi8(chars, _mm_shuffle_epi8(Load(kAlnumShift), high));
+    *values = _mm_or_si128(
+        _mm_andnot_si128(last, shifted),
+        _mm_or_si128(_mm_and_si128(is62, _mm_set1_epi8(62)),
+                     _mm_and_si128(is63, _mm_set1_epi8(63))));
+    return true;
+  }
+
+ private:
+  __m128i offsets_;
+  __m128i c62_;
+  __m128i c63_;
+};
+
+class Base64EncodeBlock {
+ public:
+  static constexpr size_t kInput = 12;
+  static constexpr size_t kLoad = 16;
+
+  explicit Base64EncodeBlock(const char* alphabet) : alphabet_(alphabet) {}
+
+  void operator()(const unsigned char* src, char* dest) const {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                     alphabet_.Encode(SplitSextets(Load(src))));
+  }
+
+ private:
+  Base64Alphabet alphabet_;
+};
+
+class Base64DecodeBlock {
+ public:
+  static constexpr size_t kInput = 16;
+
+  explicit Base64DecodeBlock(const char* alphabet) : alphabet_(alphabet) {}
+
+  bool operator()(const char* src, char* dest) const {
+    __m128i values;
+    if (!alphabet_.Decode(Load(src), &values)) return false;
+    const __m128i bytes = JoinSextets(values);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dest), bytes);
+    const uint32_t tail =
+        static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(bytes, 8)));
+    std::memcpy(dest + 8, &tail, sizeof(tail));
+    return true;
+  }
+
+ private:
+  Base64Alphabet alphabet_;
+};
+
+// The values of 16 hex digits, or false if some are not.
+inline bool HexValues(__m128i chars, __m128i* values) {
+  const __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+  const __m128i letter = _mm_sub_epi8(
+      _mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+  const __m128i is_digit =
+      _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+  const __m128i is_letter =
+      _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+  if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) != 0xffff) {
+    return false;
+  }
+  *values = _mm_or_si128(
+      _mm_and_si128(is_digit, digit),
+      _mm_andnot_si128(is_digit, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+  return true;
+}
+
+class HexEncodeBlock {
+ public:
+  static constexpr size_t kInput = 16;
+
+  void operator()(const unsigned char* src, char* dest) const {
+    const __m128i digits = Load(kHexDigits);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    const __m128i v = Load(src);
+    const __m128i high =
+        _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+    const __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(v, nibble));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                     _mm_unpacklo_epi8(high, low));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 16),
+                     _mm_unpackhi_epi8(high, low));
+  }
+};
+
+class HexDecodeBlock {
+ public:
+  static constexpr size_t kInput = 32;
+
+  bool operator()(const char* src, char* dest) const {
+    __m128i a, b;
+    if (!HexValues(Load(src), &a) || !HexValues(Load(src + 16), &b)) {
+      return false;
+    }
+    const __m128i pairs = _mm_set1_epi16(0x0110);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                     _mm_packus_epi16(_mm_maddubs_epi16(a, pairs),
+                                      _mm_maddubs_epi16(b, pairs)));
+    return true;
+  }
+};
+
+#include "turbo/strings/internal/escaping_simd.inc"
+
+}  // namespace ssse3
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace avx2 {
+
+inline __m256i Load(const void* p) {
+  return _mm256_loadu_si256(static_cast<const __m256i*>(p));
+}
+
+// A 16-byte table in both lanes.
+inline __m256i Table(const void* p) {
+  return _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(static_cast<const __m128i*>(p)));
+}
+
+// The ssse3 ones on each lane.
+inline __m256i SplitSextets(__m256i in) {
+  in = _mm256_shuffle_epi8(
+      in, _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                           1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+  const __m256i ac =
+      _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)),
+                         _mm256_set1_epi32(0x04000040));
+  const __m256i bd =
+      _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)),
+                         _mm256_set1_epi32(0x01000010));
+  return _mm256_or_si256(ac, bd);
+}
+
+inline __m256i JoinSextets(__m256i values) {
+  const __m256i pairs =
+      _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+  const __m256i triples =
+      _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+  return _mm256_shuffle_epi8(
+      triples,
+      _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                       2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+class Base64Alphabet {
+ public:
+  explicit Base64Alphabet(const char* alphabet)
+      : offsets_(_mm256_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            static_cast<char>(alphabet[62] - 62),
+            static_cast<char>(alphabet[63] - 63), 'A', 0, 0, 'a' - 26,
+            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            static_cast<char>(alphabet[62] - 62),
+            static_cast<char>(alphabet[63] - 63), 'A', 0, 0)),
+        c62_(_mm256_set1_epi8(alphabet[62])),
+        c63_(_mm256_set1_epi8(alphabet[63])) {}
+
+  __m256i Encode(__m256i values) const {
+    __m256i range = _mm256_subs_epu8(values, _mm256_set1_epi8(51));
+    range = _mm256_or_si256(
+        range, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), values),
+                                _mm256_set1_epi8(13)));
+    return _mm256_add_epi8(_mm256_shuffle_epi8(offsets_, range), values);
+  }
+
+  bool Decode(__m256i chars, __m256i* values) const {
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const __m256i high = _mm256_and_si256(_mm256_srli_epi16(chars, 4), nibble);
+    const __m256i alnum = _mm256_and_si256(
+        _mm256_shuffle_epi8(Table(kAlnumLow), _mm256_and_si256(chars, nibble)),
+        _mm256_shuffle_epi8(Table(kAlnumHigh), high));
+    const __m256i is62 = _mm256_cmpeq_epi8(chars, c62_);
+    const __m256i is63 = _mm256_cmpeq_epi8(chars, c63_);
+    const __m256i last = _mm256_or_si256(is62, is63);
+    const __m256i invalid = _mm256_andnot_si256(
+        last, _mm256_cmpeq_epi8(alnum, _mm256_setzero_si256()));
+    if (_mm256_movemask_epi8(invalid) != 0) return false;
+    const __m256i shifted =
+        _mm256_add_epi8(chars, _mm256_shuffle_epi8(Table(kAlnumShift), high));
+    *values = _mm256_or_si256(
+        _mm256_andnot_si256(last, shifted),
+        _mm256_or_si256(_mm256_and_si256(is62, _mm256_set1_epi8(62)),
+                        _mm256_and_si256(is63, _mm256_set1_epi8(63))));
+    return true;
+  }
+
+ private:
+  __m256i offsets_;
+  __m256i c62_;
+  __m256i c63_;
+};
+
+class Base64EncodeBlock {
+ public:
+  static constexpr size_t kInput = 24;
+  static constexpr size_t kLoad = 28;
+
+  explicit Base64EncodeBlock(const char* alphabet) : alphabet_(alphabet) {}
+
+  void operator()(const unsigned char* src, char* dest) const {
+    // 12 bytes to a lane.
+    const __m256i in = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(src))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12)), 1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest),
+                        alphabet_.Encode(SplitSextets(in)));
+  }
+
+ private:
+  Base64Alphabet alphabet_;
+};
+
+class Base64DecodeBlock {
+ public:
+  static constexpr size_t kInput = 32;
+
+  explicit Base64DecodeBlock(const char* alphabet) : alphabet_(alphabet) {}
+
+  bool operator()(const char* src, char* dest) const {
+    __m256i values;
+    if (!alphabet_.Decode(Load(src), &values)) return false;
+    // The 12 bytes of each lane, next to each other.
+    const __m256i bytes = _mm256_permutevar8x32_epi32(
+        JoinSextets(values), _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                     _mm256_castsi256_si128(bytes));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dest + 16),
+                     _mm256_extracti128_si256(bytes, 1));
+    return true;
+  }
+
+ private:
+  Base64Alphabet alphabet_;
+};
+
+inline bool HexValues(__m256i chars, __m256i* values) {
+  const __m256i digit = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+  const __m256i letter = _mm256_sub_epi8(
+      _mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+  const __m256i is_digit =
+      _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+  const __m256i is_letter =
+      _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+  if (_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_letter)) != -1) {
+    return false;
+  }
+  *values = _mm256_or_si256(
+      _mm256_and_si256(is_digit, digit),
+      _mm256_andnot_si256(is_digit,
+                          _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+  return true;
+}
+
+class HexEncodeBlock {
+ public:
+  static constexpr size_t kInput = 32;
+
+  void operator()(const unsigned char* src, char* dest) const {
+    const __m256i digits = Table(kHexDigits);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const __m256i v = Load(src);
+    const __m256i high = _mm256_shuffle_epi8(
+        digits, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+    const __m256i low =
+        _mm256_shuffle_epi8(digits, _mm256_and_si256(v, nibble));
+    // Bytes 0-7 and 16-23, then 8-15 and 24-31.
+    const __m256i first = _mm256_unpacklo_epi8(high, low);
+    const __m256i second = _mm256_unpackhi_epi8(high, low);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest),
+                        _mm256_permute2x128_si256(first, second, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + 32),
+                        _mm256_permute2x128_si256(first, second, 0x31));
+  }
+};
+
+class HexDecodeBlock {
+ public:
+  static constexpr size_t kInput = 64;
+
+  bool operator()(const char* src, char* dest) const {
+    __m256i a, b;
+    if (!HexValues(Load(src), &a) || !HexValues(Load(src + 32), &b)) {
+      return false;
+    }
+    const __m256i pairs = _mm256_set1_epi16(0x0110);
+    // packus works on each lane, which interleaves the quarters of a and b.
+    const __m256i bytes = _mm256_packus_epi16(_mm256_maddubs_epi16(a, pairs),
+                                              _mm256_maddubs_epi16(b, pairs));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest),
+                        _mm256_permute4x64_epi64(bytes, 0xd8));
+    return true;
+  }
+};
+
+#include "turbo/strings/internal/escaping_simd.inc"
+
+}  // namespace avx2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#elif defined(TURBO_ESCAPING_SIMD_NEON)
+
+namespace neon {
+
+// The values of the characters in `chars`, accumulating in `*valid` the
+// lanes which are in the alphabet.
+class Base64Alphabet {
+ public:
+  explicit Base64Alphabet(const char* alphabet)
+      : c62_(vdupq_n_u8(static_cast<uint8_t>(alphabet[62]))),
+        c63_(vdupq_n_u8(static_cast<uint8_t>(alphabet[63]))) {}
+
+  uint8x16_t Decode(uint8x16_t chars, uint8x16_t* valid) const {
+    const uint8x16_t high = vshrq_n_u8(chars, 4);
+    const uint8x16_t alnum =
+        vtstq_u8(vqtbl1q_u8(vld1q_u8(kAlnumLow), vandq_u8(chars, vdupq_n_u8(0x0f))),
+                 vqtbl1q_u8(vld1q_u8(kAlnumHigh), high));
+    const uint8x16_t is62 = vceqq_u8(chars, c62_);
+    const uint8x16_t is63 = vceqq_u8(chars, c63_);
+    *valid = vandq_u8(*valid, vorrq_u8(alnum, vorrq_u8(is62, is63)));
+    uint8x16_t values = vaddq_u8(
+        chars, vqtbl1q_u8(vreinterpretq_u8_s8(vld1q_s8(kAlnumShift)), high));
+    values = vbslq_u8(is62, vdupq_n_u8(62), values);
+    return vbslq_u8(is63, vdupq_n_u8(63), values);
+  }
+
+ private:
+  uint8x16_t c62_;
+  uint8x16_t c63_;
+};
+
+class Base64EncodeBlock {
+ public:
+  static constexpr size_t kInput = 48;
+  static constexpr size_t kLoad = 48;
+
+  explicit Base64EncodeBlock(const char* alphabet) {
+    const uint8_t* chars = reinterpret_cast<const uint8_t*>(alphabet);
+    table_ = {{vld1q_u8(chars), vld1q_u8(chars + 16), vld1q_u8(chars + 32),
+               vld1q_u8(chars + 48)}};
+  }
+
+  void operator()(const unsigned char* src, char* dest) const {
+    // Byte i of each of the 16 groups of three in in.val[i].
+    const uint8x16x3_t in = vld3q_u8(src);
+    const uint8x16_t mask = vdupq_n_u8(0x3f);
+    uint8x16x4_t out;
+    out.val[0] = vshrq_n_u8(in.val[0], 2);
+    out.val[1] = vandq_u8(
+        vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask);
+    out.val[2] = vandq_u8(
+        vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask);
+    out.val[3] = vandq_u8(in.val[2], mask);
+    for (int i = 0; i < 4; ++i) out.val[i] = vqtbl4q_u8(table_, out.val[i]);
+    vst4q_u8(reinterpret_cast<uint8_t*>(dest), out);
+  }
+
+ private:
+  uint8x16x4_t table_;
+};
+
+class Base64DecodeBlock {
+ public:
+  static constexpr size_t kInput = 64;
+
+  explicit Base64DecodeBlock(const char* alphabet) : alphabet_(alphabet) {}
+
+  bool operator()(const char* src, char* dest) const {
+    // Character i of each of the 16 groups of four in in.val[i].
+    uint8x16x4_t in = vld4q_u8(reinterpret_cast<const uint8_t*>(src));
+    uint8x16_t valid = vdupq_n_u8(0xff);
+    for (int i = 0; i < 4; ++i) {
+      in.val[i] = alphabet_.Decode(in.val[i], &valid);
+    }
+    if (vminvq_u8(valid) == 0) return false;
+    uint8x16x3_t out;
+    out.val[0] = vorrq_u8(vshlq_n_u8(in.val[0], 2), vshrq_n_u8(in.val[1], 4));
+    out.val[1] = vorrq_u8(vshlq_n_u8(in.val[1], 4), vshrq_n_u8(in.val[2], 2));
+    out.val[2] = vorrq_u8(vshlq_n_u8(in.val[2], 6), in.val[3]);
+    vst3q_u8(reinterpret_cast<uint8_t*>(dest), out);
+    return true;
+  }
+
+ private:
+  Base64Alphabet alphabet_;
+};
+
+// The values of 16 hex digits, accumulating in `*valid` the lanes which are.
+inline uint8x16_t HexValues(uint8x16_t chars, uint8x16_t* valid) {
+  const uint8x16_t digit = vsubq_u8(chars, vdupq_n_u8('0'));
+  const uint8x16_t letter =
+      vsubq_u8(vorrq_u8(chars, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+  const uint8x16_t is_digit = vcltq_u8(digit, vdupq_n_u8(10));
+  const uint8x16_t is_letter = vcltq_u8(letter, vdupq_n_u8(6));
+  *valid = vandq_u8(*valid, vorrq_u8(is_digit, is_letter));
+  return vbslq_u8(is_digit, digit, vaddq_u8(letter, vdupq_n_u8(10)));
+}
+
+class HexEncodeBlock {
+ public:
+  static constexpr size_t kInput = 16;
+
+  void operator()(const unsigned char* src, char* dest) const {
+    const uint8x16_t digits =
+        vld1q_u8(reinterpret_cast<const uint8_t*>(kHexDigits));
+    const uint8x16_t v = vld1q_u8(src);
+    uint8x16x2_t out;
+    out.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(v, 4));
+    out.val[1] = vqtbl1q_u8(digits, vandq_u8(v, vdupq_n_u8(0x0f)));
+    vst2q_u8(reinterpret_cast<uint8_t*>(dest), out);
+  }
+};
+
+class HexDecodeBlock {
+ public:
+  static constexpr size_t kInput = 32;
+
+  bool operator()(const char* src, char* dest) const {
+    const uint8x16x2_t in = vld2q_u8(reinterpret_cast<const uint8_t*>(src));
+    uint8x16_t valid = vdupq_n_u8(0xff);
+    const uint8x16_t high = HexValues(in.val[0], &valid);
+    const uint8x16_t low = HexValues(in.val[1], &valid);
+    if (vminvq_u8(valid) == 0) return false;
+    vst1q_u8(reinterpret_cast<uint8_t*>(dest),
+             vorrq_u8(vshlq_n_u8(high, 4), low));
+    return true;
+  }
+};
+
+#include "turbo/strings/internal/escaping_simd.inc"
+
+}  // namespace neon
+
+#endif
+
+const EscapingKernels& Kernels() {
+  static const EscapingKernels* const kernels = [] {
+#if defined(TURBO_ESCAPING_SIMD_X86)
+    if (crc_internal::SupportsX86AVX2()) return &avx2::kKernels;
+    if (crc_internal::SupportsX86SSSE3()) return &ssse3::kKernels;
+#elif defined(TURBO_ESCAPING_SIMD_NEON)
+    return &neon::kKernels;
+#endif
+    return &scalar::kKernels;
+  }();
+  return *kernels;
+}
+
+}  // namespace
+
+size_t Base64EncodeBlocks(const unsigned char* src, size_t n, char* dest,
+                          const char* alphabet) {
+  return Kernels().base64_encode(src, n, dest, alphabet);
+}
+
+size_t Base64DecodeBlocks(const char* src, size_t n, char* dest,
+                          const char* alphabet) {
+  return Kernels().base64_decode(src, n, dest, alphabet);
+}
+
+size_t HexEncodeBlocks(const unsigned char* src, size_t n, char* dest) {
+  return Kernels().hex_encode(src, n, dest);
+}
+
+size_t HexDecodeBlocks(const char* src, size_t n, char* dest) {
+  return Kernels().hex_decode(src, n, dest);
+}
+
+}  // namespace strings_internal
+TURBO_NAMESPACE_END
+}  // namespace turbo
@@ -0,0 +1,58 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+// Vector kernels for the bulk of Base64 and hex encoding and decoding in
+// escaping.cc, picked at runtime. Each handles the leading whole blocks of
+// its input and leaves the rest, which is everything on CPUs without a
+// kernel, to the scalar loops of the caller.
+
+#ifndef TURBO_STRINGS_INTERNAL_ESCAPING_SIMD_H_
+#define TURBO_STRINGS_INTERNAL_ESCAPING_SIMD_H_
+
+#include <cstddef>
+
+#include <turbo/base/config.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+namespace strings_internal {
+
+// Encodes groups of 3 bytes of `src` with the 64 characters of `alphabet`
+// and returns the number of bytes consumed, a multiple of 3. `dest`
+// receives 4 characters a group.
+size_t Base64EncodeBlocks(const unsigned char* src, size_t n, char* dest,
+                          const char* alphabet);
+
+// Decodes groups of 4 characters of `alphabet` until a block holding any
+// other byte (whitespace, padding or garbage) and returns the number of
+// characters consumed, a multiple of 4. `dest` receives 3 bytes a group.
+size_t Base64DecodeBlocks(const char* src, size_t n, char* dest,
+                          const char* alphabet);
+
+// Writes two lowercase hex digits a byte of `src` and returns the number of
+// bytes consumed.
+size_t HexEncodeBlocks(const unsigned char* src, size_t n, char* dest);
+
+// Decodes pairs of hex digits until a block holding any other byte and
+// returns the number of characters consumed, an even number.
+size_t HexDecodeBlocks(const char* src, size_t n, char* dest);
+
+}  // namespace strings_internal
+TURBO_NAMESPACE_END
+}  // namespace turbo
+
+#endif  // TURBO_STRINGS_INTERNAL_ESCAPING_SIMD_H_
@@ -0,0 +1,53 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TURBO_STRINGS_INTERNAL_SHORTEST_DECIMAL_H_
+#define TURBO_STRINGS_INTERNAL_SHORTEST_DECIMAL_H_
+
+#include <cstdint>
+
+#include <turbo/base/config.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+namespace strings_internal {
+
+// The shortest decimal `digits * 10^exponent` which reads back as a given
+// binary floating point number, computed as in Ulf Adams, "Ryu: Fast
+// Float-to-String Conversion" (PLDI 2018). Among the shortest, the one
+// closest to the number is picked, and ties go to the even one.
+//
+// `digits` has no trailing zeros, and is 0 only for zero.
+struct ShortestDecimal {
+  uint64_t digits = 0;
+  int exponent = 0;
+  // The number of decimal digits of `digits`, at least 1.
+  int num_digits = 1;
+};
+
+// These take the absolute value of finite numbers; the sign, infinities and
+// NaNs are left to the caller.
+ShortestDecimal ShortestDecimalFromDouble(double value);
+ShortestDecimal ShortestDecimalFromFloat(float value);
+// `bits` is an IEEE binary16 number.
+ShortestDecimal ShortestDecimalFromFloat16(uint16_t bits);
+
+}  // namespace strings_internal
+TURBO_NAMESPACE_END
+}  // namespace turbo
+
+#endif  // TURBO_STRINGS_INTERNAL_SHORTEST_DECIMAL_H_
@@ -143,7 +143,10 @@ class ConverterConsumer {
 template <typename Converter>
 bool ConvertAll(const UntypedFormatSpecImpl format,
                 turbo::span<const FormatArgImpl> args, Converter converter) {
-  if (format.has_parsed_conversion()) {
+  if (format.has_compiled_format()) {
+    return format.compiled_format()->ProcessFormat(
+        ConverterConsumer<Converter>(converter, args));
+  } else if (format.has_parsed_conversion()) {
     return format.parsed_conversion()->ProcessFormat(
         ConverterConsumer<Converter>(converter, args));
   } else {
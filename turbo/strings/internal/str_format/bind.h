@@ -27,6 +27,7 @@
 #include <turbo/container/inlined_vector.h>
 #include <turbo/strings/internal/str_format/arg.h>
 #include <turbo/strings/internal/str_format/checker.h>
+#include <turbo/strings/internal/str_format/compiled_format.h>
 #include <turbo/strings/internal/str_format/constexpr_parser.h>
 #include <turbo/strings/internal/str_format/extension.h>
 #include <turbo/strings/internal/str_format/parser.h>
@@ -63,10 +64,17 @@ namespace turbo {
                     const str_format_internal::ParsedFormatBase *pc)
                     : data_(pc), size_(~size_t{}) {}
 
+            explicit UntypedFormatSpecImpl(
+                    const str_format_internal::CompiledFormatView *cf)
+                    : data_(cf), size_(kCompiledFormatSize) {}
+
             bool has_parsed_conversion() const { return size_ == ~size_t{}; }
 
+            bool has_compiled_format() const { return size_ == kCompiledFormatSize; }
+
             std::string_view str() const {
                 assert(!has_parsed_conversion());
+                assert(!has_compiled_format());
                 return std::string_view(static_cast<const char *>(data_), size_);
             }
 
@@ -75,12 +83,19 @@ namespace turbo {
                 return static_cast<const str_format_internal::ParsedFormatBase *>(data_);
             }
 
+            const str_format_internal::CompiledFormatView *compiled_format() const {
+                assert(has_compiled_format());
+                return static_cast<const str_format_internal::CompiledFormatView *>(data_);
+            }
+
             template<typename T>
             static const UntypedFormatSpecImpl &Extract(const T &s) {
                 return s.spec_;
             }
 
         private:
+            static constexpr size_t kCompiledFormatSize = ~size_t{} - 1;
+
             const void *data_;
             size_t size_;
         };
@@ -181,6 +196,16 @@ namespace turbo {
                 CheckArity<sizeof...(C), sizeof...(Args)>();
                 CheckMatches<C...>(turbo::make_index_sequence<sizeof...(C)>{});
             }
+
+            // From `TURBO_FORMAT(format)`, checked against the arguments at compile
+            // time on every compiler.
+            template<typename Format>
+            FormatSpecTemplate(CompiledFormatLiteral<Format>)  // NOLINT
+                    : Base(&CompiledFormatLiteral<Format>::kView) {
+                static_assert(
+                        CompiledFormatMatches<Args...>(CompiledFormatLiteral<Format>::kCompiled),
+                        "Format specified does not match the arguments passed.");
+            }
         };
 
         class Streamable {
@@ -0,0 +1,201 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef TURBO_STRINGS_INTERNAL_STR_FORMAT_COMPILED_FORMAT_H_
+#define TURBO_STRINGS_INTERNAL_STR_FORMAT_COMPILED_FORMAT_H_
+
+#include <algorithm>
+#include <cstddef>
+
+#include <turbo/base/config.h>
+#include <turbo/base/const_init.h>
+#include <turbo/strings/internal/str_format/constexpr_parser.h>
+#include <turbo/strings/internal/str_format/extension.h>
+#include <turbo/strings/string_view.h>
+
+// Format strings lowered at compile time.
+//
+// `TURBO_STR_FORMAT_INTERNAL_COMPILE(format)` parses a format string literal
+// while compiling into the runs of literal text and the conversions between
+// them, so that formatting only walks the result instead of scanning the
+// string for '%' and decoding each conversion on every call.
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+namespace str_format_internal {
+
+struct CompiledFormatItem {
+  bool is_conversion = false;
+  // The item's text in the format string: the literal text, or the
+  // conversion without its leading '%'.
+  size_t text_begin = 0;
+  size_t text_end = 0;
+  UnboundConversion conv{turbo::kConstInit};
+};
+
+// An upper bound on the number of items of `format`: every '%' starts at most
+// one conversion or literal, and is followed by at most one literal.
+constexpr size_t CompiledFormatCapacity(std::string_view format) {
+  size_t percents = 0;
+  for (char c : format) percents += c == '%';
+  return 2 * percents + 1;
+}
+
+template <size_t N>
+struct CompiledFormat {
+  // False if the format is malformed, in which case it fails to format like
+  // any malformed format does.
+  bool valid = false;
+  size_t size = 0;
+  CompiledFormatItem items[N];
+};
+
+// Splits `format` the way `ParseFormatString()` does. Adjacent literals, such
+// as the text before a "%%" and its '%', are joined.
+template <size_t N>
+constexpr CompiledFormat<N> CompileFormat(std::string_view format) {
+  CompiledFormat<N> out;
+  const auto add_literal = [&out](size_t begin, size_t end) {
+    if (begin == end) return;
+    if (out.size > 0 && !out.items[out.size - 1].is_conversion &&
+        out.items[out.size - 1].text_end == begin) {
+      out.items[out.size - 1].text_end = end;
+      return;
+    }
+    CompiledFormatItem& item = out.items[out.size++];
+    item.text_begin = begin;
+    item.text_end = end;
+  };
+  int next_arg = 0;
+  const char* const base = format.data();
+  const char* const end = base + format.size();
+  const char* p = base;
+  while (p != end) {
+    const char* percent = p;
+    while (percent != end && *percent != '%') ++percent;
+    add_literal(static_cast<size_t>(p - base),
+                static_cast<size_t>(percent - base));
+    if (percent == end) break;
+    if (percent + 1 == end) return out;
+    if (percent[1] == '%') {
+      add_literal(static_cast<size_t>(percent - base),
+                  static_cast<size_t>(percent + 1 - base));
+      p = percent + 2;
+      continue;
+    }
+    CompiledFormatItem& item = out.items[out.size];
+    p = ConsumeUnboundConversion(percent + 1, end, &item.conv, &next_arg);
+    if (p == nullptr) return out;
+    item.is_conversion = true;
+    item.text_begin = static_cast<size_t>(percent + 1 - base);
+    item.text_end = static_cast<size_t>(p - base);
+    ++out.size;
+  }
+  out.valid = true;
+  return out;
+}
+
+// Whether `format` accepts arguments of the conversions `C...` and uses all
+// of them, as `ValidFormatImpl()` checks for a format string.
+template <FormatConversionCharSet... C, size_t N>
+constexpr bool CompiledFormatMatches(const CompiledFormat<N>& format) {
+  if (!format.valid) return false;
+  constexpr FormatConversionCharSet
+      kAllowedConvs[(std::max)(sizeof...(C), size_t{1})] = {C...};
+  bool used[(std::max)(sizeof...(C), size_t{1})]{};
+  constexpr int kNumArgs = sizeof...(C);
+  for (size_t i = 0; i < format.size; ++i) {
+    const CompiledFormatItem& item = format.items[i];
+    if (!item.is_conversion) continue;
+    const UnboundConversion& conv = item.conv;
+    if (conv.arg_position <= 0 || conv.arg_position > kNumArgs) return false;
+    if (!Contains(kAllowedConvs[conv.arg_position - 1], conv.conv)) {
+      return false;
+    }
+    used[conv.arg_position - 1] = true;
+    for (auto extra : {conv.width, conv.precision}) {
+      if (extra.is_from_arg()) {
+        int pos = extra.get_from_arg();
+        if (pos <= 0 || pos > kNumArgs) return false;
+        used[pos - 1] = true;
+        if (!Contains(kAllowedConvs[pos - 1], '*')) return false;
+      }
+    }
+  }
+  if (sizeof...(C) != 0) {
+    for (bool b : used) {
+      if (!b) return false;
+    }
+  }
+  return true;
+}
+
+// The size-erased form of a valid `CompiledFormat`, which
+// `UntypedFormatSpecImpl` points to.
+struct CompiledFormatView {
+  const char* text;
+  const CompiledFormatItem* items;
+  size_t size;
+
+  template <typename Consumer>
+  bool ProcessFormat(Consumer consumer) const {
+    for (size_t i = 0; i < size; ++i) {
+      const CompiledFormatItem& item = items[i];
+      std::string_view item_text(text + item.text_begin,
+                                 item.text_end - item.text_begin);
+      if (item.is_conversion) {
+        if (!consumer.ConvertOne(item.conv, item_text)) return false;
+      } else {
+        if (!consumer.Append(item_text)) return false;
+      }
+    }
+    return true;
+  }
+};
+
+// The compiled form of the format string that `Format::value()` returns.
+// `FormatSpecTemplate` converts from it and checks it against the arguments.
+template <typename Format>
+struct CompiledFormatLiteral {
+  static constexpr std::string_view kFormat = Format::value();
+  static constexpr auto kCompiled =
+      CompileFormat<CompiledFormatCapacity(kFormat)>(kFormat);
+  static constexpr CompiledFormatView kView = {kFormat.data(), kCompiled.items,
+                                               kCompiled.size};
+
+  // nullptr if the format is malformed.
+  static constexpr const CompiledFormatView* view() {
+    return kCompiled.valid ? &kView : nullptr;
+  }
+  static constexpr std::string_view str() { return kFormat; }
+};
+
+}  // namespace str_format_internal
+TURBO_NAMESPACE_END
+}  // namespace turbo
+
+// Evaluates to a `CompiledFormatLiteral` for the string literal `format`.
+#define TURBO_STR_FORMAT_INTERNAL_COMPILE(format)                         \
+  ([] {                                                                   \
+    struct TurboCompiledFormatString {                                    \
+      static constexpr std::string_view value() { return format; }        \
+    };                                                                    \
+    return ::turbo::str_format_internal::CompiledFormatLiteral<           \
+        TurboCompiledFormatString>();                                     \
+  }())
+
+#endif  // TURBO_STRINGS_INTERNAL_STR_FORMAT_COMPILED_FORMAT_H_
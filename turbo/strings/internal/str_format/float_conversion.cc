@@ -33,6 +33,7 @@
 #include <turbo/numeric/bits.h>
 #include <turbo/numeric/int128.h>
 #include <turbo/numeric/internal/representation.h>
+#include <turbo/strings/internal/shortest_decimal.h>
 #include <turbo/strings/numbers.h>
 #include <optional>
 #include <turbo/container/span.h>
@@ -1341,6 +1342,45 @@ namespace turbo {
                 sink->Append(right_spaces, ' ');
             }
 
+            // Fills `out` with the first `precision + 1` significant digits of `v` as
+            // FloatToBuffer<FormatStyle::Precision> does, when the shortest digits
+            // which read back as `v` are not more: up to 15 digits, those are within
+            // half a unit of the last printed digit of `v`, hence its correct
+            // rounding. Much faster than the exact digits, for "%g" on everyday
+            // values.
+            template<typename Float>
+            bool ShortestToBuffer(Float, size_t, Buffer *, int *) {
+                return false;
+            }
+
+            bool ShortestToBuffer(double v, size_t precision, Buffer *out,
+                                  int *exp_out) {
+                // Below the normal range the unit in the last place is too large
+                // relative to `v` for the argument above.
+                if (precision + 1 > 15 || v < std::numeric_limits<double>::min()) {
+                    return false;
+                }
+                const strings_internal::ShortestDecimal shortest =
+                        strings_internal::ShortestDecimalFromDouble(v);
+                const size_t num_digits = static_cast<size_t>(shortest.num_digits);
+                if (num_digits > precision + 1) {
+                    return false;
+                }
+                char digits[20] = {};
+                uint64_t value = shortest.digits;
+                for (size_t i = num_digits; i-- > 0;) {
+                    digits[i] = static_cast<char>('0' + value % 10);
+                    value /= 10;
+                }
+                out->begin = out->end = out->data + 1 + kMaxFixedPrecision + 1;
+                out->push_back(digits[0]);
+                out->push_back('.');
+                for (size_t i = 1; i < num_digits; ++i) out->push_back(digits[i]);
+                for (size_t i = num_digits; i <= precision; ++i) out->push_back('0');
+                *exp_out = shortest.exponent + shortest.num_digits - 1;
+                return true;
+            }
+
             template<typename Float>
             bool FloatToSink(const Float v, const FormatConversionSpecImpl &conv,
                              FormatSinkImpl *sink) {
@@ -1390,7 +1430,8 @@ namespace turbo {
                 } else if (c == FormatConversionCharInternal::g ||
                            c == FormatConversionCharInternal::G) {
                     precision = std::max(precision, size_t{1}) - 1;
-                    if (!FloatToBuffer<FormatStyle::Precision>(decomposed, precision, &buffer,
+                    if (!ShortestToBuffer(abs_v, precision, &buffer, &exp) &&
+                        !FloatToBuffer<FormatStyle::Precision>(decomposed, precision, &buffer,
                                                                &exp)) {
                         return FallbackToSnprintf(v, conv, sink);
                     }
@@ -0,0 +1,104 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//
+// Decimal digits eight at a time in a 64-bit word ("SWAR"), for the integer
+// parsers of numbers.h and the mantissa of from_chars().
+
+#ifndef TURBO_STRINGS_INTERNAL_SWAR_DIGITS_H_
+#define TURBO_STRINGS_INTERNAL_SWAR_DIGITS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <turbo/base/config.h>
+#include <turbo/base/endian.h>
+#include <turbo/numeric/bits.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+namespace strings_internal {
+
+// Loads 8 characters with the first one in the low byte.
+inline uint64_t LoadEightChars(const char* p) {
+  return turbo::little_endian::load64(p);
+}
+
+// Returns a word with bits set in the bytes of `chunk` which are not ASCII
+// digits. A carry may also flag bytes after the first such one, so only the
+// lowest flag is reliable.
+inline uint64_t NonDigitMask(uint64_t chunk) {
+  const uint64_t x = chunk ^ 0x3030303030303030u;
+  // A digit leaves 0..9 in its byte, with a high nibble of zero, and adding 6
+  // keeps it so.
+  return (x | (x + 0x0606060606060606u)) & 0xf0f0f0f0f0f0f0f0u;
+}
+
+inline bool IsEightDigits(uint64_t chunk) { return NonDigitMask(chunk) == 0; }
+
+// The value of the 8 ASCII digits in `chunk`, the one in the low byte being
+// the most significant.
+inline uint32_t ParseEightDigits(uint64_t chunk) {
+  chunk -= 0x3030303030303030u;
+  // Pairs of digits, then quadruples, then all eight.
+  chunk = chunk * 10 + (chunk >> 8);
+  chunk = ((chunk & 0x000000ff000000ffu) * (100 + (uint64_t{1000000} << 32)) +
+           ((chunk >> 16) & 0x000000ff000000ffu) *
+               (1 + (uint64_t{10000} << 32))) >>
+          32;
+  return static_cast<uint32_t>(chunk);
+}
+
+// Parses the run of ASCII digits at the start of [begin, end) into `*value`
+// and returns its length. `*value` is exact if the run has at most 19
+// digits, which is as many as always fit in 64 bits.
+inline size_t ParseDigitRun(const char* begin, const char* end,
+                            uint64_t* value) {
+  static constexpr uint64_t kPow10[8] = {1,     10,     100,     1000,
+                                         10000, 100000, 1000000, 10000000};
+  const char* p = begin;
+  uint64_t v = 0;
+  while (end - p >= 8) {
+    uint64_t chunk = LoadEightChars(p);
+    const uint64_t non_digits = NonDigitMask(chunk);
+    if (non_digits != 0) {
+      const int n = turbo::countr_zero(non_digits) / 8;
+      if (n > 0) {
+        // Move the digits to the high bytes, behind leading zeros.
+        chunk = (chunk << (64 - 8 * n)) | (0x3030303030303030u >> (8 * n));
+        v = v * kPow10[n] + ParseEightDigits(chunk);
+        p += n;
+      }
+      *value = v;
+      return static_cast<size_t>(p - begin);
+    }
+    v = v * 100000000 + ParseEightDigits(chunk);
+    p += 8;
+  }
+  // Short tails are quicker a digit at a time than copied into a word.
+  while (p < end && static_cast<unsigned char>(*p - '0') < 10) {
+    v = v * 10 + static_cast<unsigned char>(*p - '0');
+    ++p;
+  }
+  *value = v;
+  return static_cast<size_t>(p - begin);
+}
+
+}  // namespace strings_internal
+TURBO_NAMESPACE_END
+}  // namespace turbo
+
+#endif  // TURBO_STRINGS_INTERNAL_SWAR_DIGITS_H_
@@ -22,6 +22,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <string_view>
 
 #include <turbo/base/config.h>
 
@@ -46,6 +47,15 @@ namespace strings_internal {
 enum { kMaxEncodedUTF8Size = 4 };
 size_t EncodeUTF8Char(char *buffer, char32_t utf8_char);
 
+// The name of the implementation behind the functions of turbo/strings/utf8.h:
+// "avx2", "ssse3", "neon" or "scalar".
+const char *Utf8Implementation();
+
+// Switches those functions to the implementation `name`, for tests and
+// benchmarks. Returns false, changing nothing, if this build or this CPU
+// cannot run it.
+bool SetUtf8Implementation(std::string_view name);
+
 }  // namespace strings_internal
 TURBO_NAMESPACE_END
 }  // namespace turbo
@@ -31,6 +31,7 @@
 #include <iterator>
 #include <limits>
 #include <system_error>  // NOLINT(build/c++11)
+#include <type_traits>
 #include <utility>
 
 #include <turbo/base/attributes.h>
@@ -43,6 +44,7 @@
 #include <turbo/numeric/int128.h>
 #include <turbo/strings/ascii.h>
 #include <turbo/strings/charconv.h>
+#include <turbo/strings/internal/swar_digits.h>
 #include <turbo/strings/match.h>
 #include <turbo/strings/string_view.h>
 
@@ -110,6 +112,137 @@ namespace turbo {
         return true;
     }
 
+    namespace {
+
+        // Skips the ASCII whitespace around a field of simple_atoi_into() or
+        // simple_atod_into(), other than the delimiter.
+        inline const char *SkipFieldSpace(const char *p, const char *end,
+                                          char delimiter) {
+            while (p < end && *p != delimiter &&
+                   turbo::ascii_isspace(static_cast<unsigned char>(*p))) {
+                ++p;
+            }
+            return p;
+        }
+
+        // Parses an int64_t at the start of [p, end), and returns the end of it,
+        // or nullptr if there is no integer there. A well-formed integer out of
+        // range sets `*ec`.
+        const char *ParseInt64Field(const char *p, const char *end, int64_t *value,
+                                    std::errc *ec) {
+            bool negative = false;
+            if (p < end && (*p == '-' || *p == '+')) {
+                negative = *p == '-';
+                ++p;
+            }
+            uint64_t magnitude;
+            const size_t length = strings_internal::ParseDigitRun(p, end, &magnitude);
+            if (length == 0) {
+                return nullptr;
+            }
+            const char *digits = p;
+            p += length;
+            if (length > 19) {
+                // Leading zeros aside, that is too many.
+                while (*digits == '0' && p - digits > 19) {
+                    ++digits;
+                }
+                if (p - digits > 19) {
+                    *ec = std::errc::result_out_of_range;
+                    return p;
+                }
+                strings_internal::ParseDigitRun(digits, p, &magnitude);
+            }
+            const uint64_t limit =
+                    static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) +
+                    (negative ? 1 : 0);
+            if (magnitude > limit) {
+                *ec = std::errc::result_out_of_range;
+                return p;
+            }
+            *value = negative ? static_cast<int64_t>(0 - magnitude)
+                              : static_cast<int64_t>(magnitude);
+            return p;
+        }
+
+        // Parses a double at the start of [p, end) as simple_atod() would.
+        const char *ParseDoubleField(const char *p, const char *end, double *value,
+                                     std::errc *) {
+            // from_chars() doesn't accept an initial '+', and "+-0" is invalid.
+            if (p < end && *p == '+') {
+                ++p;
+                if (p < end && *p == '-') {
+                    return nullptr;
+                }
+            }
+            const turbo::from_chars_result result = turbo::from_chars(p, end, *value);
+            if (result.ec == std::errc::invalid_argument) {
+                return nullptr;
+            }
+            if (result.ec == std::errc::result_out_of_range) {
+                if (*value > 1.0) {
+                    *value = std::numeric_limits<double>::infinity();
+                } else if (*value < -1.0) {
+                    *value = -std::numeric_limits<double>::infinity();
+                }
+            }
+            return result.ptr;
+        }
+
+        // The loop of simple_atoi_into() and simple_atod_into(): finds each
+        // field's delimiter right after the number `parse_field` parsed there.
+        template<typename T, typename ParseField>
+        simple_parse_result ParseFields(std::string_view text, char delimiter,
+                                        turbo::span<T> out, ParseField parse_field) {
+            const char *const begin = text.data();
+            const char *const end = begin + text.size();
+            simple_parse_result result = {0, text.size(), std::errc()};
+            if (SkipFieldSpace(begin, end, delimiter) == end) {
+                return result;
+            }
+            const char *p = begin;
+            for (;;) {
+                const char *const field = p;
+                if (result.count == out.size()) {
+                    result.pos = static_cast<size_t>(field - begin);
+                    return result;
+                }
+                std::errc ec = std::errc();
+                p = parse_field(SkipFieldSpace(p, end, delimiter), end,
+                                &out[result.count], &ec);
+                if (p != nullptr) {
+                    p = SkipFieldSpace(p, end, delimiter);
+                }
+                if (p == nullptr || (p != end && *p != delimiter)) {
+                    result.pos = static_cast<size_t>(field - begin);
+                    result.ec = std::errc::invalid_argument;
+                    return result;
+                }
+                if (ec != std::errc()) {
+                    result.pos = static_cast<size_t>(field - begin);
+                    result.ec = ec;
+                    return result;
+                }
+                ++result.count;
+                if (p == end) {
+                    return result;
+                }
+                ++p;
+            }
+        }
+
+    }  // namespace
+
+    simple_parse_result simple_atoi_into(std::string_view text, char delimiter,
+                                         turbo::span<int64_t> out) {
+        return ParseFields(text, delimiter, out, ParseInt64Field);
+    }
+
+    simple_parse_result simple_atod_into(std::string_view text, char delimiter,
+                                         turbo::span<double> out) {
+        return ParseFields(text, delimiter, out, ParseDoubleField);
+    }
+
     bool simple_atob(std::string_view str, turbo::Nonnull<bool *> out) {
         TURBO_RAW_CHECK(out != nullptr, "Output pointer must not be nullptr.");
         if (equals_ignore_case(str, "true") || equals_ignore_case(str, "t") ||
@@ -979,9 +1112,51 @@ namespace turbo {
 
 #undef X_OVER_BASE_INITIALIZER
 
+        // Parses decimal digits eight at a time, for the common case of a value
+        // of up to 19 digits which fits in IntType. Returns false otherwise, with
+        // `*value_p` untouched, for the digit loops below to handle.
+        template<typename IntType,
+                typename std::enable_if<(sizeof(IntType) <= 8), int>::type = 0>
+        inline bool safe_parse_decimal_int(std::string_view text, bool negative,
+                                           turbo::Nonnull<IntType *> value_p) {
+            uint64_t magnitude;
+            if (text.empty() || text.size() > 19 ||
+                strings_internal::ParseDigitRun(text.data(), text.data() + text.size(),
+                                                &magnitude) != text.size()) {
+                return false;
+            }
+            if (!negative) {
+                if (magnitude > static_cast<uint64_t>(std::numeric_limits<IntType>::max())) {
+                    return false;
+                }
+                *value_p = static_cast<IntType>(magnitude);
+                return true;
+            }
+            if (magnitude == 0) {
+                *value_p = 0;
+                return true;
+            }
+            // -(max + 1) is min, without overflowing on the way there.
+            if (magnitude - 1 > static_cast<uint64_t>(std::numeric_limits<IntType>::max())) {
+                return false;
+            }
+            *value_p = static_cast<IntType>(-static_cast<IntType>(magnitude - 1) - 1);
+            return true;
+        }
+
+        template<typename IntType,
+                typename std::enable_if<(sizeof(IntType) > 8), int>::type = 0>
+        inline bool safe_parse_decimal_int(std::string_view, bool,
+                                           turbo::Nonnull<IntType *>) {
+            return false;
+        }
+
         template<typename IntType>
         inline bool safe_parse_positive_int(std::string_view text, int base,
                                             turbo::Nonnull<IntType *> value_p) {
+            if (base == 10 && safe_parse_decimal_int(text, false, value_p)) {
+                return true;
+            }
             IntType value = 0;
             const IntType vmax = std::numeric_limits<IntType>::max();
             assert(vmax > 0);
@@ -1019,6 +1194,9 @@ namespace turbo {
         template<typename IntType>
         inline bool safe_parse_negative_int(std::string_view text, int base,
                                             turbo::Nonnull<IntType *> value_p) {
+            if (base == 10 && safe_parse_decimal_int(text, true, value_p)) {
+                return true;
+            }
             IntType value = 0;
             const IntType vmin = std::numeric_limits<IntType>::min();
             assert(vmin < 0);
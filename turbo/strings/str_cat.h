@@ -43,7 +43,8 @@
 // valid inputs. No output is generated for null `char *` pointers.
 //
 // Floating point numbers are formatted with six-digit precision, which is
-// the default for "std::cout <<" or printf "%g" (the same as "%.6g").
+// the default for "std::cout <<" or printf "%g" (the same as "%.6g"). Pass
+// `shortest_digits(x)` instead for the shortest digits which read back as `x`.
 //
 // You can convert to hexadecimal output rather than decimal output using the
 // `Hex` type contained here. To do so, pass `Hex(my_int)` as a parameter to
@@ -105,6 +106,7 @@
 #include <turbo/base/nullability.h>
 #include <turbo/base/port.h>
 #include <turbo/meta/type_traits.h>
+#include <turbo/strings/charconv.h>
 #include <turbo/strings/has_stringify.h>
 #include <turbo/strings/internal/resize_uninitialized.h>
 #include <turbo/strings/internal/stringify_sink.h>
@@ -123,6 +125,10 @@ namespace turbo {
             size_t size;
         };
 
+        // The longest output of turbo::to_chars(double) without a format, as
+        // "-2.2250738585072014e-308".
+        static constexpr size_t kShortestDigitsBufferSize = 24;
+
     }  // namespace strings_internal
 
     // Enum that specifies the number of significant digits to return in a `Hex` or
@@ -641,4 +647,30 @@ namespace turbo {
         return result;
     }
 
+    // Helper function for the shortest floating-point format which reads back
+    // exactly, as turbo::to_chars() writes it: `str_cat(shortest_digits(0.1))`
+    // is "0.1" and `str_cat(shortest_digits(1.0 / 3))` is
+    // "0.3333333333333333", where the default format gives "0.333333".
+    inline strings_internal::AlphaNumBuffer<
+            strings_internal::kShortestDigitsBufferSize>
+    shortest_digits(double d) {
+        strings_internal::AlphaNumBuffer<strings_internal::kShortestDigitsBufferSize>
+                result;
+        char *begin = &result.data[0];
+        result.size = static_cast<size_t>(
+                turbo::to_chars(begin, begin + result.data.size(), d).ptr - begin);
+        return result;
+    }
+
+    inline strings_internal::AlphaNumBuffer<
+            strings_internal::kShortestDigitsBufferSize>
+    shortest_digits(float f) {
+        strings_internal::AlphaNumBuffer<strings_internal::kShortestDigitsBufferSize>
+                result;
+        char *begin = &result.data[0];
+        result.size = static_cast<size_t>(
+                turbo::to_chars(begin, begin + result.data.size(), f).ptr - begin);
+        return result;
+    }
+
 }  // namespace turbo
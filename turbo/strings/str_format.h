@@ -57,6 +57,8 @@
 //     format string for a specific set of type(s), and which can be passed
 //     between API boundaries. (The `FormatSpec` type should not be used
 //     directly except as an argument type for wrapper functions.)
+//   * A `TURBO_FORMAT("...")` literal, which is parsed at compile time and
+//     can be passed wherever a `FormatSpec` is expected.
 //
 // The `str_format` library provides the ability to output its format strings to
 // arbitrary sink types:
@@ -85,6 +87,7 @@
 #include <turbo/strings/internal/str_format/arg.h>  // IWYU pragma: export
 #include <turbo/strings/internal/str_format/bind.h>  // IWYU pragma: export
 #include <turbo/strings/internal/str_format/checker.h>  // IWYU pragma: export
+#include <turbo/strings/internal/str_format/compiled_format.h>  // IWYU pragma: export
 #include <turbo/strings/internal/str_format/extension.h>  // IWYU pragma: export
 #include <turbo/strings/internal/str_format/parser.h>  // IWYU pragma: export
 #include <turbo/strings/string_view.h>
@@ -118,6 +121,10 @@ namespace turbo {
                 turbo::Nonnull<const str_format_internal::ParsedFormatBase *> pc)
                 : spec_(pc) {}
 
+        explicit UntypedFormatSpec(
+                turbo::Nonnull<const str_format_internal::CompiledFormatView *> cf)
+                : spec_(cf) {}
+
     private:
         friend str_format_internal::UntypedFormatSpecImpl;
         str_format_internal::UntypedFormatSpecImpl spec_;
@@ -341,6 +348,21 @@ namespace turbo {
         turbo::str_format_internal::ToFormatConversionCharSet(Conv)...>;
 #endif  // defined(__cpp_nontype_template_parameter_auto)
 
+// TURBO_FORMAT()
+//
+// Parses a format string literal at compile time into its runs of literal
+// text and its conversions, so that `str_format()`, `str_append_format()` and
+// the other entry points format it without scanning the string on each call.
+// The result converts to any `FormatSpec` whose arguments it accepts; a
+// mismatch fails to compile on every compiler. Unlike `ParsedFormat`, nothing
+// is built at runtime.
+//
+// Example:
+//
+//   // In a hot loop.
+//   turbo::str_append_format(&out, TURBO_FORMAT("%s=%d;"), key, value);
+#define TURBO_FORMAT(format) TURBO_STR_FORMAT_INTERNAL_COMPILE(format)
+
     // str_format()
     //
     // Returns a `string` given a `printf()`-style format string and zero or more
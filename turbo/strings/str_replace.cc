@@ -25,6 +25,7 @@
 
 #include <turbo/base/config.h>
 #include <turbo/base/nullability.h>
+#include <turbo/strings/cord.h>
 #include <turbo/strings/str_cat.h>
 #include <turbo/strings/string_view.h>
 
@@ -90,5 +91,95 @@ int str_replace_all(strings_internal::FixedMapping replacements,
   return str_replace_all<strings_internal::FixedMapping>(replacements, target);
 }
 
+StrReplacer::StrReplacer(strings_internal::FixedMapping replacements)
+    : replacements_(CopyReplacements(replacements)),
+      automaton_(Patterns(replacements_)) {}
+
+std::vector<std::string_view> StrReplacer::Patterns(
+    const Replacements& replacements) {
+  std::vector<std::string_view> patterns;
+  patterns.reserve(replacements.size());
+  for (const auto& rep : replacements) patterns.push_back(rep.first);
+  return patterns;
+}
+
+std::vector<strings_internal::AhoCorasick::Match> StrReplacer::FindAll(
+    std::string_view s) const {
+  std::vector<strings_internal::AhoCorasick::Match> matches;
+  strings_internal::AhoCorasick::State state;
+  automaton_.Scan(s, &state, &matches);
+  automaton_.Finish(&state, &matches);
+  return matches;
+}
+
+void StrReplacer::AppendReplaced(
+    std::string_view s,
+    const std::vector<strings_internal::AhoCorasick::Match>& matches,
+    turbo::Nonnull<std::string*> out) const {
+  size_t pos = 0;
+  for (const auto& match : matches) {
+    str_append(out, s.substr(pos, match.pos - pos),
+               replacements_[match.pattern].second);
+    pos = match.pos + automaton_.pattern_size(match.pattern);
+  }
+  out->append(s.data() + pos, s.size() - pos);
+}
+
+std::string StrReplacer::replace_all(std::string_view s) const {
+  const auto matches = FindAll(s);
+  std::string result;
+  result.reserve(s.size());
+  AppendReplaced(s, matches, &result);
+  return result;
+}
+
+int StrReplacer::replace_all(turbo::Nonnull<std::string*> target) const {
+  const auto matches = FindAll(*target);
+  if (matches.empty()) return 0;
+  std::string result;
+  result.reserve(target->size());
+  AppendReplaced(*target, matches, &result);
+  target->swap(result);
+  return static_cast<int>(matches.size());
+}
+
+std::vector<strings_internal::AhoCorasick::Match> StrReplacer::FindAll(
+    const turbo::Cord& cord) const {
+  std::vector<strings_internal::AhoCorasick::Match> matches;
+  strings_internal::AhoCorasick::State state;
+  for (std::string_view chunk : cord.chunks()) {
+    automaton_.Scan(chunk, &state, &matches);
+  }
+  automaton_.Finish(&state, &matches);
+  return matches;
+}
+
+turbo::Cord StrReplacer::Replaced(
+    const turbo::Cord& cord,
+    const std::vector<strings_internal::AhoCorasick::Match>& matches) const {
+  turbo::Cord result;
+  size_t pos = 0;
+  for (const auto& match : matches) {
+    result.append(cord.subcord(pos, match.pos - pos));
+    result.append(replacements_[match.pattern].second);
+    pos = match.pos + automaton_.pattern_size(match.pattern);
+  }
+  result.append(cord.subcord(pos, cord.size() - pos));
+  return result;
+}
+
+turbo::Cord StrReplacer::replace_all(const turbo::Cord& cord) const {
+  const auto matches = FindAll(cord);
+  if (matches.empty()) return cord;
+  return Replaced(cord, matches);
+}
+
+int StrReplacer::replace_all(turbo::Nonnull<turbo::Cord*> target) const {
+  const auto matches = FindAll(*target);
+  if (matches.empty()) return 0;
+  *target = Replaced(*target, matches);
+  return static_cast<int>(matches.size());
+}
+
 TURBO_NAMESPACE_END
 }  // namespace turbo
@@ -46,10 +46,13 @@
 
 #include <turbo/base/attributes.h>
 #include <turbo/base/nullability.h>
+#include <turbo/strings/internal/aho_corasick.h>
 #include <turbo/strings/string_view.h>
 
 namespace turbo {
 
+    class Cord;
+
     // str_replace_all()
     //
     // Replaces character sequences within a given string with replacements provided
@@ -133,6 +136,87 @@ namespace turbo {
     int str_replace_all(const StrToStrMapping &replacements,
                       turbo::Nonnull<std::string *> target);
 
+    // StrReplacer
+    //
+    // A set of replacements prepared once to be applied to many strings, with
+    // the same results as `str_replace_all()` as long as no pattern is given
+    // twice (see below). Where `str_replace_all()` searches
+    // for each pattern on its own, which costs the length of the text times the
+    // number of patterns, a `StrReplacer` finds all of them in a single pass over
+    // the text (see strings/internal/aho_corasick.h). Prefer it for more than a
+    // handful of patterns, or for replacements applied over and over.
+    //
+    // The patterns and replacements are copied, so the mapping need not outlive
+    // the `StrReplacer`. Of two equal patterns, the first one is always used,
+    // whereas `str_replace_all()` may pick either of them from one match to
+    // the next.
+    //
+    // Example:
+    //
+    //   static const turbo::StrReplacer* const kRedactor = new turbo::StrReplacer(
+    //       LoadRedactions());  // e.g. a std::vector of std::pair, or a map.
+    //   std::string clean = kRedactor->replace_all(user_input);
+    class StrReplacer {
+    public:
+        explicit StrReplacer(
+                std::initializer_list<std::pair<std::string_view, std::string_view>>
+                replacements);
+
+        template<typename StrToStrMapping>
+        explicit StrReplacer(const StrToStrMapping &replacements)
+                : replacements_(CopyReplacements(replacements)),
+                  automaton_(Patterns(replacements_)) {}
+
+        // Returns `s` with the replacements made.
+        TURBO_MUST_USE_RESULT std::string replace_all(std::string_view s) const;
+
+        // Makes the replacements in `*target`, and returns how many were made.
+        int replace_all(turbo::Nonnull<std::string *> target) const;
+
+        // The same for `Cord`s, which are scanned chunk by chunk. The text
+        // between the replacements is shared with `cord` rather than copied.
+        TURBO_MUST_USE_RESULT turbo::Cord replace_all(const turbo::Cord &cord) const;
+
+        int replace_all(turbo::Nonnull<turbo::Cord *> target) const;
+
+    private:
+        using Replacements = std::vector<std::pair<std::string, std::string>>;
+
+        template<typename StrToStrMapping>
+        static Replacements CopyReplacements(const StrToStrMapping &replacements) {
+            Replacements copy;
+            copy.reserve(replacements.size());
+            for (const auto &rep: replacements) {
+                using std::get;
+                copy.emplace_back(std::string_view(get<0>(rep)),
+                                  std::string_view(get<1>(rep)));
+            }
+            return copy;
+        }
+
+        static std::vector<std::string_view> Patterns(
+                const Replacements &replacements);
+
+        // Returns the matches in `s`.
+        std::vector<strings_internal::AhoCorasick::Match> FindAll(
+                std::string_view s) const;
+
+        std::vector<strings_internal::AhoCorasick::Match> FindAll(
+                const turbo::Cord &cord) const;
+
+        // Appends `s` with `matches` replaced to `*out`.
+        void AppendReplaced(std::string_view s,
+                            const std::vector<strings_internal::AhoCorasick::Match> &matches,
+                            turbo::Nonnull<std::string *> out) const;
+
+        turbo::Cord Replaced(
+                const turbo::Cord &cord,
+                const std::vector<strings_internal::AhoCorasick::Match> &matches) const;
+
+        Replacements replacements_;
+        strings_internal::AhoCorasick automaton_;
+    };
+
     // Implementation details only, past this point.
     namespace strings_internal {
 
@@ -24,6 +24,8 @@
 
 #include <turbo/base/config.h>
 #include <turbo/base/internal/raw_logging.h>
+#include <turbo/strings/charset.h>
+#include <turbo/strings/internal/charset_scan.h>
 #include <turbo/strings/string_view.h>
 
 namespace turbo {
@@ -31,11 +33,10 @@ namespace turbo {
     namespace {
 
         // This GenericFind() template function encapsulates the finding algorithm
-        // shared between the ByString and ByAnyChar delimiters. The FindPolicy
-        // template parameter allows each delimiter to customize the actual find
-        // function to use and the length of the found delimiter. For example, the
-        // Literal delimiter will ultimately use std::string_view::find(), and the
-        // AnyOf delimiter will use std::string_view::find_first_of().
+        // of the ByString delimiter. The FindPolicy template parameter allows to
+        // customize the actual find function to use and the length of the found
+        // delimiter. For example, the Literal delimiter will ultimately use
+        // std::string_view::find().
         template<typename FindPolicy>
         std::string_view GenericFind(std::string_view text,
                                        std::string_view delimiter, size_t pos,
@@ -69,16 +70,15 @@ namespace turbo {
             }
         };
 
-        // Finds using std::string_view::find_first_of(), therefore the length of the
-        // found delimiter is 1.
-        struct AnyOfPolicy {
-            static size_t Find(std::string_view text, std::string_view delimiter,
-                               size_t pos) {
-                return text.find_first_of(delimiter, pos);
-            }
-
-            static size_t Length(std::string_view /* delimiter */) { return 1; }
-        };
+        // Finds any byte of `matcher`, therefore the length of the found
+        // delimiter is 1.
+        std::string_view FindAnyOf(const strings_internal::CharSetMatcher &matcher,
+                                   std::string_view text, size_t pos) {
+            const size_t found_pos = strings_internal::FindFirstOf(matcher, text, pos);
+            if (found_pos == std::string_view::npos)
+                return std::string_view(text.data() + text.size(), 0);
+            return text.substr(found_pos, 1);
+        }
 
     }  // namespace
 
@@ -102,7 +102,8 @@ namespace turbo {
 
     std::string_view ByAsciiWhitespace::Find(std::string_view text,
                                                size_t pos) const {
-        return GenericFind(text, " \t\v\f\r\n", pos, AnyOfPolicy());
+        static const strings_internal::CharSetMatcher kWhitespace(CharSet::AsciiWhitespace());
+        return FindAnyOf(kWhitespace, text, pos);
     }
 
     //
@@ -120,10 +121,47 @@ namespace turbo {
     // ByAnyChar
     //
 
-    ByAnyChar::ByAnyChar(std::string_view sp) : delimiters_(sp) {}
+    ByAnyChar::ByAnyChar(std::string_view sp) : matcher_(CharSet(sp)) {}
+
+    ByAnyChar::ByAnyChar(const CharSet &delimiters) : matcher_(delimiters) {}
 
     std::string_view ByAnyChar::Find(std::string_view text, size_t pos) const {
-        return GenericFind(text, delimiters_, pos, AnyOfPolicy());
+        if (matcher_.empty()) {
+            // Like ByString(""): each character is a piece.
+            if (text.empty())
+                return std::string_view(text.data() + text.size(), 0);
+            return std::string_view(text.data() + pos + 1, 0);
+        }
+        return FindAnyOf(matcher_, text, pos);
+    }
+
+    //
+    // str_split_into
+    //
+
+    size_t str_split_into(std::string_view text, char delimiter, turbo::span<std::string_view> out) {
+        if (out.empty()) {
+            return 0;
+        }
+        return strings_internal::SplitByChar(text, delimiter, out);
+    }
+
+    size_t str_split_into(std::string_view text, const ByAnyChar &delimiters,
+                          turbo::span<std::string_view> out) {
+        if (out.empty()) {
+            return 0;
+        }
+        if (delimiters.matcher_.empty()) {
+            // As str_split(): each character is a piece.
+            size_t count = 0;
+            while (count + 1 < out.size() && count + 1 < text.size()) {
+                out[count] = text.substr(count, 1);
+                ++count;
+            }
+            out[count] = text.substr(count);
+            return count + 1;
+        }
+        return strings_internal::SplitByCharSet(text, delimiters.matcher_, out);
     }
 
     //
@@ -47,6 +47,9 @@
 
 #include <turbo/base/internal/raw_logging.h>
 #include <turbo/base/macros.h>
+#include <turbo/container/span.h>
+#include <turbo/strings/charset.h>
+#include <turbo/strings/internal/charset_scan.h>
 #include <turbo/strings/internal/str_split_internal.h>
 #include <turbo/strings/string_view.h>
 #include <turbo/strings/strip.h>
@@ -197,6 +200,14 @@ namespace turbo {
     //   std::vector<std::string> v = turbo::str_split("a,b=c", ByAnyChar(",="));
     //   // v[0] == "a", v[1] == "b", v[2] == "c"
     //
+    // The delimiters may also be given as a `turbo::CharSet`:
+    //
+    //   std::vector<std::string> v = turbo::str_split(
+    //       "a b\tc", ByAnyChar(turbo::CharSet::AsciiWhitespace()));
+    //
+    // The search tests 16 or 32 bytes of the input per instruction where the
+    // CPU allows, whatever the number of delimiters.
+    //
     // If `ByAnyChar` is given the empty string, it behaves exactly like
     // `ByString` and matches each individual character in the input string.
     //
@@ -204,10 +215,15 @@ namespace turbo {
     public:
         explicit ByAnyChar(std::string_view sp);
 
+        explicit ByAnyChar(const turbo::CharSet &delimiters);
+
         std::string_view Find(std::string_view text, size_t pos) const;
 
     private:
-        const std::string delimiters_;
+        friend size_t str_split_into(std::string_view text, const ByAnyChar &delimiters,
+                                     turbo::span<std::string_view> out);
+
+        strings_internal::CharSetMatcher matcher_;
     };
 
     // ByLength
@@ -393,6 +409,38 @@ namespace turbo {
         }
     };
 
+    //------------------------------------------------------------------------------
+    //                                  str_split_into()
+    //------------------------------------------------------------------------------
+
+    // str_split_into()
+    //
+    // Splits `text` at each `delimiter`, or at each of the `ByAnyChar`
+    // `delimiters`, into the string views of `out`, and returns the number of
+    // pieces stored. This is the fast path for tokenizing a line into fields:
+    // it scans a block of the input at a time, with no iterator nor container
+    // in between. If there are more pieces than `out` holds, the last one is
+    // the rest of `text`, unsplit, as with `MaxSplits()`. Empty pieces are
+    // kept, and an empty `text` is one empty piece. Nothing is stored if `out`
+    // is empty.
+    //
+    // Example:
+    //
+    //   std::string_view fields[4];
+    //   size_t n = turbo::str_split_into("a\tb\t\tc", '\t', fields);
+    //   // n == 4, fields[0] == "a", fields[1] == "b", fields[2] == "",
+    //   // fields[3] == "c"
+    //
+    //   n = turbo::str_split_into("k=v;k2=v2", turbo::ByAnyChar("=;"), fields);
+    //   // n == 4, fields[0] == "k", fields[1] == "v", fields[2] == "k2",
+    //   // fields[3] == "v2"
+    //
+    // The views refer to `text`, which must outlive them.
+    size_t str_split_into(std::string_view text, char delimiter, turbo::span<std::string_view> out);
+
+    size_t str_split_into(std::string_view text, const ByAnyChar &delimiters,
+                          turbo::span<std::string_view> out);
+
     template<typename T>
     using EnableSplitIfString =
             typename std::enable_if<std::is_same<T, std::string>::value ||
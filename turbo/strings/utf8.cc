@@ -0,0 +1,573 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/strings/utf8.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include <turbo/base/config.h>
+#include <turbo/base/optimization.h>
+#include <turbo/crypto/internal/cpu_detect.h>
+#include <turbo/numeric/bits.h>
+#include <turbo/strings/internal/resize_uninitialized.h>
+#include <turbo/strings/internal/utf8.h>
+
+// The x86 implementations are compiled for their instruction set whatever
+// the flags of the build, and picked according to the CPU at runtime.
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#define TURBO_UTF8_X86 1
+#include <immintrin.h>
+#elif defined(TURBO_INTERNAL_HAVE_ARM_NEON) && defined(__aarch64__) && defined(TURBO_IS_LITTLE_ENDIAN)
+#define TURBO_UTF8_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace turbo {
+
+    namespace {
+
+        struct Utf8Kernels {
+            const char *name;
+            bool (*validate)(const char *p, size_t n);
+            size_t (*count)(const char *p, size_t n);
+            size_t (*utf16_length)(const char *p, size_t n);
+            char16_t *(*to_utf16)(const char *p, size_t n, char16_t *out);
+            char32_t *(*to_utf32)(const char *p, size_t n, char32_t *out);
+            // nullptr if `p` is not valid UTF-16.
+            char *(*from_utf16)(const char16_t *p, size_t n, char *out);
+        };
+
+        // Portable code, also used for the tails of the vectorized loops.
+
+        bool ValidateScalar(const char *p, size_t n) {
+            const auto *s = reinterpret_cast<const unsigned char *>(p);
+            size_t i = 0;
+            while (i < n) {
+                if (i + 8 <= n) {
+                    uint64_t word;
+                    std::memcpy(&word, s + i, sizeof(word));
+                    if ((word & 0x8080808080808080ull) == 0) {
+                        i += 8;
+                        continue;
+                    }
+                }
+                const unsigned char c = s[i];
+                if (c < 0x80) {
+                    ++i;
+                    continue;
+                }
+                size_t length;
+                char32_t code_point;
+                char32_t min;
+                if ((c & 0xe0) == 0xc0) {
+                    length = 2;
+                    code_point = c & 0x1f;
+                    min = 0x80;
+                } else if ((c & 0xf0) == 0xe0) {
+                    length = 3;
+                    code_point = c & 0x0f;
+                    min = 0x800;
+                } else if ((c & 0xf8) == 0xf0) {
+                    length = 4;
+                    code_point = c & 0x07;
+                    min = 0x10000;
+                } else {
+                    return false;
+                }
+                if (n - i < length) {
+                    return false;
+                }
+                for (size_t k = 1; k < length; ++k) {
+                    if ((s[i + k] & 0xc0) != 0x80) {
+                        return false;
+                    }
+                    code_point = (code_point << 6) | (s[i + k] & 0x3f);
+                }
+                if (code_point < min || code_point > 0x10ffff || (code_point >= 0xd800 && code_point <= 0xdfff)) {
+                    return false;
+                }
+                i += length;
+            }
+            return true;
+        }
+
+        size_t CountCodePointsScalar(const char *p, size_t n) {
+            size_t count = 0;
+            for (size_t i = 0; i < n; ++i) {
+                count += static_cast<signed char>(p[i]) > -65;
+            }
+            return count;
+        }
+
+        size_t Utf16LengthScalar(const char *p, size_t n) {
+            size_t count = 0;
+            for (size_t i = 0; i < n; ++i) {
+                const auto c = static_cast<unsigned char>(p[i]);
+                count += (static_cast<signed char>(c) > -65) + (c >= 0xf0);
+            }
+            return count;
+        }
+
+        // Decodes the code point of valid UTF-8 at `p`, returning its length.
+        inline size_t DecodeCodePoint(const char *p, char32_t *code_point) {
+            const auto *s = reinterpret_cast<const unsigned char *>(p);
+            const unsigned char c = s[0];
+            if (c < 0x80) {
+                *code_point = c;
+                return 1;
+            }
+            if (c < 0xe0) {
+                *code_point = (char32_t{c & 0x1fu} << 6) | (s[1] & 0x3fu);
+                return 2;
+            }
+            if (c < 0xf0) {
+                *code_point = (char32_t{c & 0x0fu} << 12) | (char32_t{s[1] & 0x3fu} << 6) | (s[2] & 0x3fu);
+                return 3;
+            }
+            *code_point = (char32_t{c & 0x07u} << 18) | (char32_t{s[1] & 0x3fu} << 12) |
+                          (char32_t{s[2] & 0x3fu} << 6) | (s[3] & 0x3fu);
+            return 4;
+        }
+
+        inline size_t DecodeUtf8(const char *p, char16_t **out) {
+            char32_t code_point;
+            const size_t length = DecodeCodePoint(p, &code_point);
+            if (code_point < 0x10000) {
+                *(*out)++ = static_cast<char16_t>(code_point);
+            } else {
+                code_point -= 0x10000;
+                *(*out)++ = static_cast<char16_t>(0xd800 + (code_point >> 10));
+                *(*out)++ = static_cast<char16_t>(0xdc00 + (code_point & 0x3ff));
+            }
+            return length;
+        }
+
+        inline size_t DecodeUtf8(const char *p, char32_t **out) {
+            return DecodeCodePoint(p, (*out)++);
+        }
+
+        char16_t *Utf8ToUtf16Scalar(const char *p, size_t n, char16_t *out) {
+            for (size_t i = 0; i < n;) {
+                i += DecodeUtf8(p + i, &out);
+            }
+            return out;
+        }
+
+        char32_t *Utf8ToUtf32Scalar(const char *p, size_t n, char32_t *out) {
+            for (size_t i = 0; i < n;) {
+                i += DecodeUtf8(p + i, &out);
+            }
+            return out;
+        }
+
+        // Encodes the code point of the `remaining` UTF-16 units at `p`,
+        // returning how many it takes, or 0 for an unpaired surrogate.
+        inline size_t EncodeUtf16(const char16_t *p, size_t remaining, char **out) {
+            const char32_t unit = p[0];
+            char *dst = *out;
+            if (unit < 0x80) {
+                dst[0] = static_cast<char>(unit);
+                *out = dst + 1;
+                return 1;
+            }
+            if (unit < 0x800) {
+                dst[0] = static_cast<char>(0xc0 | (unit >> 6));
+                dst[1] = static_cast<char>(0x80 | (unit & 0x3f));
+                *out = dst + 2;
+                return 1;
+            }
+            if (unit < 0xd800 || unit > 0xdfff) {
+                dst[0] = static_cast<char>(0xe0 | (unit >> 12));
+                dst[1] = static_cast<char>(0x80 | ((unit >> 6) & 0x3f));
+                dst[2] = static_cast<char>(0x80 | (unit & 0x3f));
+                *out = dst + 3;
+                return 1;
+            }
+            if (unit > 0xdbff || remaining < 2 || p[1] < 0xdc00 || p[1] > 0xdfff) {
+                return 0;
+            }
+            const char32_t code_point = 0x10000 + ((unit - 0xd800) << 10) + (p[1] - 0xdc00);
+            dst[0] = static_cast<char>(0xf0 | (code_point >> 18));
+            dst[1] = static_cast<char>(0x80 | ((code_point >> 12) & 0x3f));
+            dst[2] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+            dst[3] = static_cast<char>(0x80 | (code_point & 0x3f));
+            *out = dst + 4;
+            return 2;
+        }
+
+        char *Utf16ToUtf8Scalar(const char16_t *p, size_t n, char *out) {
+            for (size_t i = 0; i < n;) {
+                const size_t used = EncodeUtf16(p + i, n - i, &out);
+                if (used == 0) {
+                    return nullptr;
+                }
+                i += used;
+            }
+            return out;
+        }
+
+        constexpr Utf8Kernels kScalarKernels = {
+                "scalar", ValidateScalar, CountCodePointsScalar, Utf16LengthScalar,
+                Utf8ToUtf16Scalar, Utf8ToUtf32Scalar, Utf16ToUtf8Scalar,
+        };
+
+#if defined(TURBO_UTF8_X86)
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("ssse3"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("ssse3")
+#endif
+
+        namespace ssse3 {
+
+            constexpr const char *kName = "ssse3";
+            using Vector = __m128i;
+            constexpr size_t kWidth = 16;
+
+            inline Vector Zero() { return _mm_setzero_si128(); }
+            inline Vector Splat(uint8_t b) { return _mm_set1_epi8(static_cast<char>(b)); }
+            inline Vector Load(const char *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+            inline void Store(char *p, Vector v) { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+            inline Vector Table(const uint8_t *table) { return Load(reinterpret_cast<const char *>(table)); }
+            inline Vector Or(Vector a, Vector b) { return _mm_or_si128(a, b); }
+            inline Vector And(Vector a, Vector b) { return _mm_and_si128(a, b); }
+            inline Vector Xor(Vector a, Vector b) { return _mm_xor_si128(a, b); }
+            inline Vector SaturatingSub(Vector a, Vector b) { return _mm_subs_epu8(a, b); }
+            inline Vector ShiftRight4(Vector v) { return And(_mm_srli_epi16(v, 4), Splat(0x0f)); }
+            inline Vector Lookup(Vector table, Vector v) { return _mm_shuffle_epi8(table, v); }
+
+            template<int N>
+            inline Vector Prev(Vector input, Vector prev) {
+                return _mm_alignr_epi8(input, prev, 16 - N);
+            }
+
+            inline bool IsAscii(Vector v) { return _mm_movemask_epi8(v) == 0; }
+
+            inline bool AllZero(Vector v) { return _mm_movemask_epi8(_mm_cmpeq_epi8(v, Zero())) == 0xffff; }
+
+            inline size_t CountGreater(Vector v, int8_t b) {
+                return static_cast<size_t>(turbo::popcount(
+                        static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(v, _mm_set1_epi8(b))))));
+            }
+
+            inline void StoreUtf16(char16_t *p, Vector v) {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm_unpacklo_epi8(v, Zero()));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(p + 8), _mm_unpackhi_epi8(v, Zero()));
+            }
+
+            inline void StoreUtf32(char32_t *p, Vector v) {
+                const Vector low = _mm_unpacklo_epi8(v, Zero());
+                const Vector high = _mm_unpackhi_epi8(v, Zero());
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm_unpacklo_epi16(low, Zero()));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(p + 4), _mm_unpackhi_epi16(low, Zero()));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(p + 8), _mm_unpacklo_epi16(high, Zero()));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(p + 12), _mm_unpackhi_epi16(high, Zero()));
+            }
+
+            inline bool LoadUtf16Ascii(const char16_t *p, Vector *v) {
+                const Vector a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+                const Vector b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 8));
+                const Vector high = And(Or(a, b), _mm_set1_epi16(static_cast<int16_t>(0xff80)));
+                if (!AllZero(high)) {
+                    return false;
+                }
+                *v = _mm_packus_epi16(a, b);
+                return true;
+            }
+
+#include "turbo/strings/internal/utf8_simd.inc"
+
+        }  // namespace ssse3
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+        namespace avx2 {
+
+            constexpr const char *kName = "avx2";
+            using Vector = __m256i;
+            constexpr size_t kWidth = 32;
+
+            inline Vector Zero() { return _mm256_setzero_si256(); }
+            inline Vector Splat(uint8_t b) { return _mm256_set1_epi8(static_cast<char>(b)); }
+            inline Vector Load(const char *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+            inline void Store(char *p, Vector v) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+
+            inline Vector Table(const uint8_t *table) {
+                return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(table)));
+            }
+
+            inline Vector Or(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+            inline Vector And(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+            inline Vector Xor(Vector a, Vector b) { return _mm256_xor_si256(a, b); }
+            inline Vector SaturatingSub(Vector a, Vector b) { return _mm256_subs_epu8(a, b); }
+            inline Vector ShiftRight4(Vector v) { return And(_mm256_srli_epi16(v, 4), Splat(0x0f)); }
+            inline Vector Lookup(Vector table, Vector v) { return _mm256_shuffle_epi8(table, v); }
+
+            // The shifts of AVX2 stay within each 128 bit lane: the lane
+            // below each one is brought in first.
+            template<int N>
+            inline Vector Prev(Vector input, Vector prev) {
+                return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - N);
+            }
+
+            inline bool IsAscii(Vector v) { return _mm256_movemask_epi8(v) == 0; }
+            inline bool AllZero(Vector v) { return _mm256_testz_si256(v, v) != 0; }
+
+            inline size_t CountGreater(Vector v, int8_t b) {
+                return static_cast<size_t>(turbo::popcount(
+                        static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(b))))));
+            }
+
+            inline void StoreUtf16(char16_t *p, Vector v) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(p + 16),
+                                    _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+            }
+
+            inline void StoreUtf32(char32_t *p, Vector v) {
+                const __m128i low = _mm256_castsi256_si128(v);
+                const __m128i high = _mm256_extracti128_si256(v, 1);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), _mm256_cvtepu8_epi32(low));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(p + 8), _mm256_cvtepu8_epi32(_mm_srli_si128(low, 8)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(p + 16), _mm256_cvtepu8_epi32(high));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(p + 24), _mm256_cvtepu8_epi32(_mm_srli_si128(high, 8)));
+            }
+
+            inline bool LoadUtf16Ascii(const char16_t *p, Vector *v) {
+                const Vector a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+                const Vector b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 16));
+                if (!_mm256_testz_si256(Or(a, b), _mm256_set1_epi16(static_cast<int16_t>(0xff80)))) {
+                    return false;
+                }
+                // The pack interleaves the lanes of `a` and `b`.
+                *v = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xd8);
+                return true;
+            }
+
+#include "turbo/strings/internal/utf8_simd.inc"
+
+        }  // namespace avx2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#elif defined(TURBO_UTF8_NEON)
+
+        namespace neon {
+
+            constexpr const char *kName = "neon";
+            using Vector = uint8x16_t;
+            constexpr size_t kWidth = 16;
+
+            inline Vector Zero() { return vdupq_n_u8(0); }
+            inline Vector Splat(uint8_t b) { return vdupq_n_u8(b); }
+            inline Vector Load(const char *p) { return vld1q_u8(reinterpret_cast<const uint8_t *>(p)); }
+            inline void Store(char *p, Vector v) { vst1q_u8(reinterpret_cast<uint8_t *>(p), v); }
+            inline Vector Table(const uint8_t *table) { return vld1q_u8(table); }
+            inline Vector Or(Vector a, Vector b) { return vorrq_u8(a, b); }
+            inline Vector And(Vector a, Vector b) { return vandq_u8(a, b); }
+            inline Vector Xor(Vector a, Vector b) { return veorq_u8(a, b); }
+            inline Vector SaturatingSub(Vector a, Vector b) { return vqsubq_u8(a, b); }
+            inline Vector ShiftRight4(Vector v) { return vshrq_n_u8(v, 4); }
+            inline Vector Lookup(Vector table, Vector v) { return vqtbl1q_u8(table, v); }
+
+            template<int N>
+            inline Vector Prev(Vector input, Vector prev) {
+                return vextq_u8(prev, input, 16 - N);
+            }
+
+            inline bool IsAscii(Vector v) { return vmaxvq_u8(v) < 0x80; }
+            inline bool AllZero(Vector v) { return vmaxvq_u8(v) == 0; }
+
+            inline size_t CountGreater(Vector v, int8_t b) {
+                const uint8x16_t greater = vcgtq_s8(vreinterpretq_s8_u8(v), vdupq_n_s8(b));
+                return vaddvq_u8(vshrq_n_u8(greater, 7));
+            }
+
+            inline void StoreUtf16(char16_t *p, Vector v) {
+                auto *dst = reinterpret_cast<uint16_t *>(p);
+                vst1q_u16(dst, vmovl_u8(vget_low_u8(v)));
+                vst1q_u16(dst + 8, vmovl_u8(vget_high_u8(v)));
+            }
+
+            inline void StoreUtf32(char32_t *p, Vector v) {
+                auto *dst = reinterpret_cast<uint32_t *>(p);
+                const uint16x8_t low = vmovl_u8(vget_low_u8(v));
+                const uint16x8_t high = vmovl_u8(vget_high_u8(v));
+                vst1q_u32(dst, vmovl_u16(vget_low_u16(low)));
+                vst1q_u32(dst + 4, vmovl_u16(vget_high_u16(low)));
+                vst1q_u32(dst + 8, vmovl_u16(vget_low_u16(high)));
+                vst1q_u32(dst + 12, vmovl_u16(vget_high_u16(high)));
+            }
+
+            inline bool LoadUtf16Ascii(const char16_t *p, Vector *v) {
+                const uint16x8_t a = vld1q_u16(reinterpret_cast<const uint16_t *>(p));
+                const uint16x8_t b = vld1q_u16(reinterpret_cast<const uint16_t *>(p + 8));
+                if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80) {
+                    return false;
+                }
+                *v = vcombine_u8(vmovn_u16(a), vmovn_u16(b));
+                return true;
+            }
+
+#include "turbo/strings/internal/utf8_simd.inc"
+
+        }  // namespace neon
+
+#endif
+
+        // The implementations this build and this CPU can run, best first.
+        struct Implementations {
+            const Utf8Kernels *list[4];
+            size_t size = 0;
+
+            Implementations() {
+#if defined(TURBO_UTF8_X86)
+                if (crc_internal::SupportsX86AVX2()) {
+                    list[size++] = &avx2::kKernels;
+                }
+                if (crc_internal::SupportsX86SSSE3()) {
+                    list[size++] = &ssse3::kKernels;
+                }
+#elif defined(TURBO_UTF8_NEON)
+                list[size++] = &neon::kKernels;
+#endif
+                list[size++] = &kScalarKernels;
+            }
+        };
+
+        const Implementations &available() {
+            static const Implementations implementations;
+            return implementations;
+        }
+
+        std::atomic<const Utf8Kernels *> g_kernels{nullptr};
+
+        const Utf8Kernels &kernels() {
+            const Utf8Kernels *k = g_kernels.load(std::memory_order_relaxed);
+            if (TURBO_UNLIKELY(k == nullptr)) {
+                k = available().list[0];
+                g_kernels.store(k, std::memory_order_relaxed);
+            }
+            return *k;
+        }
+
+    }  // namespace
+
+    namespace strings_internal {
+
+        const char *Utf8Implementation() {
+            return kernels().name;
+        }
+
+        bool SetUtf8Implementation(std::string_view name) {
+            const Implementations &implementations = available();
+            for (size_t i = 0; i < implementations.size; ++i) {
+                if (name == implementations.list[i]->name) {
+                    g_kernels.store(implementations.list[i], std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    }  // namespace strings_internal
+
+    bool validate_utf8(std::string_view s) {
+        return kernels().validate(s.data(), s.size());
+    }
+
+    size_t count_utf8_code_points(std::string_view s) {
+        return kernels().count(s.data(), s.size());
+    }
+
+    size_t utf16_length_from_utf8(std::string_view s) {
+        return kernels().utf16_length(s.data(), s.size());
+    }
+
+    size_t utf8_length_from_utf16(std::u16string_view s) {
+        size_t length = 0;
+        for (size_t i = 0; i < s.size(); ++i) {
+            const char16_t unit = s[i];
+            if (unit < 0x80) {
+                length += 1;
+            } else if (unit < 0x800) {
+                length += 2;
+            } else if (unit >= 0xd800 && unit <= 0xdbff && i + 1 < s.size() && s[i + 1] >= 0xdc00 &&
+                       s[i + 1] <= 0xdfff) {
+                length += 4;
+                ++i;
+            } else {
+                length += 3;
+            }
+        }
+        return length;
+    }
+
+    bool utf8_to_utf16(std::string_view s, turbo::Nonnull<std::u16string *> out) {
+        const Utf8Kernels &k = kernels();
+        if (!k.validate(s.data(), s.size())) {
+            return false;
+        }
+        strings_internal::STLStringResizeUninitialized(out, k.utf16_length(s.data(), s.size()));
+        k.to_utf16(s.data(), s.size(), &(*out)[0]);
+        return true;
+    }
+
+    bool utf8_to_utf32(std::string_view s, turbo::Nonnull<std::u32string *> out) {
+        const Utf8Kernels &k = kernels();
+        if (!k.validate(s.data(), s.size())) {
+            return false;
+        }
+        strings_internal::STLStringResizeUninitialized(out, k.count(s.data(), s.size()));
+        k.to_utf32(s.data(), s.size(), &(*out)[0]);
+        return true;
+    }
+
+    bool utf16_to_utf8(std::u16string_view s, turbo::Nonnull<std::string *> out) {
+        // At most three bytes a unit: a pair of surrogates takes four.
+        strings_internal::STLStringResizeUninitialized(out, 3 * s.size());
+        const char *end = kernels().from_utf16(s.data(), s.size(), &(*out)[0]);
+        if (end == nullptr) {
+            return false;
+        }
+        out->resize(static_cast<size_t>(end - out->data()));
+        return true;
+    }
+
+}  // namespace turbo
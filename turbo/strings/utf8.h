@@ -0,0 +1,77 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+// File: utf8.h
+// -----------------------------------------------------------------------------
+//
+// This package validates and counts UTF-8 text and converts it to and from
+// UTF-16 and UTF-32, many bytes per instruction: the implementation is picked
+// at runtime among AVX2, SSSE3, NEON and portable code, according to the CPU.
+//
+// Valid UTF-8 follows RFC 3629: no overlong encodings, no surrogates (U+D800
+// to U+DFFF) and nothing above U+10FFFF. Valid UTF-16 has no unpaired
+// surrogates. The conversions return false, leaving their output unspecified,
+// when their input is not valid.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include <turbo/base/nullability.h>
+
+namespace turbo {
+
+    // validate_utf8()
+    //
+    // Returns whether `s` is valid UTF-8.
+    bool validate_utf8(std::string_view s);
+
+    // count_utf8_code_points()
+    //
+    // Returns the number of code points of the valid UTF-8 string `s`, that is
+    // the number of its bytes which are not continuation bytes (10xxxxxx).
+    size_t count_utf8_code_points(std::string_view s);
+
+    // utf16_length_from_utf8()
+    //
+    // Returns the number of UTF-16 code units the valid UTF-8 string `s`
+    // converts to.
+    size_t utf16_length_from_utf8(std::string_view s);
+
+    // utf8_length_from_utf16()
+    //
+    // Returns the number of bytes the valid UTF-16 string `s` converts to.
+    size_t utf8_length_from_utf16(std::u16string_view s);
+
+    // utf8_to_utf16()
+    //
+    // Converts the UTF-8 string `s` to UTF-16 into `out`.
+    bool utf8_to_utf16(std::string_view s, turbo::Nonnull<std::u16string *> out);
+
+    // utf16_to_utf8()
+    //
+    // Converts the UTF-16 string `s` to UTF-8 into `out`.
+    bool utf16_to_utf8(std::u16string_view s, turbo::Nonnull<std::string *> out);
+
+    // utf8_to_utf32()
+    //
+    // Converts the UTF-8 string `s` to UTF-32 into `out`.
+    bool utf8_to_utf32(std::string_view s, turbo::Nonnull<std::u32string *> out);
+
+}  // namespace turbo
@@ -0,0 +1,104 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/synchronization/distributed_rw_lock.h>
+
+#include <atomic>
+#include <cstddef>
+#include <thread>  // NOLINT(build/c++11)
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+
+namespace {
+
+// Number of slot scans a writer performs before it starts yielding to the
+// readers it is waiting for.
+constexpr int kWriterSpinScans = 100;
+
+}  // namespace
+
+DistributedRWLock::DistributedRWLock() : writer_(false) {
+  TURBO_TSAN_MUTEX_CREATE(this, __tsan_mutex_not_static);
+}
+
+DistributedRWLock::~DistributedRWLock() {
+  TURBO_TSAN_MUTEX_DESTROY(this, __tsan_mutex_not_static);
+}
+
+size_t DistributedRWLock::NextSlot() {
+  static std::atomic<size_t> next_slot{0};
+  return next_slot.fetch_add(1, std::memory_order_relaxed) % kNumSlots;
+}
+
+bool DistributedRWLock::ReadersDrained() const {
+  for (const Slot& s : slots_) {
+    if (s.readers.load(std::memory_order_seq_cst) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void DistributedRWLock::ReaderLockSlow() {
+  const size_t slot = ThreadSlot();
+  do {
+    // The writer holds `writer_mu_` for its whole critical section, so this
+    // blocks until it is done; all waiting readers are released together.
+    writer_mu_.ReaderLock();
+    writer_mu_.ReaderUnlock();
+  } while (!ReaderTryLockInternal(slot));
+}
+
+void DistributedRWLock::Lock() {
+  TURBO_TSAN_MUTEX_PRE_LOCK(this, 0);
+  writer_mu_.Lock();
+  writer_.store(true, std::memory_order_seq_cst);
+  for (int scans = 0; !ReadersDrained(); ++scans) {
+    if (scans >= kWriterSpinScans) {
+      std::this_thread::yield();
+    }
+  }
+  TURBO_TSAN_MUTEX_POST_LOCK(this, 0, 0);
+}
+
+void DistributedRWLock::Unlock() {
+  TURBO_TSAN_MUTEX_PRE_UNLOCK(this, 0);
+  writer_.store(false, std::memory_order_release);
+  writer_mu_.Unlock();
+  TURBO_TSAN_MUTEX_POST_UNLOCK(this, 0);
+}
+
+bool DistributedRWLock::TryLock() {
+  TURBO_TSAN_MUTEX_PRE_LOCK(this, __tsan_mutex_try_lock);
+  bool locked = false;
+  if (writer_mu_.TryLock()) {
+    writer_.store(true, std::memory_order_seq_cst);
+    locked = ReadersDrained();
+    if (!locked) {
+      writer_.store(false, std::memory_order_release);
+      writer_mu_.Unlock();
+    }
+  }
+  TURBO_TSAN_MUTEX_POST_LOCK(
+      this, __tsan_mutex_try_lock | (locked ? 0 : __tsan_mutex_try_lock_failed),
+      0);
+  return locked;
+}
+
+TURBO_NAMESPACE_END
+}  // namespace turbo
@@ -0,0 +1,210 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+// distributed_rw_lock.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines `DistributedRWLock`, a reader-writer lock for
+// read-dominated hot paths.
+//
+// `turbo::Mutex` keeps all of its state in a single word, so every
+// `ReaderLock()`/`ReaderUnlock()` pair writes a cache line shared by all
+// readers. `DistributedRWLock` instead spreads readers over `kNumSlots`
+// cache-line sized counters. Each thread is assigned a slot once, so readers
+// on different slots never touch the same cache line, and the only shared
+// line they read (the writer flag) stays in the shared state as long as no
+// writer shows up.
+//
+// Writers pay for this: they raise the writer flag and then scan every slot
+// until all readers have drained. Use `DistributedRWLock` only when writers
+// are rare; otherwise `turbo::Mutex` is the better choice. Each lock occupies
+// `kNumSlots` cache lines.
+//
+// Readers that find a writer active block on an internal `turbo::Mutex`
+// instead of spinning. The lock is not reentrant and has no `Condition`
+// support.
+
+#ifndef TURBO_SYNCHRONIZATION_DISTRIBUTED_RW_LOCK_H_
+#define TURBO_SYNCHRONIZATION_DISTRIBUTED_RW_LOCK_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <turbo/base/attributes.h>
+#include <turbo/base/config.h>
+#include <turbo/base/internal/tsan_mutex_interface.h>
+#include <turbo/base/optimization.h>
+#include <turbo/base/thread_annotations.h>
+#include <turbo/synchronization/mutex.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+
+class TURBO_LOCKABLE DistributedRWLock {
+ public:
+  // Number of reader counters. Threads beyond this share slots.
+  static constexpr size_t kNumSlots = 64;
+
+  DistributedRWLock();
+  DistributedRWLock(const DistributedRWLock&) = delete;
+  DistributedRWLock& operator=(const DistributedRWLock&) = delete;
+  ~DistributedRWLock();
+
+  // DistributedRWLock::Lock()
+  //
+  // Blocks until the lock is free and acquires it in exclusive mode.
+  void Lock() TURBO_EXCLUSIVE_LOCK_FUNCTION() TURBO_NO_THREAD_SAFETY_ANALYSIS;
+
+  // DistributedRWLock::Unlock()
+  //
+  // Releases the lock held in exclusive mode.
+  void Unlock() TURBO_UNLOCK_FUNCTION() TURBO_NO_THREAD_SAFETY_ANALYSIS;
+
+  // DistributedRWLock::TryLock()
+  //
+  // Acquires the lock in exclusive mode if that is possible without waiting
+  // for readers or other writers.
+  TURBO_MUST_USE_RESULT bool TryLock() TURBO_EXCLUSIVE_TRYLOCK_FUNCTION(true)
+      TURBO_NO_THREAD_SAFETY_ANALYSIS;
+
+  // DistributedRWLock::ReaderLock()
+  //
+  // Acquires the lock in shared mode; only blocks while a writer holds or
+  // waits for the lock.
+  void ReaderLock() TURBO_SHARED_LOCK_FUNCTION() {
+    TURBO_TSAN_MUTEX_PRE_LOCK(this, __tsan_mutex_read_lock);
+    if (TURBO_UNLIKELY(!ReaderTryLockInternal(ThreadSlot()))) {
+      ReaderLockSlow();
+    }
+    TURBO_TSAN_MUTEX_POST_LOCK(this, __tsan_mutex_read_lock, 0);
+  }
+
+  // DistributedRWLock::ReaderUnlock()
+  //
+  // Releases the lock held in shared mode. Must be called on the thread that
+  // acquired it.
+  void ReaderUnlock() TURBO_UNLOCK_FUNCTION() {
+    TURBO_TSAN_MUTEX_PRE_UNLOCK(this, __tsan_mutex_read_lock);
+    slots_[ThreadSlot()].readers.fetch_sub(1, std::memory_order_release);
+    TURBO_TSAN_MUTEX_POST_UNLOCK(this, __tsan_mutex_read_lock);
+  }
+
+  // DistributedRWLock::ReaderTryLock()
+  //
+  // Acquires the lock in shared mode unless a writer holds or waits for it.
+  TURBO_MUST_USE_RESULT bool ReaderTryLock()
+      TURBO_SHARED_TRYLOCK_FUNCTION(true) {
+    TURBO_TSAN_MUTEX_PRE_LOCK(this,
+                              __tsan_mutex_read_lock | __tsan_mutex_try_lock);
+    const bool locked = ReaderTryLockInternal(ThreadSlot());
+    TURBO_TSAN_MUTEX_POST_LOCK(
+        this,
+        __tsan_mutex_read_lock | __tsan_mutex_try_lock |
+            (locked ? 0 : __tsan_mutex_try_lock_failed),
+        0);
+    return locked;
+  }
+
+  // Aliases for the standard `Lockable` and `SharedLockable` requirements,
+  // so the lock can be used with `std::unique_lock` and `std::shared_lock`.
+  void lock() TURBO_EXCLUSIVE_LOCK_FUNCTION() { Lock(); }
+  void unlock() TURBO_UNLOCK_FUNCTION() { Unlock(); }
+  bool try_lock() TURBO_EXCLUSIVE_TRYLOCK_FUNCTION(true) { return TryLock(); }
+  void lock_shared() TURBO_SHARED_LOCK_FUNCTION() { ReaderLock(); }
+  void unlock_shared() TURBO_UNLOCK_FUNCTION() { ReaderUnlock(); }
+  bool try_lock_shared() TURBO_SHARED_TRYLOCK_FUNCTION(true) {
+    return ReaderTryLock();
+  }
+
+ private:
+  struct TURBO_CACHELINE_ALIGNED Slot {
+    std::atomic<int32_t> readers{0};
+  };
+
+  // Returns the reader slot of the calling thread. Slots are handed out
+  // round-robin on first use so that threads spread evenly.
+  static size_t ThreadSlot() {
+    static thread_local size_t slot = NextSlot();
+    return slot;
+  }
+  static size_t NextSlot();
+
+  bool ReaderTryLockInternal(size_t slot) {
+    Slot& s = slots_[slot];
+    // Pairs with the writer raising `writer_` and then scanning the slots:
+    // sequentially consistent ordering guarantees that either this reader sees
+    // the writer, or the writer sees this reader.
+    s.readers.fetch_add(1, std::memory_order_seq_cst);
+    if (TURBO_LIKELY(!writer_.load(std::memory_order_seq_cst))) {
+      return true;
+    }
+    s.readers.fetch_sub(1, std::memory_order_release);
+    return false;
+  }
+
+  // The internal mutex is acquired and released on different calls, which the
+  // static analysis cannot follow.
+  void ReaderLockSlow() TURBO_NO_THREAD_SAFETY_ANALYSIS;
+  bool ReadersDrained() const;
+
+  Slot slots_[kNumSlots];
+  // True while a writer holds or is acquiring the lock.
+  TURBO_CACHELINE_ALIGNED std::atomic<bool> writer_;
+  // Held by the writer for its whole critical section; serializes writers and
+  // gives readers something to block on.
+  Mutex writer_mu_;
+};
+
+// -----------------------------------------------------------------------------
+// Scoped holders
+// -----------------------------------------------------------------------------
+
+class TURBO_SCOPED_LOCKABLE DistributedReaderLock {
+ public:
+  explicit DistributedReaderLock(DistributedRWLock* mu)
+      TURBO_SHARED_LOCK_FUNCTION(mu)
+      : mu_(mu) {
+    mu_->ReaderLock();
+  }
+  DistributedReaderLock(const DistributedReaderLock&) = delete;
+  DistributedReaderLock& operator=(const DistributedReaderLock&) = delete;
+  ~DistributedReaderLock() TURBO_UNLOCK_FUNCTION() { mu_->ReaderUnlock(); }
+
+ private:
+  DistributedRWLock* const mu_;
+};
+
+class TURBO_SCOPED_LOCKABLE DistributedWriterLock {
+ public:
+  explicit DistributedWriterLock(DistributedRWLock* mu)
+      TURBO_EXCLUSIVE_LOCK_FUNCTION(mu)
+      : mu_(mu) {
+    mu_->Lock();
+  }
+  DistributedWriterLock(const DistributedWriterLock&) = delete;
+  DistributedWriterLock& operator=(const DistributedWriterLock&) = delete;
+  ~DistributedWriterLock() TURBO_UNLOCK_FUNCTION() { mu_->Unlock(); }
+
+ private:
+  DistributedRWLock* const mu_;
+};
+
+TURBO_NAMESPACE_END
+}  // namespace turbo
+
+#endif  // TURBO_SYNCHRONIZATION_DISTRIBUTED_RW_LOCK_H_
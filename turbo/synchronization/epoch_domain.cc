@@ -0,0 +1,276 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/synchronization/epoch_domain.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include <turbo/base/const_init.h>
+#include <turbo/base/internal/raw_logging.h>
+#include <turbo/base/no_destructor.h>
+#include <turbo/container/flat_hash_map.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+
+namespace synchronization_internal {
+
+TURBO_CONST_INIT thread_local EpochLocalCache epoch_local_cache = {0, nullptr};
+
+namespace {
+
+// Live domains by id. Thread exit consults it so that records of a domain that
+// has already been destroyed are never touched.
+TURBO_CONST_INIT turbo::Mutex registry_mu(turbo::kConstInit);
+
+turbo::flat_hash_map<uint64_t, EpochDomain*>& LiveDomains()
+    TURBO_EXCLUSIVE_LOCKS_REQUIRED(registry_mu) {
+  static turbo::NoDestructor<turbo::flat_hash_map<uint64_t, EpochDomain*>>
+      domains;
+  return *domains;
+}
+
+std::atomic<uint64_t> next_domain_id{1};
+
+// Set once the current thread's `EpochThreadRecords` has been destroyed.
+TURBO_CONST_INIT thread_local bool thread_records_destroyed = false;
+
+}  // namespace
+
+struct EpochThreadRecords {
+  ~EpochThreadRecords() {
+    thread_records_destroyed = true;
+    epoch_local_cache = {0, nullptr};
+    turbo::MutexLock lock(&registry_mu);
+    for (const auto& entry : records) {
+      auto it = LiveDomains().find(entry.first);
+      if (it != LiveDomains().end()) {
+        it->second->ReleaseRecord(entry.second);
+      }
+    }
+  }
+
+  std::vector<std::pair<uint64_t, EpochRecord*>> records;
+};
+
+}  // namespace synchronization_internal
+
+EpochDomain::EpochDomain()
+    : id_(synchronization_internal::next_domain_id.fetch_add(
+          1, std::memory_order_relaxed)),
+      epoch_(1),
+      records_(nullptr) {
+  turbo::MutexLock lock(&synchronization_internal::registry_mu);
+  synchronization_internal::LiveDomains()[id_] = this;
+}
+
+EpochDomain::~EpochDomain() {
+  {
+    turbo::MutexLock lock(&synchronization_internal::registry_mu);
+    synchronization_internal::LiveDomains().erase(id_);
+  }
+  Record* record = records_.load(std::memory_order_acquire);
+  while (record != nullptr) {
+    TURBO_RAW_CHECK(record->nesting == 0,
+                    "EpochDomain destroyed while a thread is pinned");
+    for (const Record::Retired& r : record->retired) {
+      r.deleter(r.ptr);
+    }
+    Record* next = record->next;
+    delete record;
+    record = next;
+  }
+  turbo::MutexLock lock(&orphans_mu_);
+  for (const Record::Retired& r : orphans_) {
+    r.deleter(r.ptr);
+  }
+}
+
+EpochDomain& EpochDomain::Default() {
+  static turbo::NoDestructor<EpochDomain> domain;
+  return *domain;
+}
+
+EpochDomain::Record* EpochDomain::LocalRecordSlow() {
+  if (TURBO_UNLIKELY(synchronization_internal::thread_records_destroyed)) {
+    // Pinned from a thread_local destructor that runs after the thread's
+    // records were released, e.g. one that logs. The record is only borrowed
+    // until it is unpinned, see `ReturnBorrowed()`.
+    Record* record = AcquireRecord();
+    record->borrowed = true;
+    synchronization_internal::epoch_local_cache = {id_, record};
+    return record;
+  }
+  static thread_local synchronization_internal::EpochThreadRecords
+      thread_records;
+  Record* record = nullptr;
+  for (const auto& entry : thread_records.records) {
+    if (entry.first == id_) {
+      record = entry.second;
+      break;
+    }
+  }
+  if (record == nullptr) {
+    record = AcquireRecord();
+    thread_records.records.emplace_back(id_, record);
+  }
+  synchronization_internal::epoch_local_cache = {id_, record};
+  return record;
+}
+
+EpochDomain::Record* EpochDomain::AcquireRecord() {
+  for (Record* record = records_.load(std::memory_order_acquire);
+       record != nullptr; record = record->next) {
+    bool expected = false;
+    if (!record->in_use.load(std::memory_order_relaxed) &&
+        record->in_use.compare_exchange_strong(expected, true,
+                                               std::memory_order_acquire)) {
+      return record;
+    }
+  }
+  Record* record = new Record;
+  record->domain = this;
+  record->in_use.store(true, std::memory_order_relaxed);
+  Record* head = records_.load(std::memory_order_relaxed);
+  do {
+    record->next = head;
+  } while (!records_.compare_exchange_weak(head, record,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed));
+  return record;
+}
+
+void EpochDomain::ReleaseRecord(Record* record) {
+  record->nesting = 0;
+  record->state.store(0, std::memory_order_release);
+  if (!record->retired.empty()) {
+    turbo::MutexLock lock(&orphans_mu_);
+    orphans_.insert(orphans_.end(), record->retired.begin(),
+                    record->retired.end());
+  }
+  record->retired.clear();
+  record->retired.shrink_to_fit();
+  record->in_use.store(false, std::memory_order_release);
+}
+
+void EpochDomain::ReturnBorrowed(Record* record) {
+  if (!record->borrowed || record->nesting != 0) return;
+  record->borrowed = false;
+  synchronization_internal::EpochLocalCache& cache =
+      synchronization_internal::epoch_local_cache;
+  if (cache.record == record) {
+    cache = {0, nullptr};
+  }
+  // The next pin takes the same record off the free list again, so a thread
+  // that keeps pinning after exit does not grow the record list.
+  ReleaseRecord(record);
+}
+
+bool EpochDomain::TryAdvance() {
+  // Pairs with the fence in `Enter()`: a reader whose announcement this scan
+  // misses is guaranteed to observe every unlink made before the scan.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  uint64_t e = epoch_.load(std::memory_order_relaxed);
+  for (Record* record = records_.load(std::memory_order_acquire);
+       record != nullptr; record = record->next) {
+    const uint64_t state = record->state.load(std::memory_order_acquire);
+    if ((state & 1) != 0 && (state >> 1) != e) {
+      return false;
+    }
+  }
+  // Losing the race means another thread advanced the epoch for us.
+  epoch_.compare_exchange_strong(e, e + 1, std::memory_order_acq_rel,
+                                 std::memory_order_relaxed);
+  return true;
+}
+
+size_t EpochDomain::ReclaimRecord(Record* record) {
+  const uint64_t e = epoch_.load(std::memory_order_acquire);
+  auto& retired = record->retired;
+  // Objects are appended in epoch order, so the reclaimable ones form a prefix.
+  auto end = std::find_if(retired.begin(), retired.end(),
+                          [e](const Record::Retired& r) {
+                            return r.epoch + 2 > e;
+                          });
+  // Move the batch out first: a deleter may itself retire objects.
+  std::vector<Record::Retired> batch(retired.begin(), end);
+  retired.erase(retired.begin(), end);
+  for (const Record::Retired& r : batch) {
+    r.deleter(r.ptr);
+  }
+  return batch.size();
+}
+
+size_t EpochDomain::ReclaimOrphans() {
+  const uint64_t e = epoch_.load(std::memory_order_acquire);
+  std::vector<Record::Retired> batch;
+  {
+    turbo::MutexLock lock(&orphans_mu_);
+    auto mid = std::partition(orphans_.begin(), orphans_.end(),
+                              [e](const Record::Retired& r) {
+                                return r.epoch + 2 > e;
+                              });
+    batch.assign(mid, orphans_.end());
+    orphans_.erase(mid, orphans_.end());
+  }
+  for (const Record::Retired& r : batch) {
+    r.deleter(r.ptr);
+  }
+  return batch.size();
+}
+
+void EpochDomain::Retire(void* ptr, void (*deleter)(void*)) {
+  Record* record = LocalRecord();
+  record->retired.push_back(
+      {ptr, deleter, epoch_.load(std::memory_order_acquire)});
+  if (record->retired.size() >= kReclaimBatch) {
+    TryAdvance();
+    ReclaimRecord(record);
+  }
+  ReturnBorrowed(record);
+}
+
+size_t EpochDomain::Reclaim() {
+  TryAdvance();
+  Record* record = LocalRecord();
+  const size_t reclaimed = ReclaimRecord(record);
+  ReturnBorrowed(record);
+  return reclaimed + ReclaimOrphans();
+}
+
+void EpochDomain::Synchronize() {
+  Record* record = LocalRecord();
+  TURBO_RAW_CHECK(record->nesting == 0,
+                  "EpochDomain::Synchronize() called while pinned");
+  const uint64_t target = epoch_.load(std::memory_order_acquire) + 2;
+  while (epoch_.load(std::memory_order_acquire) < target) {
+    if (!TryAdvance()) {
+      std::this_thread::yield();
+    }
+  }
+  ReclaimRecord(record);
+  ReturnBorrowed(record);
+  ReclaimOrphans();
+}
+
+TURBO_NAMESPACE_END
+}  // namespace turbo
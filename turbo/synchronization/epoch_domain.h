@@ -0,0 +1,267 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+// epoch_domain.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines `EpochDomain`, an epoch-based memory reclamation
+// (EBR) primitive. It allows lock-free readers to dereference shared objects
+// while writers unlink and retire them concurrently; a retired object is only
+// destroyed once every reader that could still observe it has left its
+// critical section.
+//
+// Readers bracket their accesses with an `EpochDomain::Guard`. Pinning costs a
+// store to a cache line owned by the calling thread plus a fence; it never
+// writes memory shared with other readers. Writers unlink an object so that no
+// new reader can reach it and then hand it to `Retire()`. Retired objects are
+// batched per thread and reclaimed once the global epoch has advanced twice
+// past the epoch in which they were retired.
+//
+// Example:
+//
+//   turbo::EpochDomain& domain = turbo::EpochDomain::Default();
+//   std::atomic<Config*> config;
+//
+//   // Reader
+//   {
+//     turbo::EpochDomain::Guard guard = domain.Pin();
+//     Use(*config.load(std::memory_order_acquire));
+//   }
+//
+//   // Writer
+//   Config* old = config.exchange(new Config(...), std::memory_order_acq_rel);
+//   domain.Retire(old);
+//
+// A reader that stays pinned for a long time stalls reclamation for the whole
+// domain. Long-lived readers should use `HazardPointerDomain` instead, see
+// hazard_pointer.h.
+
+#ifndef TURBO_SYNCHRONIZATION_EPOCH_DOMAIN_H_
+#define TURBO_SYNCHRONIZATION_EPOCH_DOMAIN_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <turbo/base/attributes.h>
+#include <turbo/base/config.h>
+#include <turbo/base/optimization.h>
+#include <turbo/base/thread_annotations.h>
+#include <turbo/synchronization/mutex.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+
+class EpochDomain;
+
+namespace synchronization_internal {
+
+// Per-thread state of one thread in one `EpochDomain`.
+struct TURBO_CACHELINE_ALIGNED EpochRecord {
+  struct Retired {
+    void* ptr;
+    void (*deleter)(void*);
+    uint64_t epoch;
+  };
+
+  // `(epoch << 1) | 1` while the owning thread is pinned, zero otherwise. This
+  // is the only field other threads read on the hot path.
+  std::atomic<uint64_t> state{0};
+  // Guard nesting depth; only accessed by the owning thread.
+  int nesting = 0;
+  // Set while a thread owns the record.
+  std::atomic<bool> in_use{false};
+  // Set while the record is lent to a thread whose own records were already
+  // released at thread exit; `domain` takes it back once it is unpinned.
+  bool borrowed = false;
+  // Immutable; the domain whose record list holds the record.
+  EpochDomain* domain = nullptr;
+  // Immutable once the record is published in the domain's record list.
+  EpochRecord* next = nullptr;
+  // Objects retired by the owning thread, oldest first.
+  std::vector<Retired> retired;
+};
+
+// One-entry cache of the record the current thread used last, so that pinning
+// the same domain repeatedly avoids the slow lookup.
+struct EpochLocalCache {
+  uint64_t domain_id;
+  EpochRecord* record;
+};
+
+TURBO_CONST_INIT extern thread_local EpochLocalCache epoch_local_cache;
+
+// Owns the records of the current thread and releases them on thread exit.
+struct EpochThreadRecords;
+
+}  // namespace synchronization_internal
+
+// -----------------------------------------------------------------------------
+// EpochDomain
+// -----------------------------------------------------------------------------
+class EpochDomain {
+ public:
+  // Number of objects a thread retires before it attempts to advance the
+  // epoch and reclaim its batch.
+  static constexpr size_t kReclaimBatch = 64;
+
+  EpochDomain();
+  EpochDomain(const EpochDomain&) = delete;
+  EpochDomain& operator=(const EpochDomain&) = delete;
+
+  // Destroys every object still pending reclamation. No thread may be pinned
+  // on the domain when it is destroyed.
+  ~EpochDomain();
+
+  // EpochDomain::Default()
+  //
+  // Returns a process-wide domain, which is never destroyed.
+  static EpochDomain& Default();
+
+  // EpochDomain::Guard
+  //
+  // RAII read-side critical section. While any guard is alive, objects that
+  // were reachable when it was created are not reclaimed. Guards may nest and
+  // must be destroyed on the thread that created them.
+  class Guard {
+   public:
+    Guard() : record_(nullptr) {}
+    explicit Guard(EpochDomain* domain) : record_(domain->Enter()) {}
+    Guard(Guard&& other) noexcept : record_(other.record_) {
+      other.record_ = nullptr;
+    }
+    Guard& operator=(Guard&& other) noexcept {
+      if (this != &other) {
+        Release();
+        record_ = other.record_;
+        other.record_ = nullptr;
+      }
+      return *this;
+    }
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+    ~Guard() { Release(); }
+
+    // Guard::Release()
+    //
+    // Leaves the critical section early.
+    void Release() {
+      if (record_ != nullptr) {
+        EpochDomain::Exit(record_);
+        record_ = nullptr;
+      }
+    }
+
+   private:
+    synchronization_internal::EpochRecord* record_;
+  };
+
+  // EpochDomain::Pin()
+  //
+  // Enters a read-side critical section on this domain.
+  Guard Pin() { return Guard(this); }
+
+  // EpochDomain::Retire()
+  //
+  // Schedules `ptr` to be destroyed by `deleter(ptr)` once no reader can still
+  // hold a reference obtained before this call. The object must already be
+  // unreachable for new readers. May be called while pinned.
+  void Retire(void* ptr, void (*deleter)(void*));
+
+  template <typename T>
+  void Retire(T* ptr) {
+    Retire(static_cast<void*>(ptr),
+           [](void* p) { delete static_cast<T*>(p); });
+  }
+
+  // EpochDomain::Reclaim()
+  //
+  // Tries to advance the epoch once and destroys the calling thread's retired
+  // objects (and objects left behind by exited threads) that are safe to
+  // reclaim. Returns the number of objects destroyed. Never blocks on readers.
+  size_t Reclaim();
+
+  // EpochDomain::Synchronize()
+  //
+  // Waits until every reader pinned before the call has left its critical
+  // section, then reclaims everything the calling thread and exited threads
+  // had retired. Must not be called while the calling thread is pinned on
+  // this domain.
+  void Synchronize();
+
+  // EpochDomain::epoch()
+  //
+  // Returns the current global epoch, for tests and diagnostics.
+  uint64_t epoch() const { return epoch_.load(std::memory_order_acquire); }
+
+ private:
+  using Record = synchronization_internal::EpochRecord;
+
+  synchronization_internal::EpochRecord* Enter() {
+    Record* record = LocalRecord();
+    if (record->nesting++ == 0) {
+      const uint64_t e = epoch_.load(std::memory_order_relaxed);
+      record->state.store((e << 1) | 1, std::memory_order_relaxed);
+      // Orders the announcement before every read in the critical section;
+      // pairs with the fence in `TryAdvance()`.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+    return record;
+  }
+
+  static void Exit(Record* record) {
+    if (--record->nesting == 0) {
+      record->state.store(0, std::memory_order_release);
+      if (TURBO_UNLIKELY(record->borrowed)) {
+        record->domain->ReturnBorrowed(record);
+      }
+    }
+  }
+
+  Record* LocalRecord() {
+    synchronization_internal::EpochLocalCache& cache =
+        synchronization_internal::epoch_local_cache;
+    if (TURBO_LIKELY(cache.domain_id == id_)) {
+      return cache.record;
+    }
+    return LocalRecordSlow();
+  }
+
+  Record* LocalRecordSlow();
+  Record* AcquireRecord();
+  void ReleaseRecord(Record* record);
+  void ReturnBorrowed(Record* record);
+  bool TryAdvance();
+  size_t ReclaimRecord(Record* record);
+  size_t ReclaimOrphans();
+
+  friend struct synchronization_internal::EpochThreadRecords;
+
+  const uint64_t id_;
+  std::atomic<uint64_t> epoch_;
+  std::atomic<Record*> records_;
+
+  Mutex orphans_mu_;
+  // Objects retired by threads that have exited.
+  std::vector<Record::Retired> orphans_ TURBO_GUARDED_BY(orphans_mu_);
+};
+
+TURBO_NAMESPACE_END
+}  // namespace turbo
+
+#endif  // TURBO_SYNCHRONIZATION_EPOCH_DOMAIN_H_
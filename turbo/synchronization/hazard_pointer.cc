@@ -0,0 +1,136 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/synchronization/hazard_pointer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include <turbo/base/internal/raw_logging.h>
+#include <turbo/base/no_destructor.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+
+using synchronization_internal::HazardSlot;
+
+HazardPointerDomain::HazardPointerDomain()
+    : slots_(nullptr), num_slots_(0), num_retired_(0) {}
+
+HazardPointerDomain::~HazardPointerDomain() {
+  HazardSlot* slot = slots_.load(std::memory_order_acquire);
+  while (slot != nullptr) {
+    TURBO_RAW_CHECK(slot->ptr.load(std::memory_order_relaxed) == nullptr,
+                    "HazardPointerDomain destroyed while an object is protected");
+    HazardSlot* next = slot->next;
+    delete slot;
+    slot = next;
+  }
+  turbo::MutexLock lock(&retired_mu_);
+  for (const Retired& r : retired_) {
+    r.deleter(r.ptr);
+  }
+}
+
+HazardPointerDomain& HazardPointerDomain::Default() {
+  static turbo::NoDestructor<HazardPointerDomain> domain;
+  return *domain;
+}
+
+HazardSlot* HazardPointerDomain::AcquireSlot() {
+  for (HazardSlot* slot = slots_.load(std::memory_order_acquire);
+       slot != nullptr; slot = slot->next) {
+    bool expected = false;
+    if (!slot->in_use.load(std::memory_order_relaxed) &&
+        slot->in_use.compare_exchange_strong(expected, true,
+                                             std::memory_order_acquire)) {
+      return slot;
+    }
+  }
+  HazardSlot* slot = new HazardSlot;
+  slot->in_use.store(true, std::memory_order_relaxed);
+  HazardSlot* head = slots_.load(std::memory_order_relaxed);
+  do {
+    slot->next = head;
+  } while (!slots_.compare_exchange_weak(head, slot, std::memory_order_release,
+                                         std::memory_order_relaxed));
+  num_slots_.fetch_add(1, std::memory_order_relaxed);
+  return slot;
+}
+
+void HazardPointerDomain::Retire(void* ptr, void (*deleter)(void*)) {
+  {
+    turbo::MutexLock lock(&retired_mu_);
+    retired_.push_back({ptr, deleter});
+  }
+  const size_t pending =
+      num_retired_.fetch_add(1, std::memory_order_relaxed) + 1;
+  const size_t threshold = std::max(
+      kReclaimBatch, 2 * num_slots_.load(std::memory_order_relaxed));
+  if (pending >= threshold) {
+    Reclaim();
+  }
+}
+
+size_t HazardPointerDomain::Reclaim() {
+  std::vector<Retired> candidates;
+  {
+    turbo::MutexLock lock(&retired_mu_);
+    candidates.swap(retired_);
+    num_retired_.store(0, std::memory_order_relaxed);
+  }
+  if (candidates.empty()) {
+    return 0;
+  }
+
+  // Pairs with the fence in `Holder::TryProtect()`: a reader whose hazard
+  // pointer this scan misses is guaranteed to see the object unlinked.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::vector<const void*> hazards;
+  hazards.reserve(num_slots_.load(std::memory_order_relaxed));
+  for (HazardSlot* slot = slots_.load(std::memory_order_acquire);
+       slot != nullptr; slot = slot->next) {
+    const void* ptr = slot->ptr.load(std::memory_order_acquire);
+    if (ptr != nullptr) {
+      hazards.push_back(ptr);
+    }
+  }
+  std::sort(hazards.begin(), hazards.end());
+
+  auto mid = std::partition(candidates.begin(), candidates.end(),
+                            [&hazards](const Retired& r) {
+                              return std::binary_search(hazards.begin(),
+                                                        hazards.end(), r.ptr);
+                            });
+  const size_t reclaimed = static_cast<size_t>(candidates.end() - mid);
+  for (auto it = mid; it != candidates.end(); ++it) {
+    it->deleter(it->ptr);
+  }
+  candidates.erase(mid, candidates.end());
+
+  if (!candidates.empty()) {
+    turbo::MutexLock lock(&retired_mu_);
+    retired_.insert(retired_.end(), candidates.begin(), candidates.end());
+    num_retired_.fetch_add(candidates.size(), std::memory_order_relaxed);
+  }
+  return reclaimed;
+}
+
+TURBO_NAMESPACE_END
+}  // namespace turbo
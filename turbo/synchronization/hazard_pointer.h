@@ -0,0 +1,205 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+// hazard_pointer.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines `HazardPointerDomain`, a hazard-pointer based
+// memory reclamation primitive. Unlike `EpochDomain` (see epoch_domain.h),
+// which protects everything a reader can reach for the duration of its
+// critical section, a hazard pointer protects exactly one object. A reader
+// that holds on to an object for a long time therefore only delays the
+// reclamation of that object, never of the rest of the domain.
+//
+// Example:
+//
+//   std::atomic<Node*> head;
+//
+//   // Reader
+//   turbo::HazardPointerDomain::Holder hp;
+//   Node* node = hp.Protect(head);
+//   ... `node` stays valid until `hp` is reset or destroyed ...
+//
+//   // Writer
+//   Node* old = head.exchange(replacement, std::memory_order_acq_rel);
+//   turbo::HazardPointerDomain::Default().Retire(old);
+
+#ifndef TURBO_SYNCHRONIZATION_HAZARD_POINTER_H_
+#define TURBO_SYNCHRONIZATION_HAZARD_POINTER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include <turbo/base/config.h>
+#include <turbo/base/optimization.h>
+#include <turbo/base/thread_annotations.h>
+#include <turbo/synchronization/mutex.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+
+namespace synchronization_internal {
+
+// A single hazard pointer. Slots are never freed while their domain lives;
+// released slots are reused by later holders.
+struct TURBO_CACHELINE_ALIGNED HazardSlot {
+  std::atomic<const void*> ptr{nullptr};
+  std::atomic<bool> in_use{false};
+  // Immutable once the slot is published in the domain's slot list.
+  HazardSlot* next = nullptr;
+};
+
+}  // namespace synchronization_internal
+
+// -----------------------------------------------------------------------------
+// HazardPointerDomain
+// -----------------------------------------------------------------------------
+class HazardPointerDomain {
+ public:
+  // Minimum number of retired objects before `Retire()` scans the hazard
+  // pointers; the actual threshold also grows with the number of slots so
+  // that a scan reclaims a constant fraction of the pending objects.
+  static constexpr size_t kReclaimBatch = 64;
+
+  HazardPointerDomain();
+  HazardPointerDomain(const HazardPointerDomain&) = delete;
+  HazardPointerDomain& operator=(const HazardPointerDomain&) = delete;
+
+  // Destroys every object still pending reclamation. No holder may protect an
+  // object of the domain when it is destroyed.
+  ~HazardPointerDomain();
+
+  // HazardPointerDomain::Default()
+  //
+  // Returns a process-wide domain, which is never destroyed.
+  static HazardPointerDomain& Default();
+
+  // HazardPointerDomain::Holder
+  //
+  // Owns one hazard pointer of a domain. A holder protects at most one object
+  // at a time and may be used by one thread at a time.
+  class Holder {
+   public:
+    Holder() : Holder(&HazardPointerDomain::Default()) {}
+    explicit Holder(HazardPointerDomain* domain)
+        : slot_(domain->AcquireSlot()) {}
+    Holder(Holder&& other) noexcept : slot_(other.slot_) {
+      other.slot_ = nullptr;
+    }
+    Holder& operator=(Holder&& other) noexcept {
+      if (this != &other) {
+        ReleaseSlot();
+        slot_ = other.slot_;
+        other.slot_ = nullptr;
+      }
+      return *this;
+    }
+    Holder(const Holder&) = delete;
+    Holder& operator=(const Holder&) = delete;
+    ~Holder() { ReleaseSlot(); }
+
+    // Holder::Protect()
+    //
+    // Loads `src` and protects the loaded object; the returned pointer stays
+    // valid until the holder is reset, re-protects or is destroyed.
+    template <typename T>
+    T* Protect(const std::atomic<T*>& src) {
+      T* ptr = src.load(std::memory_order_relaxed);
+      while (!TryProtect(ptr, src)) {
+      }
+      return ptr;
+    }
+
+    // Holder::TryProtect()
+    //
+    // Protects `ptr`, which the caller has loaded from `src`. Returns false and
+    // updates `ptr` to the current value of `src` if `src` changed meanwhile,
+    // in which case nothing is protected.
+    template <typename T>
+    bool TryProtect(T*& ptr, const std::atomic<T*>& src) {
+      T* const expected = ptr;
+      Reset(expected);
+      // Orders the hazard pointer before the validation load; pairs with the
+      // fence in `HazardPointerDomain::Reclaim()`.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      ptr = src.load(std::memory_order_acquire);
+      if (TURBO_UNLIKELY(ptr != expected)) {
+        Reset();
+        return false;
+      }
+      return true;
+    }
+
+    // Holder::Reset()
+    //
+    // Protects `ptr`, which the caller knows to be live (e.g. it is already
+    // protected by another holder), or clears the protection.
+    void Reset(const void* ptr = nullptr) {
+      slot_->ptr.store(ptr, std::memory_order_release);
+    }
+
+   private:
+    void ReleaseSlot() {
+      if (slot_ != nullptr) {
+        slot_->ptr.store(nullptr, std::memory_order_release);
+        slot_->in_use.store(false, std::memory_order_release);
+        slot_ = nullptr;
+      }
+    }
+
+    synchronization_internal::HazardSlot* slot_;
+  };
+
+  // HazardPointerDomain::Retire()
+  //
+  // Schedules `ptr` to be destroyed by `deleter(ptr)` once no hazard pointer
+  // protects it. The object must already be unreachable for new readers.
+  void Retire(void* ptr, void (*deleter)(void*));
+
+  template <typename T>
+  void Retire(T* ptr) {
+    Retire(static_cast<void*>(ptr),
+           [](void* p) { delete static_cast<T*>(p); });
+  }
+
+  // HazardPointerDomain::Reclaim()
+  //
+  // Destroys every retired object that is not currently protected. Returns
+  // the number of objects destroyed.
+  size_t Reclaim();
+
+ private:
+  struct Retired {
+    void* ptr;
+    void (*deleter)(void*);
+  };
+
+  synchronization_internal::HazardSlot* AcquireSlot();
+
+  std::atomic<synchronization_internal::HazardSlot*> slots_;
+  std::atomic<size_t> num_slots_;
+
+  Mutex retired_mu_;
+  std::vector<Retired> retired_ TURBO_GUARDED_BY(retired_mu_);
+  std::atomic<size_t> num_retired_;
+};
+
+TURBO_NAMESPACE_END
+}  // namespace turbo
+
+#endif  // TURBO_SYNCHRONIZATION_HAZARD_POINTER_H_
@@ -47,6 +47,7 @@
 #include <turbo/base/call_once.h>
 #include <turbo/base/config.h>
 #include <turbo/base/dynamic_annotations.h>
+#include <turbo/base/internal/adaptive_spin.h>
 #include <turbo/base/internal/atomic_hook.h>
 #include <turbo/base/internal/cycleclock.h>
 #include <turbo/base/internal/hide_ptr.h>
@@ -773,6 +774,10 @@ void Mutex::EnableDebugLog(const char* name) {
   TURBO_ANNOTATE_IGNORE_WRITES_END();
 }
 
+void EnableMutexAdaptiveSpinning(bool enabled) {
+  base_internal::AdaptiveSpin::set_enabled(enabled);
+}
+
 void EnableMutexInvariantDebugging(bool enabled) {
   synch_check_invariants.store(enabled, std::memory_order_release);
 }
@@ -1506,10 +1511,36 @@ void Mutex::AssertNotHeld() const {
   }
 }
 
+// Like TryAcquireWithSpinning() below, but bounds the spin by the budget
+// learned for *mu and feeds the outcome back into it.
+static bool TryAcquireWithAdaptiveSpinning(std::atomic<intptr_t>* mu,
+                                           int max_spins) {
+  using base_internal::AdaptiveSpin;
+  const int limit = AdaptiveSpin::SpinLimit(mu, max_spins);
+  int c = limit;
+  do {
+    intptr_t v = mu->load(std::memory_order_relaxed);
+    if ((v & (kMuReader | kMuEvent)) != 0) {
+      return false;  // a reader or tracing -> give up; says nothing about spin
+    } else if (((v & kMuWriter) == 0) &&
+               mu->compare_exchange_strong(v, kMuWriter | v,
+                                           std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+      AdaptiveSpin::RecordSuccess(mu, limit - c);
+      return true;
+    }
+  } while (--c > 0);
+  AdaptiveSpin::RecordFailure(mu, limit);
+  return false;
+}
+
 // Attempt to acquire *mu, and return whether successful.  The implementation
 // may spin for a short while if the lock cannot be acquired immediately.
 static bool TryAcquireWithSpinning(std::atomic<intptr_t>* mu) {
   int c = globals.spinloop_iterations.load(std::memory_order_relaxed);
+  if (TURBO_UNLIKELY(base_internal::AdaptiveSpin::enabled()) && c > 1) {
+    return TryAcquireWithAdaptiveSpinning(mu, c);
+  }
   do {  // do/while somewhat faster on AMD
     intptr_t v = mu->load(std::memory_order_relaxed);
     if ((v & (kMuReader | kMuEvent)) != 0) {
@@ -1179,6 +1179,17 @@ void RegisterMutexTracer(void (*fn)(const char* msg, const void* obj,
 // RegisterMutexProfiler() above.
 void RegisterCondVarTracer(void (*fn)(const char* msg, const void* cv));
 
+// EnableMutexAdaptiveSpinning()
+//
+// Enable or disable adaptive spinning for `Mutex` and the internal `SpinLock`.
+// By default a contended lock spins a fixed number of iterations before the
+// thread blocks. When enabled, each lock learns from recent acquisitions how
+// long spinning takes to pay off, so that locks with long critical sections
+// block almost immediately while locks with short ones keep spinning. Locks
+// share the learned state by address, so unrelated locks may influence each
+// other. Disabled by default.
+void EnableMutexAdaptiveSpinning(bool enabled);
+
 // EnableMutexInvariantDebugging()
 //
 // Enable or disable global support for Mutex invariant debugging.  If enabled,
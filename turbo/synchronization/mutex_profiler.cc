@@ -0,0 +1,250 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <turbo/synchronization/mutex_profiler.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+
+#include <turbo/base/attributes.h>
+#include <turbo/base/call_once.h>
+#include <turbo/base/config.h>
+#include <turbo/base/internal/cycleclock.h>
+#include <turbo/base/no_destructor.h>
+#include <turbo/base/optimization.h>
+#include <turbo/debugging/stacktrace.h>
+#include <turbo/profiling/internal/periodic_sampler.h>
+#include <turbo/profiling/internal/sample_recorder.h>
+#include <turbo/strings/str_cat.h>
+#include <turbo/synchronization/mutex.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+
+namespace {
+
+struct MutexContentionTag {};
+using ContentionSampler =
+    profiling_internal::PeriodicSampler<MutexContentionTag, 0>;
+
+// The record for one unique stack of a releasing thread.
+struct ContentionStack : public profiling_internal::Sample<ContentionStack> {
+  static constexpr int kMaxStackDepth = 64;
+
+  void PrepareForSampling(size_t stack_hash, void* const* pcs, int n) {
+    count.store(0, std::memory_order_relaxed);
+    wait_cycles.store(0, std::memory_order_relaxed);
+    hash = stack_hash;
+    depth = n;
+    std::memcpy(stack, pcs, sizeof(void*) * static_cast<size_t>(n));
+  }
+
+  bool Matches(size_t stack_hash, void* const* pcs, int n) const {
+    return hash == stack_hash && depth == n &&
+           std::memcmp(stack, pcs, sizeof(void*) * static_cast<size_t>(n)) ==
+               0;
+  }
+
+  std::atomic<int64_t> count;
+  std::atomic<int64_t> wait_cycles;
+  size_t hash;
+  int depth;
+  void* stack[kMaxStackDepth];
+};
+
+// Maps stacks to their records. Lookups and updates are lock-free; the
+// recorder's internal mutexes are only taken the first time a stack is seen.
+class ContentionTable {
+ public:
+  // Open addressing with linear probing; sized for a few thousand distinct
+  // contended call sites.
+  static constexpr size_t kNumBuckets = 4096;
+  static constexpr size_t kMaxProbes = 64;
+
+  ContentionTable() {
+    for (auto& b : buckets_) b.store(nullptr, std::memory_order_relaxed);
+  }
+
+  void Record(int64_t wait_cycles, void* const* pcs, int depth) {
+    const size_t hash = HashStack(pcs, depth);
+    ContentionStack* fresh = nullptr;
+    ContentionStack* found = nullptr;
+    for (size_t i = 0; i < kMaxProbes && found == nullptr; ++i) {
+      auto& bucket = buckets_[(hash + i) & (kNumBuckets - 1)];
+      ContentionStack* s = bucket.load(std::memory_order_acquire);
+      if (s == nullptr) {
+        if (fresh == nullptr) {
+          fresh = recorder_.Register(hash, pcs, depth);
+          if (fresh == nullptr) break;
+        }
+        // On failure `s` holds the record that won the bucket, which may be
+        // for this very stack.
+        if (bucket.compare_exchange_strong(s, fresh, std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+          s = fresh;
+          fresh = nullptr;
+        }
+      }
+      if (s->Matches(hash, pcs, depth)) found = s;
+    }
+    if (fresh != nullptr) recorder_.Unregister(fresh);
+    if (TURBO_UNLIKELY(found == nullptr)) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    found->count.fetch_add(1, std::memory_order_relaxed);
+    found->wait_cycles.fetch_add(wait_cycles, std::memory_order_relaxed);
+  }
+
+  int64_t Iterate(const std::function<void(const MutexContentionSample&)>& f) {
+    recorder_.Iterate([&](const ContentionStack& s) {
+      MutexContentionSample sample;
+      sample.count = s.count.load(std::memory_order_relaxed);
+      sample.wait_cycles = s.wait_cycles.load(std::memory_order_relaxed);
+      sample.depth = s.depth;
+      sample.stack = s.stack;
+      if (sample.count > 0) f(sample);
+    });
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+  void Reset() {
+    for (auto& b : buckets_) {
+      ContentionStack* s = b.load(std::memory_order_acquire);
+      if (s == nullptr) continue;
+      s->count.store(0, std::memory_order_relaxed);
+      s->wait_cycles.store(0, std::memory_order_relaxed);
+    }
+    dropped_.store(0, std::memory_order_relaxed);
+  }
+
+ private:
+  static size_t HashStack(void* const* pcs, int depth) {
+    uint64_t h = static_cast<uint64_t>(depth);
+    for (int i = 0; i < depth; ++i) {
+      h = (h ^ reinterpret_cast<uintptr_t>(pcs[i])) * 0x9E3779B97F4A7C15ull;
+      h ^= h >> 29;
+    }
+    return static_cast<size_t>(h);
+  }
+
+  profiling_internal::SampleRecorder<ContentionStack> recorder_;
+  std::atomic<ContentionStack*> buckets_[kNumBuckets];
+  std::atomic<int64_t> dropped_{0};
+};
+
+ContentionTable& GlobalContentionTable() {
+  static turbo::NoDestructor<ContentionTable> table;
+  return *table;
+}
+
+TURBO_CONST_INIT std::atomic<int> g_contention_period{0};
+
+TURBO_CONST_INIT thread_local ContentionSampler g_contention_sampler;
+
+// Set while the current thread is inside `RecordMutexContention()`. The
+// recorder uses `turbo::Mutex` internally, whose contention would otherwise
+// re-enter the profiler.
+TURBO_CONST_INIT thread_local bool g_in_contention_profiler = false;
+
+void RecordMutexContention(int64_t wait_cycles) {
+  if (TURBO_LIKELY(!g_contention_sampler.Sample())) return;
+  if (g_in_contention_profiler) return;
+  g_in_contention_profiler = true;
+  void* pcs[ContentionStack::kMaxStackDepth];
+  // As with hashtablez, no frames are skipped: the inliner makes a hardcoded
+  // skip count unreliable, and the profiler and mutex release frames on top of
+  // every stack are easily folded away with `pprof --ignore`.
+  const int depth = turbo::GetStackTrace(pcs, ContentionStack::kMaxStackDepth,
+                                         /* skip_count= */ 0);
+  GlobalContentionTable().Record(wait_cycles, pcs, depth);
+  g_in_contention_profiler = false;
+}
+
+void AppendMemoryMap(std::string* out) {
+#if defined(__linux__)
+  FILE* maps = std::fopen("/proc/self/maps", "r");
+  if (maps == nullptr) return;
+  out->append("\nMAPPED_LIBRARIES:\n");
+  char buf[4096];
+  size_t n;
+  while ((n = std::fread(buf, 1, sizeof(buf), maps)) > 0) {
+    out->append(buf, n);
+  }
+  std::fclose(maps);
+#else
+  (void)out;
+#endif
+}
+
+}  // namespace
+
+void SetMutexContentionSamplingPeriod(int period) {
+  if (period > 0) {
+    static turbo::once_flag registered;
+    turbo::call_once(registered, [] {
+      GlobalContentionTable();
+      RegisterMutexProfiler(&RecordMutexContention);
+    });
+  }
+  if (period < 0) period = 0;
+  g_contention_period.store(period, std::memory_order_relaxed);
+  ContentionSampler::SetGlobalPeriod(period);
+}
+
+int GetMutexContentionSamplingPeriod() {
+  return g_contention_period.load(std::memory_order_relaxed);
+}
+
+int64_t IterateMutexContentionProfile(
+    const std::function<void(const MutexContentionSample&)>& f) {
+  return GlobalContentionTable().Iterate(f);
+}
+
+void ResetMutexContentionProfile() { GlobalContentionTable().Reset(); }
+
+std::string DumpMutexContentionProfile() {
+  std::string out = "--- contention:\n";
+  turbo::str_append(
+      &out, "cycles/second = ",
+      static_cast<int64_t>(base_internal::CycleClock::Frequency()), "\n");
+  turbo::str_append(&out, "sampling period = ",
+                    GetMutexContentionSamplingPeriod(), "\n");
+  const int64_t dropped =
+      IterateMutexContentionProfile([&](const MutexContentionSample& s) {
+        turbo::str_append(&out, s.wait_cycles, " ", s.count, " @");
+        for (int i = 0; i < s.depth; ++i) {
+          turbo::str_append(
+              &out, " 0x",
+              turbo::Hex(reinterpret_cast<uintptr_t>(s.stack[i])));
+        }
+        out.push_back('\n');
+      });
+  if (dropped > 0) {
+    turbo::str_append(&out, "# dropped samples = ", dropped, "\n");
+  }
+  AppendMemoryMap(&out);
+  return out;
+}
+
+TURBO_NAMESPACE_END
+}  // namespace turbo
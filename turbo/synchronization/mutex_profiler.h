@@ -0,0 +1,107 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+// mutex_profiler.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines a sampling contention profiler for `turbo::Mutex`.
+//
+// The profiler plugs into `RegisterMutexProfiler()`. Whenever a contended
+// mutex is released and its waiters are woken, the releasing thread reports
+// the cycles those waiters spent blocked. One in every `period` such events
+// (chosen at random) is sampled: the stack of the releasing thread is captured
+// and the wait cycles are added to the record for that stack. Attributing the
+// delay to the unlocker points at the critical section that made others wait,
+// which is usually what needs fixing.
+//
+// Records are kept per unique stack, so memory is proportional to the number
+// of contended call sites rather than to the number of events. The profile can
+// be dumped in the legacy text format understood by `pprof`:
+//
+//   turbo::SetMutexContentionSamplingPeriod(100);
+//   ...
+//   std::string profile = turbo::DumpMutexContentionProfile();
+//   // $ pprof --text ./binary profile.txt
+//
+// Only one mutex profiler can be registered per binary; do not combine this
+// with another call to `RegisterMutexProfiler()`.
+
+#ifndef TURBO_SYNCHRONIZATION_MUTEX_PROFILER_H_
+#define TURBO_SYNCHRONIZATION_MUTEX_PROFILER_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include <turbo/base/config.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+
+// MutexContentionSample
+//
+// The aggregated contention recorded for one stack of a releasing thread.
+// Values are raw sampled values; multiply by the sampling period to estimate
+// totals.
+struct MutexContentionSample {
+  // Number of sampled contention events.
+  int64_t count;
+  // Sum of the wait cycles (as measured by `base_internal::CycleClock`) of
+  // the sampled events.
+  int64_t wait_cycles;
+  // The captured stack, innermost frame first.
+  int depth;
+  void* const* stack;
+};
+
+// SetMutexContentionSamplingPeriod()
+//
+// Samples on average one in every `period` contention events. A period of 0
+// (the default) disables sampling, and 1 records every event. The first call
+// with a non-zero period registers the profiler via `RegisterMutexProfiler()`.
+void SetMutexContentionSamplingPeriod(int period);
+
+// GetMutexContentionSamplingPeriod()
+//
+// Returns the period set by `SetMutexContentionSamplingPeriod()`.
+int GetMutexContentionSamplingPeriod();
+
+// IterateMutexContentionProfile()
+//
+// Calls `f` for every stack with a non-zero count, and returns the number of
+// sampled events that were dropped because the profiler ran out of room for
+// new stacks.
+int64_t IterateMutexContentionProfile(
+    const std::function<void(const MutexContentionSample&)>& f);
+
+// ResetMutexContentionProfile()
+//
+// Clears all counts. Stacks that have been seen keep their storage.
+void ResetMutexContentionProfile();
+
+// DumpMutexContentionProfile()
+//
+// Returns the profile in the legacy `pprof` contention format: a
+// `--- contention:` header with the cycle frequency and sampling period, one
+// `<cycles> <count> @ <pc>...` line per stack and, on Linux, the memory map
+// of the process so that `pprof` can symbolize the addresses.
+std::string DumpMutexContentionProfile();
+
+TURBO_NAMESPACE_END
+}  // namespace turbo
+
+#endif  // TURBO_SYNCHRONIZATION_MUTEX_PROFILER_H_
@@ -0,0 +1,172 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+// read_mostly.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines `ReadMostly<T>`, an RCU-style holder for values
+// that are read very frequently and replaced rarely, such as configuration
+// snapshots, routing tables or feature flags.
+//
+// Readers obtain an immutable snapshot through `Read()`. A read pins the
+// holder's `EpochDomain` (see epoch_domain.h), which only writes a cache line
+// owned by the reading thread, so concurrent readers never contend with each
+// other the way `Mutex::ReaderLock()` does. Writers build a complete new
+// value, publish it with a single atomic exchange and retire the old version,
+// which is destroyed once every reader that might still see it is gone.
+//
+// Example:
+//
+//   turbo::ReadMostly<RoutingTable> table(LoadRoutingTable());
+//
+//   // Request path
+//   auto snapshot = table.Read();
+//   Route(snapshot->Lookup(key));
+//
+//   // Control path
+//   table.Update([](RoutingTable& t) { t.Add(new_route); });
+//
+// A snapshot must not outlive the `ReadMostly` it came from, must be released
+// on the thread that obtained it, and should be short-lived: while it is held
+// no version retired in the same domain can be reclaimed.
+
+#ifndef TURBO_SYNCHRONIZATION_READ_MOSTLY_H_
+#define TURBO_SYNCHRONIZATION_READ_MOSTLY_H_
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include <turbo/base/config.h>
+#include <turbo/synchronization/epoch_domain.h>
+#include <turbo/synchronization/mutex.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+
+template <typename T>
+class ReadMostly {
+ public:
+  // ReadMostly::Snapshot
+  //
+  // A pinned, immutable view of the value current at the time of `Read()`.
+  class Snapshot {
+   public:
+    Snapshot(Snapshot&&) noexcept = default;
+    Snapshot& operator=(Snapshot&&) noexcept = default;
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    const T& operator*() const { return *value_; }
+    const T* operator->() const { return value_; }
+    const T* get() const { return value_; }
+
+   private:
+    friend class ReadMostly;
+    Snapshot(EpochDomain::Guard guard, const T* value)
+        : guard_(std::move(guard)), value_(value) {}
+
+    EpochDomain::Guard guard_;
+    const T* value_;
+  };
+
+  // Holds a value-initialized `T`.
+  ReadMostly() : ReadMostly(std::make_unique<T>()) {}
+
+  explicit ReadMostly(T value,
+                      EpochDomain* domain = &EpochDomain::Default())
+      : ReadMostly(std::make_unique<T>(std::move(value)), domain) {}
+
+  explicit ReadMostly(std::unique_ptr<T> value,
+                      EpochDomain* domain = &EpochDomain::Default())
+      : domain_(domain), current_(value.release()) {}
+
+  ReadMostly(const ReadMostly&) = delete;
+  ReadMostly& operator=(const ReadMostly&) = delete;
+
+  // Older versions may still be pending in the domain; they are reclaimed
+  // independently of the holder.
+  ~ReadMostly() { delete current_.load(std::memory_order_relaxed); }
+
+  // ReadMostly::Read()
+  //
+  // Returns the current value. Never blocks and performs no write to memory
+  // shared with other readers.
+  Snapshot Read() const {
+    EpochDomain::Guard guard = domain_->Pin();
+    const T* value = current_.load(std::memory_order_acquire);
+    return Snapshot(std::move(guard), value);
+  }
+
+  // ReadMostly::With()
+  //
+  // Invokes `f(const T&)` on the current value and returns its result.
+  template <typename F>
+  decltype(auto) With(F&& f) const {
+    Snapshot snapshot = Read();
+    return std::forward<F>(f)(*snapshot);
+  }
+
+  // ReadMostly::Store()
+  //
+  // Publishes `value`; readers that start after this call see it. The
+  // previous version is retired to the domain and destroyed once no reader
+  // holds it. Does not wait for readers, see `Synchronize()`.
+  void Store(std::unique_ptr<T> value) {
+    turbo::MutexLock lock(&writer_mu_);
+    Publish(value.release());
+  }
+
+  void Store(T value) { Store(std::make_unique<T>(std::move(value))); }
+
+  // ReadMostly::Update()
+  //
+  // Copies the current value, applies `f(T&)` to the copy and publishes it.
+  // Concurrent updates are serialized, so none of them is lost.
+  template <typename F>
+  void Update(F&& f) {
+    turbo::MutexLock lock(&writer_mu_);
+    auto next = std::make_unique<T>(*current_.load(std::memory_order_relaxed));
+    std::forward<F>(f)(*next);
+    Publish(next.release());
+  }
+
+  // ReadMostly::Synchronize()
+  //
+  // Blocks until no reader can observe a version replaced before this call
+  // and destroys those versions that were retired by the calling thread. Must
+  // not be called while holding a snapshot of the same domain.
+  void Synchronize() { domain_->Synchronize(); }
+
+ private:
+  void Publish(T* next) TURBO_EXCLUSIVE_LOCKS_REQUIRED(writer_mu_) {
+    T* previous = current_.exchange(next, std::memory_order_acq_rel);
+    domain_->Retire(previous);
+    // Opportunistically reclaim versions whose readers are already gone, so
+    // rarely updated values do not wait for a full retirement batch.
+    domain_->Reclaim();
+  }
+
+  EpochDomain* const domain_;
+  std::atomic<T*> current_;
+  Mutex writer_mu_;
+};
+
+TURBO_NAMESPACE_END
+}  // namespace turbo
+
+#endif  // TURBO_SYNCHRONIZATION_READ_MOSTLY_H_
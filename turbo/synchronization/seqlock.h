@@ -0,0 +1,246 @@
+// Copyright (C) 2024 EA group inc.
+// Author: Jeff.li lijippy@163.com
+// All rights reserved.
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Affero General Public License as published
+// by the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+// -----------------------------------------------------------------------------
+// seqlock.h
+// -----------------------------------------------------------------------------
+//
+// This header file defines `SeqLock<T>` and `MultiWriterSeqLock<T>`, sequence
+// locks protecting a trivially copyable payload of arbitrary size.
+//
+// A sequence counter is incremented before and after each write; a reader
+// copies the payload and accepts the copy only if the counter was even and
+// unchanged across the copy. Readers never block and never write shared
+// memory, which makes sequence locks a good fit for small, frequently read
+// snapshots such as statistics or clock calibration data.
+//
+// The payload is stored as an array of `std::atomic<uint64_t>` and copied
+// with relaxed atomic accesses, so concurrent reads and writes are not data
+// races under the C++ memory model. See "Can Seqlocks Get Along With
+// Programming Language Memory Models?" by Hans J. Boehm for the background.
+//
+// Example:
+//
+//   struct Calibration { int64_t base_ns; int64_t base_cycles; double scale; };
+//   turbo::SeqLock<Calibration> calibration;
+//
+//   // Writer (a single thread, or use MultiWriterSeqLock)
+//   calibration.Update([&](Calibration& c) {
+//     c.base_ns = now_ns;
+//     c.base_cycles = now_cycles;
+//   });
+//
+//   // Readers
+//   Calibration c = calibration.Load();
+
+#ifndef TURBO_SYNCHRONIZATION_SEQLOCK_H_
+#define TURBO_SYNCHRONIZATION_SEQLOCK_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include <turbo/base/config.h>
+#include <turbo/base/internal/spinlock.h>
+#include <turbo/base/optimization.h>
+
+namespace turbo {
+TURBO_NAMESPACE_BEGIN
+
+namespace synchronization_internal {
+
+// Performs the equivalent of "memcpy(dst, src, size)", reading `src` with
+// relaxed atomic loads.
+inline void RelaxedCopyFromAtomic(void* dst, const std::atomic<uint64_t>* src,
+                                  size_t size) {
+  char* dst_byte = static_cast<char*>(dst);
+  while (size >= sizeof(uint64_t)) {
+    uint64_t word = src->load(std::memory_order_relaxed);
+    std::memcpy(dst_byte, &word, sizeof(word));
+    dst_byte += sizeof(word);
+    src++;
+    size -= sizeof(word);
+  }
+  if (size > 0) {
+    uint64_t word = src->load(std::memory_order_relaxed);
+    std::memcpy(dst_byte, &word, size);
+  }
+}
+
+// Performs the equivalent of "memcpy(dst, src, size)", writing `dst` with
+// relaxed atomic stores.
+inline void RelaxedCopyToAtomic(std::atomic<uint64_t>* dst, const void* src,
+                                size_t size) {
+  const char* src_byte = static_cast<const char*>(src);
+  while (size >= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, src_byte, sizeof(word));
+    dst->store(word, std::memory_order_relaxed);
+    src_byte += sizeof(word);
+    dst++;
+    size -= sizeof(word);
+  }
+  if (size > 0) {
+    uint64_t word = 0;
+    std::memcpy(&word, src_byte, size);
+    dst->store(word, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace synchronization_internal
+
+// -----------------------------------------------------------------------------
+// SeqLock
+// -----------------------------------------------------------------------------
+//
+// A sequence lock for a single writer. Calls to `Store()` and `Update()` must
+// be externally synchronized with each other; they may run concurrently with
+// any number of readers.
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SeqLock requires a trivially copyable payload");
+
+ public:
+  SeqLock() : SeqLock(T{}) {}
+
+  explicit SeqLock(const T& value) : seq_(0), shadow_(value) {
+    synchronization_internal::RelaxedCopyToAtomic(words_, &shadow_,
+                                                  sizeof(T));
+  }
+
+  SeqLock(const SeqLock&) = delete;
+  SeqLock& operator=(const SeqLock&) = delete;
+
+  // SeqLock::TryLoad()
+  //
+  // Makes a single optimistic read attempt. Returns false if a write was in
+  // progress or completed during the copy, in which case `*out` holds
+  // unspecified (but not uninitialized) bytes.
+  bool TryLoad(T* out) const {
+    // Acquire ensures that no load of the payload is reordered above the
+    // first load of the sequence counter.
+    const uint64_t seq_before = seq_.load(std::memory_order_acquire);
+    if (TURBO_UNLIKELY((seq_before & 1) != 0)) return false;
+    synchronization_internal::RelaxedCopyFromAtomic(out, words_, sizeof(T));
+    // Orders the payload loads above before the second counter load.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return TURBO_LIKELY(seq_before == seq_.load(std::memory_order_relaxed));
+  }
+
+  // SeqLock::Load()
+  //
+  // Returns a consistent copy of the payload, retrying while writes overlap
+  // the read. Never blocks on a lock.
+  T Load() const {
+    T value;
+    while (!TryLoad(&value)) {
+    }
+    return value;
+  }
+
+  // SeqLock::version()
+  //
+  // Returns the number of completed writes. Readers can use it to detect that
+  // the payload changed without copying it.
+  uint64_t version() const {
+    return seq_.load(std::memory_order_acquire) / 2;
+  }
+
+  // SeqLock::Store()
+  //
+  // Replaces the payload.
+  void Store(const T& value) {
+    shadow_ = value;
+    Publish();
+  }
+
+  // SeqLock::Update()
+  //
+  // Applies `f(T&)` to the writer's copy of the payload and publishes the
+  // result as a single write, so any number of field updates made by `f` cost
+  // readers at most one retry.
+  template <typename F>
+  void Update(F&& f) {
+    std::forward<F>(f)(shadow_);
+    Publish();
+  }
+
+ private:
+  static constexpr size_t kWords =
+      (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  void Publish() {
+    // Relaxed counter updates suffice because writers are externally
+    // synchronized; the fences below order them against the payload.
+    const uint64_t seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed);
+    // Makes every payload store below effectively a release operation, so
+    // the odd counter value cannot be reordered after any of them.
+    std::atomic_thread_fence(std::memory_order_release);
+    synchronization_internal::RelaxedCopyToAtomic(words_, &shadow_, sizeof(T));
+    seq_.store(seq + 2, std::memory_order_release);
+  }
+
+  std::atomic<uint64_t> seq_;
+  std::atomic<uint64_t> words_[kWords];
+  // The writer's private copy of the payload, which `Update()` mutates in
+  // place instead of reading the atomic words back.
+  T shadow_;
+};
+
+// -----------------------------------------------------------------------------
+// MultiWriterSeqLock
+// -----------------------------------------------------------------------------
+//
+// A `SeqLock` whose writers are serialized by an internal spin lock, for
+// payloads updated from several threads. The read side is identical.
+template <typename T>
+class MultiWriterSeqLock {
+ public:
+  MultiWriterSeqLock() = default;
+  explicit MultiWriterSeqLock(const T& value) : lock_(value) {}
+
+  MultiWriterSeqLock(const MultiWriterSeqLock&) = delete;
+  MultiWriterSeqLock& operator=(const MultiWriterSeqLock&) = delete;
+
+  bool TryLoad(T* out) const { return lock_.TryLoad(out); }
+  T Load() const { return lock_.Load(); }
+  uint64_t version() const { return lock_.version(); }
+
+  void Store(const T& value) {
+    base_internal::SpinLockHolder l(&writer_mu_);
+    lock_.Store(value);
+  }
+
+  template <typename F>
+  void Update(F&& f) {
+    base_internal::SpinLockHolder l(&writer_mu_);
+    lock_.Update(std::forward<F>(f));
+  }
+
+ private:
+  base_internal::SpinLock writer_mu_;
+  SeqLock<T> lock_;
+};
+
+TURBO_NAMESPACE_END
+}  // namespace turbo
+
+#endif  // TURBO_SYNCHRONIZATION_SEQLOCK_H_